@@ -28,6 +28,9 @@ namespace binary_resource
 	// SOURCE: shaders/cube.vert
 	DEFINE_RESOURCE(cube_vert)
 
+	// SOURCE: shaders/cull.comp
+	DEFINE_RESOURCE(cull_comp)
+
 	// SOURCE: shaders/exposure-lerp.comp
 	DEFINE_RESOURCE(exposure_lerp_comp)
 
@@ -43,8 +46,8 @@ namespace binary_resource
 	// SOURCE: shaders/gen-diffuse.frag
 	DEFINE_RESOURCE(gen_diffuse_frag)
 
-	// SOURCE: shaders/gen-specular.frag
-	DEFINE_RESOURCE(gen_specular_frag)
+	// SOURCE: shaders/gen-specular.comp
+	DEFINE_RESOURCE(gen_specular_comp)
 
 	// SOURCE: shaders/gbuffer.frag
 	DEFINE_RESOURCE(gbuffer_frag)
@@ -52,8 +55,8 @@ namespace binary_resource
 	// SOURCE: shaders/gbuffer.vert
 	DEFINE_RESOURCE(gbuffer_vert)
 
-	// SOURCE: shaders/gbuffer-skin.vert
-	DEFINE_RESOURCE(gbuffer_skin_vert)
+	// SOURCE: shaders/gbuffer-indirect.vert
+	DEFINE_RESOURCE(gbuffer_indirect_vert)
 
 	// SOURCE: shaders/lighting.frag
 	DEFINE_RESOURCE(lighting_frag)
@@ -70,14 +73,17 @@ namespace binary_resource
 	// SOURCE: shaders/shadow.vert
 	DEFINE_RESOURCE(shadow_vert)
 
+	// SOURCE: shaders/shadow-indirect.vert
+	DEFINE_RESOURCE(shadow_indirect_vert)
+
 	// SOURCE: shaders/shadow-opaque.vert
 	DEFINE_RESOURCE(shadow_opaque_vert)
 
-	// SOURCE: shaders/shadow-skin.vert
-	DEFINE_RESOURCE(shadow_skin_vert)
+	// SOURCE: shaders/shadow-opaque-indirect.vert
+	DEFINE_RESOURCE(shadow_opaque_indirect_vert)
 
-	// SOURCE: shaders/shadow-skin-opaque.vert
-	DEFINE_RESOURCE(shadow_skin_opaque_vert)
+	// SOURCE: shaders/skin.comp
+	DEFINE_RESOURCE(skin_comp)
 
 	/* Assets */
 
@@ -18,6 +18,7 @@ struct Camera_controller
 		  zoom_sensitivity = 0.2, lerp_speed = 15;
 
 	void update(ImGuiIO& io);
+	void snap();  // Jumps to the target without lerping
 
 	glm::mat4 rotation_matrix() const;
 	glm::mat4 view_matrix() const;
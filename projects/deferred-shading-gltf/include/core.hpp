@@ -36,13 +36,24 @@ struct Core
 	bool render_one_frame(const loop_func& func);
 	void recreate_swapchain();
 
-	Core()
+	// `wide_gbuffer` keeps the wide gbuffer layout even if the compact one is supported
+	explicit Core(bool wide_gbuffer = false)
 	{
 		initialize_sdl();
 
+		env.features.wide_gbuffer_forced = wide_gbuffer;
 		env.create();
 		pipeline_set.create(env);
 		render_targets.create(env, pipeline_set);
 		ui_controller.init_imgui(env);
 	}
+
+	// Headless core rendering into offscreen images of `extent`, neither SDL nor ImGui is initialized
+	explicit Core(vk::Extent2D extent, bool wide_gbuffer = false)
+	{
+		env.features.wide_gbuffer_forced = wide_gbuffer;
+		env.create_headless(extent);
+		pipeline_set.create(env);
+		render_targets.create(env, pipeline_set);
+	}
 };
@@ -6,6 +6,7 @@
 
 inline constexpr uint32_t csm_count              = 3;
 inline constexpr uint32_t bloom_downsample_count = 8;
+inline constexpr uint32_t frames_in_flight       = 2;  // Frames recorded by CPU while GPU is still executing
 
 using namespace VKLIB_HPP_NAMESPACE;
 
@@ -19,6 +20,11 @@ class Environment
 		bool debug_marker_enabled;
 		bool  anistropy_enabled;
 		float max_anistropy = 0.0;
+		bool  indirect_draw_enabled;        // Multi-draw indirect with non-zero first instance, required by GPU culling
+		bool  headless = false;             // No window, surface or swapchain, see `create_headless`
+		bool  compact_gbuffer_enabled;      // Gbuffer uses `Gbuffer_pipeline::compact_formats`
+		bool  wide_gbuffer_forced = false;  // Keeps the wide gbuffer even if the compact one is supported, see `--gbuffer`
+		bool  texture_compression_bc_enabled;
 	} features;
 
 	SDL2_window   window;
@@ -34,6 +40,20 @@ class Environment
 	uint32_t g_family_count;
 	Queue    g_queue, g_queue2, p_queue, t_queue, c_queue;
 
+	// > Held by worker threads while they submit to or wait on `t_queue` & `g_queue2`, as the render thread keeps presenting.
+	// The render thread holds it while recreating the swapchain, whose `device->waitIdle()` & submissions need them synchronized
+	mutable std::mutex worker_queue_mutex;
+
+	// > Whether `t_queue` or `g_queue2` is the same queue as `g_queue`, `p_queue` or `c_queue`, on devices exposing fewer
+	// queues than requested (e.g. software rasterizers). The render thread then takes `worker_queue_mutex` as well
+	bool worker_queues_aliased = false;
+
+	// Lock of `worker_queue_mutex` held by the render thread while using its queues, only taken if `worker_queues_aliased`
+	std::unique_lock<std::mutex> lock_render_queues() const
+	{
+		return worker_queues_aliased ? std::unique_lock(worker_queue_mutex) : std::unique_lock<std::mutex>();
+	}
+
 	Command_pool                command_pool;
 	std::vector<Command_buffer> command_buffer;
 
@@ -49,6 +69,8 @@ class Environment
 		std::vector<vk::Image>  image_handles;
 		std::vector<Image_view> image_views;
 
+		std::vector<Image> offscreen_images;  // Backs `image_handles` in headless mode
+
 		struct
 		{
 			bool color_depth_10_enabled = false;
@@ -59,12 +81,20 @@ class Environment
 		void create_images(const Environment& env);
 
 		void create(Environment& env);
+
+		// Creates `frames_in_flight` offscreen images of `extent` in place of the swapchain images.
+		// The images are left in color attachment layout after FXAA and can be copied from.
+		void create_offscreen(Environment& env, vk::Extent2D extent);
 	};
 
 	Env_swapchain swapchain;
 
 	void create();
 
+	// Creates the environment without a window, so no SDL initialization is needed.
+	// Presentable images are replaced by offscreen images, CPU implementations such as lavapipe are accepted.
+	void create_headless(vk::Extent2D extent);
+
 	template <typename... T>
 	void log_msg(const std::format_string<std::remove_reference_t<T>...> fmt, T&&... args) const
 	{
@@ -82,9 +112,11 @@ class Environment
   private:
 
 	static Physical_device helper_select_physical_device(const std::vector<Physical_device>& device_list);
+	static Physical_device helper_select_headless_physical_device(const std::vector<Physical_device>& device_list);
 
 	void create_window();
 	void create_instance_debug_utility(bool disable_validation = false);
 	void find_queue_families();
 	void create_logic_device();
+	void create_device();
 };
@@ -1,9 +1,15 @@
 #pragma once
 
 #include "environment.hpp"
+#include <filesystem>
 #include <vklib/core.hpp>
 
-constexpr uint32_t environment_layers = 6;
+constexpr uint32_t environment_layers  = 6;
+constexpr uint32_t diffuse_resolution  = 32;
+constexpr uint32_t brdf_lut_resolution = 256;
+
+// Holds environment & diffuse maps of previously loaded HDRIs, keyed by the content hash of the source file
+inline const std::filesystem::path ibl_cache_directory = "ibl-cache";
 
 struct Hdri_resource
 {
@@ -14,18 +20,40 @@ struct Hdri_resource
 	Descriptor_pool descriptor_pool;
 	Descriptor_set  descriptor_set;
 
+	// Command pool & queue used for generation, the pool must not be used by other threads meanwhile.
+	// Allows generating on a worker thread while the render thread keeps presenting frames.
+	struct Generate_context
+	{
+		Command_pool        command_pool;
+		Queue               queue;
+		std::atomic<float>* progress    = nullptr;
+		std::mutex*         queue_mutex = nullptr;  // Held while using `queue` if given, see `Environment::worker_queue_mutex`
+
+		// Submits one chunk of generation work and waits for it
+		void submit_and_wait(const Command_buffer& command_buffer) const;
+
+		void report_progress(float value) const
+		{
+			if (progress) *progress = value;
+		}
+	};
+
 	void generate(
 		const Environment&           env,
+		const Generate_context&      context,
 		const Image_view&            input_image,
 		uint32_t                     resolution,
 		const Descriptor_set_layout& layout
 	)
 	{
 		create_sampler(env);
-		generate_environment(env, input_image, resolution);
-		generate_diffuse(env, 32);
-		generate_specular(env, resolution);
-		generate_brdf_lut(env, 256);
+		generate_environment(env, context, input_image, resolution);
+		context.report_progress(0.2f);
+		generate_diffuse(env, context, diffuse_resolution);
+		context.report_progress(0.4f);
+		generate_specular(env, context, resolution);
+		if (!brdf_lut.is_valid()) generate_brdf_lut(env, context, brdf_lut_resolution);
+		context.report_progress(1.0f);
 		generate_descriptors(env.device, layout);
 
 		mipmapped_environment.explicit_destroy();
@@ -35,6 +63,36 @@ struct Hdri_resource
 
 	void generate_descriptors(const Device& device, const Descriptor_set_layout& layout);
 
+	// Reuses the BRDF LUT of `other` instead of generating one, as it doesn't depend on the environment
+	void share_brdf_lut(const Hdri_resource& other)
+	{
+		brdf_lut      = other.brdf_lut;
+		brdf_lut_view = other.brdf_lut_view;
+	}
+
+	/* IBL Cache */
+
+	// Identifies a source HDRI file in the cache, both are compared on a cache hit
+	struct Source_key
+	{
+		uint64_t hash;  // Content hash, also names the cache file
+		uint64_t size;  // Byte size of the file
+	};
+
+	static Source_key source_key(std::span<const uint8_t> data);
+
+	// Restores the maps saved by `save_cache` instead of generating them, returns false if no valid cache exists
+	bool load_cache(
+		const Environment&           env,
+		const Generate_context&      context,
+		const Source_key&            source,
+		uint32_t                     resolution,
+		const Descriptor_set_layout& layout
+	);
+
+	// Reads back the generated environment & diffuse maps into the cache
+	void save_cache(const Environment& env, const Generate_context& context, const Source_key& source, uint32_t resolution) const;
+
   private:
 
 	Image         mipmapped_environment;
@@ -47,8 +105,13 @@ struct Hdri_resource
 	};
 
 	void create_sampler(const Environment& env);
-	void generate_environment(const Environment& env, const Image_view& input_image, uint32_t resolution);
-	void generate_diffuse(const Environment& env, uint32_t resolution);
-	void generate_specular(const Environment& env, uint32_t resolution);
-	void generate_brdf_lut(const Environment& env, uint32_t resolution);
+	void generate_environment(
+		const Environment&      env,
+		const Generate_context& context,
+		const Image_view&       input_image,
+		uint32_t                resolution
+	);
+	void generate_diffuse(const Environment& env, const Generate_context& context, uint32_t resolution);
+	void generate_specular(const Environment& env, const Generate_context& context, uint32_t resolution);
+	void generate_brdf_lut(const Environment& env, const Generate_context& context, uint32_t resolution);
 };
\ No newline at end of file
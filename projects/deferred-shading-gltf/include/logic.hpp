@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core.hpp"
+#include "profiler.hpp"
 #include <nlohmann/json.hpp>
 #include <utility>
 
@@ -64,6 +65,28 @@ struct Scene_preset
 	void assign(Render_params& dst) const;
 };
 
+// Options of the headless mode, rendering a preset into offscreen images without a window
+struct Headless_config
+{
+	std::string           preset_path;
+	std::filesystem::path output_dir = "headless-output";
+	vk::Extent2D          extent     = {1280, 720};
+
+	uint32_t frame_count      = 60;
+	float    timestep         = 1.0f / 60;  // Seconds advanced per frame, independent of the actual frame time
+	uint32_t capture_interval = 0;          // Captures every n-th frame, 0 only captures the last frame
+	int      animation        = -1;         // Index of the animation played from the first frame, -1 for none
+
+	// Parses `--headless <preset.json>` and its options, returns `std::nullopt` if `--headless` isn't present.
+	// Throws `error::Detailed_error` on malformed arguments.
+	static std::optional<Headless_config> parse(int argc, char** argv);
+
+	bool should_capture(uint32_t frame) const
+	{
+		return capture_interval == 0 ? frame + 1 == frame_count : frame % capture_interval == 0;
+	}
+};
+
 class App_render_logic : public Application_logic_base
 {
   private:
@@ -80,6 +103,9 @@ class App_render_logic : public Application_logic_base
 	uint32_t  gbuffer_object_count, shadow_object_count, gbuffer_vertex_count, shadow_vertex_count;
 	glm::vec3 scene_min_bound{0.0}, scene_max_bound{0.0};
 
+	Gpu_profiler gpu_profiler;
+	std::string  gpu_profile_export_msg, cpu_trace_export_msg;
+
 	/* Generator */
 
 	Drawcall_generator                        gbuffer_generator;
@@ -89,39 +115,113 @@ class App_render_logic : public Application_logic_base
 	Camera_parameter                        gbuffer_param;
 
 	Node_traverser traverser;
+	Scene_bounds   scene_bounds;
+
+	// Static primitives are culled and drawn indirectly on GPU when enabled, skinned ones still go through the generators
+	Gpu_culling gpu_culling;
+	bool        gpu_culling_active = false;  // GPU culling is used in the current frame
 
 	// Vulkan Objects
 
+	// Command pool owned by a single recording thread, command buffers are recycled after `reset()`
+	struct Thread_command_pool
+	{
+		Command_pool                pool;
+		std::vector<Command_buffer> primary_buffers, secondary_buffers;
+		size_t                      primary_used = 0, secondary_used = 0;
+
+		Thread_command_pool(const Environment& env);
+
+		void           reset();
+		Command_buffer acquire(vk::CommandBufferLevel level);
+	};
+
 	struct Command_buffer_set
 	{
 		Command_buffer animation_update_command_buffer, gbuffer_command_buffer, shadow_command_buffer, lighting_command_buffer,
 			compute_command_buffer, composite_command_buffer;
 
-		Command_buffer_set(const Command_pool& pool)
+		// Secondary command buffers holding slices of the drawlists, executed in order
+		std::vector<Command_buffer>                        gbuffer_secondary_buffers;
+		std::array<std::vector<Command_buffer>, csm_count> shadow_secondary_buffers;
+
+		std::vector<Thread_command_pool> thread_command_pools;  // One for each recording thread
+
+		Command_buffer_set(const Environment& env, size_t thread_count)
 		{
-			animation_update_command_buffer = {pool};
-			gbuffer_command_buffer          = {pool};
-			shadow_command_buffer           = {pool};
-			lighting_command_buffer         = {pool};
-			compute_command_buffer          = {pool};
-			composite_command_buffer        = {pool};
+			animation_update_command_buffer = {env.command_pool};
+			gbuffer_command_buffer          = {env.command_pool};
+			shadow_command_buffer           = {env.command_pool};
+			composite_command_buffer        = {env.command_pool};
+
+			for (auto _ : Iota(thread_count)) thread_command_pools.emplace_back(env);
 		}
 	};
 
-	std::vector<Command_buffer_set> command_buffers;
+	std::vector<Command_buffer_set> command_buffers;  // Per frame in flight
+
+	// Workers for culling and command recording, the main thread also takes part
+	utility::Thread_pool record_thread_pool;
+
+	// Semaphores of a single frame in flight
+	struct Frame_semaphore_set
+	{
+		Semaphore copy_buffer_semaphore, gbuffer_shadow_semaphore, composite_semaphore, compute_semaphore, lighting_semaphore;
+
+		Frame_semaphore_set(const Device& device)
+		{
+			copy_buffer_semaphore    = {device};
+			gbuffer_shadow_semaphore = {device};
+			composite_semaphore      = {device};
+			compute_semaphore        = {device};
+			lighting_semaphore       = {device};
+		}
+	};
 
-	Semaphore copy_buffer_semaphore, gbuffer_shadow_semaphore, composite_semaphore, compute_semaphore, lighting_semaphore;
+	std::vector<Frame_semaphore_set> frame_semaphores;
 
 	/* Draw Logic */
 
-	// Draw
-	void draw(uint32_t idx);
+	// Draw to swapchain image `image_idx`. Other functions take `idx` as the current frame slot,
+	// indexing command buffers and render target sets
+	void draw(uint32_t image_idx);
 
 	void generate_drawcalls(uint32_t idx);
 	void update_uniforms(uint32_t idx);
 
-	void draw_gbuffer(uint32_t idx, const Command_buffer& command_buffer);
-	void draw_shadow(uint32_t idx, const Command_buffer& command_buffer);
+	// A drawlist paired with its draw parameters
+	struct Drawlist_range_item
+	{
+		const Drawlist&              drawlist;
+		const Drawlist::Draw_params& params;
+	};
+
+	static constexpr size_t min_drawcalls_per_slice = 256;
+
+	// Records gbuffer, shadow, lighting and compute command buffers with `record_thread_pool`
+	void record_passes(uint32_t idx);
+
+	// Draws drawcalls in [first, first + count) of `drawlists` concatenated, `descriptor_set` is bound to set 0 of each layout
+	static void draw_drawlist_range(
+		const Command_buffer&                command_buffer,
+		vk::DescriptorSet                    descriptor_set,
+		std::span<const Drawlist_range_item> drawlists,
+		size_t                               first,
+		size_t                               count
+	);
+
+	// Indirect drawcalls of `gpu_culling` are also recorded if `draw_indirect` is true
+	void draw_gbuffer(uint32_t idx, const Command_buffer& command_buffer, size_t first, size_t count, bool draw_indirect);
+	void draw_shadow(
+		uint32_t              idx,
+		uint32_t              csm_idx,
+		const Command_buffer& command_buffer,
+		size_t                first,
+		size_t                count,
+		bool                  draw_indirect
+	);
+	void execute_gbuffer(uint32_t idx, const Command_buffer_set& set);
+	void execute_shadow(uint32_t idx, const Command_buffer_set& set);
 	void draw_lighting(uint32_t idx, const Command_buffer& command_buffer);
 
 	void compute_auto_exposure(uint32_t idx, const Command_buffer& command_buffer);
@@ -129,9 +229,9 @@ class App_render_logic : public Application_logic_base
 	void compute_process(uint32_t idx, const Command_buffer& command_buffer);
 
 	void draw_composite(uint32_t idx, const Command_buffer& command_buffer);
-	void draw_ui(uint32_t idx, const Command_buffer& command_buffer);
-	void execute_fxaa(uint32_t idx, const Command_buffer& command_buffer);
-	void draw_swapchain(uint32_t idx, const Command_buffer& command_buffer);
+	void draw_ui(uint32_t image_idx, const Command_buffer& command_buffer);
+	void execute_fxaa(uint32_t idx, uint32_t image_idx, const Command_buffer& command_buffer);
+	void draw_swapchain(uint32_t idx, uint32_t image_idx, const Command_buffer& command_buffer);
 
 	// Submit commands to queues
 	void submit_commands(const Command_buffer_set& set) const;
@@ -156,6 +256,8 @@ class App_render_logic : public Application_logic_base
 	float  animation_time = 0.0, animation_rate = 1.0;
 	double animation_start_time = 0.0;
 
+	std::vector<uint32_t> animation_cursors;  // keyframe hints of the animation samplers
+
 	void update_animation();  // Update animation
 	void upload_skin(uint32_t idx);
 
@@ -163,6 +265,23 @@ class App_render_logic : public Application_logic_base
 
 	std::string exported_preset_json;
 
+	// Seconds since start and of the last frame, from ImGui or advanced by the fixed timestep in headless mode
+	double frame_time  = 0.0;
+	float  frame_delta = 0.0;
+
+	/* Headless */
+
+	std::optional<Headless_config> headless_config;
+
+	bool                capture_frame = false;  // Final image of the current frame is copied to `capture_buffers`
+	std::vector<Buffer> capture_buffers;        // One for each offscreen image
+
+	// Renders the configured frames without UI and presentation, then writes captures and timings
+	std::shared_ptr<Application_logic_base> work_headless();
+
+	void record_capture(uint32_t image_idx, const Command_buffer& command_buffer) const;
+	void write_capture(uint32_t image_idx, const std::filesystem::path& path) const;
+
   public:
 
 	virtual ~App_render_logic() { core->env.device->waitIdle(); }
@@ -171,6 +290,8 @@ class App_render_logic : public Application_logic_base
 
 	App_render_logic(std::shared_ptr<Core> resource, const Scene_preset& preset);
 
+	App_render_logic(std::shared_ptr<Core> resource, const Scene_preset& preset, Headless_config config);
+
 	virtual std::shared_ptr<Application_logic_base> work();
 };
 
@@ -208,7 +329,7 @@ class App_load_model_logic : public Application_logic_base
 	std::jthread load_thread;
 
 	io::gltf::Load_stage       load_stage   = io::gltf::Load_stage::Uninitialized;
-	float                      sub_progress = 0.0;
+	std::atomic<float>         sub_progress = 0.0;
 
 	std::string                             load_err_msg;
 
@@ -244,15 +365,20 @@ class App_load_hdri_logic : public Application_logic_base
 
 	enum class Load_state
 	{
-		Start,
+		Decoding,
+		Generating,
 		Load_failed,
 		Load_success,
 		Quit
-	} load_state = Load_state::Start;
+	};
+
+	std::atomic<Load_state> load_state        = Load_state::Decoding;
+	std::atomic<float>      generate_progress = 0.0;
 
 	std::string load_fail_reason;
 
-	std::string load_path;
+	std::string  load_path;
+	std::jthread load_thread;
 
   public:
 
@@ -273,4 +399,23 @@ class App_load_hdri_logic : public Application_logic_base
 
 	void draw(uint32_t idx);
 	void ui_logic();
+	void load_thread_work();
+};
+
+// Loads the preset of the headless mode, then hands over to `App_render_logic`
+class App_headless_logic : public Application_logic_base
+{
+  private:
+
+	Headless_config config;
+
+  public:
+
+	App_headless_logic(std::shared_ptr<Core> resource, Headless_config config) :
+		Application_logic_base(std::move(resource)),
+		config(std::move(config))
+	{
+	}
+
+	virtual std::shared_ptr<Application_logic_base> work();
 };
@@ -3,6 +3,9 @@
 #include "pipeline.hpp"
 #include "render-params.hpp"
 
+// Computes world transforms of nodes in a scene.
+// The hierarchy is flattened once into parent-before-child order with local transformations stored as SoA, after which each
+// traversal is a linear pass that only recomputes subtrees of nodes marked dirty.
 class Node_traverser
 {
   public:
@@ -27,15 +30,39 @@ class Node_traverser
 		bool      traversed = false;
 	};
 
+	// Updates world transforms of dirty subtrees, flattening the hierarchy first if model or scene changed
 	void traverse(const Traverse_params& params);
 
+	// Marks local transformation of a node as changed, e.g. by animation or user edits
+	void mark_dirty(uint32_t node_idx);
+
+	// Marks local transformations of all nodes as changed, e.g. when overridden transformations are discarded
+	void mark_all_dirty();
+
+	// Whether world transform of a node was recomputed in the last traversal
+	bool changed(uint32_t node_idx) const { return node_changed[node_idx] != 0; }
+
 	auto operator[](uint32_t idx) const { return transform_list[idx]; }
 
   private:
 
+	const io::gltf::Model* model               = nullptr;
+	uint32_t               scene_idx           = -1;
+	glm::mat4              base_transformation = glm::mat4(1.0);
+
 	std::vector<Traverse_node> transform_list;
 
-	void traverse(const Traverse_params& params, uint32_t node_idx, const glm::mat4& transform);
+	// Flattened hierarchy, indexed by position in parent-before-child order
+	std::vector<uint32_t>  flat_nodes;    // Node index
+	std::vector<uint32_t>  flat_parents;  // Node index of parent, -1 for root nodes of the scene
+	std::vector<glm::vec3> translations, scales;
+	std::vector<glm::quat> rotations;
+
+	// Indexed by node
+	std::vector<uint8_t> node_dirty, node_changed;
+	bool                 any_dirty = false, any_changed = false;
+
+	void flatten(const Traverse_params& params);
 };
 
 struct Drawcall
@@ -64,6 +91,13 @@ struct Drawlist
 
 	void emplace(const Drawcall& drawcall, io::gltf::Alpha_mode mode);
 
+	void append(const Drawlist& other)
+	{
+		opaque.insert(opaque.end(), other.opaque.begin(), other.opaque.end());
+		mask.insert(mask.end(), other.mask.begin(), other.mask.end());
+		blend.insert(blend.end(), other.blend.begin(), other.blend.end());
+	}
+
 	void sort()
 	{
 		std::sort(opaque.begin(), opaque.end());
@@ -74,16 +108,109 @@ struct Drawlist
 	struct Draw_params
 	{
 		Command_buffer                       command_buffer;
+		const io::gltf::Model*               model;
 		Model_pipeline_set                   pipeline_set;
 		Pipeline_layout                      pipeline_layout;
 		std::function<void(const Drawcall&)> bind_material_func;
 		std::function<void(const Drawcall&)> bind_vertex_func_opaque;
 		std::function<void(const Drawcall&)> bind_vertex_func_mask;
 		std::function<void(const Drawcall&)> bind_vertex_func_blend;
-		std::function<void(const Drawcall&)> bind_node_func = nullptr;
+		std::function<void(const Drawcall&)> bind_node_func  = nullptr;
+		bool                                 vertex_per_node = false;  // Vertex buffers differ between nodes, e.g. pre-skinned vertices
 	};
 
-	void draw(const Draw_params& params) const;
+	void draw(const Draw_params& params) const { draw(params, 0, size()); }
+
+	// Draws drawcalls in [first, first + count), ordered as opaque, mask and then blend
+	void draw(const Draw_params& params, size_t first, size_t count) const;
+};
+
+// World-space bounds of all visible primitives, organized in a bounding volume hierarchy (BVH).
+// The hierarchy is built when the set of visible primitives changes, otherwise only primitives of moved nodes are recomputed
+// and the hierarchy is refitted.
+class Scene_bounds
+{
+  public:
+
+	struct Build_params
+	{
+		const io::gltf::Model* model          = nullptr;
+		const Node_traverser*  node_traverser = nullptr;
+
+		utility::Thread_pool* thread_pool = nullptr;  // Work is split across the pool if not NULL
+
+		void verify() const;
+	};
+
+	// Primitive with its transformed corner points
+	struct Item
+	{
+		uint32_t                   node_idx;
+		const io::gltf::Primitive* primitive;
+		std::array<glm::vec3, 8>   edge_points;
+	};
+
+	struct Bvh_node
+	{
+		glm::vec3 min{std::numeric_limits<float>::max()}, max{-std::numeric_limits<float>::max()};
+
+		uint32_t parent = -1;
+		uint32_t left = 0, right = 0;             // Children of inner nodes
+		uint32_t first_item = 0, item_count = 0;  // Item range of leaves
+
+		bool is_leaf() const { return item_count > 0; }
+	};
+
+	void build(const Build_params& params);
+
+	const io::gltf::Model& get_model() const { return *model; }
+	const Node_traverser&  get_traverser() const { return *traverser; }
+
+	// Items, sorted by the order of BVH leaves
+	const std::vector<Item>&                        get_items() const { return items; }
+	const algorithm::geometry::frustum::AABB_batch& get_bounding_boxes() const { return bounding_boxes; }
+
+	const std::vector<Bvh_node>& get_bvh_nodes() const { return bvh_nodes; }
+
+	// World space bounds of items
+	const std::vector<glm::vec3>& get_item_min() const { return item_min; }
+	const std::vector<glm::vec3>& get_item_max() const { return item_max; }
+
+	// Incremented every time items are rebuilt or reordered
+	uint64_t get_revision() const { return revision; }
+
+	// Roots of disjoint subtrees covering the whole BVH in item order, used as tasks for parallel culling
+	const std::vector<uint32_t>& get_task_roots() const { return task_roots; }
+
+  private:
+
+	static constexpr size_t max_leaf_items = 8, min_items_per_task = 1024;
+
+	const io::gltf::Model* model     = nullptr;
+	const Node_traverser*  traverser = nullptr;
+
+	// Items in leaf order
+	std::vector<Item>                        items;
+	std::vector<glm::vec3>                   item_min, item_max;
+	std::vector<uint32_t>                    item_leaf;
+	algorithm::geometry::frustum::AABB_batch bounding_boxes;
+
+	std::vector<Bvh_node> bvh_nodes;
+	std::vector<uint8_t>  bvh_dirty;
+	std::vector<uint32_t> task_roots;
+	uint64_t              revision = 0;
+
+	// Visible primitives in node order, compared every frame to detect changes
+	std::vector<std::pair<uint32_t, const io::gltf::Primitive*>> item_keys, visible_keys;
+
+	// Nodes whose items need updating, either moved in the last traversal or skinned
+	std::vector<uint8_t> node_dirty;
+
+	void     update_item(size_t item_idx);
+	void     update_items(utility::Thread_pool* thread_pool, bool all);
+	void     build_hierarchy(size_t task_count);
+	uint32_t build_node(std::vector<uint32_t>& order, uint32_t first, uint32_t count, uint32_t parent);
+	void     refit();
 };
 
 class Drawcall_generator
@@ -92,13 +219,18 @@ class Drawcall_generator
 
 	struct Gen_params
 	{
-		const io::gltf::Model*       model          = nullptr;
-		const Node_traverser*        node_traverser = nullptr;
+		const Scene_bounds* scene_bounds = nullptr;
 
 		algorithm::geometry::frustum::Frustum frustum;
 		glm::vec3                             eye_position;
 		glm::vec3                             eye_path;
 
+		utility::Thread_pool* thread_pool = nullptr;  // Subtrees are culled in parallel if not NULL
+
+		// Only skinned primitives are emitted, the rest is culled by `Gpu_culling`.
+		// Near and far planes are still calculated from all primitives
+		bool skinned_only = false;
+
 		void set_by_camera_parameter(const Camera_parameter& param)
 		{
 			frustum      = param.frustum;
@@ -139,9 +271,118 @@ class Drawcall_generator
 	const Drawlist& get_single_sided_skin_drawlist() const { return single_sided_skin; }
 	const Drawlist& get_double_sided_skin_drawlist() const { return double_sided_skin; }
 
+	size_t drawcall_count() const
+	{
+		return single_sided.size() + double_sided.size() + single_sided_skin.size() + double_sided_skin.size();
+	}
+
 	Gen_result generate(const Gen_params& params);
 
+	// > Culls the same scene bounds against the frustum of every `params` in one pass, results are written to `generators[i]`
+	// All `params` should share the same `scene_bounds` and `thread_pool`
+	static std::vector<Gen_result> generate(std::span<Drawcall_generator> generators, std::span<const Gen_params> params);
+
   private:
 
 	Drawlist single_sided, double_sided, single_sided_skin, double_sided_skin;
-};
\ No newline at end of file
+
+	// Drawcalls generated from a subtree of `Scene_bounds`
+	struct Task_output
+	{
+		Drawlist   single_sided, double_sided, single_sided_skin, double_sided_skin;
+		Gen_result result;
+
+		std::vector<std::pair<uint32_t, uint32_t>> item_ranges;  // [begin, end) of items in leaves passing side planes
+		std::vector<uint32_t>                      node_stack;
+		std::vector<uint8_t>                       side_mask, depth_mask;
+
+		void cull(const Gen_params& params, uint32_t root);
+	};
+
+	std::vector<Task_output> task_outputs;
+
+	Gen_result merge();
+};
+
+// Culls static (non-skinned) primitives on GPU. World space bounds and model matrices are uploaded to storage buffers every frame,
+// a compute pass then tests them against the camera and all shadow cascades, writing indexed indirect drawcalls.
+// Each primitive is drawn with a single `vkCmdDrawIndexedIndirect` over all of its instances.
+class Gpu_culling
+{
+  public:
+
+	static constexpr uint32_t view_count = Culling_pipeline::view_count;
+
+	// Consecutive commands sharing the same primitive
+	struct Batch
+	{
+		const io::gltf::Primitive* primitive;
+		uint32_t                   first_command, command_count;
+	};
+
+	struct Batch_list
+	{
+		std::vector<Batch> opaque, mask, blend;
+
+		void clear()
+		{
+			opaque.clear();
+			mask.clear();
+			blend.clear();
+		}
+	};
+
+	// Uploads bounds, model matrices and view frusta of `frame_idx`. `frusta[0]` is the camera, followed by the shadow cascades
+	void update(
+		const Environment&                                                 env,
+		const Pipeline_set&                                                pipeline_set,
+		const Scene_bounds&                                                scene_bounds,
+		std::span<const algorithm::geometry::frustum::Frustum, view_count> frusta,
+		uint32_t                                                           frame_idx
+	);
+
+	// Records the culling dispatch, must be outside of a render pass
+	void cull(const Command_buffer& command_buffer, const Culling_pipeline& pipeline, uint32_t frame_idx) const;
+
+	// Draws the culled commands of `view`. `bind_node_func` of the params is ignored,
+	// and `pipeline_layout` should have the indirect model matrix set at set = 2
+	void draw(
+		const Drawlist::Draw_params& single_sided_params,
+		const Drawlist::Draw_params& double_sided_params,
+		vk::DescriptorSet            model_matrix_set,
+		uint32_t                     view,
+		uint32_t                     frame_idx
+	) const;
+
+	// Model matrix descriptor set for gbuffer and shadow pipelines
+	vk::DescriptorSet get_gbuffer_set(uint32_t frame_idx) const { return frame_data[frame_idx].gbuffer_set; }
+	vk::DescriptorSet get_shadow_set(uint32_t frame_idx) const { return frame_data[frame_idx].shadow_set; }
+
+	size_t item_count() const { return item_indices.size(); }
+
+  private:
+
+	struct Frame_data
+	{
+		Descriptor_pool descriptor_pool;
+		Descriptor_set  cull_set, gbuffer_set, shadow_set;
+
+		Buffer item_buffer;     // `Culling_pipeline::Cull_item` of each item, CPU to GPU
+		Buffer matrix_buffer;   // Model matrix of each item, CPU to GPU
+		Buffer view_buffer;     // `Culling_pipeline::View_uniform`, CPU to GPU
+		Buffer command_buffer;  // `view_count * capacity` indirect drawcalls, GPU only
+
+		uint32_t capacity = 0;
+	};
+
+	std::array<Frame_data, frames_in_flight> frame_data;
+
+	const io::gltf::Model* model          = nullptr;
+	uint64_t               scene_revision = -1;
+
+	std::vector<uint32_t> item_indices;  // Index into `Scene_bounds::get_items()` of each command
+	Batch_list            single_sided, double_sided;
+
+	void build_batches(const Scene_bounds& scene_bounds);
+	void allocate(const Environment& env, const Pipeline_set& pipeline_set, Frame_data& frame, uint32_t capacity) const;
+};
@@ -27,10 +27,10 @@ struct Shadow_pipeline
 
 	Descriptor_set_layout descriptor_set_layout_shadow_matrix,  // @vert, set = 0, shadow matrix
 		descriptor_set_layout_texture,                          // @frag, set = 1, textures
-		descriptor_set_layout_skin;                             // @vert, set = 2, skin matrices
+		descriptor_set_layout_indirect;                         // @vert, set = 2, model matrices of indirect drawcalls
 
-	Pipeline_layout    pipeline_layout, pipeline_layout_skin;
-	Model_pipeline_set single_side, double_side, single_side_skin, double_side_skin;
+	Pipeline_layout    pipeline_layout, pipeline_layout_indirect;
+	Model_pipeline_set single_side, double_side, single_side_indirect, double_side_indirect;
 	Render_pass       render_pass;
 
 	static vk::ClearValue clear_value;
@@ -44,9 +44,34 @@ struct Shadow_pipeline
 
 struct Gbuffer_pipeline
 {
-	static constexpr vk::Format normal_format = vk::Format::eR16G16B16A16Sfloat, color_format = vk::Format::eR8G8B8A8Unorm,
-								pbr_format = vk::Format::eR8G8B8A8Unorm, emissive_format = vk::Format::eR8G8B8A8Unorm,
-								depth_format = vk::Format::eD24UnormS8Uint;
+	struct Formats
+	{
+		vk::Format normal, color, pbr, emissive;
+	};
+
+	// Normal: (xyz, emissive strength); Color: (rgb, -); PBR: (occlusion, roughness, metalness, -); Emissive: (gamma rgb, -)
+	static constexpr Formats wide_formats = {
+		.normal   = vk::Format::eR16G16B16A16Sfloat,
+		.color    = vk::Format::eR8G8B8A8Unorm,
+		.pbr      = vk::Format::eR8G8B8A8Unorm,
+		.emissive = vk::Format::eR8G8B8A8Unorm
+	};
+
+	// > 14 instead of 20 bytes per pixel, used when `Environment::features.compact_gbuffer_enabled`.
+	// Normal: octahedral (xy); Color: (rgb, occlusion); PBR: (roughness, metalness); Emissive: linear rgb premultiplied by strength
+	static constexpr Formats compact_formats = {
+		.normal   = vk::Format::eR16G16Snorm,
+		.color    = vk::Format::eR8G8B8A8Unorm,
+		.pbr      = vk::Format::eR8G8Unorm,
+		.emissive = vk::Format::eB10G11R11UfloatPack32
+	};
+
+	static constexpr vk::Format depth_format = vk::Format::eD24UnormS8Uint;
+
+	static const Formats& formats(const Environment& env)
+	{
+		return env.features.compact_gbuffer_enabled ? compact_formats : wide_formats;
+	}
 
 	// At Gbuffer Vert, set = 0
 	struct Camera_uniform
@@ -59,10 +84,10 @@ struct Gbuffer_pipeline
 
 	Descriptor_set_layout descriptor_set_layout_texture,  // @frag, set = 1, textures
 		descriptor_set_layout_camera,                     // @vert, set = 0, camera matrix
-		descriptor_set_layout_skin;                       // @vert, set = 2, skin matrices
+		descriptor_set_layout_indirect;                   // @vert, set = 2, model matrices of indirect drawcalls
 
-	Pipeline_layout    pipeline_layout, pipeline_layout_skin;
-	Model_pipeline_set single_side, double_side, single_side_skin, double_side_skin;
+	Pipeline_layout    pipeline_layout, pipeline_layout_indirect;
+	Model_pipeline_set single_side, double_side, single_side_indirect, double_side_indirect;
 	Render_pass       render_pass;
 
 	static std::array<vk::ClearValue, 5> clear_values;
@@ -75,6 +100,71 @@ struct Gbuffer_pipeline
 	void create(const Environment& env);
 };
 
+// Culls bounding boxes against the camera and all shadow cascades, generating indexed indirect drawcalls
+struct Culling_pipeline
+{
+	static constexpr uint32_t view_count     = csm_count + 1;  // Camera, followed by shadow cascades
+	static constexpr uint32_t workgroup_size = 64;
+
+	// At Cull Comp, set = 0, binding = 0, storage buffer
+	struct Cull_item
+	{
+		glm::vec4 min, max;  // World space bounding box
+		uint32_t  first_index, index_count;
+		uint32_t  padding[2];
+	};
+
+	// At Cull Comp, set = 0, binding = 1, uniform buffer
+	struct View_uniform
+	{
+		std::array<glm::vec4, view_count * 6> planes;  // (normal, -dot(normal, position)), as near, far, left, right, top, bottom
+	};
+
+	// At Cull Comp, push_constant
+	struct Params
+	{
+		uint32_t item_count;
+		uint32_t capacity;  // Stride of commands between views
+	};
+
+	Descriptor_set_layout descriptor_set_layout;
+	Pipeline_layout       pipeline_layout;
+	Compute_pipeline      pipeline;
+
+	inline static auto descriptor_pool_size = std::to_array<vk::DescriptorPoolSize>({
+		{vk::DescriptorType::eStorageBuffer, 2},
+		{vk::DescriptorType::eUniformBuffer, 1}
+	});
+
+	void create(const Environment& env);
+};
+
+// Blends skinned vertices with joint matrices, writing world-space positions, normals and tangents
+struct Skinning_pipeline
+{
+	static constexpr uint32_t workgroup_size = 64;
+
+	// At Skin Comp, push_constant. Offsets are counted in vertices
+	struct Params
+	{
+		uint32_t vertex_count;
+		uint32_t position_offset, normal_offset, tangent_offset, joint_offset, weight_offset;
+		uint32_t joint_matrix_offset;
+		uint32_t output_offset;
+		uint32_t output_stride;  // Vertex count of each attribute region in the output buffer
+	};
+
+	Descriptor_set_layout descriptor_set_layout;
+	Pipeline_layout       pipeline_layout;
+	Compute_pipeline      pipeline;
+
+	inline static auto descriptor_pool_size = std::to_array<vk::DescriptorPoolSize>({
+		{vk::DescriptorType::eStorageBuffer, 7}
+	});
+
+	void create(const Environment& env);
+};
+
 struct Lighting_pipeline
 {
 	static constexpr vk::Format luminance_format = vk::Format::eR16G16B16A16Sfloat;
@@ -279,6 +369,8 @@ struct Pipeline_set
 {
 	Shadow_pipeline                shadow_pipeline;
 	Gbuffer_pipeline               gbuffer_pipeline;
+	Culling_pipeline               culling_pipeline;
+	Skinning_pipeline              skinning_pipeline;
 	Lighting_pipeline              lighting_pipeline;
 	Auto_exposure_compute_pipeline auto_exposure_pipeline;
 	Bloom_pipeline                 bloom_pipeline;
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "environment.hpp"
+#include <filesystem>
+
+// Measures GPU time of render stages with timestamp queries.
+// Queries of a frame slot are read back when the slot comes around again, `frames_in_flight` frames later,
+// after its fence has been waited, so collecting never stalls the CPU.
+class Gpu_profiler
+{
+  public:
+
+	// Shadow cascades take `csm_count` consecutive stages starting from `Shadow`
+	enum class Stage : uint32_t
+	{
+		Gbuffer,
+		Shadow,
+		Lighting = Shadow + csm_count,
+		Auto_exposure,
+		Bloom,
+		Composite,
+		Fxaa,
+		Ui
+	};
+
+	static constexpr uint32_t stage_count  = (uint32_t)Stage::Ui + 1;
+	static constexpr uint32_t history_size = 512;  // Frames kept for the rolling statistics
+
+	static Stage       shadow_stage(uint32_t csm_idx) { return Stage((uint32_t)Stage::Shadow + csm_idx); }
+	static std::string stage_name(Stage stage);
+
+	// Durations in milliseconds over the recorded history
+	struct Statistics
+	{
+		float average = 0, p95 = 0, p99 = 0, max = 0;
+	};
+
+	Gpu_profiler() = default;
+	Gpu_profiler(const Environment& env);
+
+	// Timestamps are only written when all graphics and compute queues support them
+	bool supported() const { return query_pool.is_valid(); }
+
+	// Reads back the timestamps previously recorded in `frame_idx`, call after waiting for the fence of the frame slot
+	void collect(uint32_t frame_idx);
+
+	// Resets queries of `frame_idx`, must be recorded into the command buffer executed first in the frame
+	void reset(const Command_buffer& command_buffer, uint32_t frame_idx);
+
+	void begin(const Command_buffer& command_buffer, uint32_t frame_idx, Stage stage) const;
+	void end(const Command_buffer& command_buffer, uint32_t frame_idx, Stage stage) const;
+
+	Statistics statistics(Stage stage) const;
+	uint32_t   sample_count() const { return history_count; }
+
+	// Writes statistics of all stages as CSV, throws `error::IO_error` on failure
+	void export_csv(const std::filesystem::path& path) const;
+
+  private:
+
+	static constexpr uint32_t queries_per_frame = stage_count * 2;
+
+	Query_pool query_pool;
+	float      timestamp_period = 1;  // Nanoseconds per tick
+	uint64_t   timestamp_mask   = ~0ull;
+
+	std::array<bool, frames_in_flight> pending{};
+
+	std::array<std::array<float, history_size>, stage_count> history{};
+	uint32_t                                                 history_count = 0, history_cursor = 0;
+};
@@ -33,24 +33,61 @@ struct Render_source
 
 	/* Skin */
 
-	std::vector<std::vector<glm::mat4>> skin_matrix_cpu;
-	Buffer                              skin_matrix_data_staging;  // Staging buffer pre-allocated for immediate use
-	Buffer                              skin_matrix_data_gpu;      // Storage buffer at GPU side
+	// A skinned primitive under a node, pre-skinned once per frame into `Skin_frame_data::skinned_vertices`
+	struct Skinned_primitive
+	{
+		uint32_t                   node_idx;
+		const io::gltf::Primitive* primitive;
+		uint32_t                   output_offset;  // First vertex in each attribute region of the output
+	};
 
-	struct Skin_descriptor
+	// Skin resources of a single frame in flight
+	struct Skin_frame_data
 	{
-		Descriptor_set gbuffer_set, shadow_set;
+		Buffer                      staging;           // Staging buffer pre-allocated for immediate use
+		Buffer                      gpu;               // Storage buffer at GPU side
+		Buffer                      skinned_vertices;  // World-space positions, normals and tangents, as 3 regions
+		std::vector<Descriptor_set> skinning_sets;     // Skinning descriptors for each skinned primitive
 	};
 
-	Descriptor_pool              skin_descriptor_pool;
-	std::vector<Skin_descriptor> skin_descriptors;  // Skin descriptors for each skin
-	uint32_t                     skin_matrix_count;
+	std::vector<std::vector<glm::mat4>>           skin_matrix_cpu;
+	std::array<Skin_frame_data, frames_in_flight> skin_frame_data;
+
+	std::vector<Skinned_primitive> skinned_primitives;
+	std::vector<uint32_t>          skin_matrix_offsets;  // First joint matrix of each skin
+
+	// (node, position buffer, position offset) -> index in `skinned_primitives`
+	std::map<std::tuple<uint32_t, uint32_t, uint32_t>, uint32_t> skinned_primitive_lut;
+
+	Descriptor_pool skin_descriptor_pool;
+	uint32_t        skin_matrix_count;
+	uint32_t        skinned_vertex_count;
 
 	void generate_material_data(const Environment& env, const Pipeline_set& pipeline);
 
 	void generate_skin_data(const Environment& env, const Pipeline_set& pipeline);
 
-	void stream_skin_data(const Environment& env, const Command_buffer& command_buffer);
+	void stream_skin_data(const Environment& env, const Command_buffer& command_buffer, uint32_t frame_idx);
+
+	// Records skinning of all skinned primitives, must be executed after skin matrices are streamed
+	void record_skinning(const Command_buffer& command_buffer, const Pipeline_set& pipeline, uint32_t frame_idx) const;
+
+	// Vertex input layouts of the pipelines drawing pre-skinned vertices
+	enum class Skinned_vertex_input
+	{
+		Gbuffer,       // position, normal, texcoord, tangent
+		Shadow,        // position, texcoord
+		Shadow_opaque  // position
+	};
+
+	// Binds pre-skinned vertex buffers of a skinned primitive under `node_idx`
+	void bind_skinned_vertices(
+		const Command_buffer&      command_buffer,
+		uint32_t                   node_idx,
+		const io::gltf::Primitive& primitive,
+		uint32_t                   frame_idx,
+		Skinned_vertex_input       input
+	) const;
 };
 
 struct Camera_parameter
@@ -126,6 +163,10 @@ struct Render_params
 	float bloom_start = 2.0, bloom_end = 15.0, bloom_intensity = 0.02, bloom_attenuation = 2.0;
 	float adapt_speed = 1;
 
+	/*====== Culling ======*/
+
+	bool gpu_culling = false;  // Cull static primitives with compute shader and draw them indirectly
+
 	/*====== Shadow ======*/
 
 	std::array<float, 3> shadow_near, shadow_far;
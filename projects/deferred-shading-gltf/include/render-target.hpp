@@ -83,8 +83,18 @@ using Write_descriptor_buffer = Write_descriptor_template<Count, Type, vk::Descr
 template <size_t Count = 1, vk::DescriptorType Type = vk::DescriptorType::eCombinedImageSampler>
 using Write_descriptor_image = Write_descriptor_template<Count, Type, vk::DescriptorImageInfo>;
 
+// Passes of a frame in the render graph, in submission order
+struct Frame_passes
+{
+	Render_graph::Handle gbuffer, shadow, lighting, compute, composite, fxaa;
+
+	void declare(const Environment& env, Render_graph& graph);
+};
+
 struct Shadow_rt
 {
+	std::array<Render_graph::Handle, csm_count> shadow_image_handles;
+
 	std::array<Image, csm_count>       shadow_images;       // cascaded shadow maps
 	std::array<Image_view, csm_count>  shadow_image_views;  // corresponding image views
 	std::array<Framebuffer, csm_count> shadow_framebuffers;
@@ -92,8 +102,11 @@ struct Shadow_rt
 	std::array<Buffer, csm_count>         shadow_matrix_uniform;  // @vert, set = 0, binding = 0
 	std::array<Descriptor_set, csm_count> shadow_matrix_descriptor_set;
 
+	void declare(Render_graph& graph, const Frame_passes& passes, const std::array<uint32_t, csm_count>& shadow_map_size);
+
 	void create(
 		const Environment&                     env,
+		const Render_graph&                    graph,
 		const Render_pass&                     render_pass,
 		const Descriptor_pool&                 pool,
 		const Descriptor_set_layout&           layout,
@@ -106,6 +119,8 @@ struct Shadow_rt
 
 struct Gbuffer_rt
 {
+	Render_graph::Handle normal_handle, albedo_handle, pbr_handle, emissive_handle, depth_handle;
+
 	Image       normal, albedo, pbr, emissive, depth;
 	Image_view  normal_view, albedo_view, pbr_view, emissive_view, depth_view;
 	Framebuffer framebuffer;
@@ -113,13 +128,23 @@ struct Gbuffer_rt
 	Buffer         camera_uniform_buffer;  // @vert, set = 0, binding = 0
 	Descriptor_set camera_uniform_descriptor_set;
 
-	void create(const Environment& env, const Render_pass& render_pass, const Descriptor_pool& pool, const Descriptor_set_layout& layout);
+	void declare(const Environment& env, Render_graph& graph, const Frame_passes& passes);
+
+	void create(
+		const Environment&           env,
+		const Render_graph&          graph,
+		const Render_pass&           render_pass,
+		const Descriptor_pool&       pool,
+		const Descriptor_set_layout& layout
+	);
 
 	Write_descriptor_buffer<> update_uniform(const Gbuffer_pipeline::Camera_uniform& data);
 };
 
 struct Lighting_rt
 {
+	Render_graph::Handle luminance_handle, brightness_handle;
+
 	Image       luminance, brightness;
 	Image_view  luminance_view, brightness_view;
 	Framebuffer framebuffer;
@@ -129,7 +154,15 @@ struct Lighting_rt
 	Buffer         transmat_buffer;  // @frag, set = 0, binding = 6
 	Descriptor_set input_descriptor_set;
 
-	void create(const Environment& env, const Render_pass& render_pass, const Descriptor_pool& pool, const Descriptor_set_layout& layout);
+	void declare(const Environment& env, Render_graph& graph, const Frame_passes& passes);
+
+	void create(
+		const Environment&           env,
+		const Render_graph&          graph,
+		const Render_pass&           render_pass,
+		const Descriptor_pool&       pool,
+		const Descriptor_set_layout& layout
+	);
 
 	std::array<Write_descriptor_image<>, 5> link_gbuffer(const Gbuffer_rt& gbuffer);
 	Write_descriptor_image<csm_count>       link_shadow(const Shadow_rt& shadow);
@@ -156,6 +189,8 @@ struct Auto_exposure_compute_rt
 
 struct Bloom_rt
 {
+	Render_graph::Handle bloom_downsample_chain_handle, bloom_upsample_chain_handle;
+
 	Image bloom_downsample_chain, bloom_upsample_chain;
 
 	std::array<Image_view, bloom_downsample_count>     downsample_chain_view;
@@ -169,7 +204,9 @@ struct Bloom_rt
 
 	std::vector<Descriptor_set> bloom_blur_descriptor_sets, bloom_acc_descriptor_sets;
 
-	void create(const Environment& env, const Descriptor_pool& pool, const Bloom_pipeline& pipeline);
+	void declare(const Environment& env, Render_graph& graph, const Frame_passes& passes);
+
+	void create(const Environment& env, const Render_graph& graph, const Descriptor_pool& pool, const Bloom_pipeline& pipeline);
 
 	std::tuple<std::array<Write_descriptor_image<1, vk::DescriptorType::eStorageImage>, 2>, Write_descriptor_buffer<>>
 	link_bloom_filter(const Lighting_rt& lighting, const Auto_exposure_compute_rt& exposure);
@@ -192,6 +229,8 @@ struct Bloom_rt
 
 struct Composite_rt
 {
+	Render_graph::Handle composite_output_handle;
+
 	Image       composite_output;
 	Image_view  image_view;
 	Framebuffer framebuffer;
@@ -201,8 +240,11 @@ struct Composite_rt
 	Buffer         params_buffer;  // @frag, set = 0, binding = 1
 	Descriptor_set descriptor_set;
 
+	void declare(const Environment& env, Render_graph& graph, const Frame_passes& passes);
+
 	void create(
 		const Environment&           env,
+		const Render_graph&          graph,
 		const Render_pass&           render_pass,
 		const Descriptor_pool&       pool,
 		const Descriptor_set_layout& layout
@@ -216,26 +258,26 @@ struct Composite_rt
 
 struct Fxaa_rt
 {
-	Image_view  image_view;
-	Framebuffer framebuffer;
-
 	Image_sampler input_sampler;
 
 	Buffer         params_buffer;
 	Descriptor_set descriptor_set;
 
-	void create(
-		const Environment&           env,
-		const Render_pass&           render_pass,
-		const Descriptor_pool&       pool,
-		const Descriptor_set_layout& layout,
-		uint32_t                     idx
-	);
+	void create(const Environment& env, const Descriptor_pool& pool, const Descriptor_set_layout& layout);
 
 	Write_descriptor_image<>  link_composite(const Composite_rt& composite);
 	Write_descriptor_buffer<> update_uniform(const Fxaa_pipeline::Params& param);
 };
 
+// Output of FXAA, the only target kept per swapchain image
+struct Present_rt
+{
+	Image_view  image_view;  // owned by the swapchain
+	Framebuffer framebuffer;
+
+	void create(const Environment& env, const Render_pass& render_pass, uint32_t idx);
+};
+
 inline static std::array<uint32_t, 3> shadow_map_res{
 	{2048, 2048, 1536}
 };
@@ -278,6 +320,10 @@ struct Render_target_set
 {
 	Descriptor_pool shared_pool;
 
+	// Owns the transient images of the set and derives barriers between passes
+	Render_graph graph;
+	Frame_passes passes;
+
 	Shadow_rt    shadow_rt;
 	Gbuffer_rt   gbuffer_rt;
 	Lighting_rt  lighting_rt;
@@ -285,7 +331,7 @@ struct Render_target_set
 	Composite_rt composite_rt;
 	Fxaa_rt      fxaa_rt;
 
-	void create(const Environment& env, const Pipeline_set& pipeline, uint32_t idx);
+	void create(const Environment& env, const Pipeline_set& pipeline);
 	void link(const Environment& env, const Auto_exposure_compute_rt& auto_exposure_rt);
 
 	void update(
@@ -302,17 +348,37 @@ struct Render_targets
 	Descriptor_pool          shared_pool;
 	Auto_exposure_compute_rt auto_exposure_rt;
 
-	std::vector<Render_target_set> render_target_set;
+	// Attachments are only in use by frames in flight, so one set per frame slot is enough regardless of the swapchain length
+	std::array<Render_target_set, frames_in_flight> render_target_set;
+	std::vector<Present_rt>                         present_rt;  // Per swapchain image
 
-	Semaphore acquire_semaphore, render_done_semaphore;
-	Fence     next_frame_fence;
+	struct Frame_sync
+	{
+		Semaphore acquire_semaphore, render_done_semaphore;
+		Fence     next_frame_fence;
+	};
+
+	std::array<Frame_sync, frames_in_flight> frame_sync;
+	std::vector<vk::Fence>                   image_fences;  // Fence of the last frame rendering to each swapchain image
+	uint32_t                                 frame_idx = 0;
 
 	Render_target_set&       operator[](size_t idx) { return render_target_set[idx]; }
 	const Render_target_set& operator[](size_t idx) const { return render_target_set[idx]; }
 
+	const Frame_sync& current_frame() const { return frame_sync[frame_idx]; }
+
 	void create(const Environment& env, const Pipeline_set& pipeline);
 
 	void create_sync_objects(const Environment& env);
 
+	// Wait until the current frame slot is no longer used by GPU
+	void wait_frame(const Environment& env) const;
+
+	// Wait until the resources tied to `image_idx` (e.g. per-image command buffers of loading screens) are released,
+	// then reset the fence of the current frame
+	void acquire_image(const Environment& env, uint32_t image_idx);
+
+	void next_frame() { frame_idx = (frame_idx + 1) % frames_in_flight; }
+
 	void link(const Environment& env);
 };
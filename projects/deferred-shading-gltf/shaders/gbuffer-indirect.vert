@@ -0,0 +1,36 @@
+#version 450
+
+layout(location = 0) out vec3 out_normal;
+layout(location = 1) out vec2 out_uv;
+layout(location = 2) out vec3 out_tangent;
+
+layout(location = 0) in vec3 in_position;
+layout(location = 1) in vec3 in_normal;
+layout(location = 2) in vec2 in_uv;
+layout(location = 3) in vec3 in_tangent;
+
+layout(set = 0, binding = 0) uniform Camera_uniform
+{
+	mat4 view_projection_matrix;
+} camera_uniform;
+
+// Model matrices of GPU culled items, indexed by first instance of the indirect drawcall
+layout(set = 2, binding = 0) readonly buffer Model_matrices
+{
+	mat4 data[];
+} model_matrices;
+
+void main()
+{
+	mat4 matrix = model_matrices.data[gl_InstanceIndex];
+
+	vec4 model_pos = matrix * vec4(in_position, 1.0); // world space position
+	gl_Position = camera_uniform.view_projection_matrix * model_pos; // clip space position
+	
+	vec4 trans_normal = matrix * vec4(in_normal, 0.0); // world space normal
+	out_normal = normalize(trans_normal.xyz);
+	vec4 trans_tangent = matrix * vec4(in_tangent, 0.0);
+	out_tangent = normalize(trans_tangent.xyz);
+
+	out_uv = in_uv; // uv coordinate
+}
@@ -1,4 +1,5 @@
 #version 450
+#extension GL_GOOGLE_include_directive : enable
 
 layout(location = 0) out vec4 out_normal;
 layout(location = 1) out vec4 out_color;
@@ -11,6 +12,7 @@ layout(location = 2) in vec3 in_tangent;
 
 layout(constant_id = 0) const bool alpha_cutoff_enabled = false;
 layout(constant_id = 1) const bool alpha_blend_enabled = false;
+layout(constant_id = 2) const bool compact_gbuffer = false;
 
 layout(set = 1, binding = 0) uniform sampler2D albedo_texture;
 layout(set = 1, binding = 1) uniform sampler2D metalness_roughness_texture;
@@ -28,6 +30,8 @@ layout(set = 1, binding = 5) uniform Mat_params
 	float emissive_strength;
 } mat_params;
 
+#include "octahedral.glsl"
+
 const int bayer[64] = int[64](1, 49, 13, 61, 4, 52, 16, 64, 33, 17, 45, 29, 36, 20, 48, 32, 9, 57, 5, 53, 12, 60, 8, 56, 41, 25, 37, 21, 44, 28, 40, 24, 3, 51, 15, 63, 2, 50, 14, 62, 35, 19, 47, 31, 34, 18, 46, 30, 11, 59, 7, 55, 10, 58, 6, 54, 43, 27, 39, 23, 42, 26, 38, 22);
 
 void main()
@@ -52,7 +56,9 @@ void main()
 	vec3 tangent	 = normalize(cross(in_normal, bitangent));
 	vec3 normal		 = normalize(in_normal);
 
-	vec3 sampled_normal_offset = normalize(texture(normal_texture, in_uv).xyz * 2.0 - 1.0);
+	// Z is reconstructed, as two-channel (BC5) normal maps only store XY
+	vec2 sampled_normal_xy = texture(normal_texture, in_uv).xy * 2.0 - 1.0;
+	vec3 sampled_normal_offset = vec3(sampled_normal_xy, sqrt(max(0.0, 1.0 - dot(sampled_normal_xy, sampled_normal_xy))));
 	sampled_normal_offset.xy *= mat_params.normal_scale;
 	mat3 TBN = mat3(tangent, bitangent, normal);
 	vec3 mapped_normal = TBN * sampled_normal_offset;
@@ -62,8 +68,21 @@ void main()
 
 	if(!gl_FrontFacing) mapped_normal = -mapped_normal;
 
-	out_emissive = vec4(texture(emissive_texture, in_uv).rgb * mat_params.emissive_multiplier, 1.0);
-	out_normal	 = vec4(mapped_normal, mat_params.emissive_strength);
-	out_color	 = vec4(color_transformed, 0.0);
-	out_pbr		 = vec4(occlusion, roughness_metalness, 0.0);
+	vec3 emissive = texture(emissive_texture, in_uv).rgb * mat_params.emissive_multiplier;
+
+	// See `Gbuffer_pipeline::compact_formats` and `Gbuffer_pipeline::wide_formats`
+	if(compact_gbuffer)
+	{
+		out_normal	 = vec4(octahedral_encode(mapped_normal), 0.0, 0.0);
+		out_color	 = vec4(color_transformed, occlusion);
+		out_pbr		 = vec4(roughness_metalness, 0.0, 0.0);
+		out_emissive = vec4(pow(emissive, vec3(2.2)) * mat_params.emissive_strength, 1.0);
+	}
+	else
+	{
+		out_emissive = vec4(emissive, 1.0);
+		out_normal	 = vec4(mapped_normal, mat_params.emissive_strength);
+		out_color	 = vec4(color_transformed, 0.0);
+		out_pbr		 = vec4(occlusion, roughness_metalness, 0.0);
+	}
 }
\ No newline at end of file
@@ -37,6 +37,10 @@ layout(set = 1, binding = 2) uniform sampler2D brdf_lut;
 
 #include "pbr.glsl"
 #include "gltf-pbr.glsl"
+#include "octahedral.glsl"
+
+// Gbuffer layout, see `Gbuffer_pipeline::compact_formats`
+layout(constant_id = 0) const bool compact_gbuffer = false;
 
 const float gamma = 2.2;
 const vec3 rgb_brightness_coeff = vec3(0.21, 0.72, 0.07);
@@ -118,15 +122,29 @@ void main()
 	vec3 position = world_space.xyz / world_space.w;
 	vec3 view_direction = normalize(position - params.camera_position);
 
-	// Normal & Emissive Values
-	vec4 normal_sampled = texture(normal_tex, uv);
-	vec3 normal = normalize(normal_sampled.xyz);
-	float emissive_strength = normal_sampled.a;
-	vec3 emissive = pow(texture(emissive_tex, uv).rgb, vec3(gamma)) * emissive_strength;
+	vec3 normal, emissive, color, pbr;
+
+	if(compact_gbuffer)
+	{
+		normal = octahedral_decode(texture(normal_tex, uv).xy);
+		emissive = texture(emissive_tex, uv).rgb;
 
-	// Color & PBR
-	vec3 color = pow(texture(color_tex, uv).rgb, vec3(gamma));
-	vec3 pbr = texture(pbr_tex, uv).xyz;
+		vec4 color_sampled = texture(color_tex, uv);
+		color = pow(color_sampled.rgb, vec3(gamma));
+		pbr = vec3(color_sampled.a, texture(pbr_tex, uv).xy);
+	}
+	else
+	{
+		// Normal & Emissive Values
+		vec4 normal_sampled = texture(normal_tex, uv);
+		normal = normalize(normal_sampled.xyz);
+		float emissive_strength = normal_sampled.a;
+		emissive = pow(texture(emissive_tex, uv).rgb, vec3(gamma)) * emissive_strength;
+
+		// Color & PBR
+		color = pow(texture(color_tex, uv).rgb, vec3(gamma));
+		pbr = texture(pbr_tex, uv).xyz;
+	}
 
 	pbr.g = mix(0.04, 1, pbr.g); // map roughness to avoid artifacts
 
@@ -0,0 +1,26 @@
+precision highp float;
+
+// Octahedral normal encoding, maps unit vectors to [-1, 1]^2 for snorm targets
+
+vec2 sign_not_zero(vec2 v)
+{
+	return vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+vec2 octahedral_encode(vec3 n)
+{
+	n /= abs(n.x) + abs(n.y) + abs(n.z);
+
+	// Fold the lower hemisphere over the diagonals
+	return n.z >= 0.0 ? n.xy : (1.0 - abs(n.yx)) * sign_not_zero(n.xy);
+}
+
+vec3 octahedral_decode(vec2 e)
+{
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+
+	float t = max(-n.z, 0.0);
+	n.xy -= t * sign_not_zero(n.xy);
+
+	return normalize(n);
+}
@@ -52,6 +52,11 @@ namespace binary_resource
 #include "cube.vert.spv.h"
 	DEFINE_RESOURCE_TAIL(cube_vert)
 
+	// SOURCE: shaders/cull.comp
+	DEFINE_RESOURCE_HEAD(cull_comp)
+#include "cull.comp.spv.h"
+	DEFINE_RESOURCE_TAIL(cull_comp)
+
 	// SOURCE: shaders/exposure-lerp.comp
 	DEFINE_RESOURCE_HEAD(exposure_lerp_comp)
 #include "exposure-lerp.comp.spv.h"
@@ -77,10 +82,10 @@ namespace binary_resource
 #include "gen-diffuse.frag.spv.h"
 	DEFINE_RESOURCE_TAIL(gen_diffuse_frag)
 
-	// SOURCE: shaders/gen-specular.frag
-	DEFINE_RESOURCE_HEAD(gen_specular_frag)
-#include "gen-specular.frag.spv.h"
-	DEFINE_RESOURCE_TAIL(gen_specular_frag)
+	// SOURCE: shaders/gen-specular.comp
+	DEFINE_RESOURCE_HEAD(gen_specular_comp)
+#include "gen-specular.comp.spv.h"
+	DEFINE_RESOURCE_TAIL(gen_specular_comp)
 
 	// SOURCE: shaders/gbuffer.frag
 	DEFINE_RESOURCE_HEAD(gbuffer_frag)
@@ -92,10 +97,10 @@ namespace binary_resource
 #include "gbuffer.vert.spv.h"
 	DEFINE_RESOURCE_TAIL(gbuffer_vert)
 
-	// SOURCE: shaders/gbuffer-skin.vert
-	DEFINE_RESOURCE_HEAD(gbuffer_skin_vert)
-#include "gbuffer-skin.vert.spv.h"
-	DEFINE_RESOURCE_TAIL(gbuffer_skin_vert)
+	// SOURCE: shaders/gbuffer-indirect.vert
+	DEFINE_RESOURCE_HEAD(gbuffer_indirect_vert)
+#include "gbuffer-indirect.vert.spv.h"
+	DEFINE_RESOURCE_TAIL(gbuffer_indirect_vert)
 
 	// SOURCE: shaders/lighting.frag
 	DEFINE_RESOURCE_HEAD(lighting_frag)
@@ -122,20 +127,25 @@ namespace binary_resource
 #include "shadow.vert.spv.h"
 	DEFINE_RESOURCE_TAIL(shadow_vert)
 
+	// SOURCE: shaders/shadow-indirect.vert
+	DEFINE_RESOURCE_HEAD(shadow_indirect_vert)
+#include "shadow-indirect.vert.spv.h"
+	DEFINE_RESOURCE_TAIL(shadow_indirect_vert)
+
 	// SOURCE: shaders/shadow-opaque.vert
 	DEFINE_RESOURCE_HEAD(shadow_opaque_vert)
 #include "shadow-opaque.vert.spv.h"
 	DEFINE_RESOURCE_TAIL(shadow_opaque_vert)
 
-	// SOURCE: shaders/shadow-skin.vert
-	DEFINE_RESOURCE_HEAD(shadow_skin_vert)
-#include "shadow-skin.vert.spv.h"
-	DEFINE_RESOURCE_TAIL(shadow_skin_vert)
+	// SOURCE: shaders/shadow-opaque-indirect.vert
+	DEFINE_RESOURCE_HEAD(shadow_opaque_indirect_vert)
+#include "shadow-opaque-indirect.vert.spv.h"
+	DEFINE_RESOURCE_TAIL(shadow_opaque_indirect_vert)
 
-	// SOURCE: shaders/shadow-skin-opaque.vert
-	DEFINE_RESOURCE_HEAD(shadow_skin_opaque_vert)
-#include "shadow-skin-opaque.vert.spv.h"
-	DEFINE_RESOURCE_TAIL(shadow_skin_opaque_vert)
+	// SOURCE: shaders/skin.comp
+	DEFINE_RESOURCE_HEAD(skin_comp)
+#include "skin.comp.spv.h"
+	DEFINE_RESOURCE_TAIL(skin_comp)
 
 	/* Assets */
 
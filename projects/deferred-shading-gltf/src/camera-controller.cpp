@@ -65,6 +65,12 @@ void Camera_controller::update(ImGuiIO& io)
 	}
 }
 
+void Camera_controller::snap()
+{
+	std::tie(current_yaw, current_pitch, current_log_distance, current_eye_center)
+		= std::tie(target_yaw, target_pitch, target_log_distance, target_eye_center);
+}
+
 glm::mat4 Camera_controller::rotation_matrix() const
 {
 	return glm::rotate(
@@ -2,6 +2,9 @@
 
 bool Core::render_one_frame(const loop_func& loop_func)
 {
+	// Wait for the resources of the current frame slot
+	render_targets.wait_frame(env);
+
 	// Fetch next image
 	uint32_t image_idx;
 
@@ -9,7 +12,11 @@ bool Core::render_one_frame(const loop_func& loop_func)
 	{
 		try
 		{
-			auto acquire_result = env.device->acquireNextImageKHR(env.swapchain.swapchain, 1e10, render_targets.acquire_semaphore);
+			auto acquire_result = env.device->acquireNextImageKHR(
+				env.swapchain.swapchain,
+				1e10,
+				render_targets.current_frame().acquire_semaphore
+			);
 
 			if (acquire_result.result == vk::Result::eSuccess) [[likely]]
 			{
@@ -26,16 +33,19 @@ bool Core::render_one_frame(const loop_func& loop_func)
 		recreate_swapchain();
 	}
 
-	const auto wait_fence_result = env.device->waitForFences({render_targets.next_frame_fence}, true, 1e10);
-	if (wait_fence_result != vk::Result::eSuccess) throw error::Detailed_error("Fence wait timeout!");
-	env.device->resetFences({render_targets.next_frame_fence});
+	render_targets.acquire_image(env, image_idx);
 
 	// Record Command Buffer
 	loop_func(image_idx);
 
-	vk::Semaphore graphic_wait_semaphore = render_targets.acquire_semaphore, graphics_signal_semaphore = render_targets.render_done_semaphore,
+	const auto& frame_sync = render_targets.current_frame();
+
+	vk::Semaphore graphic_wait_semaphore = frame_sync.acquire_semaphore, graphics_signal_semaphore = frame_sync.render_done_semaphore,
 				  present_wait_semaphore = graphics_signal_semaphore;
 
+	// Worker threads may be using the same queues on devices with few queues
+	const auto queue_lock = env.lock_render_queues();
+
 	// Submit to Graphic Queue
 	{
 		const auto wait_stages         = std::to_array<vk::PipelineStageFlags>({vk::PipelineStageFlagBits::eColorAttachmentOutput});
@@ -47,7 +57,7 @@ bool Core::render_one_frame(const loop_func& loop_func)
 				.setWaitSemaphores(graphic_wait_semaphore)
 				.setSignalSemaphores(graphics_signal_semaphore)
 				.setWaitDstStageMask(wait_stages),
-			render_targets.next_frame_fence
+			frame_sync.next_frame_fence
 		);
 	}
 
@@ -73,6 +83,8 @@ bool Core::render_one_frame(const loop_func& loop_func)
 		}
 	}
 
+	render_targets.next_frame();
+
 	return true;
 }
 
@@ -93,6 +105,9 @@ void Core::recreate_swapchain()
 		if ((flags & SDL_WINDOW_MINIMIZED) == 0 && width > 0 && height > 0) break;
 	}
 
+	// Worker threads loading resources may be submitting meanwhile
+	const std::lock_guard lock(env.worker_queue_mutex);
+
 	env.device->waitIdle();
 
 	for (auto i : Iota(env.swapchain.image_count)) env.command_buffer[i].reset();
@@ -3,18 +3,22 @@
 #define MANUAL_CHOOSE_DEVICE 0
 #define FORCE_DEBUG_LAYER 0
 
+static bool satisfies_limits(const vk::PhysicalDeviceLimits& limits)
+{
+	return limits.maxDescriptorSetSamplers >= 3 && limits.maxDescriptorSetInputAttachments >= 5
+		&& limits.maxDescriptorSetUniformBuffers >= 3;
+}
+
 Physical_device Environment::helper_select_physical_device(const std::vector<Physical_device>& device_list_input)
 {
 	static auto condition = [](Physical_device device) -> bool
 	{
-		const auto  properties = device.getProperties();
-		const auto& limits     = properties.limits;
+		const auto properties = device.getProperties();
 
 		const bool type_satisfy = properties.deviceType == vk::PhysicalDeviceType::eDiscreteGpu
 							   || properties.deviceType == vk::PhysicalDeviceType::eIntegratedGpu;
 
-		return type_satisfy && limits.maxDescriptorSetSamplers >= 3 && limits.maxDescriptorSetInputAttachments >= 5
-			&& limits.maxDescriptorSetUniformBuffers >= 3;
+		return type_satisfy && satisfies_limits(properties.limits);
 	};
 
 	auto       filtered_list = std::views::all(device_list_input) | std::views::filter(condition);
@@ -103,6 +107,38 @@ Physical_device Environment::helper_select_physical_device(const std::vector<Phy
 #endif
 }
 
+Physical_device Environment::helper_select_headless_physical_device(const std::vector<Physical_device>& device_list)
+{
+	// Never prompts, CPU implementations come last but are accepted for running without a GPU
+	static const std::map<vk::PhysicalDeviceType, int> type_ranking = {
+		{vk::PhysicalDeviceType::eDiscreteGpu,   0},
+		{vk::PhysicalDeviceType::eIntegratedGpu, 1},
+		{vk::PhysicalDeviceType::eVirtualGpu,    2},
+		{vk::PhysicalDeviceType::eCpu,           3}
+	};
+
+	std::optional<Physical_device> selected;
+	int                             selected_rank = 0;
+
+	for (const auto& device : device_list)
+	{
+		const auto properties = device.getProperties();
+		const auto find_rank  = type_ranking.find(properties.deviceType);
+
+		if (find_rank == type_ranking.end() || !satisfies_limits(properties.limits)) continue;
+
+		if (!selected || find_rank->second < selected_rank)
+		{
+			selected      = device;
+			selected_rank = find_rank->second;
+		}
+	}
+
+	if (!selected) throw error::Detailed_error("Can't find suitable physical device");
+
+	return selected.value();
+}
+
 void Environment::create_window()
 {
 	window = SDL2_window(
@@ -116,7 +152,7 @@ void Environment::create_window()
 void Environment::create_instance_debug_utility(bool disable_validation)
 {
 
-	std::vector<const char*> instance_extensions = window.get_extension_names();
+	std::vector<const char*> instance_extensions = features.headless ? std::vector<const char*>() : window.get_extension_names();
 	std::vector<const char*> layers              = {};
 
 	features.validation_layer_enabled = Debug_utility::is_supported();
@@ -189,9 +225,11 @@ void Environment::find_queue_families()
 		return std::nullopt;
 	}();
 
-	// match present queue family
+	// match present queue family, nothing is presented in headless mode
 	const auto p_family_match = [=, this]() -> std::optional<uint32_t>
 	{
+		if (features.headless) return g_family_match;
+
 		for (auto i : Iota(family_properties.size()))
 		{
 			auto supported = physical_device.getSurfaceSupportKHR(i, surface);
@@ -214,22 +252,46 @@ void Environment::create_logic_device()
 {
 	auto queue_priorities = std::to_array({1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f});
 
+	const auto family_properties = physical_device.getQueueFamilyProperties();
+
+	// Number of queues wanted from each family
 	std::map<uint32_t, uint32_t> family_idx_map;
 
-	const auto g_queue_offset = family_idx_map[g_family_idx];
-	family_idx_map[g_family_idx] += 1;
+	// > Takes the next queue of a family. Families with fewer queues than wanted hand out their queues again, render thread
+	// queues are taken first so that the worker queues are the ones aliased
+	const auto take_queue = [&](uint32_t family_idx)
+	{
+		return family_idx_map[family_idx]++ % family_properties[family_idx].queueCount;
+	};
 
-	const auto g_queue2_offset = family_idx_map[g_family_idx];
-	family_idx_map[g_family_idx] += 1;
+	const auto g_queue_offset  = take_queue(g_family_idx);
+	const auto p_queue_offset  = take_queue(p_family_idx);
+	const auto c_queue_offset  = take_queue(c_family_idx);
+	const auto g_queue2_offset = take_queue(g_family_idx);
+	const auto t_queue_offset  = take_queue(g_family_idx);
 
-	const auto t_queue_offset = family_idx_map[g_family_idx];
-	family_idx_map[g_family_idx] += 1;
+	for (auto& [family_idx, count] : family_idx_map) count = std::min(count, family_properties[family_idx].queueCount);
 
-	const auto p_queue_offset = family_idx_map[p_family_idx];
-	family_idx_map[p_family_idx]++;
+	const auto render_queues = std::to_array<std::pair<uint32_t, uint32_t>>({
+		{g_family_idx, g_queue_offset},
+		{p_family_idx, p_queue_offset},
+		{c_family_idx, c_queue_offset}
+	});
 
-	const auto c_queue_offset = family_idx_map[c_family_idx];
-	family_idx_map[c_family_idx]++;
+	const auto worker_queues = std::to_array<std::pair<uint32_t, uint32_t>>({
+		{g_family_idx, g_queue2_offset},
+		{g_family_idx, t_queue_offset }
+	});
+
+	worker_queues_aliased = std::ranges::any_of(
+		worker_queues,
+		[&render_queues](const auto& queue)
+		{
+			return std::ranges::find(render_queues, queue) != render_queues.end();
+		}
+	);
+
+	if (worker_queues_aliased) log_msg("Worker queues are shared with the render thread, G={} queue(s)", g_family_count);
 
 	std::vector<vk::DeviceQueueCreateInfo> queue_create_info;
 	queue_create_info.reserve(family_idx_map.size());
@@ -245,12 +307,40 @@ void Environment::create_logic_device()
 	features.anistropy_enabled = device_features.samplerAnisotropy;
 	features.max_anistropy     = device_limits.maxSamplerAnisotropy;
 
+	// Request BC formats for compressed KTX2 textures
+	if (device_features.textureCompressionBC) requested_features.textureCompressionBC = true;
+	features.texture_compression_bc_enabled = device_features.textureCompressionBC;
+
+	// Request indirect drawing features for GPU culling
+	features.indirect_draw_enabled = device_features.multiDrawIndirect && device_features.drawIndirectFirstInstance;
+	if (features.indirect_draw_enabled)
+	{
+		requested_features.multiDrawIndirect         = true;
+		requested_features.drawIndirectFirstInstance = true;
+	}
+
 	if (device_features.independentBlend)
 		requested_features.independentBlend = true;
 	else
 		throw error::Detailed_error("Device Feature Unsupported: Independent Blend");
 
-	std::vector device_extensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+	// Formats of the compact gbuffer with no guaranteed color attachment support, falls back to the wide layout otherwise
+	const bool compact_gbuffer_supported = std::ranges::all_of(
+		std::to_array({vk::Format::eR16G16Snorm, vk::Format::eB10G11R11UfloatPack32}),
+		[this](vk::Format format)
+		{
+			const auto required = vk::FormatFeatureFlagBits::eColorAttachment | vk::FormatFeatureFlagBits::eSampledImage;
+			return (physical_device.getFormatProperties(format).optimalTilingFeatures & required) == required;
+		}
+	);
+	features.compact_gbuffer_enabled = compact_gbuffer_supported && !features.wide_gbuffer_forced;
+	log_msg(
+		"Compact Gbuffer {}",
+		features.compact_gbuffer_enabled ? "ENABLED" : (compact_gbuffer_supported ? "Disabled by --gbuffer" : "Not Supported")
+	);
+
+	std::vector<const char*> device_extensions;
+	if (!features.headless) device_extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
 
 	// query debug marker
 	if (features.debug_marker_enabled)
@@ -277,6 +367,27 @@ void Environment::create_logic_device()
 	debug_marker.load(device);
 }
 
+void Environment::create_device()
+{
+	//* Physical Device
+	const auto physical_devices = instance->enumeratePhysicalDevices();
+	physical_device             = features.headless ? helper_select_headless_physical_device(physical_devices)
+													: helper_select_physical_device(physical_devices);
+
+	log_msg("Physical Device: {}", physical_device.getProperties().deviceName.data());
+
+	//* Logic Device
+	find_queue_families();
+
+	create_logic_device();
+
+	//* Command pool & Command Buffer
+	command_pool = Command_pool(device, g_family_idx, vk::CommandPoolCreateFlagBits::eResetCommandBuffer);
+
+	//* VMA Allocator
+	allocator = Vma_allocator(physical_device, device, instance);
+}
+
 void Environment::create()
 {
 
@@ -289,22 +400,21 @@ void Environment::create()
 	//* Surface
 	surface = Surface(instance, window);
 
-	//* Physical Device
-	const auto physical_devices = instance->enumeratePhysicalDevices();
-	physical_device             = helper_select_physical_device(physical_devices);
+	create_device();
 
-	//* Logic Device
-	find_queue_families();
+	swapchain.create(*this);
+}
 
-	create_logic_device();
+void Environment::create_headless(vk::Extent2D extent)
+{
+	features.headless = true;
 
-	//* Command pool & Command Buffer
-	command_pool = Command_pool(device, g_family_idx, vk::CommandPoolCreateFlagBits::eResetCommandBuffer);
+	//* Instance & Debug Utility
+	create_instance_debug_utility();
 
-	//* VMA Allocator
-	allocator = Vma_allocator(physical_device, device, instance);
+	create_device();
 
-	swapchain.create(*this);
+	swapchain.create_offscreen(*this, extent);
 }
 
 void Environment::Env_swapchain::create_swapchain(const Environment& env)
@@ -413,3 +523,41 @@ void Environment::Env_swapchain::create(Environment& env)
 
 	env.command_buffer = Command_buffer::allocate_multiple_from(env.command_pool, image_count);
 }
+
+void Environment::Env_swapchain::create_offscreen(Environment& env, vk::Extent2D extent)
+{
+	surface_format = vk::SurfaceFormatKHR(vk::Format::eR8G8B8A8Unorm, vk::ColorSpaceKHR::eVkColorspaceSrgbNonlinear);
+	image_count    = frames_in_flight;
+	this->extent   = extent;
+
+	env.log_msg("Offscreen Size: [{}, {}], {} images", extent.width, extent.height, image_count);
+
+	offscreen_images.clear();
+	image_handles.clear();
+	image_views.clear();
+
+	for (auto _ : Iota(image_count))
+	{
+		const auto& image = offscreen_images.emplace_back(
+			env.allocator,
+			vk::ImageType::e2D,
+			vk::Extent3D(extent, 1),
+			surface_format.format,
+			vk::ImageTiling::eOptimal,
+			vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
+			VMA_MEMORY_USAGE_GPU_ONLY,
+			vk::SharingMode::eExclusive
+		);
+
+		image_handles.push_back(image);
+		image_views.emplace_back(
+			env.device,
+			image,
+			surface_format.format,
+			vk::ImageViewType::e2D,
+			vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1)
+		);
+	}
+
+	env.command_buffer = Command_buffer::allocate_multiple_from(env.command_pool, image_count);
+}
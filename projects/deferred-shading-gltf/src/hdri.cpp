@@ -1,6 +1,20 @@
 #include "hdri.hpp"
 #include "binary-resource.hpp"
 
+#include <bit>
+#include <numbers>
+
+void Hdri_resource::Generate_context::submit_and_wait(const Command_buffer& command_buffer) const
+{
+	const auto command_buffers = command_buffer.raw();
+
+	std::unique_lock<std::mutex> lock;
+	if (queue_mutex != nullptr) lock = std::unique_lock(*queue_mutex);
+
+	queue.submit(vk::SubmitInfo().setCommandBuffers(command_buffers));
+	queue.waitIdle();
+}
+
 void Hdri_resource::create_sampler(const Environment& env)
 {
 	bilinear_sampler = [=]
@@ -58,7 +72,12 @@ void Hdri_resource::create_sampler(const Environment& env)
 	}();
 }
 
-void Hdri_resource::generate_environment(const Environment& env, const Image_view& input_image, uint32_t resolution)
+void Hdri_resource::generate_environment(
+	const Environment&      env,
+	const Generate_context& context,
+	const Image_view&       input_image,
+	uint32_t                resolution
+)
 {
 	const Render_pass render_pass = [=]
 	{
@@ -171,7 +190,8 @@ void Hdri_resource::generate_environment(const Environment& env, const Image_vie
 			{resolution, resolution, 1},
 			vk::Format::eR16G16B16A16Sfloat,
 			vk::ImageTiling::eOptimal,
-			vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled,
+			vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eStorage
+				| vk::ImageUsageFlagBits::eTransferSrc,
 			VMA_MEMORY_USAGE_GPU_ONLY,
 			vk::SharingMode::eExclusive,
 			environment_layers,
@@ -348,7 +368,7 @@ void Hdri_resource::generate_environment(const Environment& env, const Image_vie
 	const auto view_projection = glm::perspective(glm::radians<float>(90), 1.0f, 0.1f, 10.0f);
 
 	/* Render */
-	const auto command_buffer = Command_buffer(env.command_pool);
+	const auto command_buffer = Command_buffer(context.command_pool);
 	{
 		command_buffer.begin();
 
@@ -400,12 +420,8 @@ void Hdri_resource::generate_environment(const Environment& env, const Image_vie
 
 		command_buffer.end();
 
-		// Submit Command Buffer
-		const auto command_buffers = command_buffer.raw();
-		env.g_queue.submit(vk::SubmitInfo().setCommandBuffers(command_buffers));
+		context.submit_and_wait(command_buffer);
 	}
-
-	env.g_queue.waitIdle();
 }
 
 void Hdri_resource::generate_descriptors(const Device& device, const Descriptor_set_layout& layout)
@@ -459,7 +475,7 @@ void Hdri_resource::generate_descriptors(const Device& device, const Descriptor_
 	device->updateDescriptorSets({write_environment_set, write_diffuse_set, write_lut_set}, {});
 }
 
-void Hdri_resource::generate_diffuse(const Environment& env, uint32_t resolution)
+void Hdri_resource::generate_diffuse(const Environment& env, const Generate_context& context, uint32_t resolution)
 {
 	const Render_pass render_pass = [=]
 	{
@@ -560,7 +576,7 @@ void Hdri_resource::generate_diffuse(const Environment& env, uint32_t resolution
 			{resolution, resolution, 1},
 			vk::Format::eR16G16B16A16Sfloat,
 			vk::ImageTiling::eOptimal,
-			vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled,
+			vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferSrc,
 			VMA_MEMORY_USAGE_GPU_ONLY,
 			vk::SharingMode::eExclusive,
 			1,
@@ -678,7 +694,7 @@ void Hdri_resource::generate_diffuse(const Environment& env, uint32_t resolution
 	const auto view_projection = glm::perspective(glm::radians<float>(90), 1.0f, 0.1f, 10.0f);
 
 	/* Render */
-	const auto command_buffer = Command_buffer(env.command_pool);
+	const auto command_buffer = Command_buffer(context.command_pool);
 	{
 		command_buffer.begin();
 
@@ -717,293 +733,227 @@ void Hdri_resource::generate_diffuse(const Environment& env, uint32_t resolution
 
 		command_buffer.end();
 
-		// Submit Command Buffer
-		const auto command_buffers = command_buffer.raw();
-		env.g_queue.submit(vk::SubmitInfo().setCommandBuffers(command_buffers));
+		context.submit_and_wait(command_buffer);
 	}
+}
+
+// Sample counts of the specular prefilter scale with roughness: smooth levels have narrow lobes, and filtered importance
+// sampling reads blurrier source mips for sparse samples, so few samples suffice
+static constexpr uint32_t specular_min_samples = 64, specular_max_samples = 1024;
 
-	env.g_queue.waitIdle();
+static uint32_t specular_sample_count(float roughness)
+{
+	return specular_min_samples + (uint32_t)((specular_max_samples - specular_min_samples) * roughness);
 }
 
-void Hdri_resource::generate_specular(const Environment& env, uint32_t resolution)
+static float radical_inverse(uint32_t bits)
 {
-	struct Gen_params
-	{
-		float roughness;
-		float resolution;
-	};
+	bits = (bits << 16u) | (bits >> 16u);
+	bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+	bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+	bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+	bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+	return (float)bits * 2.3283064365386963e-10f;
+}
 
-	const Render_pass render_pass = [=]
-	{
-		std::array<vk::AttachmentDescription, 1> attachment_descriptions;
+// GGX samples around +Z with V = N, identical for every texel of a level, so they're computed once on the CPU.
+// xyz: light direction in tangent space, w: source LOD matching the solid angle covered by the sample
+static std::vector<glm::vec4> generate_specular_samples(float roughness, uint32_t sample_count, uint32_t source_resolution)
+{
+	constexpr float pi = std::numbers::pi_v<float>;
 
-		// one face of hdri output
-		attachment_descriptions[0]
-			.setInitialLayout(vk::ImageLayout::eUndefined)
-			.setFinalLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
-			.setFormat(vk::Format::eR16G16B16A16Sfloat)
-			.setLoadOp(vk::AttachmentLoadOp::eDontCare)
-			.setStoreOp(vk::AttachmentStoreOp::eStore);
+	const float alpha             = roughness * roughness;
+	const float alpha2            = alpha * alpha;
+	const float texel_solid_angle = 4 * pi / (6.0f * source_resolution * source_resolution);
 
-		std::array<vk::AttachmentReference, 1> subpass0_attachment_ref;
-		subpass0_attachment_ref[0].setAttachment(0).setLayout(vk::ImageLayout::eColorAttachmentOptimal);
+	std::vector<glm::vec4> samples;
+	samples.reserve(sample_count);
 
-		std::array<vk::SubpassDescription, 1> subpass_descriptions;
-		subpass_descriptions[0]
-			.setColorAttachments(subpass0_attachment_ref)
-			.setPipelineBindPoint(vk::PipelineBindPoint::eGraphics);
+	for (auto i : Iota(sample_count))
+	{
+		const float phi       = 2 * pi * i / sample_count;
+		const float xi        = radical_inverse(i);
+		const float cos_theta = std::sqrt((1 - xi) / (1 + (alpha2 - 1) * xi));
+		const float sin_theta = std::sqrt(1 - cos_theta * cos_theta);
 
-		std::array<vk::SubpassDependency, 1> subpass_dependencies;
-		subpass_dependencies[0]
-			.setSrcSubpass(vk::SubpassExternal)
-			.setSrcStageMask(vk::PipelineStageFlagBits::eFragmentShader)
-			.setSrcAccessMask(vk::AccessFlagBits::eShaderRead)
-			.setDstSubpass(0)
-			.setDstStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput)
-			.setDstAccessMask(vk::AccessFlagBits::eColorAttachmentWrite);
+		const auto half  = glm::vec3(std::cos(phi) * sin_theta, std::sin(phi) * sin_theta, cos_theta);
+		const auto light = 2 * cos_theta * half - glm::vec3(0, 0, 1);
+		if (light.z <= 0) continue;
 
-		return Render_pass(env.device, attachment_descriptions, subpass_descriptions, subpass_dependencies);
-	}();
+		// pdf(L) = D(h) / 4, as n_dot_h equals v_dot_h
+		const float ndf_denominator = cos_theta * cos_theta * (alpha2 - 1) + 1;
+		const float pdf             = alpha2 / (pi * ndf_denominator * ndf_denominator) / 4;
 
-	/* Create Layout Objects */
+		const float sample_solid_angle = 1 / (sample_count * pdf);
+		const float lod                = std::max(0.5f * std::log2(sample_solid_angle / texel_solid_angle) + 1, 0.0f);
 
-	const Descriptor_set_layout descriptor_set_layout = [=]
-	{
-		const auto layout_bindings = std::to_array<vk::DescriptorSetLayoutBinding>({vk::DescriptorSetLayoutBinding(
-			0,
-			vk::DescriptorType::eCombinedImageSampler,
-			1,
-			vk::ShaderStageFlagBits::eFragment
-		)});
+		samples.emplace_back(light, lod);
+	}
 
-		return Descriptor_set_layout(env.device, layout_bindings);
-	}();
+	return samples;
+}
 
-	const Pipeline_layout pipeline_layout = [=]
+void Hdri_resource::generate_specular(const Environment& env, const Generate_context& context, uint32_t resolution)
+{
+	struct Gen_params
 	{
-		const auto push_constants = std::to_array(
-			{vk::PushConstantRange(vk::ShaderStageFlagBits::eVertex, 0, sizeof(Push_constant)),
-			 vk::PushConstantRange(vk::ShaderStageFlagBits::eFragment, sizeof(Push_constant), sizeof(Gen_params))}
-		);
+		uint32_t sample_offset;
+		uint32_t sample_count;
+	};
 
-		const auto descriptor_set_layouts = Descriptor_set_layout::to_array({descriptor_set_layout});
+	constexpr uint32_t level_count = environment_layers - 1;
 
-		return Pipeline_layout(env.device, descriptor_set_layouts, push_constants);
-	}();
+	/* Create Sample Table */
 
-	/* Create Descriptors */
+	std::vector<glm::vec4>              sample_table;
+	std::array<Gen_params, level_count> gen_params;
 
-	const Descriptor_pool descriptor_pool = [=]
+	for (auto level : Iota(level_count))
 	{
-		const auto pool_sizes = std::to_array<vk::DescriptorPoolSize>({
-			{vk::DescriptorType::eCombinedImageSampler, 1}
-		});
+		const float roughness = (float)(level + 1) / environment_layers;
+		const auto  samples   = generate_specular_samples(roughness, specular_sample_count(roughness), resolution);
 
-		return Descriptor_pool(env.device, pool_sizes, 1);
-	}();
-
-	const Descriptor_set descriptor_set = [=]
-	{
-		const auto layouts = Descriptor_set_layout::to_array({descriptor_set_layout});
-		return Descriptor_set::create_multiple(env.device, descriptor_pool, layouts)[0];
-	}();
+		gen_params[level] = {(uint32_t)sample_table.size(), (uint32_t)samples.size()};
+		sample_table.insert(sample_table.end(), samples.begin(), samples.end());
+	}
 
-	// Update Descriptor Sets
-	{
-		std::array<vk::DescriptorImageInfo, 1> image_infos;
-		image_infos[0]
-			.setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
-			.setImageView(mipmapped_environment_view)
-			.setSampler(mipmapped_environment_sampler);
+	const auto sample_buffer = Buffer(
+		env.allocator,
+		sample_table.size() * sizeof(glm::vec4),
+		vk::BufferUsageFlagBits::eStorageBuffer,
+		vk::SharingMode::eExclusive,
+		VMA_MEMORY_USAGE_CPU_TO_GPU,
+		VMA_ALLOCATION_CREATE_MAPPED_BIT
+	);
 
-		std::array<vk::WriteDescriptorSet, 1> write_infos;
-		write_infos[0]
-			.setDescriptorCount(1)
-			.setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
-			.setImageInfo(image_infos)
-			.setDstBinding(0)
-			.setDstSet(descriptor_set);
+	std::memcpy(sample_buffer.mapped_data(), sample_table.data(), sample_table.size() * sizeof(glm::vec4));
 
-		env.device->updateDescriptorSets(write_infos, {});
-	}
+	/* Create Layout Objects */
 
-	const Graphics_pipeline pipeline = [=]
+	const auto descriptor_set_layout = [=]
 	{
-		vk::GraphicsPipelineCreateInfo pipeline_create_info;
-
-		/* Load Shaders */
-		auto vert_module = Shader_module(env.device, binary_resource::cube_vert_span),
-			 frag_module = Shader_module(env.device, binary_resource::gen_specular_frag_span);
-
-		const auto stage_infos = std::to_array(
-			{vert_module.stage_info(vk::ShaderStageFlagBits::eVertex),
-			 frag_module.stage_info(vk::ShaderStageFlagBits::eFragment)}
+		const auto bindings = std::to_array(
+			{vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eCompute),
+			 vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eStorageImage, 1, vk::ShaderStageFlagBits::eCompute),
+			 vk::DescriptorSetLayoutBinding(2, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute)}
 		);
 
-		pipeline_create_info.setStages(stage_infos);
-
-		/* Setup Vertex Input: No vertex input */
-		auto vertex_input_state = vk::PipelineVertexInputStateCreateInfo();
-		pipeline_create_info.setPVertexInputState(&vertex_input_state);
-
-		/* Setup Input Assembly */
-		const auto input_assembly_state = vk::PipelineInputAssemblyStateCreateInfo()
-											  .setTopology(vk::PrimitiveTopology::eTriangleList)
-											  .setPrimitiveRestartEnable(false);
-		pipeline_create_info.setPInputAssemblyState(&input_assembly_state);
+		return Descriptor_set_layout(env.device, bindings);
+	}();
 
-		/* Setup Viewport & Scissor */
-		const auto viewport_state = vk::PipelineViewportStateCreateInfo().setViewportCount(1).setScissorCount(1);
-		pipeline_create_info.setPViewportState(&viewport_state);
+	const auto pipeline_layout = [=]
+	{
+		const auto push_constants
+			= std::to_array({vk::PushConstantRange(vk::ShaderStageFlagBits::eCompute, 0, sizeof(Gen_params))});
 
-		/* Setup Rasterization */
-		const auto rasterization_state = vk::PipelineRasterizationStateCreateInfo()
-											 .setDepthClampEnable(false)
-											 .setRasterizerDiscardEnable(false)
-											 .setPolygonMode(vk::PolygonMode::eFill)
-											 .setLineWidth(1.0f)
-											 .setCullMode(vk::CullModeFlagBits::eNone)
-											 .setFrontFace(vk::FrontFace::eCounterClockwise)
-											 .setDepthBiasEnable(false);
-		pipeline_create_info.setPRasterizationState(&rasterization_state);
+		return Pipeline_layout(env.device, {descriptor_set_layout}, push_constants);
+	}();
 
-		/* Setup Multisampling */
-		const auto multisample_state = vk::PipelineMultisampleStateCreateInfo()
-										   .setRasterizationSamples(vk::SampleCountFlagBits::e1)
-										   .setSampleShadingEnable(false);
-		pipeline_create_info.setPMultisampleState(&multisample_state);
+	const auto compute_pipeline = [=]
+	{
+		const auto shader_module = Shader_module(env.device, binary_resource::gen_specular_comp_span);
 
-		/* Setup Color Blending */
-		const auto color_blend_attachment = vk::PipelineColorBlendAttachmentState()
-												.setColorWriteMask(
-													vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG
-													| vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA
-												)
-												.setBlendEnable(false);
-		const auto color_blend_state
-			= vk::PipelineColorBlendStateCreateInfo().setAttachmentCount(1).setPAttachments(&color_blend_attachment);
-		pipeline_create_info.setPColorBlendState(&color_blend_state);
+		return Compute_pipeline(
+			env.device,
+			pipeline_layout,
+			shader_module.stage_info(vk::ShaderStageFlagBits::eCompute)
+		);
+	}();
 
-		/* Setup Dynamic State */
-		const auto dynamic_states = std::to_array({vk::DynamicState::eViewport, vk::DynamicState::eScissor});
-		const auto dynamic_state  = vk::PipelineDynamicStateCreateInfo().setDynamicStates(dynamic_states);
-		pipeline_create_info.setPDynamicState(&dynamic_state);
+	/* Create Descriptors */
 
-		/* Setup Layouts */
-		pipeline_create_info.setRenderPass(render_pass);
-		pipeline_create_info.setLayout(pipeline_layout);
-		pipeline_create_info.setSubpass(0);
+	const auto descriptor_pool = [=]
+	{
+		const auto sizes = std::to_array(
+			{vk::DescriptorPoolSize(vk::DescriptorType::eCombinedImageSampler, level_count),
+			 vk::DescriptorPoolSize(vk::DescriptorType::eStorageImage, level_count),
+			 vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, level_count)}
+		);
 
-		return Graphics_pipeline(env.device, pipeline_create_info);
+		return Descriptor_pool(env.device, sizes, level_count);
 	}();
 
-	// 6 view matrices
-	const auto view_matrices = std::to_array<glm::mat4>(
-		{glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f)),
-		 glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f)),
-		 glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f)),
-		 glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f)),
-		 glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, -1.0f, 0.0f)),
-		 glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, -1.0f, 0.0f))}
-	);
-	const auto view_projection = glm::perspective(glm::radians<float>(90), 1.0f, 0.1f, 10.0f);
-
-	// create image_view & framebuffers
-	std::vector<std::array<Framebuffer, 6>> framebuffers(environment_layers - 1);
-	std::vector<std::array<Image_view, 6>>  image_views(environment_layers - 1);
-	std::vector<uint32_t>                   resolution_list(environment_layers - 1);
+	const auto layouts         = std::vector<vk::DescriptorSetLayout>(level_count, descriptor_set_layout);
+	const auto descriptor_sets = Descriptor_set::create_multiple(env.device, descriptor_pool, layouts);
 
-	// Generate resolution list
+	// One 2D array view per level, covering all 6 faces
+	std::array<Image_view, level_count> image_views;
+	for (auto level : Iota(level_count))
 	{
-		uint32_t resolution_downsampled = resolution;
-		for (auto level : Iota(environment_layers - 1))
-		{
-			resolution_downsampled /= 2;
-			resolution_list[level] = resolution_downsampled;
-		}
+		image_views[level] = Image_view(
+			env.device,
+			environment,
+			vk::Format::eR16G16B16A16Sfloat,
+			vk::ImageViewType::e2DArray,
+			{vk::ImageAspectFlagBits::eColor, level + 1, 1, 0, 6}
+		);
+
+		const vk::DescriptorImageInfo source_info{
+			mipmapped_environment_sampler,
+			mipmapped_environment_view,
+			vk::ImageLayout::eShaderReadOnlyOptimal
+		};
+		const vk::DescriptorImageInfo  output_info{{}, image_views[level], vk::ImageLayout::eGeneral};
+		const vk::DescriptorBufferInfo sample_info{sample_buffer, 0, vk::WholeSize};
+
+		const auto write_infos = std::to_array<vk::WriteDescriptorSet>({
+			{descriptor_sets[level], 0, 0, 1, vk::DescriptorType::eCombinedImageSampler, &source_info},
+			{descriptor_sets[level], 1, 0, 1, vk::DescriptorType::eStorageImage,         &output_info},
+			{descriptor_sets[level], 2, 0, 1, vk::DescriptorType::eStorageBuffer,        nullptr,     &sample_info}
+		});
+
+		env.device->updateDescriptorSets(write_infos, {});
 	}
 
-	// Generate Framebuffers and Image views
-	for (auto level : Iota(environment_layers - 1))
+	// Each level is submitted separately, keeping every chunk of GPU work short
+	for (auto level : Iota(level_count))
 	{
-		for (auto face : Iota(6u))
+		const auto current_resolution = std::max(resolution >> (level + 1), 1u);
+		const auto subresource_range  = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, level + 1, 1, 0, 6);
+
+		const auto command_buffer = Command_buffer(context.command_pool);
+		command_buffer.begin(true);
 		{
-			image_views[level][face] = Image_view(
-				env.device,
+			// Transit to eGeneral
+			command_buffer.layout_transit(
 				environment,
-				vk::Format::eR16G16B16A16Sfloat,
-				vk::ImageViewType::e2D,
-				{vk::ImageAspectFlagBits::eColor, level + 1, 1, face, 1}
+				vk::ImageLayout::eUndefined,
+				vk::ImageLayout::eGeneral,
+				{},
+				vk::AccessFlagBits::eShaderWrite,
+				vk::PipelineStageFlagBits::eTopOfPipe,
+				vk::PipelineStageFlagBits::eComputeShader,
+				subresource_range
 			);
 
-			framebuffers[level][face] = Framebuffer(
-				env.device,
-				render_pass,
-				{image_views[level][face]},
-				{resolution_list[level], resolution_list[level], 1}
-			);
-		}
-	}
+			const auto dispatch_size = (uint32_t)(ceil((float)current_resolution / 8));
 
-	const auto command_buffer = Command_buffer(env.command_pool);
-	{
-		command_buffer.begin();
+			command_buffer.bind_pipeline(vk::PipelineBindPoint::eCompute, compute_pipeline);
+			command_buffer
+				.bind_descriptor_sets(vk::PipelineBindPoint::eCompute, pipeline_layout, 0, {descriptor_sets[level]});
+			command_buffer.push_constants(pipeline_layout, vk::ShaderStageFlagBits::eCompute, gen_params[level]);
+			command_buffer->dispatch(dispatch_size, dispatch_size, 6);
 
-		// draw each level
-		for (auto level : Iota(environment_layers - 1))
-		{
-			const auto current_resolution = resolution_list[level];
-			command_buffer.set_viewport(
-				utility::flip_viewport(vk::Viewport(0, 0, current_resolution, current_resolution, 0, 1))
+			// Transit to eShaderReadOnlyOptimal
+			command_buffer.layout_transit(
+				environment,
+				vk::ImageLayout::eGeneral,
+				vk::ImageLayout::eShaderReadOnlyOptimal,
+				vk::AccessFlagBits::eShaderWrite,
+				vk::AccessFlagBits::eShaderRead,
+				vk::PipelineStageFlagBits::eComputeShader,
+				vk::PipelineStageFlagBits::eFragmentShader,
+				subresource_range
 			);
-			command_buffer.set_scissor({
-				{0,                  0                 },
-				{current_resolution, current_resolution}
-			});
-
-			// Draw 6 faces
-			for (auto i : Iota(6))
-			{
-				command_buffer.begin_render_pass(
-					render_pass,
-					framebuffers[level][i],
-					vk::Rect2D({0, 0}, {current_resolution, current_resolution}),
-					{},
-					vk::SubpassContents::eInline
-				);
-				{
-					const auto push_constant = Push_constant{view_projection * view_matrices[i]};
-					const auto gen_params    = Gen_params{(float)(level + 1) / environment_layers, (float)resolution};
-
-					command_buffer.bind_pipeline(vk::PipelineBindPoint::eGraphics, pipeline);
-					command_buffer
-						.bind_descriptor_sets(vk::PipelineBindPoint::eGraphics, pipeline_layout, 0, {descriptor_set});
-
-					command_buffer.push_constants(pipeline_layout, vk::ShaderStageFlagBits::eVertex, push_constant, 0);
-					command_buffer.push_constants(
-						pipeline_layout,
-						vk::ShaderStageFlagBits::eFragment,
-						gen_params,
-						sizeof(Push_constant)
-					);
-
-					command_buffer.draw(0, 36, 0, 1);
-				}
-				command_buffer.end_render_pass();
-			}
 		}
-
 		command_buffer.end();
 
-		// Submit Command Buffer
-		const auto command_buffers = command_buffer.raw();
-		env.g_queue.submit(vk::SubmitInfo().setCommandBuffers(command_buffers));
+		context.submit_and_wait(command_buffer);
+		context.report_progress(0.4f + 0.5f * (level + 1) / level_count);
 	}
-
-	env.g_queue.waitIdle();
 }
 
-void Hdri_resource::generate_brdf_lut(const Environment& env, uint32_t resolution)
+void Hdri_resource::generate_brdf_lut(const Environment& env, const Generate_context& context, uint32_t resolution)
 {
 	const auto descriptor_set_layout = [=]
 	{
@@ -1070,7 +1020,7 @@ void Hdri_resource::generate_brdf_lut(const Environment& env, uint32_t resolutio
 		env.device->updateDescriptorSets({write_info}, {});
 	}
 
-	const auto command_buffer = Command_buffer(env.command_pool);
+	const auto command_buffer = Command_buffer(context.command_pool);
 	{
 		command_buffer.begin(true);
 
@@ -1106,9 +1056,305 @@ void Hdri_resource::generate_brdf_lut(const Environment& env, uint32_t resolutio
 
 		command_buffer.end();
 
-		const auto command_buffer_list = Command_buffer::to_array({command_buffer});
-		env.c_queue.submit(vk::SubmitInfo().setCommandBuffers(command_buffer_list));
+		context.submit_and_wait(command_buffer);
+	}
+}
+/* IBL Cache */
+
+struct Ibl_cache_header
+{
+	std::array<char, 8> magic;
+	uint32_t            version;
+	uint32_t            resolution, levels, diffuse_resolution;
+	uint64_t            source_hash, source_size;
+};
+
+static constexpr std::array<char, 8> ibl_cache_magic   = {'I', 'B', 'L', 'C', 'A', 'C', 'H', 'E'};
+static constexpr uint32_t            ibl_cache_version = 3;
+static constexpr vk::DeviceSize      ibl_texel_size    = sizeof(uint16_t) * 4;  // R16G16B16A16Sfloat
+
+// Size of a cubemap mip chain, tightly packed level by level
+static vk::DeviceSize cubemap_size(uint32_t resolution, uint32_t levels)
+{
+	vk::DeviceSize size = 0;
+	for (auto level : Iota(levels)) size += (vk::DeviceSize)(resolution >> level) * (resolution >> level) * 6 * ibl_texel_size;
+
+	return size;
+}
+
+// Copy regions of a cubemap mip chain, tightly packed level by level from `offset`
+static std::vector<vk::BufferImageCopy> cubemap_copy_regions(uint32_t resolution, uint32_t levels, vk::DeviceSize offset)
+{
+	std::vector<vk::BufferImageCopy> regions;
+
+	for (auto level : Iota(levels))
+	{
+		const auto level_resolution = resolution >> level;
+
+		regions.emplace_back(
+			offset,
+			0,
+			0,
+			vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level, 0, 6),
+			vk::Offset3D(0, 0, 0),
+			vk::Extent3D(level_resolution, level_resolution, 1)
+		);
+
+		offset += (vk::DeviceSize)level_resolution * level_resolution * 6 * ibl_texel_size;
+	}
+
+	return regions;
+}
+
+static std::filesystem::path ibl_cache_path(uint64_t source_hash, uint32_t resolution)
+{
+	return ibl_cache_directory / std::format("{:016x}-{}.ibl", source_hash, resolution);
+}
+
+Hdri_resource::Source_key Hdri_resource::source_key(std::span<const uint8_t> data)
+{
+	// xxHash64-style rounds over 64-bit words, the rotation folds high bits back into the low ones,
+	// then the MurmurHash3 finalizer so every input bit reaches every output bit
+	constexpr uint64_t prime1 = 0x9E3779B185EBCA87, prime2 = 0xC2B2AE3D27D4EB4F;
+
+	const auto mix_word = [](uint64_t acc, uint64_t word)
+	{
+		return std::rotl(acc + word * prime2, 31) * prime1;
+	};
+
+	uint64_t hash = 0x27D4EB2F165667C5 ^ data.size();
+
+	const size_t word_count = data.size() / sizeof(uint64_t);
+	for (auto i : Iota(word_count))
+	{
+		uint64_t word;
+		std::memcpy(&word, data.data() + i * sizeof(uint64_t), sizeof(uint64_t));
+		hash = mix_word(hash, word);
+	}
+
+	// Remaining bytes, zero padded. The size seeded above tells apart trailing zeros
+	const size_t tail_size = data.size() - word_count * sizeof(uint64_t);
+	uint64_t     tail      = 0;
+	if (tail_size != 0) std::memcpy(&tail, data.data() + word_count * sizeof(uint64_t), tail_size);
+	hash = mix_word(hash, tail);
+
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCD;
+	hash ^= hash >> 33;
+	hash *= 0xC4CEB9FE1A85EC53;
+	hash ^= hash >> 33;
+
+	return {hash, data.size()};
+}
+
+bool Hdri_resource::load_cache(
+	const Environment&           env,
+	const Generate_context&      context,
+	const Source_key&            source,
+	uint32_t                     resolution,
+	const Descriptor_set_layout& layout
+)
+{
+	const auto path = ibl_cache_path(source.hash, resolution);
+	if (!std::filesystem::is_regular_file(path)) return false;
+
+	const io::Mapped_file file(path.string());
+
+	const auto environment_size = cubemap_size(resolution, environment_layers);
+	const auto diffuse_size     = cubemap_size(diffuse_resolution, 1);
+
+	// Validate
+	if (file.size() != sizeof(Ibl_cache_header) + environment_size + diffuse_size) return false;
+
+	Ibl_cache_header header;
+	std::memcpy(&header, file.data().data(), sizeof(Ibl_cache_header));
+
+	if (header.magic != ibl_cache_magic || header.version != ibl_cache_version || header.source_hash != source.hash
+		|| header.source_size != source.size || header.resolution != resolution || header.levels != environment_layers
+		|| header.diffuse_resolution != diffuse_resolution)
+		return false;
+
+	// Create Images
+	const auto create_cubemap = [&](uint32_t cube_resolution, uint32_t levels) -> std::tuple<Image, Image_view>
+	{
+		const auto image = Image(
+			env.allocator,
+			vk::ImageType::e2D,
+			{cube_resolution, cube_resolution, 1},
+			vk::Format::eR16G16B16A16Sfloat,
+			vk::ImageTiling::eOptimal,
+			vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eTransferSrc,
+			VMA_MEMORY_USAGE_GPU_ONLY,
+			vk::SharingMode::eExclusive,
+			levels,
+			vk::ImageLayout::eUndefined,
+			vk::SampleCountFlagBits::e1,
+			6,
+			vk::ImageCreateFlagBits::eCubeCompatible
+		);
+
+		const auto view = Image_view(
+			env.device,
+			image,
+			vk::Format::eR16G16B16A16Sfloat,
+			vk::ImageViewType::eCube,
+			{vk::ImageAspectFlagBits::eColor, 0, levels, 0, 6}
+		);
+
+		return {image, view};
+	};
+
+	std::tie(environment, environment_view) = create_cubemap(resolution, environment_layers);
+	std::tie(diffuse, diffuse_view)         = create_cubemap(diffuse_resolution, 1);
+
+	// Upload
+	const Buffer staging_buffer(
+		env.allocator,
+		environment_size + diffuse_size,
+		vk::BufferUsageFlagBits::eTransferSrc,
+		vk::SharingMode::eExclusive,
+		VMA_MEMORY_USAGE_CPU_TO_GPU
+	);
+
+	staging_buffer << file.data().subspan(sizeof(Ibl_cache_header));
+
+	const auto command_buffer = Command_buffer(context.command_pool);
+	{
+		command_buffer.begin(true);
+
+		for (const auto& [image, levels] : {std::tuple(environment, environment_layers), std::tuple(diffuse, 1u)})
+		{
+			command_buffer.layout_transit(
+				image,
+				vk::ImageLayout::eUndefined,
+				vk::ImageLayout::eTransferDstOptimal,
+				{},
+				vk::AccessFlagBits::eTransferWrite,
+				vk::PipelineStageFlagBits::eTopOfPipe,
+				vk::PipelineStageFlagBits::eTransfer,
+				{vk::ImageAspectFlagBits::eColor, 0, levels, 0, 6}
+			);
+		}
+
+		command_buffer.copy_buffer_to_image(
+			environment,
+			staging_buffer,
+			vk::ImageLayout::eTransferDstOptimal,
+			cubemap_copy_regions(resolution, environment_layers, 0)
+		);
+		command_buffer.copy_buffer_to_image(
+			diffuse,
+			staging_buffer,
+			vk::ImageLayout::eTransferDstOptimal,
+			cubemap_copy_regions(diffuse_resolution, 1, environment_size)
+		);
+
+		for (const auto& [image, levels] : {std::tuple(environment, environment_layers), std::tuple(diffuse, 1u)})
+		{
+			command_buffer.layout_transit(
+				image,
+				vk::ImageLayout::eTransferDstOptimal,
+				vk::ImageLayout::eShaderReadOnlyOptimal,
+				vk::AccessFlagBits::eTransferWrite,
+				vk::AccessFlagBits::eShaderRead,
+				vk::PipelineStageFlagBits::eTransfer,
+				vk::PipelineStageFlagBits::eFragmentShader,
+				{vk::ImageAspectFlagBits::eColor, 0, levels, 0, 6}
+			);
+		}
+
+		command_buffer.end();
+
+		context.submit_and_wait(command_buffer);
 	}
 
-	env.c_queue.waitIdle();
-}
\ No newline at end of file
+	create_sampler(env);
+	if (!brdf_lut.is_valid()) generate_brdf_lut(env, context, brdf_lut_resolution);
+	generate_descriptors(env.device, layout);
+
+	context.report_progress(1.0f);
+
+	return true;
+}
+
+void Hdri_resource::save_cache(const Environment& env, const Generate_context& context, const Source_key& source, uint32_t resolution)
+	const
+{
+	const auto environment_size = cubemap_size(resolution, environment_layers);
+	const auto diffuse_size     = cubemap_size(diffuse_resolution, 1);
+
+	const Buffer readback_buffer(
+		env.allocator,
+		environment_size + diffuse_size,
+		vk::BufferUsageFlagBits::eTransferDst,
+		vk::SharingMode::eExclusive,
+		VMA_MEMORY_USAGE_GPU_TO_CPU,
+		VMA_ALLOCATION_CREATE_MAPPED_BIT
+	);
+
+	const auto command_buffer = Command_buffer(context.command_pool);
+	{
+		command_buffer.begin(true);
+
+		for (const auto& [image, levels] : {std::tuple(environment, environment_layers), std::tuple(diffuse, 1u)})
+		{
+			command_buffer.layout_transit(
+				image,
+				vk::ImageLayout::eShaderReadOnlyOptimal,
+				vk::ImageLayout::eTransferSrcOptimal,
+				vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eShaderWrite,
+				vk::AccessFlagBits::eTransferRead,
+				vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eComputeShader,
+				vk::PipelineStageFlagBits::eTransfer,
+				{vk::ImageAspectFlagBits::eColor, 0, levels, 0, 6}
+			);
+		}
+
+		const auto environment_regions = cubemap_copy_regions(resolution, environment_layers, 0);
+		const auto diffuse_regions     = cubemap_copy_regions(diffuse_resolution, 1, environment_size);
+
+		command_buffer->copyImageToBuffer(environment, vk::ImageLayout::eTransferSrcOptimal, readback_buffer, environment_regions);
+		command_buffer->copyImageToBuffer(diffuse, vk::ImageLayout::eTransferSrcOptimal, readback_buffer, diffuse_regions);
+
+		for (const auto& [image, levels] : {std::tuple(environment, environment_layers), std::tuple(diffuse, 1u)})
+		{
+			command_buffer.layout_transit(
+				image,
+				vk::ImageLayout::eTransferSrcOptimal,
+				vk::ImageLayout::eShaderReadOnlyOptimal,
+				{},
+				vk::AccessFlagBits::eShaderRead,
+				vk::PipelineStageFlagBits::eTransfer,
+				vk::PipelineStageFlagBits::eFragmentShader,
+				{vk::ImageAspectFlagBits::eColor, 0, levels, 0, 6}
+			);
+		}
+
+		command_buffer.end();
+
+		context.submit_and_wait(command_buffer);
+	}
+
+	const Ibl_cache_header header{
+		ibl_cache_magic,
+		ibl_cache_version,
+		resolution,
+		environment_layers,
+		diffuse_resolution,
+		source.hash,
+		source.size
+	};
+
+	std::vector<uint8_t> file_data(sizeof(Ibl_cache_header) + environment_size + diffuse_size);
+	std::memcpy(file_data.data(), &header, sizeof(Ibl_cache_header));
+	std::memcpy(file_data.data() + sizeof(Ibl_cache_header), readback_buffer.mapped_data(), environment_size + diffuse_size);
+
+	// Written under a temporary name first, so an interrupted write never leaves a truncated cache behind
+	const auto path      = ibl_cache_path(source.hash, resolution);
+	auto       temp_path = path;
+	temp_path += ".tmp";
+
+	std::filesystem::create_directories(ibl_cache_directory);
+	io::write(temp_path.string(), file_data);
+	std::filesystem::rename(temp_path, path);
+}
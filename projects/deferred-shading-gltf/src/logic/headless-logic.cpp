@@ -0,0 +1,100 @@
+#include "logic.hpp"
+#include <charconv>
+
+std::optional<Headless_config> Headless_config::parse(int argc, char** argv)
+{
+	const std::vector<std::string_view> args(argv + 1, argv + argc);
+
+	if (std::ranges::find(args, "--headless") == args.end()) return std::nullopt;
+
+	auto parse_number = [](std::string_view option, std::string_view value, auto& dst)
+	{
+		const auto result = std::from_chars(value.data(), value.data() + value.size(), dst);
+
+		if (result.ec != std::errc() || result.ptr != value.data() + value.size())
+			throw error::Detailed_error(std::format("Invalid value \"{}\" for {}", value, option));
+	};
+
+	Headless_config config;
+
+	// Every option takes exactly one value
+	for (size_t i = 0; i < args.size(); i += 2)
+	{
+		const auto option = args[i];
+		if (i + 1 >= args.size()) throw error::Detailed_error(std::format("Missing value for {}", option));
+
+		const auto value = args[i + 1];
+
+		if (option == "--headless")
+			config.preset_path = value;
+		else if (option == "--output")
+			config.output_dir = value;
+		else if (option == "--width")
+			parse_number(option, value, config.extent.width);
+		else if (option == "--height")
+			parse_number(option, value, config.extent.height);
+		else if (option == "--frames")
+			parse_number(option, value, config.frame_count);
+		else if (option == "--timestep")
+			parse_number(option, value, config.timestep);
+		else if (option == "--capture-interval")
+			parse_number(option, value, config.capture_interval);
+		else if (option == "--animation")
+			parse_number(option, value, config.animation);
+		else if (option == "--gbuffer")
+			continue;  // Not specific to headless mode, see `parse_wide_gbuffer` in main.cpp
+		else
+			throw error::Detailed_error(std::format("Unknown option {}", option));
+	}
+
+	if (config.extent.width == 0 || config.extent.height == 0) throw error::Detailed_error("Headless extent can't be empty");
+	if (config.frame_count == 0) throw error::Detailed_error("Headless frame count can't be zero");
+	if (!(config.timestep > 0)) throw error::Detailed_error("Headless timestep must be positive");
+
+	return config;
+}
+
+std::shared_ptr<Application_logic_base> App_headless_logic::work()
+{
+	Scene_preset preset;
+
+	try
+	{
+		preset.deserialize(nlohmann::json::parse(io::read_string(config.preset_path)));
+	}
+	catch (const error::Detailed_error& e)
+	{
+		throw error::Detailed_error(std::format("Read preset \"{}\" failed: {}", config.preset_path, e.detail));
+	}
+	catch (const nlohmann::json::exception& e)
+	{
+		throw error::Detailed_error(std::format("Parse preset \"{}\" failed: {}", config.preset_path, e.what()));
+	}
+
+	// Loaders run on their own thread as in the interactive mode, but are waited for right away
+	{
+		App_load_model_logic loader(core, Scene_preset(preset));
+		std::jthread(
+			[&loader]
+			{
+				loader.load_thread_work();
+			}
+		).join();
+	}
+
+	if (core->source.model == nullptr) throw error::Detailed_error(std::format("Load model \"{}\" failed", preset.model_path));
+
+	{
+		App_load_hdri_logic loader(core, Scene_preset(preset));
+		std::jthread(
+			[&loader]
+			{
+				loader.load_thread_work();
+			}
+		).join();
+	}
+
+	if (core->source.hdri == nullptr) throw error::Detailed_error(std::format("Load HDRI \"{}\" failed", preset.hdri_path));
+
+	return std::make_shared<App_render_logic>(core, preset, config);
+}
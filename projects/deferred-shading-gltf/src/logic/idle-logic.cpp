@@ -30,7 +30,8 @@ std::shared_ptr<Application_logic_base> App_idle_logic::work()
 					continue;
 				}
 
-				if (extension == ".gltf" || extension == ".glb") return std::make_shared<App_load_model_logic>(core, file_path_str);
+				if (extension == ".gltf" || extension == ".glb" || extension == ".vkscene")
+					return std::make_shared<App_load_model_logic>(core, file_path_str);
 
 				if (extension == ".hdr") return std::make_shared<App_load_hdri_logic>(core, file_path_str);
 
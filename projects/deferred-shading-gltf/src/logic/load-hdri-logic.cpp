@@ -2,94 +2,147 @@
 #include "logic.hpp"
 #include <vklib/stbi.hpp>
 
-std::shared_ptr<Application_logic_base> App_load_hdri_logic::work()
+void App_load_hdri_logic::load_thread_work()
 {
-	SDL_EventState(SDL_DROPBEGIN, SDL_DISABLE);
-	SDL_EventState(SDL_DROPFILE, SDL_DISABLE);
-	SDL_EventState(SDL_DROPTEXT, SDL_DISABLE);
-	SDL_EventState(SDL_DROPCOMPLETE, SDL_DISABLE);
+	VKLIB_PROFILE_THREAD_NAME("HDRI Loader");
+	VKLIB_PROFILE_ZONE("Load HDRI");
 
-	auto draw_logic = [&, this]() -> Application_logic_base*
+	try
 	{
-		SDL_Event event;
-		while (SDL_PollEvent(&event))
+		core->env.log_msg("Loading HDRi from \"{}\"...", load_path);
+		load_state = Load_state::Decoding;
+
+		// Mapped instead of read, only decoded when missing from the IBL cache
+		const bool builtin     = load_path == LOAD_DEFUALT_HDRI_TOKEN;
+		const auto source_file = builtin ? io::Mapped_file() : io::Mapped_file(load_path);
+		const auto source_data = builtin ? binary_resource::builtin_hdr_span : source_file.data();
+		const auto source_key  = Hdri_resource::source_key(source_data);
+
+		// Command pool owned by this thread. Submissions go to queues the render thread only uses when recreating the swapchain,
+		// which is serialized with `worker_queue_mutex`
+		const Command_pool command_pool(core->env.device, core->env.g_family_idx);
+
+		// Generate IBL resources in chunks on the secondary graphics queue
+		const Hdri_resource::Generate_context generate_context{
+			command_pool,
+			core->env.g_queue2,
+			&generate_progress,
+			&core->env.worker_queue_mutex
+		};
+		const auto&                           layout = core->pipeline_set.lighting_pipeline.skybox_input_layout;
+
+		auto hdri = std::make_shared<Hdri_resource>();
+		if (core->source.hdri != nullptr) hdri->share_brdf_lut(*core->source.hdri);
+
+		if (hdri->load_cache(core->env, generate_context, source_key, 1024, layout))
 		{
-			ImGui_ImplSDL2_ProcessEvent(&event);
-
-			if (event.type == SDL_QUIT) return nullptr;
+			core->env.log_msg("Loaded IBL resources from cache");
 		}
-
-		core->ui_controller.imgui_new_frame();
-
-		const auto render_result = core->render_one_frame(
-			[this](uint32_t idx)
+		else
+		{
+			const auto raw_image = [&]
 			{
-				draw(idx);
-			}
-		);
+				VKLIB_PROFILE_ZONE("Decode HDRI");
+				return io::stbi::load_hdri(source_data);
+			}();
 
-		if (!render_result) return nullptr;
-
-		return this;
-	};
-
-	// render one frame before freeze
-	if (draw_logic() == nullptr) return nullptr;
-	if (draw_logic() == nullptr) return nullptr;
-
-	core->env.device->waitIdle();
-
-	// load HDRI
-	try
-	{
-		core->env.log_msg("Loading HDRi from \"{}\"...", load_path);
-
-		core->source.hdri = std::make_shared<Hdri_resource>();
+			load_state = Load_state::Generating;
 
-		auto hdri_command_buffer = core->env.command_buffer[0];
+			// Upload
+			const Command_buffer upload_command_buffer(command_pool);
+			upload_command_buffer.begin(true);
+			const auto vk_image = raw_image.to_vulkan(core->env.allocator, upload_command_buffer, false);
+			upload_command_buffer.end();
 
-		hdri_command_buffer.begin(true);
-
-		const auto raw_image = load_path == LOAD_DEFUALT_HDRI_TOKEN ? io::stbi::load_hdri(binary_resource::builtin_hdr_span)
-																	: io::stbi::load_hdri(load_path);
-		const auto vk_image  = raw_image.to_vulkan(core->env.allocator, hdri_command_buffer, false);
-
-		hdri_command_buffer.end();
+			const Fence upload_fence(core->env.device);
+			const auto  upload_command_buffers = upload_command_buffer.raw();
+			{
+				const std::lock_guard lock(core->env.worker_queue_mutex);
+				core->env.t_queue.submit(vk::SubmitInfo().setCommandBuffers(upload_command_buffers), upload_fence);
+			}
+			upload_fence.wait();
 
-		const auto submit_command_buffers = Command_buffer::to_array({hdri_command_buffer});
-		core->env.t_queue.submit(vk::SubmitInfo().setCommandBuffers(submit_command_buffers));
+			const Image_view hdri_view(
+				core->env.device,
+				vk_image.image,
+				vk::Format::eR16G16B16A16Sfloat,
+				vk::ImageViewType::e2D,
+				{vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1}
+			);
 
-		core->env.device->waitIdle();
+			{
+				VKLIB_PROFILE_ZONE("Generate IBL");
+				hdri->generate(core->env, generate_context, hdri_view, 1024, layout);
+			}
 
-		const Image_view hdri_view(
-			core->env.device,
-			vk_image.image,
-			vk::Format::eR16G16B16A16Sfloat,
-			vk::ImageViewType::e2D,
-			{vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1}
-		);
+			// A failed cache write only costs the next load its cache hit
+			try
+			{
+				hdri->save_cache(core->env, generate_context, source_key, 1024);
+			}
+			catch (const error::Detailed_error& e)
+			{
+				core->env.log_err("Save IBL cache failed, reason: {}", e.msg);
+			}
+			catch (const std::filesystem::filesystem_error& e)
+			{
+				core->env.log_err("Save IBL cache failed, reason: {}", e.what());
+			}
+		}
 
-		core->source.hdri->generate(core->env, hdri_view, 1024, core->pipeline_set.lighting_pipeline.skybox_input_layout);
+		core->source.hdri      = std::move(hdri);
 		core->source.hdri_path = load_path;
 
-		load_state = Load_state::Load_success;
 		core->env.log_msg("Loaded HDRi");
+		load_state = Load_state::Load_success;
 	}
 	catch (const error::Detailed_error& e)
 	{
+		// The previous HDRI, if any, is kept
 		load_fail_reason = std::format("{} at {}", e.msg, e.loc.function_name());
-		load_state       = Load_state::Load_failed;
 
 		core->env.log_err("Load HDRi failed, reason: {}", e.msg);
-
-		// cleanup
-		core->source.hdri = nullptr;
+		load_state = Load_state::Load_failed;
 	}
+}
+
+std::shared_ptr<Application_logic_base> App_load_hdri_logic::work()
+{
+	SDL_EventState(SDL_DROPBEGIN, SDL_DISABLE);
+	SDL_EventState(SDL_DROPFILE, SDL_DISABLE);
+	SDL_EventState(SDL_DROPTEXT, SDL_DISABLE);
+	SDL_EventState(SDL_DROPCOMPLETE, SDL_DISABLE);
+
+	// Frames in flight may still reference the previous HDRI
+	core->env.device->waitIdle();
+
+	load_thread = std::jthread(
+		[this]
+		{
+			this->load_thread_work();
+		}
+	);
 
-	// After load
 	while (true)
 	{
-		if (draw_logic() == nullptr) return nullptr;
+		SDL_Event event;
+		while (SDL_PollEvent(&event))
+		{
+			ImGui_ImplSDL2_ProcessEvent(&event);
+
+			if (event.type == SDL_QUIT) return nullptr;
+		}
+
+		core->ui_controller.imgui_new_frame();
+
+		const auto render_result = core->render_one_frame(
+			[this](uint32_t idx)
+			{
+				draw(idx);
+			}
+		);
+
+		if (!render_result) return nullptr;
 
 		if (load_state == Load_state::Quit || load_state == Load_state::Load_success)
 		{
@@ -132,9 +185,13 @@ void App_load_hdri_logic::ui_logic()
 	{
 		switch (load_state)
 		{
-		case Load_state::Start:
-			ImGui::Text("Loading HDRI");
-			ImGui::Text("Window may freeze, please wait.");
+		case Load_state::Decoding:
+			ImGui::Text("Decoding HDRI");
+			ImGui::ProgressBar(-1.0f * (float)ImGui::GetTime(), ImVec2(core->env.swapchain.extent.width / 3.0f, 0));
+			break;
+		case Load_state::Generating:
+			ImGui::Text("Generating Environment Lighting");
+			ImGui::ProgressBar(generate_progress, ImVec2(core->env.swapchain.extent.width / 3.0f, 0));
 			break;
 		case Load_state::Load_failed:
 		{
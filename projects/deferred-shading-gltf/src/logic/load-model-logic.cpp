@@ -3,6 +3,9 @@
 
 void App_load_model_logic::load_thread_work()
 {
+	VKLIB_PROFILE_THREAD_NAME("Model Loader");
+	VKLIB_PROFILE_ZONE("Load Model");
+
 	core->env.log_msg("Loading model from \"{}\"...", load_path);
 	core->source.model = std::make_shared<io::gltf::Model>();  // create new
 
@@ -13,12 +16,15 @@ void App_load_model_logic::load_thread_work()
 	loader_context.command_pool            = Command_pool(core->env.device, core->env.g_family_idx);
 	loader_context.device                  = core->env.device;
 	loader_context.transfer_queue          = core->env.t_queue;
+	loader_context.queue_mutex             = &core->env.worker_queue_mutex;
 	loader_context.physical_device         = core->env.physical_device;
 	loader_context.load_stage              = &load_stage;
 	loader_context.sub_progress            = &sub_progress;
 	loader_context.config.enable_anistropy = core->env.features.anistropy_enabled;
 	loader_context.config.max_anistropy    = std::min(8.0f, core->env.features.max_anistropy);
 
+	loader_context.config.enable_texture_compression_bc = core->env.features.texture_compression_bc_enabled;
+
 	const auto extension = std::filesystem::path(load_path).extension();
 
 	try
@@ -34,11 +40,17 @@ void App_load_model_logic::load_thread_work()
 		{
 			if (extension == ".gltf")
 				core->source.model->load_gltf_ascii(loader_context, load_path);
+			else if (extension == ".vkscene")
+				core->source.model->load_cooked(loader_context, load_path);
 			else
 				core->source.model->load_gltf_bin(loader_context, load_path);
 		}
 
 		core->source.model_path = load_path;
+
+		for (const auto& warning : loader_context.warnings) core->env.log_msg("Warning: {}", warning);
+
+		VKLIB_PROFILE_ZONE("Generate Render Data");
 		core->source.generate_material_data(core->env, core->pipeline_set);
 		core->source.generate_skin_data(core->env, core->pipeline_set);
 
@@ -62,6 +74,9 @@ std::shared_ptr<Application_logic_base> App_load_model_logic::work()
 	SDL_EventState(SDL_DROPTEXT, SDL_DISABLE);
 	SDL_EventState(SDL_DROPCOMPLETE, SDL_DISABLE);
 
+	// Frames in flight may still reference the previous model
+	core->env.device->waitIdle();
+
 	load_thread = std::jthread(
 		[this]
 		{
@@ -1,5 +1,6 @@
 #include "logic.hpp"
 #include <imgui_stdlib.h>
+#include <vklib/stbi.hpp>
 
 App_render_logic::App_render_logic(std::shared_ptr<Core> resource, const Scene_preset& preset) :
 	App_render_logic(std::move(resource))
@@ -7,22 +8,28 @@ App_render_logic::App_render_logic(std::shared_ptr<Core> resource, const Scene_p
 	preset.assign(*this);
 }
 
+App_render_logic::App_render_logic(std::shared_ptr<Core> resource, const Scene_preset& preset, Headless_config config) :
+	App_render_logic(std::move(resource), preset)
+{
+	headless_config = std::move(config);
+}
+
 App_render_logic::App_render_logic(std::shared_ptr<Core> resource) :
 	Application_logic_base(std::move(resource))
 {
 	// Create semaphores
-	gbuffer_shadow_semaphore = Semaphore(core->env.device);
-	composite_semaphore      = Semaphore(core->env.device);
-	compute_semaphore        = Semaphore(core->env.device);
-	lighting_semaphore       = Semaphore(core->env.device);
-	copy_buffer_semaphore    = Semaphore(core->env.device);
+	for (auto _ : Iota(frames_in_flight)) frame_semaphores.emplace_back(core->env.device);
 
 	// Create command buffers
-	for (auto _ : Iota(core->env.swapchain.image_count)) command_buffers.emplace_back(core->env.command_pool);
+	for (auto _ : Iota(frames_in_flight)) command_buffers.emplace_back(core->env, record_thread_pool.size() + 1);
+
+	gpu_profiler = Gpu_profiler(core->env);
 }
 
 std::shared_ptr<Application_logic_base> App_render_logic::work()
 {
+	if (headless_config.has_value()) return work_headless();
+
 	SDL_EventState(SDL_DROPBEGIN, SDL_ENABLE);
 	SDL_EventState(SDL_DROPFILE, SDL_ENABLE);
 	SDL_EventState(SDL_DROPTEXT, SDL_DISABLE);
@@ -30,6 +37,8 @@ std::shared_ptr<Application_logic_base> App_render_logic::work()
 
 	while (true)
 	{
+		VKLIB_PROFILE_ZONE("Frame");
+
 		// Execute load logic triggered from UI
 		{
 			if (load_preset) return std::make_shared<App_load_model_logic>(core, std::move(load_preset_src));
@@ -58,7 +67,8 @@ std::shared_ptr<Application_logic_base> App_render_logic::work()
 					continue;
 				}
 
-				if (extension == ".gltf" || extension == ".glb") return std::make_shared<App_load_model_logic>(core, file_path_str);
+				if (extension == ".gltf" || extension == ".glb" || extension == ".vkscene")
+					return std::make_shared<App_load_model_logic>(core, file_path_str);
 
 				if (extension == ".hdr") return std::make_shared<App_load_hdri_logic>(core, file_path_str);
 
@@ -92,19 +102,31 @@ std::shared_ptr<Application_logic_base> App_render_logic::work()
 		}
 
 		core->ui_controller.imgui_new_frame();
+		frame_time  = ImGui::GetTime();
+		frame_delta = ImGui::GetIO().DeltaTime;
+
 		core->params.camera_controller.update(ImGui::GetIO());
 		ui_logic();
 
+		// Wait for the resources of the current frame slot
+		{
+			VKLIB_PROFILE_ZONE("Wait Frame");
+			core->render_targets.wait_frame(core->env);
+		}
+		gpu_profiler.collect(core->render_targets.frame_idx);
+
 		uint32_t image_idx;
 
 		while (true)
 		{
+			VKLIB_PROFILE_ZONE("Acquire Image");
+
 			try
 			{
 				auto acquire_result = core->env.device->acquireNextImageKHR(
 					core->env.swapchain.swapchain,
 					1e10,
-					core->render_targets.acquire_semaphore
+					core->render_targets.current_frame().acquire_semaphore
 				);
 
 				if (acquire_result.result == vk::Result::eSuccess) [[likely]]
@@ -122,21 +144,23 @@ std::shared_ptr<Application_logic_base> App_render_logic::work()
 			core->recreate_swapchain();
 		}
 
+		// Wait for the previous frame rendering to this image
+		core->render_targets.acquire_image(core->env, image_idx);
+
 		// Record Command Buffer
 		draw(image_idx);
 
-		// wait for fences
-		const auto wait_fence_result = core->env.device->waitForFences({core->render_targets.next_frame_fence}, true, 1e10);
-		if (wait_fence_result != vk::Result::eSuccess) throw error::Detailed_error("Fence wait timeout!");
-		core->env.device->resetFences({core->render_targets.next_frame_fence});
-
 		// Submit Command Buffers
-		submit_commands(command_buffers[image_idx]);
+		submit_commands(command_buffers[core->render_targets.frame_idx]);
 
 		// Present
 		{
+			VKLIB_PROFILE_ZONE("Present");
+
+			const auto&      semaphores             = frame_semaphores[core->render_targets.frame_idx];
 			vk::SwapchainKHR target_swapchain       = core->env.swapchain.swapchain;
-			const auto       present_wait_semaphore = Semaphore::to_array({composite_semaphore});
+			const auto       present_wait_semaphore = Semaphore::to_array({semaphores.composite_semaphore});
+			const auto       queue_lock             = core->env.lock_render_queues();
 			try
 			{
 				auto result = core->env.p_queue.presentKHR(vk::PresentInfoKHR()
@@ -156,14 +180,152 @@ std::shared_ptr<Application_logic_base> App_render_logic::work()
 				// recreate_swapchain();
 			}
 		}
+
+		core->render_targets.next_frame();
 	}
 }
 
+std::shared_ptr<Application_logic_base> App_render_logic::work_headless()
+{
+	const auto& config = headless_config.value();
+
+	std::filesystem::create_directories(config.output_dir);
+
+	if (config.animation >= 0)
+	{
+		if (config.animation >= (int)core->source.model->animations.size())
+			throw error::Detailed_error(std::format("Animation {} not found in the model", config.animation));
+
+		selected_animation   = config.animation;
+		animation_playing    = true;
+		animation_start_time = 0.0;
+	}
+
+	// Nothing moves the camera, so the preset view is used from the first frame
+	core->params.camera_controller.snap();
+
+	capture_buffers.clear();
+	for (auto _ : Iota(core->env.swapchain.image_count))
+	{
+		capture_buffers.emplace_back(
+			core->env.allocator,
+			(vk::DeviceSize)core->env.swapchain.extent.width * core->env.swapchain.extent.height * 4,
+			vk::BufferUsageFlagBits::eTransferDst,
+			vk::SharingMode::eExclusive,
+			VMA_MEMORY_USAGE_GPU_TO_CPU,
+			VMA_ALLOCATION_CREATE_MAPPED_BIT
+		);
+	}
+
+	std::string timing_csv = "frame,time_s,cpu_record_ms,frame_ms\n";
+
+	for (const auto frame : Iota(config.frame_count))
+	{
+		VKLIB_PROFILE_ZONE("Frame");
+
+		utility::Cpu_timer frame_timer;
+		frame_timer.start();
+
+		frame_time    = frame * (double)config.timestep;
+		frame_delta   = config.timestep;
+		capture_frame = config.should_capture(frame);
+
+		{
+			VKLIB_PROFILE_ZONE("Wait Frame");
+			core->render_targets.wait_frame(core->env);
+		}
+		gpu_profiler.collect(core->render_targets.frame_idx);
+
+		// Offscreen images are used in turn, there's nothing to acquire
+		const uint32_t image_idx = frame % core->env.swapchain.image_count;
+		core->render_targets.acquire_image(core->env, image_idx);
+
+		draw(image_idx);
+		submit_commands(command_buffers[core->render_targets.frame_idx]);
+
+		if (capture_frame)
+		{
+			vk::resultCheck(core->render_targets.current_frame().next_frame_fence.wait(), "Wait for captured frame failed");
+			write_capture(image_idx, config.output_dir / std::format("frame-{:05}.png", frame));
+		}
+
+		core->render_targets.next_frame();
+
+		frame_timer.end();
+		timing_csv += std::format(
+			"{},{:.4f},{:.4f},{:.4f}\n",
+			frame,
+			frame_time,
+			cpu_time / 1000.0,
+			frame_timer.duration<std::chrono::microseconds>() / 1000.0
+		);
+	}
+
+	// Timestamps of the last frames in flight are only available after they complete
+	core->env.device->waitIdle();
+	for (const auto frame_idx : Iota(frames_in_flight)) gpu_profiler.collect(frame_idx);
+
+	io::write((config.output_dir / "frame-timing.csv").string(), std::span((const uint8_t*)timing_csv.data(), timing_csv.size()));
+	if (gpu_profiler.supported()) gpu_profiler.export_csv(config.output_dir / "gpu-profile.csv");
+
+	core->env.log_msg("Rendered {} frames to \"{}\"", config.frame_count, config.output_dir.string());
+
+	return nullptr;
+}
+
+void App_render_logic::record_capture(uint32_t image_idx, const Command_buffer& command_buffer) const
+{
+	const auto& image  = core->env.swapchain.image_handles[image_idx];
+	const auto& extent = core->env.swapchain.extent;
+
+	core->env.debug_marker.begin_region(command_buffer, "Capture Frame", {1.0, 1.0, 1.0, 1.0});
+
+	command_buffer.layout_transit(
+		image,
+		vk::ImageLayout::eColorAttachmentOptimal,
+		vk::ImageLayout::eTransferSrcOptimal,
+		vk::AccessFlagBits::eColorAttachmentWrite,
+		vk::AccessFlagBits::eTransferRead,
+		vk::PipelineStageFlagBits::eColorAttachmentOutput,
+		vk::PipelineStageFlagBits::eTransfer,
+		{vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1}
+	);
+
+	const vk::BufferImageCopy copy_region(
+		0,
+		0,
+		0,
+		{vk::ImageAspectFlagBits::eColor, 0, 0, 1},
+		{0, 0, 0},
+		{extent.width, extent.height, 1}
+	);
+	command_buffer->copyImageToBuffer(image, vk::ImageLayout::eTransferSrcOptimal, capture_buffers[image_idx], copy_region);
+
+	core->env.debug_marker.end_region(command_buffer);
+}
+
+void App_render_logic::write_capture(uint32_t image_idx, const std::filesystem::path& path) const
+{
+	const auto& extent      = core->env.swapchain.extent;
+	const auto  pixel_count = (size_t)extent.width * extent.height;
+	const auto* src         = (const uint8_t*)capture_buffers[image_idx].mapped_data();
+
+	// Alpha of the final image isn't meaningful, written as RGB
+	std::vector<uint8_t> pixels(pixel_count * 3);
+	for (auto i : Iota(pixel_count)) std::copy_n(src + i * 4, 3, pixels.begin() + i * 3);
+
+	io::stbi::write_png(path.string(), extent.width, extent.height, 3, pixels);
+}
+
 void App_render_logic::submit_commands(const Command_buffer_set& set) const
 {
-	const bool has_skin = !core->source.model->skins.empty();
+	VKLIB_PROFILE_ZONE("Submit Commands");
+
+	const bool  has_skin   = !core->source.model->skins.empty();
+	const auto& frame_sync = core->render_targets.current_frame();
+	const auto& semaphores = frame_semaphores[core->render_targets.frame_idx];
 
-	const auto copy_signal_semaphore = Semaphore::to_array({copy_buffer_semaphore});
+	const auto copy_signal_semaphore = Semaphore::to_array({semaphores.copy_buffer_semaphore});
 	const auto copy_submit_buffer    = Command_buffer::to_array({set.animation_update_command_buffer});
 	const auto copy_submit_info      = vk::SubmitInfo()
 									  .setCommandBuffers(copy_submit_buffer)
@@ -171,9 +333,9 @@ void App_render_logic::submit_commands(const Command_buffer_set& set) const
 									  .setWaitSemaphores({})
 									  .setWaitDstStageMask({});
 
-	const auto wait_stage_mask = std::to_array<vk::PipelineStageFlags>({vk::PipelineStageFlagBits::eTransfer});
+	const auto wait_stage_mask = std::to_array<vk::PipelineStageFlags>({vk::PipelineStageFlagBits::eComputeShader});
 
-	const auto gbuffer_shadow_signal_semaphore = Semaphore::to_array({gbuffer_shadow_semaphore});
+	const auto gbuffer_shadow_signal_semaphore = Semaphore::to_array({semaphores.gbuffer_shadow_semaphore});
 	const auto gbuffer_shadow_submit_buffer    = Command_buffer::to_array({set.gbuffer_command_buffer, set.shadow_command_buffer});
 	auto       gbuffer_shadow_submit_info      = vk::SubmitInfo()
 										  .setCommandBuffers(gbuffer_shadow_submit_buffer)
@@ -186,8 +348,8 @@ void App_render_logic::submit_commands(const Command_buffer_set& set) const
 		gbuffer_shadow_submit_info.setWaitSemaphores(copy_signal_semaphore).setWaitDstStageMask(wait_stage_mask);
 	}
 
-	const auto lighting_signal_semaphore = Semaphore::to_array({lighting_semaphore});
-	const auto lighting_wait_semaphore   = Semaphore::to_array({gbuffer_shadow_semaphore});
+	const auto lighting_signal_semaphore = Semaphore::to_array({semaphores.lighting_semaphore});
+	const auto lighting_wait_semaphore   = Semaphore::to_array({semaphores.gbuffer_shadow_semaphore});
 	const auto lighting_wait_stages      = std::to_array<vk::PipelineStageFlags>({vk::PipelineStageFlagBits::eColorAttachmentOutput});
 	const auto lighting_submit_buffers = Command_buffer::to_array({set.lighting_command_buffer});
 	const auto lighting_submit_info    = vk::SubmitInfo()
@@ -196,9 +358,12 @@ void App_render_logic::submit_commands(const Command_buffer_set& set) const
 										  .setWaitSemaphores(lighting_wait_semaphore)
 										  .setSignalSemaphores(lighting_signal_semaphore);
 
-	const auto compute_signal_semaphore = Semaphore::to_array({compute_semaphore});
-	const auto compute_wait_semaphore   = Semaphore::to_array({lighting_semaphore});
-	const auto compute_wait_stages      = std::to_array<vk::PipelineStageFlags>({vk::PipelineStageFlagBits::eColorAttachmentOutput});
+	const auto compute_signal_semaphore = Semaphore::to_array({semaphores.compute_semaphore});
+	const auto compute_wait_semaphore   = Semaphore::to_array({semaphores.lighting_semaphore});
+	// Wait stages cover the first usage of images handed over between queues, see `Render_graph`
+	const auto compute_wait_stages      = std::to_array<vk::PipelineStageFlags>(
+        {vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eTransfer}
+    );
 	const auto compute_submit_buffers   = Command_buffer::to_array({set.compute_command_buffer});
 	const auto compute_submit_info      = vk::SubmitInfo()
 										 .setCommandBuffers(compute_submit_buffers)
@@ -206,32 +371,41 @@ void App_render_logic::submit_commands(const Command_buffer_set& set) const
 										 .setWaitSemaphores(compute_wait_semaphore)
 										 .setSignalSemaphores(compute_signal_semaphore);
 
-	const auto composite_signal_semaphore = Semaphore::to_array({composite_semaphore});
-	const auto composite_wait_semaphore   = Semaphore::to_array({compute_semaphore, core->render_targets.acquire_semaphore});
+	const auto composite_signal_semaphore = Semaphore::to_array({semaphores.composite_semaphore});
+	const auto composite_wait_semaphore   = Semaphore::to_array({semaphores.compute_semaphore, frame_sync.acquire_semaphore});
 	const auto composite_wait_stages      = std::to_array<vk::PipelineStageFlags>(
-        {vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eColorAttachmentOutput}
+        {vk::PipelineStageFlagBits::eFragmentShader | vk::PipelineStageFlagBits::eColorAttachmentOutput,
+         vk::PipelineStageFlagBits::eColorAttachmentOutput}
     );
 	const auto composite_submit_buffers = Command_buffer::to_array({set.composite_command_buffer});
-	const auto composite_submit_info    = vk::SubmitInfo()
+	auto       composite_submit_info    = vk::SubmitInfo()
 										   .setCommandBuffers(composite_submit_buffers)
 										   .setWaitDstStageMask(composite_wait_stages)
 										   .setWaitSemaphores(composite_wait_semaphore)
 										   .setSignalSemaphores(composite_signal_semaphore);
 
+	// Nothing is acquired or presented in headless mode
+	if (core->env.features.headless) composite_submit_info.setWaitSemaphoreCount(1).setSignalSemaphoreCount(0);
+
+	const auto queue_lock = core->env.lock_render_queues();
+
 	if (has_skin) core->env.t_queue.submit({copy_submit_info});
 	core->env.g_queue.submit({gbuffer_shadow_submit_info, lighting_submit_info});
 	core->env.c_queue.submit({compute_submit_info});
-	core->env.g_queue.submit({composite_submit_info}, core->render_targets.next_frame_fence);
+	core->env.g_queue.submit({composite_submit_info}, frame_sync.next_frame_fence);
 }
 
-void App_render_logic::draw(uint32_t idx)
+void App_render_logic::draw(uint32_t image_idx)
 {
+	VKLIB_PROFILE_ZONE("Draw");
+
 	gbuffer_object_count = 0;
 	gbuffer_vertex_count = 0;
 	shadow_object_count  = 0;
 	shadow_vertex_count  = 0;
 	cpu_time             = 0;
 
+	const auto  idx                = core->render_targets.frame_idx;
 	const auto& command_buffer_set = command_buffers[idx];
 
 	utility::Cpu_timer timer;
@@ -239,11 +413,8 @@ void App_render_logic::draw(uint32_t idx)
 
 	generate_drawcalls(idx);
 	upload_skin(idx);
-	draw_gbuffer(idx, command_buffer_set.gbuffer_command_buffer);
-	draw_shadow(idx, command_buffer_set.shadow_command_buffer);
-	draw_lighting(idx, command_buffer_set.lighting_command_buffer);
-	compute_process(idx, command_buffer_set.compute_command_buffer);
-	draw_swapchain(idx, command_buffer_set.composite_command_buffer);
+	record_passes(idx);
+	draw_swapchain(idx, image_idx, command_buffer_set.composite_command_buffer);
 
 	timer.end();
 	cpu_time = timer.duration<std::chrono::microseconds>();
@@ -251,6 +422,8 @@ void App_render_logic::draw(uint32_t idx)
 
 void App_render_logic::generate_drawcalls(uint32_t idx)
 {
+	VKLIB_PROFILE_ZONE("Generate Drawcalls");
+
 	const auto& model = *core->source.model;
 
 	// Ensure node_transformations size is correct
@@ -258,8 +431,20 @@ void App_render_logic::generate_drawcalls(uint32_t idx)
 
 	if (selected_animation >= 0) update_animation();
 
-	const Node_traverser::Traverse_params traverse_param{core->source.model.get(), &node_transformations, glm::mat4(1.0), 0};
-	traverser.traverse(traverse_param);
+	{
+		VKLIB_PROFILE_ZONE("Traverse Nodes");
+
+		const Node_traverser::Traverse_params traverse_param{core->source.model.get(), &node_transformations, glm::mat4(1.0), 0};
+		traverser.traverse(traverse_param);
+	}
+
+	// Transform bounding boxes once, shared by gbuffer and all shadow cascades
+	{
+		VKLIB_PROFILE_ZONE("Build Scene Bounds");
+		scene_bounds.build({core->source.model.get(), &traverser, &record_thread_pool});
+	}
+
+	gpu_culling_active = core->params.gpu_culling && core->env.features.indirect_draw_enabled;
 
 	// Generate Gbuffer
 	{
@@ -272,11 +457,12 @@ void App_render_logic::generate_drawcalls(uint32_t idx)
 								   : core->params.get_gbuffer_parameter(core->env);
 
 		const auto gen_params = Drawcall_generator::Gen_params{
-			core->source.model.get(),
-			&traverser,
+			&scene_bounds,
 			gbuffer_camera_param_prev.frustum,
 			gbuffer_camera_param_prev.eye_position,
-			gbuffer_camera_param_prev.eye_direction
+			gbuffer_camera_param_prev.eye_direction,
+			&record_thread_pool,
+			gpu_culling_active
 		};
 
 		const auto gen_result = gbuffer_generator.generate(gen_params);
@@ -297,18 +483,37 @@ void App_render_logic::generate_drawcalls(uint32_t idx)
 
 	update_uniforms(idx);
 
-	// Generate Shadow Maps
+	// Frusta are final after `update_uniforms`
+	if (gpu_culling_active)
+	{
+		std::array<algorithm::geometry::frustum::Frustum, Gpu_culling::view_count> frusta;
+
+		frusta[0] = gbuffer_param.frustum;
+		for (const auto csm_idx : Iota(csm_count)) frusta[csm_idx + 1] = shadow_params[csm_idx].frustum;
+
+		gpu_culling.update(core->env, core->pipeline_set, scene_bounds, frusta, core->render_targets.frame_idx);
+	}
+
+	// Generate Shadow Maps, all cascades are culled in one pass
+	std::array<Drawcall_generator::Gen_params, csm_count> shadow_gen_params;
+
 	for (const auto csm_idx : Iota(csm_count))
 	{
-		auto gen_params = Drawcall_generator::Gen_params{
-			core->source.model.get(),
-			&traverser,
+		shadow_gen_params[csm_idx] = Drawcall_generator::Gen_params{
+			&scene_bounds,
 			shadow_params[csm_idx].frustum,
 			shadow_params[csm_idx].eye_position,
-			shadow_params[csm_idx].eye_direction
+			shadow_params[csm_idx].eye_direction,
+			&record_thread_pool,
+			gpu_culling_active
 		};
+	}
 
-		const auto gen_result = shadow_generator[csm_idx].generate(gen_params);
+	const auto shadow_gen_results = Drawcall_generator::generate(shadow_generator, shadow_gen_params);
+
+	for (const auto csm_idx : Iota(csm_count))
+	{
+		const auto& gen_result = shadow_gen_results[csm_idx];
 
 		const float near = std::min((gen_result.near + gen_result.far) / 2.0f - 0.01f, gen_result.near);
 		const float far  = std::max((gen_result.near + gen_result.far) / 2.0f + 0.01f, gen_result.far);
@@ -321,41 +526,161 @@ void App_render_logic::generate_drawcalls(uint32_t idx)
 	}
 }
 
-void App_render_logic::draw_gbuffer(uint32_t idx, const Command_buffer& command_buffer)
+#pragma region /* Parallel Recording */
+
+App_render_logic::Thread_command_pool::Thread_command_pool(const Environment& env) :
+	pool(env.device, env.g_family_idx, vk::CommandPoolCreateFlagBits::eTransient)
 {
-	const auto draw_extent = vk::Rect2D({0, 0}, core->env.swapchain.extent);
+}
 
-	auto bind_material = [this, command_buffer](const Drawcall& drawcall)
+void App_render_logic::Thread_command_pool::reset()
+{
+	pool.reset();
+	primary_used   = 0;
+	secondary_used = 0;
+}
+
+Command_buffer App_render_logic::Thread_command_pool::acquire(vk::CommandBufferLevel level)
+{
+	auto& buffers = level == vk::CommandBufferLevel::ePrimary ? primary_buffers : secondary_buffers;
+	auto& used    = level == vk::CommandBufferLevel::ePrimary ? primary_used : secondary_used;
+
+	if (used == buffers.size()) buffers.emplace_back(pool, level);
+
+	return buffers[used++];
+}
+
+void App_render_logic::record_passes(uint32_t idx)
+{
+	VKLIB_PROFILE_ZONE("Record Passes");
+
+	auto& set = command_buffers[idx];
+
+	for (auto& pool : set.thread_command_pools) pool.reset();
+
+	// Drawcalls in a slice shouldn't be too few, or the overhead of secondary command buffers dominates
+	const auto get_slice_count = [this](size_t drawcall_count) -> size_t
 	{
-		if (drawcall.primitive.material_idx)
-			command_buffer.bind_descriptor_sets(
-				vk::PipelineBindPoint::eGraphics,
-				core->pipeline_set.gbuffer_pipeline.pipeline_layout,
-				1,
-				{core->source.material_data[drawcall.primitive.material_idx.value()].descriptor_set}
+		return std::clamp<size_t>(drawcall_count / min_drawcalls_per_slice, 1, record_thread_pool.size() + 1);
+	};
+
+	std::vector<std::function<void(Thread_command_pool&)>> jobs;
+
+	// Gbuffer slices
+	{
+		const auto drawcall_count = gbuffer_generator.drawcall_count(), slice_count = get_slice_count(drawcall_count);
+		set.gbuffer_secondary_buffers.resize(slice_count);
+
+		for (auto slice : Iota(slice_count))
+			jobs.emplace_back(
+				[=, this, &set](Thread_command_pool& pool)
+				{
+					const auto first = slice * drawcall_count / slice_count, last = (slice + 1) * drawcall_count / slice_count;
+
+					set.gbuffer_secondary_buffers[slice] = pool.acquire(vk::CommandBufferLevel::eSecondary);
+					draw_gbuffer(idx, set.gbuffer_secondary_buffers[slice], first, last - first, slice == 0 && gpu_culling_active);
+				}
 			);
-		else
-			command_buffer.bind_descriptor_sets(
-				vk::PipelineBindPoint::eGraphics,
-				core->pipeline_set.gbuffer_pipeline.pipeline_layout,
-				1,
-				{core->source.material_data.back().descriptor_set}
+	}
+
+	// Shadow slices
+	for (const auto csm_idx : Iota(csm_count))
+	{
+		const auto drawcall_count = shadow_generator[csm_idx].drawcall_count(), slice_count = get_slice_count(drawcall_count);
+		set.shadow_secondary_buffers[csm_idx].resize(slice_count);
+
+		for (auto slice : Iota(slice_count))
+			jobs.emplace_back(
+				[=, this, &set](Thread_command_pool& pool)
+				{
+					const auto first = slice * drawcall_count / slice_count, last = (slice + 1) * drawcall_count / slice_count;
+
+					set.shadow_secondary_buffers[csm_idx][slice] = pool.acquire(vk::CommandBufferLevel::eSecondary);
+					draw_shadow(
+						idx,
+						csm_idx,
+						set.shadow_secondary_buffers[csm_idx][slice],
+						first,
+						last - first,
+						slice == 0 && gpu_culling_active
+					);
+				}
 			);
-	};
+	}
+
+	// Lighting & Compute
+	jobs.emplace_back(
+		[this, idx, &set](Thread_command_pool& pool)
+		{
+			set.lighting_command_buffer = pool.acquire(vk::CommandBufferLevel::ePrimary);
+			draw_lighting(idx, set.lighting_command_buffer);
+		}
+	);
+	jobs.emplace_back(
+		[this, idx, &set](Thread_command_pool& pool)
+		{
+			set.compute_command_buffer = pool.acquire(vk::CommandBufferLevel::ePrimary);
+			compute_process(idx, set.compute_command_buffer);
+		}
+	);
+
+	record_thread_pool.parallel_for(
+		jobs.size(),
+		[&](size_t job_idx)
+		{
+			jobs[job_idx](set.thread_command_pools[record_thread_pool.worker_index()]);
+		}
+	);
+
+	// Primary command buffers executing the slices
+	execute_gbuffer(idx, set);
+	execute_shadow(idx, set);
+}
+
+void App_render_logic::draw_drawlist_range(
+	const Command_buffer&                command_buffer,
+	vk::DescriptorSet                    descriptor_set,
+	std::span<const Drawlist_range_item> drawlists,
+	size_t                               first,
+	size_t                               count
+)
+{
+	size_t offset = 0;
+
+	for (const auto& [drawlist, params] : drawlists)
+	{
+		const auto begin = std::clamp(first, offset, offset + drawlist.size()),
+				   end   = std::clamp(first + count, offset, offset + drawlist.size());
+
+		if (begin != end)
+		{
+			command_buffer.bind_descriptor_sets(vk::PipelineBindPoint::eGraphics, params.pipeline_layout, 0, {descriptor_set});
+			drawlist.draw(params, begin - offset, end - begin);
+		}
+
+		offset += drawlist.size();
+	}
+}
+
+#pragma endregion
+
+void App_render_logic::draw_gbuffer(uint32_t idx, const Command_buffer& command_buffer, size_t first, size_t count, bool draw_indirect)
+{
+	VKLIB_PROFILE_ZONE("Record Gbuffer Slice");
 
-	auto bind_material_skin = [this, command_buffer](const Drawcall& drawcall)
+	auto bind_material = [this, command_buffer](const Drawcall& drawcall)
 	{
 		if (drawcall.primitive.material_idx)
 			command_buffer.bind_descriptor_sets(
 				vk::PipelineBindPoint::eGraphics,
-				core->pipeline_set.gbuffer_pipeline.pipeline_layout_skin,
+				core->pipeline_set.gbuffer_pipeline.pipeline_layout,
 				1,
 				{core->source.material_data[drawcall.primitive.material_idx.value()].descriptor_set}
 			);
 		else
 			command_buffer.bind_descriptor_sets(
 				vk::PipelineBindPoint::eGraphics,
-				core->pipeline_set.gbuffer_pipeline.pipeline_layout_skin,
+				core->pipeline_set.gbuffer_pipeline.pipeline_layout,
 				1,
 				{core->source.material_data.back().descriptor_set}
 			);
@@ -380,41 +705,18 @@ void App_render_logic::draw_gbuffer(uint32_t idx, const Command_buffer& command_
 
 	auto bind_vertex_skin = [this, command_buffer](const Drawcall& drawcall)
 	{
-		const auto& model     = core->source.model;
-		const auto& primitive = drawcall.primitive;
-		command_buffer->bindVertexBuffers(
-			0,
-			{model->vec3_buffers[primitive.position_buffer],
-			 model->vec3_buffers[primitive.normal_buffer],
-			 model->vec2_buffers[primitive.uv_buffer],
-			 model->vec3_buffers[primitive.tangent_buffer],
-			 model->joint_buffers[primitive.skin->joint_buffer],
-			 model->weight_buffers[primitive.skin->weight_buffer]},
-			{primitive.position_offset * sizeof(glm::vec3),
-			 primitive.normal_offset * sizeof(glm::vec3),
-			 primitive.uv_offset * sizeof(glm::vec2),
-			 primitive.tangent_offset * sizeof(glm::vec3),
-			 primitive.skin->joint_offset * sizeof(glm::u16vec4),
-			 primitive.skin->weight_offset * sizeof(glm::vec4)}
-		);
-	};
-
-	auto bind_node_skin = [this, command_buffer](const Drawcall& drawcall)
-	{
-		const auto& model = *core->source.model;
-		const auto& node  = model.nodes[drawcall.node_idx];
-
-		command_buffer->bindDescriptorSets(
-			vk::PipelineBindPoint::eGraphics,
-			core->pipeline_set.gbuffer_pipeline.pipeline_layout_skin,
-			2,
-			{core->source.skin_descriptors[node.skin_idx.value()].gbuffer_set},
-			{}
+		core->source.bind_skinned_vertices(
+			command_buffer,
+			drawcall.node_idx,
+			drawcall.primitive,
+			core->render_targets.frame_idx,
+			Render_source::Skinned_vertex_input::Gbuffer
 		);
 	};
 
 	const auto single_draw_params = Drawlist::Draw_params{
 		command_buffer,
+		core->source.model.get(),
 		core->pipeline_set.gbuffer_pipeline.single_side,
 		core->pipeline_set.gbuffer_pipeline.pipeline_layout,
 		bind_material,
@@ -425,6 +727,7 @@ void App_render_logic::draw_gbuffer(uint32_t idx, const Command_buffer& command_
 
 	const auto double_draw_params = Drawlist::Draw_params{
 		command_buffer,
+		core->source.model.get(),
 		core->pipeline_set.gbuffer_pipeline.double_side,
 		core->pipeline_set.gbuffer_pipeline.pipeline_layout,
 		bind_material,
@@ -435,33 +738,41 @@ void App_render_logic::draw_gbuffer(uint32_t idx, const Command_buffer& command_
 
 	const auto single_draw_skin_params = Drawlist::Draw_params{
 		command_buffer,
-		core->pipeline_set.gbuffer_pipeline.single_side_skin,
-		core->pipeline_set.gbuffer_pipeline.pipeline_layout_skin,
-		bind_material_skin,
+		core->source.model.get(),
+		core->pipeline_set.gbuffer_pipeline.single_side,
+		core->pipeline_set.gbuffer_pipeline.pipeline_layout,
+		bind_material,
 		bind_vertex_skin,
 		bind_vertex_skin,
 		bind_vertex_skin,
-		bind_node_skin
+		nullptr,
+		true
 	};
 
 	const auto double_draw_skin_params = Drawlist::Draw_params{
 		command_buffer,
-		core->pipeline_set.gbuffer_pipeline.double_side_skin,
-		core->pipeline_set.gbuffer_pipeline.pipeline_layout_skin,
-		bind_material_skin,
+		core->source.model.get(),
+		core->pipeline_set.gbuffer_pipeline.double_side,
+		core->pipeline_set.gbuffer_pipeline.pipeline_layout,
+		bind_material,
 		bind_vertex_skin,
 		bind_vertex_skin,
 		bind_vertex_skin,
-		bind_node_skin
+		nullptr,
+		true
 	};
 
-	command_buffer.begin();
-	core->env.debug_marker.begin_region(command_buffer, "Render Gbuffer", {0.0, 1.0, 1.0, 1.0});
-	command_buffer.begin_render_pass(
+	const auto drawlists = std::to_array<Drawlist_range_item>({
+		{gbuffer_generator.get_single_sided_drawlist(),      single_draw_params     },
+		{gbuffer_generator.get_double_sided_drawlist(),      double_draw_params     },
+		{gbuffer_generator.get_single_sided_skin_drawlist(), single_draw_skin_params},
+		{gbuffer_generator.get_double_sided_skin_drawlist(), double_draw_skin_params}
+	});
+
+	command_buffer.begin_secondary(
 		core->pipeline_set.gbuffer_pipeline.render_pass,
-		core->render_targets[idx].gbuffer_rt.framebuffer,
-		draw_extent,
-		Gbuffer_pipeline::clear_values
+		0,
+		core->render_targets[idx].gbuffer_rt.framebuffer
 	);
 	{
 		command_buffer.set_viewport(
@@ -469,33 +780,110 @@ void App_render_logic::draw_gbuffer(uint32_t idx, const Command_buffer& command_
 		);
 		command_buffer.set_scissor(vk::Rect2D({0, 0}, core->env.swapchain.extent));
 
-		command_buffer.bind_descriptor_sets(
-			vk::PipelineBindPoint::eGraphics,
-			core->pipeline_set.gbuffer_pipeline.pipeline_layout,
-			0,
-			{core->render_targets[idx].gbuffer_rt.camera_uniform_descriptor_set}
+		draw_drawlist_range(
+			command_buffer,
+			core->render_targets[idx].gbuffer_rt.camera_uniform_descriptor_set,
+			drawlists,
+			first,
+			count
 		);
 
-		gbuffer_generator.get_single_sided_drawlist().draw(single_draw_params);
-		gbuffer_generator.get_double_sided_drawlist().draw(double_draw_params);
+		if (draw_indirect)
+		{
+			const auto single_draw_indirect_params = Drawlist::Draw_params{
+				command_buffer,
+				core->source.model.get(),
+				core->pipeline_set.gbuffer_pipeline.single_side_indirect,
+				core->pipeline_set.gbuffer_pipeline.pipeline_layout_indirect,
+				bind_material,
+				bind_vertex,
+				bind_vertex,
+				bind_vertex
+			};
+
+			const auto double_draw_indirect_params = Drawlist::Draw_params{
+				command_buffer,
+				core->source.model.get(),
+				core->pipeline_set.gbuffer_pipeline.double_side_indirect,
+				core->pipeline_set.gbuffer_pipeline.pipeline_layout_indirect,
+				bind_material,
+				bind_vertex,
+				bind_vertex,
+				bind_vertex
+			};
+
+			command_buffer.bind_descriptor_sets(
+				vk::PipelineBindPoint::eGraphics,
+				core->pipeline_set.gbuffer_pipeline.pipeline_layout_indirect,
+				0,
+				{core->render_targets[idx].gbuffer_rt.camera_uniform_descriptor_set}
+			);
 
-		command_buffer.bind_descriptor_sets(
-			vk::PipelineBindPoint::eGraphics,
-			core->pipeline_set.gbuffer_pipeline.pipeline_layout_skin,
-			0,
-			{core->render_targets[idx].gbuffer_rt.camera_uniform_descriptor_set}
-		);
+			gpu_culling.draw(
+				single_draw_indirect_params,
+				double_draw_indirect_params,
+				gpu_culling.get_gbuffer_set(core->render_targets.frame_idx),
+				0,
+				core->render_targets.frame_idx
+			);
+		}
+	}
+	command_buffer.end();
+}
+
+void App_render_logic::execute_gbuffer(uint32_t idx, const Command_buffer_set& set)
+{
+	VKLIB_PROFILE_ZONE("Record Gbuffer");
+
+	const auto& command_buffer = set.gbuffer_command_buffer;
+	const auto  draw_extent    = vk::Rect2D({0, 0}, core->env.swapchain.extent);
+	const auto  frame_idx      = core->render_targets.frame_idx;
+
+	command_buffer.begin();
 
-		gbuffer_generator.get_single_sided_skin_drawlist().draw(single_draw_skin_params);
-		gbuffer_generator.get_double_sided_skin_drawlist().draw(double_draw_skin_params);
+	// Executed first in the frame, all later queries are ordered after the reset
+	gpu_profiler.reset(command_buffer, frame_idx);
+
+	// Skinned vertices of both gbuffer and shadow are generated here, after skin matrices are streamed
+	if (!core->source.skinned_primitives.empty())
+	{
+		core->env.debug_marker.begin_region(command_buffer, "Skinning", {0.5, 1.0, 0.0, 1.0});
+		core->source.record_skinning(command_buffer, core->pipeline_set, core->render_targets.frame_idx);
+		core->env.debug_marker.end_region(command_buffer);
+	}
+
+	// Indirect drawcalls of both gbuffer and shadow are generated here, shadow command buffer is submitted afterwards
+	if (gpu_culling_active)
+	{
+		core->env.debug_marker.begin_region(command_buffer, "GPU Culling", {1.0, 0.5, 0.0, 1.0});
+		gpu_culling.cull(command_buffer, core->pipeline_set.culling_pipeline, core->render_targets.frame_idx);
+		core->env.debug_marker.end_region(command_buffer);
 	}
+
+	core->render_targets[idx].graph.begin_pass(command_buffer, core->render_targets[idx].passes.gbuffer);
+
+	core->env.debug_marker.begin_region(command_buffer, "Render Gbuffer", {0.0, 1.0, 1.0, 1.0});
+	gpu_profiler.begin(command_buffer, frame_idx, Gpu_profiler::Stage::Gbuffer);
+	command_buffer.begin_render_pass(
+		core->pipeline_set.gbuffer_pipeline.render_pass,
+		core->render_targets[idx].gbuffer_rt.framebuffer,
+		draw_extent,
+		Gbuffer_pipeline::clear_values,
+		vk::SubpassContents::eSecondaryCommandBuffers
+	);
+	command_buffer.execute_commands(Command_buffer::to_vector(set.gbuffer_secondary_buffers));
 	command_buffer.end_render_pass();
+	gpu_profiler.end(command_buffer, frame_idx, Gpu_profiler::Stage::Gbuffer);
 	core->env.debug_marker.end_region(command_buffer);
+
+	core->render_targets[idx].graph.end_pass(command_buffer, core->render_targets[idx].passes.gbuffer);
 	command_buffer.end();
 }
 
 void App_render_logic::update_uniforms(uint32_t idx)
 {
+	VKLIB_PROFILE_ZONE("Update Uniforms");
+
 	//* Update gbuffer
 
 	gbuffer_param = selected_camera >= 0 ? generate_param_from_gltf_camera(
@@ -515,7 +903,7 @@ void App_render_logic::update_uniforms(uint32_t idx)
 		lighting_params.emissive_brightness = core->params.emissive_brightness;
 		lighting_params.sunlight_pos        = core->params.get_light_direction();
 		lighting_params.sunlight_color      = glm::pow(core->params.sun.color, glm::vec3(2.2)) * core->params.sun.intensity;
-		lighting_params.time                = glm::fract(ImGui::GetTime());
+		lighting_params.time                = glm::fract(frame_time);
 	}
 
 	std::array<Shadow_pipeline::Shadow_uniform, csm_count> shadow_uniforms;
@@ -553,8 +941,17 @@ void App_render_logic::update_uniforms(uint32_t idx)
 	core->env.device->updateDescriptorSets(write_sets, {});
 }
 
-void App_render_logic::draw_shadow(uint32_t idx, const Command_buffer& command_buffer)
+void App_render_logic::draw_shadow(
+	uint32_t              idx,
+	uint32_t              csm_idx,
+	const Command_buffer& command_buffer,
+	size_t                first,
+	size_t                count,
+	bool                  draw_indirect
+)
 {
+	VKLIB_PROFILE_ZONE("Record Shadow Slice");
+
 	auto bind_material = [=, this](Drawcall drawcall)
 	{
 		if (drawcall.primitive.material_idx)
@@ -573,24 +970,6 @@ void App_render_logic::draw_shadow(uint32_t idx, const Command_buffer& command_b
 			);
 	};
 
-	auto bind_material_skin = [this, command_buffer](const Drawcall& drawcall)
-	{
-		if (drawcall.primitive.material_idx)
-			command_buffer.bind_descriptor_sets(
-				vk::PipelineBindPoint::eGraphics,
-				core->pipeline_set.shadow_pipeline.pipeline_layout_skin,
-				1,
-				{core->source.material_data[drawcall.primitive.material_idx.value()].albedo_only_descriptor_set}
-			);
-		else
-			command_buffer.bind_descriptor_sets(
-				vk::PipelineBindPoint::eGraphics,
-				core->pipeline_set.shadow_pipeline.pipeline_layout_skin,
-				1,
-				{core->source.material_data.back().albedo_only_descriptor_set}
-			);
-	};
-
 	auto bind_vertex = [=, this](Drawcall drawcall)
 	{
 		const auto& model     = *core->source.model;
@@ -612,56 +991,31 @@ void App_render_logic::draw_shadow(uint32_t idx, const Command_buffer& command_b
 			->bindVertexBuffers(0, {model.vec3_buffers[primitive.position_buffer]}, {primitive.position_offset * sizeof(glm::vec3)});
 	};
 
-	auto bind_vertex_skin = [=, this](Drawcall drawcall)
+	auto bind_vertex_skin = [=, this](const Drawcall& drawcall)
 	{
-		const auto& model     = *core->source.model;
-		const auto& primitive = drawcall.primitive;
-
-		command_buffer->bindVertexBuffers(
-			0,
-			{model.vec3_buffers[primitive.position_buffer],
-			 model.vec2_buffers[primitive.uv_buffer],
-			 model.joint_buffers[primitive.skin->joint_buffer],
-			 model.weight_buffers[primitive.skin->weight_buffer]},
-			{primitive.position_offset * sizeof(glm::vec3),
-			 primitive.uv_offset * sizeof(glm::vec2),
-			 primitive.skin->joint_offset * sizeof(glm::u16vec4),
-			 primitive.skin->weight_offset * sizeof(glm::vec4)}
-		);
-	};
-
-	auto bind_vertex_opaque_skin = [=, this](Drawcall drawcall)
-	{
-		const auto& model     = *core->source.model;
-		const auto& primitive = drawcall.primitive;
-
-		command_buffer->bindVertexBuffers(
-			0,
-			{model.vec3_buffers[primitive.position_buffer],
-			 model.joint_buffers[primitive.skin->joint_buffer],
-			 model.weight_buffers[primitive.skin->weight_buffer]},
-			{primitive.position_offset * sizeof(glm::vec3),
-			 primitive.skin->joint_offset * sizeof(glm::u16vec4),
-			 primitive.skin->weight_offset * sizeof(glm::vec4)}
+		core->source.bind_skinned_vertices(
+			command_buffer,
+			drawcall.node_idx,
+			drawcall.primitive,
+			core->render_targets.frame_idx,
+			Render_source::Skinned_vertex_input::Shadow
 		);
 	};
 
-	auto bind_node_skin = [this, command_buffer](const Drawcall& drawcall)
+	auto bind_vertex_opaque_skin = [=, this](const Drawcall& drawcall)
 	{
-		const auto& model = *core->source.model;
-		const auto& node  = model.nodes[drawcall.node_idx];
-
-		command_buffer->bindDescriptorSets(
-			vk::PipelineBindPoint::eGraphics,
-			core->pipeline_set.shadow_pipeline.pipeline_layout_skin,
-			2,
-			{core->source.skin_descriptors[node.skin_idx.value()].shadow_set},
-			{}
+		core->source.bind_skinned_vertices(
+			command_buffer,
+			drawcall.node_idx,
+			drawcall.primitive,
+			core->render_targets.frame_idx,
+			Render_source::Skinned_vertex_input::Shadow_opaque
 		);
 	};
 
 	const auto single_draw_params = Drawlist::Draw_params{
 		command_buffer,
+		core->source.model.get(),
 		core->pipeline_set.shadow_pipeline.single_side,
 		core->pipeline_set.shadow_pipeline.pipeline_layout,
 		bind_material,
@@ -672,6 +1026,7 @@ void App_render_logic::draw_shadow(uint32_t idx, const Command_buffer& command_b
 
 	const auto double_draw_params = Drawlist::Draw_params{
 		command_buffer,
+		core->source.model.get(),
 		core->pipeline_set.shadow_pipeline.double_side,
 		core->pipeline_set.shadow_pipeline.pipeline_layout,
 		bind_material,
@@ -682,85 +1037,159 @@ void App_render_logic::draw_shadow(uint32_t idx, const Command_buffer& command_b
 
 	const auto single_draw_params_skin = Drawlist::Draw_params{
 		command_buffer,
-		core->pipeline_set.shadow_pipeline.single_side_skin,
-		core->pipeline_set.shadow_pipeline.pipeline_layout_skin,
-		bind_material_skin,
+		core->source.model.get(),
+		core->pipeline_set.shadow_pipeline.single_side,
+		core->pipeline_set.shadow_pipeline.pipeline_layout,
+		bind_material,
 		bind_vertex_opaque_skin,
 		bind_vertex_skin,
 		bind_vertex_skin,
-		bind_node_skin
+		nullptr,
+		true
 	};
 
 	const auto double_draw_params_skin = Drawlist::Draw_params{
 		command_buffer,
-		core->pipeline_set.shadow_pipeline.double_side_skin,
-		core->pipeline_set.shadow_pipeline.pipeline_layout_skin,
-		bind_material_skin,
+		core->source.model.get(),
+		core->pipeline_set.shadow_pipeline.double_side,
+		core->pipeline_set.shadow_pipeline.pipeline_layout,
+		bind_material,
 		bind_vertex_opaque_skin,
 		bind_vertex_skin,
 		bind_vertex_skin,
-		bind_node_skin
+		nullptr,
+		true
 	};
 
-	command_buffer.begin();
-	for (const auto csm_idx : Iota(csm_count))
+	const auto drawlists = std::to_array<Drawlist_range_item>({
+		{shadow_generator[csm_idx].get_single_sided_drawlist(),      single_draw_params     },
+		{shadow_generator[csm_idx].get_double_sided_drawlist(),      double_draw_params     },
+		{shadow_generator[csm_idx].get_single_sided_skin_drawlist(), single_draw_params_skin},
+		{shadow_generator[csm_idx].get_double_sided_skin_drawlist(), double_draw_params_skin}
+	});
+
+	command_buffer.begin_secondary(
+		core->pipeline_set.shadow_pipeline.render_pass,
+		0,
+		core->render_targets[idx].shadow_rt.shadow_framebuffers[csm_idx]
+	);
 	{
-		core->env.debug_marker.begin_region(command_buffer, std::format("Render Shadow Map, Level {}", csm_idx), {1.0, 1.0, 0.0, 1.0});
-		command_buffer.begin_render_pass(
-			core->pipeline_set.shadow_pipeline.render_pass,
-			core->render_targets[idx].shadow_rt.shadow_framebuffers[csm_idx],
-			vk::Rect2D({0, 0}, {shadow_map_res[csm_idx], shadow_map_res[csm_idx]}),
-			{Shadow_pipeline::clear_value},
-			vk::SubpassContents::eInline
+		// Set Viewport and Scissors
+		command_buffer.set_viewport(
+			utility::flip_viewport(vk::Viewport(0, 0, shadow_map_res[csm_idx], shadow_map_res[csm_idx], 0.0, 1.0))
 		);
-		{
-			// Set Viewport and Scissors
-			command_buffer.set_viewport(
-				utility::flip_viewport(vk::Viewport(0, 0, shadow_map_res[csm_idx], shadow_map_res[csm_idx], 0.0, 1.0))
-			);
 
-			command_buffer.set_scissor({
-				{0,					   0					  },
-				{shadow_map_res[csm_idx], shadow_map_res[csm_idx]}
-			});
-
-			// Bind Matrices
-			command_buffer.bind_descriptor_sets(
-				vk::PipelineBindPoint::eGraphics,
-				core->pipeline_set.shadow_pipeline.pipeline_layout,
-				0,
-				{core->render_targets[idx].shadow_rt.shadow_matrix_descriptor_set[csm_idx]}
-			);
+		command_buffer.set_scissor({
+			{0,					   0					  },
+			{shadow_map_res[csm_idx], shadow_map_res[csm_idx]}
+		});
+
+		draw_drawlist_range(
+			command_buffer,
+			core->render_targets[idx].shadow_rt.shadow_matrix_descriptor_set[csm_idx],
+			drawlists,
+			first,
+			count
+		);
 
-			shadow_generator[csm_idx].get_single_sided_drawlist().draw(single_draw_params);
-			shadow_generator[csm_idx].get_double_sided_drawlist().draw(double_draw_params);
+		if (draw_indirect)
+		{
+			const auto single_draw_indirect_params = Drawlist::Draw_params{
+				command_buffer,
+				core->source.model.get(),
+				core->pipeline_set.shadow_pipeline.single_side_indirect,
+				core->pipeline_set.shadow_pipeline.pipeline_layout_indirect,
+				bind_material,
+				bind_vertex_opaque,
+				bind_vertex,
+				bind_vertex
+			};
+
+			const auto double_draw_indirect_params = Drawlist::Draw_params{
+				command_buffer,
+				core->source.model.get(),
+				core->pipeline_set.shadow_pipeline.double_side_indirect,
+				core->pipeline_set.shadow_pipeline.pipeline_layout_indirect,
+				bind_material,
+				bind_vertex_opaque,
+				bind_vertex,
+				bind_vertex
+			};
 
 			command_buffer.bind_descriptor_sets(
 				vk::PipelineBindPoint::eGraphics,
-				core->pipeline_set.shadow_pipeline.pipeline_layout_skin,
+				core->pipeline_set.shadow_pipeline.pipeline_layout_indirect,
 				0,
 				{core->render_targets[idx].shadow_rt.shadow_matrix_descriptor_set[csm_idx]}
 			);
 
-			shadow_generator[csm_idx].get_single_sided_skin_drawlist().draw(single_draw_params_skin);
-			shadow_generator[csm_idx].get_double_sided_skin_drawlist().draw(double_draw_params_skin);
+			// View 0 is the camera, cascades follow
+			gpu_culling.draw(
+				single_draw_indirect_params,
+				double_draw_indirect_params,
+				gpu_culling.get_shadow_set(core->render_targets.frame_idx),
+				csm_idx + 1,
+				core->render_targets.frame_idx
+			);
 		}
+	}
+	command_buffer.end();
+}
+
+void App_render_logic::execute_shadow(uint32_t idx, const Command_buffer_set& set)
+{
+	VKLIB_PROFILE_ZONE("Record Shadow");
+
+	const auto& command_buffer = set.shadow_command_buffer;
+	const auto  frame_idx      = core->render_targets.frame_idx;
+
+	command_buffer.begin();
+	core->render_targets[idx].graph.begin_pass(command_buffer, core->render_targets[idx].passes.shadow);
+	for (const auto csm_idx : Iota(csm_count))
+	{
+		core->env.debug_marker.begin_region(command_buffer, std::format("Render Shadow Map, Level {}", csm_idx), {1.0, 1.0, 0.0, 1.0});
+		gpu_profiler.begin(command_buffer, frame_idx, Gpu_profiler::shadow_stage(csm_idx));
+		command_buffer.begin_render_pass(
+			core->pipeline_set.shadow_pipeline.render_pass,
+			core->render_targets[idx].shadow_rt.shadow_framebuffers[csm_idx],
+			vk::Rect2D({0, 0}, {shadow_map_res[csm_idx], shadow_map_res[csm_idx]}),
+			{Shadow_pipeline::clear_value},
+			vk::SubpassContents::eSecondaryCommandBuffers
+		);
+		command_buffer.execute_commands(Command_buffer::to_vector(set.shadow_secondary_buffers[csm_idx]));
 		command_buffer.end_render_pass();
+		gpu_profiler.end(command_buffer, frame_idx, Gpu_profiler::shadow_stage(csm_idx));
 		core->env.debug_marker.end_region(command_buffer);
 	}
+	core->render_targets[idx].graph.end_pass(command_buffer, core->render_targets[idx].passes.shadow);
 	command_buffer.end();
 }
 
 void App_render_logic::compute_process(uint32_t idx, const Command_buffer& command_buffer)
 {
+	VKLIB_PROFILE_ZONE("Record Compute");
+
+	const auto frame_idx = core->render_targets.frame_idx;
+
 	command_buffer.begin();
+	core->render_targets[idx].graph.begin_pass(command_buffer, core->render_targets[idx].passes.compute);
+
+	gpu_profiler.begin(command_buffer, frame_idx, Gpu_profiler::Stage::Auto_exposure);
 	compute_auto_exposure(idx, command_buffer);
+	gpu_profiler.end(command_buffer, frame_idx, Gpu_profiler::Stage::Auto_exposure);
+
+	gpu_profiler.begin(command_buffer, frame_idx, Gpu_profiler::Stage::Bloom);
 	compute_bloom(idx, command_buffer);
+	gpu_profiler.end(command_buffer, frame_idx, Gpu_profiler::Stage::Bloom);
+
+	core->render_targets[idx].graph.end_pass(command_buffer, core->render_targets[idx].passes.compute);
 	command_buffer.end();
 }
 
 void App_render_logic::draw_lighting(uint32_t idx, const Command_buffer& command_buffer)
 {
+	VKLIB_PROFILE_ZONE("Record Lighting");
+
 	const auto draw_extent = vk::Rect2D({0, 0}, core->env.swapchain.extent);
 
 	auto set_viewport = [=, this](bool flip)
@@ -779,7 +1208,9 @@ void App_render_logic::draw_lighting(uint32_t idx, const Command_buffer& command
 
 	// Lighting Pass
 	command_buffer.begin();
+	core->render_targets[idx].graph.begin_pass(command_buffer, core->render_targets[idx].passes.lighting);
 	core->env.debug_marker.begin_region(command_buffer, "Render Lighting", {0.0, 0.0, 1.0, 1.0});
+	gpu_profiler.begin(command_buffer, core->render_targets.frame_idx, Gpu_profiler::Stage::Lighting);
 	command_buffer.begin_render_pass(
 		core->pipeline_set.lighting_pipeline.render_pass,
 		core->render_targets[idx].lighting_rt.framebuffer,
@@ -801,7 +1232,9 @@ void App_render_logic::draw_lighting(uint32_t idx, const Command_buffer& command
 		command_buffer.draw(0, 4, 0, 1);
 	}
 	command_buffer.end_render_pass();
+	gpu_profiler.end(command_buffer, core->render_targets.frame_idx, Gpu_profiler::Stage::Lighting);
 	core->env.debug_marker.end_region(command_buffer);
+	core->render_targets[idx].graph.end_pass(command_buffer, core->render_targets[idx].passes.lighting);
 	command_buffer.end();
 }
 
@@ -810,18 +1243,7 @@ void App_render_logic::compute_auto_exposure(uint32_t idx, const Command_buffer&
 	const auto g_queue_family = core->env.g_family_idx, c_queue_family = core->env.c_family_idx;
 
 	core->env.debug_marker.begin_region(command_buffer, "Compute Auto Exposure", {1.0, 0.0, 0.0, 1.0});
-	{  // Sync 1
-		const vk::ImageMemoryBarrier barrier(
-			vk::AccessFlagBits::eColorAttachmentWrite,
-			vk::AccessFlagBits::eShaderRead,
-			vk::ImageLayout::eGeneral,
-			vk::ImageLayout::eGeneral,
-			g_queue_family,
-			c_queue_family,
-			core->render_targets[idx].lighting_rt.brightness,
-			{vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1}
-		);
-
+	{  // Sync 1, brightness is acquired by the render graph
 		const vk::BufferMemoryBarrier buffer_barrier(
 			vk::AccessFlagBits::eShaderWrite,
 			vk::AccessFlagBits::eShaderWrite,
@@ -832,15 +1254,6 @@ void App_render_logic::compute_auto_exposure(uint32_t idx, const Command_buffer&
 			sizeof(Auto_exposure_compute_pipeline::Exposure_medium)
 		);
 
-		command_buffer->pipelineBarrier(
-			vk::PipelineStageFlagBits::eColorAttachmentOutput,
-			vk::PipelineStageFlagBits::eComputeShader,
-			vk::DependencyFlagBits::eByRegion,
-			{},
-			{},
-			{barrier}
-		);
-
 		command_buffer->pipelineBarrier(
 			vk::PipelineStageFlagBits::eComputeShader,
 			vk::PipelineStageFlagBits::eComputeShader,
@@ -914,7 +1327,7 @@ void App_render_logic::compute_auto_exposure(uint32_t idx, const Command_buffer&
 
 		Auto_exposure_compute_pipeline::Lerp_params params;
 		params.adapt_speed    = core->params.adapt_speed;
-		params.delta_time     = ImGui::GetIO().DeltaTime;
+		params.delta_time     = frame_delta;
 		params.min_luminance  = Auto_exposure_compute_pipeline::min_luminance;
 		params.max_luminance  = Auto_exposure_compute_pipeline::max_luminance;
 		params.texture_size_x = core->env.swapchain.extent.width;
@@ -952,14 +1365,14 @@ void App_render_logic::compute_auto_exposure(uint32_t idx, const Command_buffer&
 	core->env.debug_marker.end_region(command_buffer);
 }
 
-void App_render_logic::draw_ui(uint32_t idx, const Command_buffer& command_buffer)
+void App_render_logic::draw_ui(uint32_t image_idx, const Command_buffer& command_buffer)
 {
 	core->env.debug_marker.begin_region(command_buffer, "Draw IMGUI", {0.7, 0.0, 1.0, 1.0});
-	core->ui_controller.imgui_draw(core->env, command_buffer, idx, false);
+	core->ui_controller.imgui_draw(core->env, command_buffer, image_idx, false);
 	core->env.debug_marker.end_region(command_buffer);
 }
 
-void App_render_logic::execute_fxaa(uint32_t idx, const Command_buffer& command_buffer)
+void App_render_logic::execute_fxaa(uint32_t idx, uint32_t image_idx, const Command_buffer& command_buffer)
 {
 	const auto draw_extent = vk::Rect2D({0, 0}, core->env.swapchain.extent);
 
@@ -980,7 +1393,7 @@ void App_render_logic::execute_fxaa(uint32_t idx, const Command_buffer& command_
 	core->env.debug_marker.begin_region(command_buffer, "Execute FXAA", {0.0, 0.2, 1.0, 1.0});
 	command_buffer.begin_render_pass(
 		core->pipeline_set.fxaa_pipeline.render_pass,
-		core->render_targets[idx].fxaa_rt.framebuffer,
+		core->render_targets.present_rt[image_idx].framebuffer,
 		draw_extent,
 		{}
 	);
@@ -1004,70 +1417,48 @@ void App_render_logic::execute_fxaa(uint32_t idx, const Command_buffer& command_
 	core->env.debug_marker.end_region(command_buffer);
 }
 
-void App_render_logic::draw_swapchain(uint32_t idx, const Command_buffer& command_buffer)
+void App_render_logic::draw_swapchain(uint32_t idx, uint32_t image_idx, const Command_buffer& command_buffer)
 {
+	VKLIB_PROFILE_ZONE("Record Swapchain");
+
+	const auto frame_idx = core->render_targets.frame_idx;
+
 	command_buffer.begin();
 	{
+		const auto& rt = core->render_targets[idx];
+
 		// Draw Composite
+		rt.graph.begin_pass(command_buffer, rt.passes.composite);
+		gpu_profiler.begin(command_buffer, frame_idx, Gpu_profiler::Stage::Composite);
 		draw_composite(idx, command_buffer);
+		gpu_profiler.end(command_buffer, frame_idx, Gpu_profiler::Stage::Composite);
+		rt.graph.end_pass(command_buffer, rt.passes.composite);
 
 		// Execute AA
-		execute_fxaa(idx, command_buffer);
-
-		// Draw UI
-		draw_ui(idx, command_buffer);
+		rt.graph.begin_pass(command_buffer, rt.passes.fxaa);
+		gpu_profiler.begin(command_buffer, frame_idx, Gpu_profiler::Stage::Fxaa);
+		execute_fxaa(idx, image_idx, command_buffer);
+		gpu_profiler.end(command_buffer, frame_idx, Gpu_profiler::Stage::Fxaa);
+		rt.graph.end_pass(command_buffer, rt.passes.fxaa);
+
+		// Draw UI, stays empty in headless mode so every stage has its timestamps
+		gpu_profiler.begin(command_buffer, frame_idx, Gpu_profiler::Stage::Ui);
+		if (!core->env.features.headless) draw_ui(image_idx, command_buffer);
+		gpu_profiler.end(command_buffer, frame_idx, Gpu_profiler::Stage::Ui);
+
+		if (capture_frame) record_capture(image_idx, command_buffer);
 	}
 	command_buffer.end();
 }
 
 void App_render_logic::compute_bloom(uint32_t idx, const Command_buffer& command_buffer)
 {
-	const auto g_queue_family = core->env.g_family_idx, c_queue_family = core->env.c_family_idx;
-
 	const auto& rt        = core->render_targets[idx];
 	const auto& pipeline  = core->pipeline_set;
 	const auto& swapchain = core->env.swapchain;
 
 	core->env.debug_marker.begin_region(command_buffer, "Compute Bloom", {1.0, 0.0, 0.0, 1.0});
-	{  // Sync
-		command_buffer.layout_transit(
-			rt.lighting_rt.luminance,
-			vk::ImageLayout::eGeneral,
-			vk::ImageLayout::eGeneral,
-			vk::AccessFlagBits::eColorAttachmentWrite,
-			vk::AccessFlagBits::eShaderRead,
-			vk::PipelineStageFlagBits::eColorAttachmentOutput,
-			vk::PipelineStageFlagBits::eComputeShader,
-			{vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1},
-			vk::DependencyFlagBits::eByRegion,
-			g_queue_family,
-			c_queue_family
-		);
-
-		command_buffer.layout_transit(
-			rt.bloom_rt.bloom_downsample_chain,
-			vk::ImageLayout::eUndefined,
-			vk::ImageLayout::eGeneral,
-			vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eTransferWrite | vk::AccessFlagBits::eTransferRead,
-			vk::AccessFlagBits::eShaderWrite,
-			vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eTransfer,
-			vk::PipelineStageFlagBits::eComputeShader,
-			{vk::ImageAspectFlagBits::eColor, 0, bloom_downsample_count, 0, 1},
-			vk::DependencyFlagBits::eByRegion
-		);
-
-		command_buffer.layout_transit(
-			rt.bloom_rt.bloom_upsample_chain,
-			vk::ImageLayout::eUndefined,
-			vk::ImageLayout::eGeneral,
-			vk::AccessFlagBits::eShaderRead,
-			vk::AccessFlagBits::eShaderWrite,
-			vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eFragmentShader,
-			vk::PipelineStageFlagBits::eComputeShader,
-			{vk::ImageAspectFlagBits::eColor, 0, bloom_downsample_count - 2, 0, 1},
-			vk::DependencyFlagBits::eByRegion
-		);
-
+	{  // Sync, luminance and both chains are transitioned by the render graph
 		const vk::BufferMemoryBarrier exposure_barrier{
 			vk::AccessFlagBits::eShaderWrite,
 			vk::AccessFlagBits::eShaderRead,
@@ -1273,7 +1664,7 @@ void App_render_logic::compute_bloom(uint32_t idx, const Command_buffer& command
 					vk::AccessFlagBits::eShaderWrite,
 					vk::AccessFlagBits::eShaderRead,
 					vk::PipelineStageFlagBits::eComputeShader,
-					vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eFragmentShader,
+					vk::PipelineStageFlagBits::eComputeShader,
 					{vk::ImageAspectFlagBits::eColor, (uint32_t)i, 1, 0, 1},
 					vk::DependencyFlagBits::eByRegion
 				);
@@ -1281,21 +1672,6 @@ void App_render_logic::compute_bloom(uint32_t idx, const Command_buffer& command
 		}
 		core->env.debug_marker.end_region(command_buffer);
 	}
-
-	// Sync
-	command_buffer.layout_transit(
-		rt.lighting_rt.luminance,
-		vk::ImageLayout::eGeneral,
-		vk::ImageLayout::eShaderReadOnlyOptimal,
-		vk::AccessFlagBits::eShaderRead,
-		vk::AccessFlagBits::eShaderRead,
-		vk::PipelineStageFlagBits::eComputeShader,
-		vk::PipelineStageFlagBits::eFragmentShader,
-		{vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1},
-		vk::DependencyFlagBits::eByRegion,
-		c_queue_family,
-		g_queue_family
-	);
 	core->env.debug_marker.end_region(command_buffer);
 }
 
@@ -1355,10 +1731,39 @@ void App_render_logic::stat_panel()
 	);
 	{
 		ImGui::Text("Objects: G=%d/S=%d", gbuffer_object_count, shadow_object_count);
+		if (gpu_culling_active) ImGui::Text("GPU Culled Objects: %zu", gpu_culling.item_count());
 		ImGui::Text("Tris: G=%d/S=%d", gbuffer_vertex_count / 3, shadow_vertex_count / 3);
 		ImGui::Text("FPS: %.1f", framerate);
 		ImGui::Text("DT: %.1fms", dt * 1000);
 		ImGui::Text("CPU Time: %.0fus", cpu_time);
+
+		if (gpu_profiler.supported() && gpu_profiler.sample_count() > 0
+			&& ImGui::BeginTable("GPU Time", 4, ImGuiTableFlags_SizingFixedFit))
+		{
+			ImGui::TableSetupColumn("GPU Stage");
+			ImGui::TableSetupColumn("Avg");
+			ImGui::TableSetupColumn("P95");
+			ImGui::TableSetupColumn("P99");
+			ImGui::TableHeadersRow();
+
+			for (auto stage_idx : Iota(Gpu_profiler::stage_count))
+			{
+				const auto stage = Gpu_profiler::Stage(stage_idx);
+				const auto stats = gpu_profiler.statistics(stage);
+
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(Gpu_profiler::stage_name(stage).c_str());
+				ImGui::TableNextColumn();
+				ImGui::Text("%.2fms", stats.average);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.2fms", stats.p95);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.2fms", stats.p99);
+			}
+
+			ImGui::EndTable();
+		}
 	}
 	ImGui::End();
 }
@@ -1469,6 +1874,11 @@ void App_render_logic::lighting_tab()
 void App_render_logic::system_tab()
 {
 	ImGui::Checkbox("Stats Panel", &show_panel);
+
+	ImGui::BeginDisabled(!core->env.features.indirect_draw_enabled);
+	ImGui::Checkbox("GPU Culling", &core->params.gpu_culling);
+	ImGui::EndDisabled();
+
 	ImGui::Separator();
 
 	// Feature
@@ -1487,6 +1897,72 @@ void App_render_logic::system_tab()
 
 		display_enable_status("10-bit Output", core->env.swapchain.feature.color_depth_10_enabled);
 		display_enable_status("HDR Output", core->env.swapchain.feature.hdr_enabled);
+		display_enable_status("Indirect Draw", core->env.features.indirect_draw_enabled);
+		display_enable_status("Compact Gbuffer", core->env.features.compact_gbuffer_enabled);
+		display_enable_status("GPU Profiler", gpu_profiler.supported());
+
+		ImGui::TreePop();
+	}
+
+	// GPU Profiler
+	if (gpu_profiler.supported() && ImGui::TreeNode("GPU Profiler"))
+	{
+		ImGui::Text("Samples: %u/%u frames", gpu_profiler.sample_count(), Gpu_profiler::history_size);
+
+		if (ImGui::Button("Export CSV"))
+		{
+			const auto now  = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now());
+			const auto path = std::format("gpu-profile-{:%Y%m%d-%H%M%S}.csv", now);
+
+			try
+			{
+				gpu_profiler.export_csv(path);
+				gpu_profile_export_msg = std::format("Exported to {}", path);
+			}
+			catch (const error::Detailed_error& err)
+			{
+				gpu_profile_export_msg = std::format("Export failed: {}", err.detail);
+			}
+		}
+
+		if (!gpu_profile_export_msg.empty()) ImGui::TextWrapped("%s", gpu_profile_export_msg.c_str());
+
+		ImGui::TreePop();
+	}
+
+	// CPU Trace, zones are only recorded with the `vklib_profiler` build option
+	if (utility::Cpu_profiler::enabled && ImGui::TreeNode("CPU Trace"))
+	{
+		if (!utility::Cpu_profiler::capturing())
+		{
+			if (ImGui::Button("Start Capture"))
+			{
+				utility::Cpu_profiler::begin_capture();
+				cpu_trace_export_msg.clear();
+			}
+		}
+		else if (ImGui::Button("Stop & Export"))
+		{
+			utility::Cpu_profiler::end_capture();
+
+			const auto now  = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now());
+			const auto path = std::format("cpu-trace-{:%Y%m%d-%H%M%S}.json", now);
+
+			try
+			{
+				utility::Cpu_profiler::write_chrome_trace(path);
+				cpu_trace_export_msg = std::format("Exported to {}", path);
+
+				if (const auto dropped = utility::Cpu_profiler::dropped_count(); dropped > 0)
+					cpu_trace_export_msg += std::format(", {} events dropped", dropped);
+			}
+			catch (const error::Detailed_error& err)
+			{
+				cpu_trace_export_msg = std::format("Export failed: {}", err.detail);
+			}
+		}
+
+		if (!cpu_trace_export_msg.empty()) ImGui::TextWrapped("%s", cpu_trace_export_msg.c_str());
 
 		ImGui::TreePop();
 	}
@@ -1567,6 +2043,8 @@ void App_render_logic::preset_tab()
 
 void App_render_logic::ui_logic()
 {
+	VKLIB_PROFILE_ZONE("UI Logic");
+
 	auto&       params    = core->params;
 	const auto& swapchain = core->env.swapchain;
 
@@ -1625,11 +2103,13 @@ void App_render_logic::ui_logic()
 
 void App_render_logic::update_animation()
 {
+	VKLIB_PROFILE_ZONE("Update Animation");
+
 	if (selected_animation < 0) return;
 
 	const auto&  model     = *core->source.model;
 	const auto&  animation = model.animations[selected_animation];
-	const double now       = ImGui::GetTime();
+	const double now       = frame_time;
 
 	// assign animation time
 	if (animation_playing)
@@ -1651,13 +2131,17 @@ void App_render_logic::update_animation()
 		[&](uint32_t idx) -> vklib::io::gltf::Node_transformation&
 		{
 			if (!node_transformations[idx].has_value()) node_transformations[idx] = model.nodes[idx].transformation;
+			traverser.mark_dirty(idx);
 			return std::ref(node_transformations[idx].value());
-		}
+		},
+		&animation_cursors
 	);
 }
 
 void App_render_logic::upload_skin(uint32_t idx)
 {
+	VKLIB_PROFILE_ZONE("Upload Skin");
+
 	const auto& model = *core->source.model;
 
 	if (model.skins.empty()) return;
@@ -1673,7 +2157,11 @@ void App_render_logic::upload_skin(uint32_t idx)
 		}
 	}
 
-	core->source.stream_skin_data(core->env, command_buffers[idx].animation_update_command_buffer);
+	core->source.stream_skin_data(
+		core->env,
+		command_buffers[idx].animation_update_command_buffer,
+		core->render_targets.frame_idx
+	);
 }
 
 void App_render_logic::animation_tab()
@@ -1691,6 +2179,7 @@ void App_render_logic::animation_tab()
 			selected_animation = -1;
 			animation_playing  = false;
 			node_transformations.clear();
+			traverser.mark_all_dirty();
 		}
 
 		// Iterate over all animations
@@ -1705,6 +2194,8 @@ void App_render_logic::animation_tab()
 				selected_animation = i;
 				animation_playing  = false;
 				node_transformations.clear();
+				animation_cursors.clear();
+				traverser.mark_all_dirty();
 			}
 		}
 
@@ -1714,7 +2205,7 @@ void App_render_logic::animation_tab()
 	if (selected_animation < 0) return;
 
 	const auto&  animation = model.animations[selected_animation];
-	const double now       = ImGui::GetTime();
+	const double now       = frame_time;
 
 	ImGui::BulletText("Start Time: %.2fs", animation.start_time);
 	ImGui::BulletText("End Time: %.2fs", animation.end_time);
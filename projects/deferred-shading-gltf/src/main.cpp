@@ -31,13 +31,32 @@ const char* cut_filename(const char* filename)
 	}
 }
 
+// Parses `--gbuffer <compact|wide>`, compact is used when supported unless `wide` is given
+static bool parse_wide_gbuffer(int argc, char** argv)
+{
+	const std::vector<std::string_view> args(argv + 1, argv + argc);
+
+	const auto option = std::ranges::find(args, "--gbuffer");
+	if (option == args.end()) return false;
+
+	if (option + 1 == args.end()) throw error::Detailed_error("Missing value for --gbuffer");
+
+	const auto value = *(option + 1);
+	if (value != "compact" && value != "wide")
+		throw error::Detailed_error(std::format("Invalid value \"{}\" for --gbuffer, expected compact or wide", value));
+
+	return value == "wide";
+}
+
 #undef main
 
-int main(int argc [[maybe_unused]], char** argv [[maybe_unused]])
+int main(int argc, char** argv)
 {
 	std::signal(SIGSEGV, sig_handler_sigsev);
 	std::signal(SIGFPE, sig_handler_fpe);
 
+	VKLIB_PROFILE_THREAD_NAME("Main");
+
 	std::shared_ptr<Core> shared_resource;
 
 	auto show_error_msgbox = [shared_resource](const std::string& title, const std::string& content)
@@ -51,15 +70,28 @@ int main(int argc [[maybe_unused]], char** argv [[maybe_unused]])
 
 	try
 	{
-		shared_resource = std::make_shared<Core>();
+		const auto headless_config = Headless_config::parse(argc, argv);
+		const bool wide_gbuffer    = parse_wide_gbuffer(argc, argv);
+
+		std::shared_ptr<Application_logic_base> current_logic;
+
+		if (headless_config.has_value())
+		{
+			shared_resource = std::make_shared<Core>(headless_config->extent, wide_gbuffer);
+			current_logic   = std::make_shared<App_headless_logic>(shared_resource, headless_config.value());
+		}
+		else
+		{
+			shared_resource = std::make_shared<Core>(wide_gbuffer);
+			current_logic   = std::make_shared<App_idle_logic>(shared_resource);
+		}
 
-		std::shared_ptr<Application_logic_base> current_logic = std::make_shared<App_idle_logic>(shared_resource);
 		while (current_logic)
 		{
 			current_logic = current_logic->work();
 		}
 
-		terminate_sdl();
+		if (!headless_config.has_value()) terminate_sdl();
 
 		shared_resource = nullptr;
 
@@ -1,4 +1,6 @@
 #include "model-renderer.hpp"
+#include <bit>
+#include <numeric>
 
 #pragma region /* Node_traverser::Traverse_params */
 
@@ -9,30 +11,104 @@ void Node_traverser::Traverse_params::verify() const
 	error::Invalid_argument::check(scene_idx < model->scenes.size(), "params.scene_idx should be smaller than scene count");
 }
 
-void Node_traverser::traverse(const Traverse_params& params)
+void Node_traverser::flatten(const Traverse_params& params)
 {
-	const auto& model = *params.model;
+	model     = params.model;
+	scene_idx = params.scene_idx;
 
-	transform_list.resize(model.nodes.size(), {});
-	const auto& scene = model.scenes[params.scene_idx];
+	flat_nodes.clear();
+	flat_parents.clear();
 
-	for (const auto node_idx : scene.nodes)
+	for (const auto node_idx : model->scenes[scene_idx].nodes)
 	{
-		traverse(params, node_idx, params.base_transformation);
+		flat_nodes.push_back(node_idx);
+		flat_parents.push_back(-1);
+	}
+
+	// Breadth-first, so that every parent precedes its children
+	for (size_t i = 0; i < flat_nodes.size(); i++)
+	{
+		const auto node_idx = flat_nodes[i];
+
+		for (const auto child_idx : model->nodes[node_idx].children)
+		{
+			flat_nodes.push_back(child_idx);
+			flat_parents.push_back(node_idx);
+		}
 	}
+
+	translations.resize(flat_nodes.size());
+	rotations.resize(flat_nodes.size());
+	scales.resize(flat_nodes.size());
+
+	transform_list.assign(model->nodes.size(), {});
+	node_dirty.assign(model->nodes.size(), 1);
+	node_changed.assign(model->nodes.size(), 0);
+	any_dirty = true;
 }
 
-void Node_traverser::traverse(const Traverse_params& params, uint32_t node_idx, const glm::mat4& transform)
+void Node_traverser::mark_dirty(uint32_t node_idx)
 {
-	const auto& model = *params.model;
-	const auto& node  = model.nodes[node_idx];
-	const auto& find  = (*params.node_trans_lut)[node_idx];
+	// Ignored before the first traversal, where every node is dirty
+	if (node_idx >= node_dirty.size()) return;
 
-	const auto node_trans = transform * (find == std::nullopt ? node.transformation.get_mat4() : find.value().get_mat4());
+	node_dirty[node_idx] = 1;
+	any_dirty            = true;
+}
 
-	transform_list[node_idx] = {node_trans, true};
+void Node_traverser::mark_all_dirty()
+{
+	std::fill(node_dirty.begin(), node_dirty.end(), 1);
+	any_dirty = true;
+}
 
-	for (const auto idx : node.children) traverse(params, idx, node_trans);
+void Node_traverser::traverse(const Traverse_params& params)
+{
+	params.verify();
+
+	if (model != params.model || scene_idx != params.scene_idx) flatten(params);
+
+	if (base_transformation != params.base_transformation)
+	{
+		base_transformation = params.base_transformation;
+		mark_all_dirty();
+	}
+
+	// Nothing moved, and no changed flags left to clear
+	if (!any_dirty && !any_changed) return;
+
+	any_changed = false;
+
+	for (auto i : Iota(flat_nodes.size()))
+	{
+		const auto node_idx   = flat_nodes[i];
+		const auto parent_idx = flat_parents[i];
+
+		const bool local_dirty    = node_dirty[node_idx] != 0;
+		const bool parent_changed = parent_idx != (uint32_t)-1 && node_changed[parent_idx] != 0;
+
+		node_changed[node_idx] = local_dirty || parent_changed;
+		if (!node_changed[node_idx]) continue;
+
+		if (local_dirty)
+		{
+			const auto& find  = (*params.node_trans_lut)[node_idx];
+			const auto& local = find.has_value() ? find.value() : model->nodes[node_idx].transformation;
+
+			translations[i]      = local.translation;
+			rotations[i]         = local.rotation;
+			scales[i]            = local.scale;
+			node_dirty[node_idx] = 0;
+		}
+
+		const auto& parent_transform = parent_idx == (uint32_t)-1 ? base_transformation : transform_list[parent_idx].transform;
+		const auto  local_transform  = glm::translate(glm::mat4(1.0), translations[i]) * glm::scale(glm::mat4(rotations[i]), scales[i]);
+
+		transform_list[node_idx] = {parent_transform * local_transform, true};
+		any_changed              = true;
+	}
+
+	any_dirty = false;
 }
 
 #pragma endregion
@@ -88,19 +164,31 @@ void Drawlist::emplace(const Drawcall& drawcall, io::gltf::Alpha_mode mode)
 	}
 }
 
-void Drawlist::draw(const Draw_params& params) const
+void Drawlist::draw(const Draw_params& params, size_t first, size_t count) const
 {
-	auto draw = [&](const std::vector<Drawcall>&                draw_list,
+	error::Invalid_argument::check(params.model != nullptr, "params.model should be non-NULL");
+
+	size_t list_offset = 0;
+
+	auto draw = [&](const std::vector<Drawcall>&                list,
 					const Graphics_pipeline&                    pipeline,
 					const std::function<void(const Drawcall&)>& bind_vertex_func,
 					const std::function<void(const Drawcall&)>& bind_node_func)
 	{
+		// Clip [first, first + count) to the range of current list
+		const auto begin = std::clamp(first, list_offset, list_offset + list.size()),
+				   end   = std::clamp(first + count, list_offset, list_offset + list.size());
+
+		const auto draw_list = std::span(list).subspan(begin - list_offset, end - begin);
+		list_offset += list.size();
+
 		if (draw_list.empty()) return;
 
 		params.command_buffer.bind_pipeline(vk::PipelineBindPoint::eGraphics, pipeline);
 
-		uint32_t                               prev_node = -1, prev_vertex_buffer = -1, prev_offset = -1;
-		std::optional<std::optional<uint32_t>> prev_material = std::nullopt;
+		uint32_t                               prev_node = -1, prev_vertex_buffer = -1, prev_offset = -1, prev_index_buffer = -1;
+		std::optional<vk::IndexType>           prev_index_type = std::nullopt;
+		std::optional<std::optional<uint32_t>> prev_material   = std::nullopt;
 
 		for (const auto& drawcall : draw_list)
 		{
@@ -110,6 +198,7 @@ void Drawlist::draw(const Draw_params& params) const
 				params.command_buffer.push_constants(params.pipeline_layout, vk::ShaderStageFlagBits::eVertex, push_constants);
 
 				if (bind_node_func != nullptr) bind_node_func(drawcall);
+				if (params.vertex_per_node) prev_vertex_buffer = -1;
 
 				prev_node = drawcall.node_idx;
 			}
@@ -127,7 +216,21 @@ void Drawlist::draw(const Draw_params& params) const
 				prev_offset        = drawcall.primitive.position_offset;
 			}
 
-			params.command_buffer.draw(0, drawcall.primitive.vertex_count, 0, 1);
+			if (drawcall.primitive.index_buffer != prev_index_buffer || drawcall.primitive.index_type != prev_index_type)
+			{
+				const auto& index_buffers = drawcall.primitive.index_type == vk::IndexType::eUint16 ? params.model->index16_buffers
+																									: params.model->index32_buffers;
+
+				params.command_buffer.bind_index_buffer(
+					index_buffers[drawcall.primitive.index_buffer],
+					0,
+					drawcall.primitive.index_type
+				);
+				prev_index_buffer = drawcall.primitive.index_buffer;
+				prev_index_type   = drawcall.primitive.index_type;
+			}
+
+			params.command_buffer.draw_indexed(drawcall.primitive.index_offset, drawcall.primitive.index_count, 0, 0, 1);
 		}
 	};
 
@@ -140,117 +243,470 @@ void Drawlist::draw(const Draw_params& params) const
 
 #pragma endregion
 
-#pragma region /* Drawcall_generator::Gen_params */
+#pragma region /* Scene_bounds */
 
-void Drawcall_generator::Gen_params::verify() const
+void Scene_bounds::Build_params::verify() const
 {
 	error::Invalid_argument::check(model != nullptr, "params.model should be non-NULL");
 	error::Invalid_argument::check(node_traverser != nullptr, "params.node_traverser should be non-NULL");
 }
 
+void Scene_bounds::build(const Build_params& params)
+{
+	params.verify();
+
+	const bool model_changed = model != params.model;
+
+	model     = params.model;
+	traverser = params.node_traverser;
+
+	// Collect visible primitives
+	visible_keys.clear();
+
+	for (auto [node_idx, node] : Walk(model->nodes))
+	{
+		// Skip nodes without mesh
+		if (!node.mesh_idx || !(*traverser)[node_idx].traversed) continue;
+
+		for (const auto& primitive : model->meshes[node.mesh_idx.value()].primitives)
+		{
+			// skip primitives without geometry
+			if (primitive.enabled) visible_keys.emplace_back((uint32_t)node_idx, &primitive);
+		}
+	}
+
+	const auto task_count = params.thread_pool == nullptr ? 1 : (params.thread_pool->size() + 1) * 2;
+
+	// Visible primitives changed, rebuild the whole hierarchy
+	if (model_changed || visible_keys != item_keys)
+	{
+		std::swap(item_keys, visible_keys);
+
+		items.resize(item_keys.size());
+		item_min.resize(item_keys.size());
+		item_max.resize(item_keys.size());
+		bounding_boxes.resize(item_keys.size());
+
+		for (auto [i, key] : Walk(item_keys)) items[i] = {key.first, key.second, {}};
+
+		node_dirty.assign(model->nodes.size(), 1);
+
+		update_items(params.thread_pool, true);
+		build_hierarchy(task_count);
+		revision++;
+
+		return;
+	}
+
+	// Otherwise only items of moved nodes are updated. Skinned nodes are always updated, as their joints may move.
+	for (auto [node_idx, node] : Walk(model->nodes))
+		node_dirty[node_idx] = node.skin_idx.has_value() || traverser->changed(node_idx);
+
+	update_items(params.thread_pool, false);
+
+	for (auto [i, item] : Walk(items))
+		if (node_dirty[item.node_idx]) bvh_dirty[item_leaf[i]] = 1;
+
+	refit();
+}
+
+void Scene_bounds::update_items(utility::Thread_pool* thread_pool, bool all)
+{
+	const auto task_count = std::clamp<size_t>(
+		items.size() / min_items_per_task,
+		1,
+		thread_pool == nullptr ? 1 : thread_pool->size() + 1
+	);
+
+	auto update_func = [&](size_t task_idx)
+	{
+		for (auto i : Iota(task_idx * items.size() / task_count, (task_idx + 1) * items.size() / task_count))
+			if (all || node_dirty[items[i].node_idx]) update_item(i);
+	};
+
+	if (task_count > 1)
+		thread_pool->parallel_for(task_count, update_func);
+	else
+		update_func(0);
+}
+
+void Scene_bounds::update_item(size_t item_idx)
+{
+	auto&       item      = items[item_idx];
+	const auto& node      = model->nodes[item.node_idx];
+	const auto& primitive = *item.primitive;
+
+	const auto &min = primitive.min, &max = primitive.max;
+
+	/* Construct AABB after transformation */
+
+	glm::vec3 min_coord(std::numeric_limits<float>::max()), max_coord(-min_coord);
+
+	auto edge_points = algorithm::geometry::generate_boundaries(min, max);
+
+	if (node.skin_idx && primitive.skin)
+	{
+		const auto& skin = model->skins[node.skin_idx.value()];
+
+		// iterates over all joints, and get an oversized bounding box
+		for (auto [i, joint_idx] : Walk(skin.joints))
+		{
+			auto local_edge_points = edge_points;
+
+			for (auto& pt : local_edge_points)
+			{
+				const auto coord = (*traverser)[joint_idx].transform * skin.inverse_bind_matrices[i] * glm::vec4(pt, 1.0);
+				pt               = coord / coord.w;
+				min_coord        = glm::min(min_coord, pt);
+				max_coord        = glm::max(max_coord, pt);
+			}
+		}
+
+		edge_points = algorithm::geometry::generate_boundaries(min_coord, max_coord);
+	}
+	else
+	{
+		const auto node_trans = (*traverser)[item.node_idx].transform;
+
+		for (auto& pt : edge_points)
+		{
+			const auto coord = node_trans * glm::vec4(pt, 1.0);
+			pt               = coord / coord.w;
+			min_coord        = glm::min(min_coord, pt);
+			max_coord        = glm::max(max_coord, pt);
+		}
+	}
+
+	item.edge_points   = edge_points;
+	item_min[item_idx] = min_coord;
+	item_max[item_idx] = max_coord;
+	bounding_boxes.set(item_idx, algorithm::geometry::frustum::AABB::from_min_max(min_coord, max_coord));
+}
+
+void Scene_bounds::build_hierarchy(size_t task_count)
+{
+	bvh_nodes.clear();
+	task_roots.clear();
+
+	if (items.empty())
+	{
+		bvh_dirty.clear();
+		item_leaf.clear();
+		return;
+	}
+
+	std::vector<uint32_t> order(items.size());
+	std::iota(order.begin(), order.end(), 0u);
+
+	build_node(order, 0, (uint32_t)items.size(), -1);
+
+	// Reorder items, so that every leaf refers to a contiguous range
+	{
+		auto reorder = [&order]<typename T>(std::vector<T>& vec)
+		{
+			std::vector<T> sorted;
+			sorted.reserve(vec.size());
+
+			for (auto idx : order) sorted.push_back(std::move(vec[idx]));
+			vec = std::move(sorted);
+		};
+
+		reorder(items);
+		reorder(item_min);
+		reorder(item_max);
+
+		for (auto i : Iota(items.size()))
+			bounding_boxes.set(i, algorithm::geometry::frustum::AABB::from_min_max(item_min[i], item_max[i]));
+	}
+
+	item_leaf.resize(items.size());
+	for (auto [node_idx, node] : Walk(bvh_nodes))
+		if (node.is_leaf())
+			std::fill_n(item_leaf.begin() + node.first_item, node.item_count, (uint32_t)node_idx);
+
+	bvh_dirty.assign(bvh_nodes.size(), 0);
+
+	// Expand subtrees level by level until there are enough tasks
+	task_roots.push_back(0);
+
+	while (task_roots.size() < task_count)
+	{
+		std::vector<uint32_t> expanded;
+		expanded.reserve(task_roots.size() * 2);
+
+		for (auto root : task_roots)
+		{
+			const auto& node = bvh_nodes[root];
+
+			if (node.is_leaf())
+				expanded.push_back(root);
+			else
+			{
+				expanded.push_back(node.left);
+				expanded.push_back(node.right);
+			}
+		}
+
+		if (expanded.size() == task_roots.size()) break;  // All leaves
+		task_roots = std::move(expanded);
+	}
+}
+
+uint32_t Scene_bounds::build_node(std::vector<uint32_t>& order, uint32_t first, uint32_t count, uint32_t parent)
+{
+	const auto node_idx = (uint32_t)bvh_nodes.size();
+	bvh_nodes.emplace_back();
+
+	Bvh_node node;
+	node.parent = parent;
+
+	glm::vec3 centroid_min(std::numeric_limits<float>::max()), centroid_max(-centroid_min);
+
+	for (auto i : Iota(first, first + count))
+	{
+		const auto idx = order[i];
+
+		node.min     = glm::min(node.min, item_min[idx]);
+		node.max     = glm::max(node.max, item_max[idx]);
+		centroid_min = glm::min(centroid_min, (item_min[idx] + item_max[idx]) / 2.0f);
+		centroid_max = glm::max(centroid_max, (item_min[idx] + item_max[idx]) / 2.0f);
+	}
+
+	if (count <= max_leaf_items)
+	{
+		node.first_item = first;
+		node.item_count = count;
+	}
+	else
+	{
+		// Median split along the longest axis of centroids
+		const auto extent = centroid_max - centroid_min;
+		const auto axis   = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+		const auto mid    = first + count / 2;
+
+		std::nth_element(
+			order.begin() + first,
+			order.begin() + mid,
+			order.begin() + first + count,
+			[this, axis](uint32_t a, uint32_t b)
+			{
+				return item_min[a][axis] + item_max[a][axis] < item_min[b][axis] + item_max[b][axis];
+			}
+		);
+
+		node.left  = build_node(order, first, mid - first, node_idx);
+		node.right = build_node(order, mid, first + count - mid, node_idx);
+	}
+
+	bvh_nodes[node_idx] = node;
+	return node_idx;
+}
+
+void Scene_bounds::refit()
+{
+	// Children always have larger indices than their parent
+	for (auto node_idx = bvh_nodes.size(); node_idx-- > 0;)
+	{
+		if (!bvh_dirty[node_idx]) continue;
+		bvh_dirty[node_idx] = 0;
+
+		auto& node = bvh_nodes[node_idx];
+
+		if (node.is_leaf())
+		{
+			node.min = glm::vec3(std::numeric_limits<float>::max());
+			node.max = glm::vec3(-std::numeric_limits<float>::max());
+
+			for (auto i : Iota(node.first_item, node.first_item + node.item_count))
+			{
+				node.min = glm::min(node.min, item_min[i]);
+				node.max = glm::max(node.max, item_max[i]);
+			}
+		}
+		else
+		{
+			node.min = glm::min(bvh_nodes[node.left].min, bvh_nodes[node.right].min);
+			node.max = glm::max(bvh_nodes[node.left].max, bvh_nodes[node.right].max);
+		}
+
+		if (node.parent != (uint32_t)-1) bvh_dirty[node.parent] = 1;
+	}
+}
+
+#pragma endregion
+
+#pragma region /* Drawcall_generator::Gen_params */
+
+void Drawcall_generator::Gen_params::verify() const
+{
+	error::Invalid_argument::check(scene_bounds != nullptr, "params.scene_bounds should be non-NULL");
+}
+
 #pragma endregion
 
 #pragma region /* Drawcall_generator */
 
 Drawcall_generator::Gen_result Drawcall_generator::generate(const Gen_params& params)
 {
+	return generate(std::span(this, 1), std::span(&params, 1))[0];
+}
+
+std::vector<Drawcall_generator::Gen_result> Drawcall_generator::generate(
+	std::span<Drawcall_generator> generators,
+	std::span<const Gen_params>   params
+)
+{
+	error::Invalid_argument::check(generators.size() == params.size(), "generators and params should have the same size");
+	if (params.empty()) return {};
+
 	// Verify input parameters
-	params.verify();
+	for (const auto& param : params) param.verify();
+
+	const auto& task_roots  = params[0].scene_bounds->get_task_roots();
+	auto* const thread_pool = params[0].thread_pool;
+
+	for (auto& generator : generators) generator.task_outputs.resize(task_roots.size());
+
+	// Each subtree is tested against all frusta while its bounds are still in cache
+	auto cull_func = [&](size_t task_idx)
+	{
+		for (auto [i, generator] : Walk(generators)) generator.task_outputs[task_idx].cull(params[i], task_roots[task_idx]);
+	};
+
+	if (thread_pool != nullptr && task_roots.size() > 1)
+		thread_pool->parallel_for(task_roots.size(), cull_func);
+	else
+		for (auto task_idx : Iota(task_roots.size())) cull_func(task_idx);
+
+	std::vector<Gen_result> results;
+	results.reserve(generators.size());
+
+	for (auto& generator : generators) results.push_back(generator.merge());
+
+	return results;
+}
 
-	// initialize buffers
+Drawcall_generator::Gen_result Drawcall_generator::merge()
+{
 	single_sided.clear();
 	double_sided.clear();
 	single_sided_skin.clear();
 	double_sided_skin.clear();
 
+	// Merge tasks in order
 	Gen_result result;
-	const auto& model     = *params.model;
-	const auto& traverser = *params.node_traverser;
 
-	// Iterates over all nodes
-	for (auto [node_idx, node] : Walk(model.nodes))
+	for (const auto& output : task_outputs)
 	{
-		const auto node_trans = traverser[node_idx].transform;
+		result += output.result;
+		single_sided.append(output.single_sided);
+		double_sided.append(output.double_sided);
+		single_sided_skin.append(output.single_sided_skin);
+		double_sided_skin.append(output.double_sided_skin);
+	}
 
-		// Skip nodes without mesh
-		if (!node.mesh_idx || !traverser[node_idx].traversed) continue;
+	single_sided.sort();
+	double_sided.sort();
 
-		const auto& mesh = model.meshes[node.mesh_idx.value()];
+	return result;
+}
+
+void Drawcall_generator::Task_output::cull(const Gen_params& params, uint32_t root)
+{
+	single_sided.clear();
+	double_sided.clear();
+	single_sided_skin.clear();
+	double_sided_skin.clear();
+
+	const auto& scene_bounds = *params.scene_bounds;
+	const auto& model        = scene_bounds.get_model();
+	const auto& traverser    = scene_bounds.get_traverser();
+	const auto& items        = scene_bounds.get_items();
+	const auto& boxes        = scene_bounds.get_bounding_boxes();
+	const auto& bvh_nodes    = scene_bounds.get_bvh_nodes();
+
+	result              = {};
+	result.min_bounding = bvh_nodes[root].min;
+	result.max_bounding = bvh_nodes[root].max;
+
+	/* Hierarchical culling */
+
+	// Subtrees are only rejected by side planes; primitives outside near/far planes still contribute to near/far results
+	item_ranges.clear();
+	node_stack.assign(1, root);
+
+	while (!node_stack.empty())
+	{
+		const auto& node = bvh_nodes[node_stack.back()];
+		node_stack.pop_back();
 
-		for (const auto& primitive : mesh.primitives)
+		const auto box = algorithm::geometry::frustum::AABB::from_min_max(node.min, node.max);
+
+		if (!box.intersect_or_forward(params.frustum.bottom) || !box.intersect_or_forward(params.frustum.top)
+			|| !box.intersect_or_forward(params.frustum.left) || !box.intersect_or_forward(params.frustum.right))
+			continue;
+
+		if (!node.is_leaf())
 		{
-			// skip primitives without material
+			// Right pushed first, so that items are visited in order
+			node_stack.push_back(node.right);
+			node_stack.push_back(node.left);
+			continue;
+		}
 
-			const auto  material_idx = primitive.material_idx;
-			const auto& material     = primitive.material_idx ? model.materials[material_idx.value()] : model.materials.back();
+		if (!item_ranges.empty() && item_ranges.back().second == node.first_item)
+			item_ranges.back().second += node.item_count;
+		else
+			item_ranges.emplace_back(node.first_item, node.first_item + node.item_count);
+	}
 
-			const auto &min = primitive.min, &max = primitive.max;
+	/* Batched culling */
 
-			/* Construct AABB after transformation */
+	for (const auto [begin, end] : item_ranges)
+	{
+		side_mask.assign(end - begin, 1);
+		boxes.intersect_or_forward(params.frustum.bottom, side_mask, begin);
+		boxes.intersect_or_forward(params.frustum.top, side_mask, begin);
+		boxes.intersect_or_forward(params.frustum.left, side_mask, begin);
+		boxes.intersect_or_forward(params.frustum.right, side_mask, begin);
 
-			glm::vec3 min_coord(std::numeric_limits<float>::max()), max_coord(-min_coord);
-			float     near = std::numeric_limits<float>::max(), far = -near;
+		depth_mask = side_mask;
+		boxes.intersect_or_forward(params.frustum.far, depth_mask, begin);
+		boxes.intersect_or_forward(params.frustum.near, depth_mask, begin);
 
-			auto edge_points = algorithm::geometry::generate_boundaries(min, max);
+		/* Emit drawcalls */
 
-			if (node.skin_idx && primitive.skin)
-			{
-				const auto& skin = model.skins[node.skin_idx.value()];
-
-				// iterates over all joints, and get an oversized bounding box
-				for (auto [i, joint_idx] : Walk(skin.joints))
-				{
-					auto       local_edge_points = edge_points;
-
-					for (auto& pt : local_edge_points)
-					{
-						const auto coord = traverser[joint_idx].transform * skin.inverse_bind_matrices[i] * glm::vec4(pt, 1.0);
-						pt               = coord / coord.w;
-						min_coord        = glm::min(min_coord, pt);
-						max_coord        = glm::max(max_coord, pt);
-					}
-				}
-
-				edge_points = algorithm::geometry::generate_boundaries(min_coord, max_coord);
-			}
-			else
+		for (auto i : Iota(begin, end))
+		{
+			const auto& item = items[i];
+
+			// Calculate far & near plane
+			if (!side_mask[i - begin]) continue;
+
+			float near = std::numeric_limits<float>::max(), far = -near;
+
+			for (const auto& pt : item.edge_points)
 			{
-				for (auto& pt : edge_points)
-				{
-					const auto coord = node_trans * glm::vec4(pt, 1.0);
-					pt               = coord / coord.w;
-					min_coord        = glm::min(min_coord, pt);
-					max_coord        = glm::max(max_coord, pt);
-				}
+				far  = std::max(far, glm::dot(params.eye_path, pt - params.eye_position));
+				near = std::min(near, glm::dot(params.eye_path, pt - params.eye_position));
 			}
 
-			const auto bounding_box = algorithm::geometry::frustum::AABB::from_min_max(min_coord, max_coord);
+			result.near = std::min(near, result.near);
+			result.far  = std::max(far, result.far);
 
-			const auto edge_bounded
-				= bounding_box.intersect_or_forward(params.frustum.bottom) && bounding_box.intersect_or_forward(params.frustum.top)
-			   && bounding_box.intersect_or_forward(params.frustum.left) && bounding_box.intersect_or_forward(params.frustum.right);
+			if (!depth_mask[i - begin]) continue;
 
-			// Calculate far & near plane
-			if (edge_bounded)
-				for (const auto& pt : edge_points)
-				{
-					far  = std::max(far, glm::dot(params.eye_path, pt - params.eye_position));
-					near = std::min(near, glm::dot(params.eye_path, pt - params.eye_position));
-				}
-
-			result.near         = std::min(near, result.near);
-			result.far          = std::max(far, result.far);
-			result.min_bounding = glm::min(min_coord, result.min_bounding);
-			result.max_bounding = glm::max(max_coord, result.max_bounding);
-
-			if (!edge_bounded || !bounding_box.intersect_or_forward(params.frustum.far)
-				|| !bounding_box.intersect_or_forward(params.frustum.near))
-				continue;
+			const auto& primitive = *item.primitive;
+			if (params.skinned_only && !primitive.skin) continue;
+
+			const auto& material = primitive.material_idx ? model.materials[*primitive.material_idx] : model.materials.back();
 
 			result.object_count++;
-			result.vertex_count += primitive.vertex_count;
+			result.vertex_count += primitive.index_count;
 
-			const Drawcall drawcall{(uint32_t)node_idx, primitive, node_trans, near, far};
+			// Skinned primitives are drawn from pre-skinned, world-space vertices
+			const auto     transform = primitive.skin ? glm::mat4(1.0) : traverser[item.node_idx].transform;
+			const Drawcall drawcall{item.node_idx, primitive, transform, near, far};
 
 			auto& non_skin_side = material.double_sided ? double_sided : single_sided;
 			auto& skin_side     = material.double_sided ? double_sided_skin : single_sided_skin;
@@ -258,11 +714,277 @@ Drawcall_generator::Gen_result Drawcall_generator::generate(const Gen_params& pa
 			(primitive.skin ? skin_side : non_skin_side).emplace(drawcall, material.alpha_mode);
 		}
 	}
+}
 
-	single_sided.sort();
-	double_sided.sort();
+#pragma endregion
 
-	return result;
+#pragma region /* Gpu_culling */
+
+void Gpu_culling::build_batches(const Scene_bounds& scene_bounds)
+{
+	const auto& items = scene_bounds.get_items();
+
+	model          = &scene_bounds.get_model();
+	scene_revision = scene_bounds.get_revision();
+
+	auto get_material = [this](const io::gltf::Primitive& primitive) -> const io::gltf::Material&
+	{
+		return primitive.material_idx ? model->materials[primitive.material_idx.value()] : model->materials.back();
+	};
+
+	item_indices.clear();
+	for (auto [i, item] : Walk(items))
+		if (!item.primitive->skin) item_indices.push_back(i);
+
+	// Group items by pipeline, then material and primitive, so that instances of the same primitive are contiguous
+	auto sort_key = [&](uint32_t item_idx)
+	{
+		const auto& primitive = *items[item_idx].primitive;
+		const auto& material  = get_material(primitive);
+
+		return std::tuple(material.double_sided, material.alpha_mode, primitive.material_idx, items[item_idx].primitive);
+	};
+
+	std::stable_sort(
+		item_indices.begin(),
+		item_indices.end(),
+		[&](uint32_t a, uint32_t b)
+		{
+			return sort_key(a) < sort_key(b);
+		}
+	);
+
+	single_sided.clear();
+	double_sided.clear();
+
+	for (auto [command_idx, item_idx] : Walk(item_indices))
+	{
+		const auto& primitive = *items[item_idx].primitive;
+		const auto& material  = get_material(primitive);
+
+		auto& list = material.double_sided ? double_sided : single_sided;
+
+		auto& batches = material.alpha_mode == io::gltf::Alpha_mode::Opaque ? list.opaque
+					  : material.alpha_mode == io::gltf::Alpha_mode::Mask   ? list.mask
+																			  : list.blend;
+
+		if (!batches.empty() && batches.back().primitive == &primitive)
+			batches.back().command_count++;
+		else
+			batches.push_back({&primitive, (uint32_t)command_idx, 1});
+	}
+}
+
+void Gpu_culling::allocate(const Environment& env, const Pipeline_set& pipeline_set, Frame_data& frame, uint32_t capacity) const
+{
+	frame.capacity = capacity;
+
+	frame.item_buffer = Buffer(
+		env.allocator,
+		capacity * sizeof(Culling_pipeline::Cull_item),
+		vk::BufferUsageFlagBits::eStorageBuffer,
+		vk::SharingMode::eExclusive,
+		VMA_MEMORY_USAGE_CPU_TO_GPU
+	);
+	env.debug_marker.set_object_name(frame.item_buffer, "GPU Culling Item Buffer");
+
+	frame.matrix_buffer = Buffer(
+		env.allocator,
+		capacity * sizeof(glm::mat4),
+		vk::BufferUsageFlagBits::eStorageBuffer,
+		vk::SharingMode::eExclusive,
+		VMA_MEMORY_USAGE_CPU_TO_GPU
+	);
+	env.debug_marker.set_object_name(frame.matrix_buffer, "GPU Culling Model Matrix Buffer");
+
+	frame.view_buffer = Buffer(
+		env.allocator,
+		sizeof(Culling_pipeline::View_uniform),
+		vk::BufferUsageFlagBits::eUniformBuffer,
+		vk::SharingMode::eExclusive,
+		VMA_MEMORY_USAGE_CPU_TO_GPU
+	);
+	env.debug_marker.set_object_name(frame.view_buffer, "GPU Culling View Buffer");
+
+	frame.command_buffer = Buffer(
+		env.allocator,
+		view_count * capacity * sizeof(vk::DrawIndexedIndirectCommand),
+		vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer,
+		vk::SharingMode::eExclusive,
+		VMA_MEMORY_USAGE_GPU_ONLY
+	);
+	env.debug_marker.set_object_name(frame.command_buffer, "GPU Culling Command Buffer");
+
+	/* Descriptors */
+
+	const auto pool_sizes = std::to_array<vk::DescriptorPoolSize>({
+		{vk::DescriptorType::eStorageBuffer, 4},
+		{vk::DescriptorType::eUniformBuffer, 1}
+	});
+
+	frame.descriptor_pool = Descriptor_pool(env.device, pool_sizes, 3);
+
+	const auto descriptor_sets = Descriptor_set::create_multiple(
+		env.device,
+		frame.descriptor_pool,
+		{pipeline_set.culling_pipeline.descriptor_set_layout,
+		 pipeline_set.gbuffer_pipeline.descriptor_set_layout_indirect,
+		 pipeline_set.shadow_pipeline.descriptor_set_layout_indirect}
+	);
+
+	frame.cull_set    = descriptor_sets[0];
+	frame.gbuffer_set = descriptor_sets[1];
+	frame.shadow_set  = descriptor_sets[2];
+
+	const vk::DescriptorBufferInfo item_info{frame.item_buffer, 0, vk::WholeSize}, view_info{frame.view_buffer, 0, vk::WholeSize},
+		command_info{frame.command_buffer, 0, vk::WholeSize}, matrix_info{frame.matrix_buffer, 0, vk::WholeSize};
+
+	const auto writes = std::to_array<vk::WriteDescriptorSet>({
+		{frame.cull_set,    0, 0, 1, vk::DescriptorType::eStorageBuffer, nullptr, &item_info   },
+		{frame.cull_set,    1, 0, 1, vk::DescriptorType::eUniformBuffer, nullptr, &view_info   },
+		{frame.cull_set,    2, 0, 1, vk::DescriptorType::eStorageBuffer, nullptr, &command_info},
+		{frame.gbuffer_set, 0, 0, 1, vk::DescriptorType::eStorageBuffer, nullptr, &matrix_info },
+		{frame.shadow_set,  0, 0, 1, vk::DescriptorType::eStorageBuffer, nullptr, &matrix_info }
+	});
+
+	env.device->updateDescriptorSets(writes, {});
 }
 
-#pragma endregion
\ No newline at end of file
+void Gpu_culling::update(
+	const Environment&                                                 env,
+	const Pipeline_set&                                                pipeline_set,
+	const Scene_bounds&                                                scene_bounds,
+	std::span<const algorithm::geometry::frustum::Frustum, view_count> frusta,
+	uint32_t                                                           frame_idx
+)
+{
+	if (model != &scene_bounds.get_model() || scene_revision != scene_bounds.get_revision()) build_batches(scene_bounds);
+
+	auto& frame = frame_data[frame_idx];
+
+	// Buffers of this frame are no longer used by GPU, as its fence has been waited
+	if (frame.capacity < std::max<size_t>(item_indices.size(), 1))
+		allocate(env, pipeline_set, frame, std::bit_ceil(std::max<uint32_t>(item_indices.size(), 1)));
+
+	const auto& items     = scene_bounds.get_items();
+	const auto& item_min  = scene_bounds.get_item_min();
+	const auto& item_max  = scene_bounds.get_item_max();
+	const auto& traverser = scene_bounds.get_traverser();
+
+	auto* const cull_items = (Culling_pipeline::Cull_item*)frame.item_buffer.map_memory();
+	auto* const matrices   = (glm::mat4*)frame.matrix_buffer.map_memory();
+	{
+		for (auto [command_idx, item_idx] : Walk(item_indices))
+		{
+			const auto& item = items[item_idx];
+
+			cull_items[command_idx] = {
+				glm::vec4(item_min[item_idx], 1.0),
+				glm::vec4(item_max[item_idx], 1.0),
+				item.primitive->index_offset,
+				item.primitive->index_count,
+				{0, 0}
+			};
+			matrices[command_idx] = traverser[item.node_idx].transform;
+		}
+	}
+	frame.item_buffer.unmap_memory();
+	frame.matrix_buffer.unmap_memory();
+
+	Culling_pipeline::View_uniform view_uniform;
+	for (auto view_idx : Iota(view_count))
+	{
+		const auto& frustum = frusta[view_idx];
+		const auto  planes  = std::to_array({frustum.near, frustum.far, frustum.left, frustum.right, frustum.top, frustum.bottom});
+
+		for (auto [plane_idx, plane] : Walk(planes))
+			view_uniform.planes[view_idx * 6 + plane_idx] = glm::vec4(plane.normal, -glm::dot(plane.normal, plane.position));
+	}
+
+	auto* const mapped_views = (Culling_pipeline::View_uniform*)frame.view_buffer.map_memory();
+	*mapped_views            = view_uniform;
+	frame.view_buffer.unmap_memory();
+}
+
+void Gpu_culling::cull(const Command_buffer& command_buffer, const Culling_pipeline& pipeline, uint32_t frame_idx) const
+{
+	const auto& frame = frame_data[frame_idx];
+
+	if (item_indices.empty()) return;
+
+	const Culling_pipeline::Params params{(uint32_t)item_indices.size(), frame.capacity};
+	const auto                     group_count = (params.item_count + Culling_pipeline::workgroup_size - 1) / Culling_pipeline::workgroup_size;
+
+	command_buffer.bind_pipeline(vk::PipelineBindPoint::eCompute, pipeline.pipeline);
+	command_buffer.bind_descriptor_sets(vk::PipelineBindPoint::eCompute, pipeline.pipeline_layout, 0, {frame.cull_set});
+	command_buffer.push_constants(pipeline.pipeline_layout, vk::ShaderStageFlagBits::eCompute, params);
+	command_buffer->dispatch(group_count, view_count, 1);
+
+	// Sync [Indirect Read] after [Shader Write]
+	command_buffer.pipeline_barrier(
+		vk::PipelineStageFlagBits::eComputeShader,
+		vk::PipelineStageFlagBits::eDrawIndirect,
+		{vk::MemoryBarrier(vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eIndirectCommandRead)},
+		{},
+		{}
+	);
+}
+
+void Gpu_culling::draw(
+	const Drawlist::Draw_params& single_sided_params,
+	const Drawlist::Draw_params& double_sided_params,
+	vk::DescriptorSet            model_matrix_set,
+	uint32_t                     view,
+	uint32_t                     frame_idx
+) const
+{
+	const auto& frame = frame_data[frame_idx];
+
+	if (item_indices.empty()) return;
+
+	auto draw = [&](const std::vector<Batch>&                   batches,
+					const Drawlist::Draw_params&                params,
+					const Graphics_pipeline&                    pipeline,
+					const std::function<void(const Drawcall&)>& bind_vertex_func)
+	{
+		if (batches.empty()) return;
+
+		params.command_buffer.bind_pipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+		params.command_buffer.bind_descriptor_sets(vk::PipelineBindPoint::eGraphics, params.pipeline_layout, 2, {model_matrix_set});
+
+		std::optional<std::optional<uint32_t>> prev_material = std::nullopt;
+
+		for (const auto& batch : batches)
+		{
+			const Drawcall drawcall{0, *batch.primitive, glm::mat4(1.0), 0, 0};
+
+			if (!prev_material.has_value() || batch.primitive->material_idx != prev_material.value())
+			{
+				params.bind_material_func(drawcall);
+				prev_material = batch.primitive->material_idx;
+			}
+
+			bind_vertex_func(drawcall);
+
+			const auto& index_buffers
+				= batch.primitive->index_type == vk::IndexType::eUint16 ? params.model->index16_buffers : params.model->index32_buffers;
+			params.command_buffer.bind_index_buffer(index_buffers[batch.primitive->index_buffer], 0, batch.primitive->index_type);
+
+			params.command_buffer.draw_indexed_indirect(
+				frame.command_buffer,
+				(view * frame.capacity + batch.first_command) * sizeof(vk::DrawIndexedIndirectCommand),
+				batch.command_count,
+				sizeof(vk::DrawIndexedIndirectCommand)
+			);
+		}
+	};
+
+	for (const auto& [list, params] : {std::pair(&single_sided, &single_sided_params), std::pair(&double_sided, &double_sided_params)})
+	{
+		draw(list->opaque, *params, params->pipeline_set.opaque, params->bind_vertex_func_opaque);
+		draw(list->mask, *params, params->pipeline_set.mask, params->bind_vertex_func_mask);
+		draw(list->blend, *params, params->pipeline_set.blend, params->bind_vertex_func_blend);
+	}
+}
+
+#pragma endregion
@@ -95,13 +95,13 @@ void Shadow_pipeline::create(const Environment& env)
 		env.debug_marker.set_object_name(descriptor_set_layout_texture, "Shadow Descriptor Set Layout (Texture)");
 	}
 
-	//* Joint Weight DS Layout
+	//* Indirect Model Matrix DS Layout
 	{
 		const auto layout_binding
 			= vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eVertex);
 
-		descriptor_set_layout_skin = Descriptor_set_layout(env.device, {layout_binding});
-		env.debug_marker.set_object_name(descriptor_set_layout_skin, "Shadow Descriptor Set Layout (Skin)");
+		descriptor_set_layout_indirect = Descriptor_set_layout(env.device, {layout_binding});
+		env.debug_marker.set_object_name(descriptor_set_layout_indirect, "Shadow Descriptor Set Layout (Indirect)");
 	}
 
 	//* Pipeline layout
@@ -115,12 +115,13 @@ void Shadow_pipeline::create(const Environment& env)
 			= Pipeline_layout(env.device, {descriptor_set_layout_shadow_matrix, descriptor_set_layout_texture}, push_constant_range);
 		env.debug_marker.set_object_name(pipeline_layout, "Shadow Pipeline Layout");
 
-		pipeline_layout_skin = Pipeline_layout(
+		// Push constant is kept, so that set 0 and 1 stay compatible with `pipeline_layout`
+		pipeline_layout_indirect = Pipeline_layout(
 			env.device,
-			{descriptor_set_layout_shadow_matrix, descriptor_set_layout_texture, descriptor_set_layout_skin},
+			{descriptor_set_layout_shadow_matrix, descriptor_set_layout_texture, descriptor_set_layout_indirect},
 			push_constant_range
 		);
-		env.debug_marker.set_object_name(pipeline_layout_skin, "Shadow Pipeline Layout (Skin)");
+		env.debug_marker.set_object_name(pipeline_layout_indirect, "Shadow Pipeline Layout (Indirect)");
 	}
 
 	//* Graphics Pipeline
@@ -129,18 +130,19 @@ void Shadow_pipeline::create(const Environment& env)
 
 		// Shaders
 		const Shader_module vert_shader = GET_SHADER_MODULE(shadow_vert), frag_shader = GET_SHADER_MODULE(shadow_frag),
-							opaque_vert_shader      = GET_SHADER_MODULE(shadow_opaque_vert),
-							skin_vert_shader        = GET_SHADER_MODULE(shadow_skin_vert),
-							skin_opaque_vert_shader = GET_SHADER_MODULE(shadow_skin_opaque_vert);
+							opaque_vert_shader          = GET_SHADER_MODULE(shadow_opaque_vert),
+							indirect_vert_shader        = GET_SHADER_MODULE(shadow_indirect_vert),
+							indirect_opaque_vert_shader = GET_SHADER_MODULE(shadow_opaque_indirect_vert);
 
 		auto shader_module_infos = std::to_array(
 			{vert_shader.stage_info(vk::ShaderStageFlagBits::eVertex), frag_shader.stage_info(vk::ShaderStageFlagBits::eFragment)}
 		);
-		auto shader_skin_module_infos = std::to_array(
-			{skin_vert_shader.stage_info(vk::ShaderStageFlagBits::eVertex), frag_shader.stage_info(vk::ShaderStageFlagBits::eFragment)}
-		);
 		const auto opaque_module_infos = std::to_array({opaque_vert_shader.stage_info(vk::ShaderStageFlagBits::eVertex)});
-		const auto opaque_skin_module_infos = std::to_array({skin_opaque_vert_shader.stage_info(vk::ShaderStageFlagBits::eVertex)});
+		auto shader_indirect_module_infos = std::to_array(
+			{indirect_vert_shader.stage_info(vk::ShaderStageFlagBits::eVertex), frag_shader.stage_info(vk::ShaderStageFlagBits::eFragment)}
+		);
+		const auto opaque_indirect_module_infos
+			= std::to_array({indirect_opaque_vert_shader.stage_info(vk::ShaderStageFlagBits::eVertex)});
 		create_info.setStages(shader_module_infos);
 
 		// Shader specialization
@@ -158,7 +160,7 @@ void Shadow_pipeline::create(const Environment& env)
 			= vk::SpecializationInfo().setDataSize(sizeof(spec_map)).setPData(&spec_map).setMapEntries(constant_entries);
 
 		shader_module_infos[1].setPSpecializationInfo(&specialization_info);
-		shader_skin_module_infos[1].setPSpecializationInfo(&specialization_info);
+		shader_indirect_module_infos[1].setPSpecializationInfo(&specialization_info);
 
 		/* Vertex Input Attribute */
 
@@ -169,17 +171,6 @@ void Shadow_pipeline::create(const Environment& env)
 		std::array<vk::VertexInputAttributeDescription, 1> opaque_attributes;
 		opaque_attributes[0].setBinding(0).setFormat(vk::Format::eR32G32B32Sfloat).setLocation(0).setOffset(0);  // in_position
 
-		std::array<vk::VertexInputAttributeDescription, 4> skin_attributes;
-		skin_attributes[0].setBinding(0).setFormat(vk::Format::eR32G32B32Sfloat).setLocation(0).setOffset(0);     // in_position
-		skin_attributes[1].setBinding(1).setFormat(vk::Format::eR32G32Sfloat).setLocation(1).setOffset(0);        // in_texcoord
-		skin_attributes[2].setBinding(2).setFormat(vk::Format::eR16G16B16A16Uint).setLocation(2).setOffset(0);    // in_joints
-		skin_attributes[3].setBinding(3).setFormat(vk::Format::eR32G32B32A32Sfloat).setLocation(3).setOffset(0);  // in_weights
-
-		std::array<vk::VertexInputAttributeDescription, 3> skin_opaque_attributes;
-		skin_opaque_attributes[0].setBinding(0).setFormat(vk::Format::eR32G32B32Sfloat).setLocation(0).setOffset(0);     // in_position
-		skin_opaque_attributes[1].setBinding(1).setFormat(vk::Format::eR16G16B16A16Uint).setLocation(1).setOffset(0);    // in_joints
-		skin_opaque_attributes[2].setBinding(2).setFormat(vk::Format::eR32G32B32A32Sfloat).setLocation(2).setOffset(0);  // in_weights
-
 		/* Vertex Binding */
 
 		std::array<vk::VertexInputBindingDescription, 2> bindings;
@@ -189,17 +180,6 @@ void Shadow_pipeline::create(const Environment& env)
 		std::array<vk::VertexInputBindingDescription, 1> opaque_bindings;
 		opaque_bindings[0].setBinding(0).setInputRate(vk::VertexInputRate::eVertex).setStride(sizeof(glm::vec3));  // in_position
 
-		std::array<vk::VertexInputBindingDescription, 4> skin_bindings;
-		skin_bindings[0].setBinding(0).setInputRate(vk::VertexInputRate::eVertex).setStride(sizeof(glm::vec3));     // in_position
-		skin_bindings[1].setBinding(1).setInputRate(vk::VertexInputRate::eVertex).setStride(sizeof(glm::vec2));     // in_texcoord
-		skin_bindings[2].setBinding(2).setInputRate(vk::VertexInputRate::eVertex).setStride(sizeof(glm::u16vec4));  // in_joints
-		skin_bindings[3].setBinding(3).setInputRate(vk::VertexInputRate::eVertex).setStride(sizeof(glm::vec4));     // in_weights
-
-		std::array<vk::VertexInputBindingDescription, 3> skin_opaque_bindings;
-		skin_opaque_bindings[0].setBinding(0).setInputRate(vk::VertexInputRate::eVertex).setStride(sizeof(glm::vec3));  // in_position
-		skin_opaque_bindings[1].setBinding(1).setInputRate(vk::VertexInputRate::eVertex).setStride(sizeof(glm::u16vec4));  // in_joints
-		skin_opaque_bindings[2].setBinding(2).setInputRate(vk::VertexInputRate::eVertex).setStride(sizeof(glm::vec4));  // in_weights
-
 		/* Vertex Input State */
 
 		auto vertex_input_state = vk::PipelineVertexInputStateCreateInfo()
@@ -208,12 +188,6 @@ void Shadow_pipeline::create(const Environment& env)
 		auto opaque_vertex_input_state = vk::PipelineVertexInputStateCreateInfo()
 											 .setVertexAttributeDescriptions(opaque_attributes)
 											 .setVertexBindingDescriptions(opaque_bindings);
-		auto skin_vertex_input_state = vk::PipelineVertexInputStateCreateInfo()
-										   .setVertexAttributeDescriptions(skin_attributes)
-										   .setVertexBindingDescriptions(skin_bindings);
-		auto skin_opaque_vertex_input_state = vk::PipelineVertexInputStateCreateInfo()
-												  .setVertexAttributeDescriptions(skin_opaque_attributes)
-												  .setVertexBindingDescriptions(skin_opaque_bindings);
 
 		create_info.setPVertexInputState(&vertex_input_state);
 
@@ -258,15 +232,11 @@ void Shadow_pipeline::create(const Environment& env)
 		auto opaque_create_info = create_info;
 		opaque_create_info.setStages(opaque_module_infos).setPVertexInputState(&opaque_vertex_input_state);
 
-		auto skin_create_info = create_info;
-		skin_create_info.setStages(shader_skin_module_infos)
-			.setPVertexInputState(&skin_vertex_input_state)
-			.setLayout(pipeline_layout_skin);
+		auto indirect_create_info = create_info;
+		indirect_create_info.setStages(shader_indirect_module_infos).setLayout(pipeline_layout_indirect);
 
-		auto skin_opaque_create_info = create_info;
-		skin_opaque_create_info.setStages(opaque_skin_module_infos)
-			.setPVertexInputState(&skin_opaque_vertex_input_state)
-			.setLayout(pipeline_layout_skin);
+		auto indirect_opaque_create_info = opaque_create_info;
+		indirect_opaque_create_info.setStages(opaque_indirect_module_infos).setLayout(pipeline_layout_indirect);
 
 		//* Single Sided
 
@@ -283,18 +253,18 @@ void Shadow_pipeline::create(const Environment& env)
 		single_side.blend           = Graphics_pipeline(env.device, create_info);
 		env.debug_marker.set_object_name(single_side.blend, "Shadow Pipeline (Single Sided Blend)");
 
-		// Single sided with skin
+		// Single sided with indirect drawcalls
 
-		single_side_skin.opaque = Graphics_pipeline(env.device, skin_opaque_create_info);
-		env.debug_marker.set_object_name(single_side_skin.opaque, "Shadow Pipeline (Single Sided Opaque Skin)");
+		single_side_indirect.opaque = Graphics_pipeline(env.device, indirect_opaque_create_info);
+		env.debug_marker.set_object_name(single_side_indirect.opaque, "Shadow Pipeline (Single Sided Opaque Indirect)");
 
-		spec_map              = {true, false};
-		single_side_skin.mask = Graphics_pipeline(env.device, skin_create_info);
-		env.debug_marker.set_object_name(single_side.mask, "Shadow Pipeline (Single Sided Alpha Skin)");
+		spec_map                  = {true, false};
+		single_side_indirect.mask = Graphics_pipeline(env.device, indirect_create_info);
+		env.debug_marker.set_object_name(single_side_indirect.mask, "Shadow Pipeline (Single Sided Alpha Indirect)");
 
-		spec_map               = {false, true};
-		single_side_skin.blend = Graphics_pipeline(env.device, skin_create_info);
-		env.debug_marker.set_object_name(single_side_skin.blend, "Shadow Pipeline (Single Sided Blend Skin)");
+		spec_map                   = {false, true};
+		single_side_indirect.blend = Graphics_pipeline(env.device, indirect_create_info);
+		env.debug_marker.set_object_name(single_side_indirect.blend, "Shadow Pipeline (Single Sided Blend Indirect)");
 
 		//* Double Sided
 		rasterization_state.setCullMode(vk::CullModeFlagBits::eNone).setDepthBiasConstantFactor(1.25).setDepthBiasSlopeFactor(1.75);
@@ -312,18 +282,18 @@ void Shadow_pipeline::create(const Environment& env)
 		double_side.blend           = Graphics_pipeline(env.device, create_info);
 		env.debug_marker.set_object_name(double_side.blend, "Shadow Pipeline (Double Sided Blend)");
 
-		// Double sided with skin
+		// Double sided with indirect drawcalls
 
-		double_side_skin.opaque = Graphics_pipeline(env.device, skin_opaque_create_info);
-		env.debug_marker.set_object_name(double_side_skin.opaque, "Shadow Pipeline (Double Sided Opaque Skin)");
+		double_side_indirect.opaque = Graphics_pipeline(env.device, indirect_opaque_create_info);
+		env.debug_marker.set_object_name(double_side_indirect.opaque, "Shadow Pipeline (Double Sided Opaque Indirect)");
 
-		spec_map              = {true, false};
-		double_side_skin.mask = Graphics_pipeline(env.device, skin_create_info);
-		env.debug_marker.set_object_name(double_side_skin.mask, "Shadow Pipeline (Double Sided Alpha Skin)");
+		spec_map                  = {true, false};
+		double_side_indirect.mask = Graphics_pipeline(env.device, indirect_create_info);
+		env.debug_marker.set_object_name(double_side_indirect.mask, "Shadow Pipeline (Double Sided Alpha Indirect)");
 
-		spec_map               = {false, true};
-		double_side_skin.blend = Graphics_pipeline(env.device, skin_create_info);
-		env.debug_marker.set_object_name(double_side_skin.blend, "Shadow Pipeline (Double Sided Blend Skin)");
+		spec_map                   = {false, true};
+		double_side_indirect.blend = Graphics_pipeline(env.device, indirect_create_info);
+		env.debug_marker.set_object_name(double_side_indirect.blend, "Shadow Pipeline (Double Sided Blend Indirect)");
 	}
 }
 
@@ -344,7 +314,9 @@ void Gbuffer_pipeline::create(const Environment& env)
 	//* Render Pass
 	{
 		std::array<vk::AttachmentDescription, 5> attachment_descriptions;
-		const auto formats = std::to_array({normal_format, color_format, pbr_format, emissive_format, depth_format});
+		const auto& gbuffer_formats = formats(env);
+		const auto  attachment_formats
+			= std::to_array({gbuffer_formats.normal, gbuffer_formats.color, gbuffer_formats.pbr, gbuffer_formats.emissive, depth_format});
 
 		for (auto i : Iota(5))
 			attachment_descriptions[i]
@@ -353,7 +325,7 @@ void Gbuffer_pipeline::create(const Environment& env)
 				.setLoadOp(vk::AttachmentLoadOp::eClear)
 				.setStoreOp(vk::AttachmentStoreOp::eStore)
 				.setSamples(vk::SampleCountFlagBits::e1)
-				.setFormat(formats[i])
+				.setFormat(attachment_formats[i])
 				.setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
 				.setStencilStoreOp(vk::AttachmentStoreOp::eDontCare);
 
@@ -464,12 +436,12 @@ void Gbuffer_pipeline::create(const Environment& env)
 		descriptor_set_layout_texture = Descriptor_set_layout(env.device, layout_bindings);
 	}
 
-	{  // Skin
+	{  // Indirect model matrices
 		const auto layout_binding
 			= vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eVertex);
 
-		descriptor_set_layout_skin = Descriptor_set_layout(env.device, {layout_binding});
-		env.debug_marker.set_object_name(descriptor_set_layout_skin, "Gbuffer Descriptor Set Layout (Skin)");
+		descriptor_set_layout_indirect = Descriptor_set_layout(env.device, {layout_binding});
+		env.debug_marker.set_object_name(descriptor_set_layout_indirect, "Gbuffer Descriptor Set Layout (Indirect)");
 	}
 
 	//* Pipeline Layout
@@ -484,12 +456,13 @@ void Gbuffer_pipeline::create(const Environment& env)
 		pipeline_layout = Pipeline_layout(env.device, descriptor_set_layouts, push_constant_range);
 		env.debug_marker.set_object_name(pipeline_layout, "Gbuffer Pipeline Layout");
 
-		pipeline_layout_skin = Pipeline_layout(
+		// Push constant is kept, so that set 0 and 1 stay compatible with `pipeline_layout`
+		pipeline_layout_indirect = Pipeline_layout(
 			env.device,
-			{descriptor_set_layout_camera, descriptor_set_layout_texture, descriptor_set_layout_skin},
+			{descriptor_set_layout_camera, descriptor_set_layout_texture, descriptor_set_layout_indirect},
 			push_constant_range
 		);
-		env.debug_marker.set_object_name(pipeline_layout_skin, "Gbuffer Pipeline Layout (Skin)");
+		env.debug_marker.set_object_name(pipeline_layout_indirect, "Gbuffer Pipeline Layout (Indirect)");
 	}
 
 	//* Graphics Pipeline
@@ -498,13 +471,13 @@ void Gbuffer_pipeline::create(const Environment& env)
 
 		// Shaders
 		const Shader_module vert_shader = GET_SHADER_MODULE(gbuffer_vert), frag_shader = GET_SHADER_MODULE(gbuffer_frag),
-							skin_vert_shader = GET_SHADER_MODULE(gbuffer_skin_vert);
+							indirect_vert_shader = GET_SHADER_MODULE(gbuffer_indirect_vert);
 
 		auto shader_module_infos = std::to_array(
 			{vert_shader.stage_info(vk::ShaderStageFlagBits::eVertex), frag_shader.stage_info(vk::ShaderStageFlagBits::eFragment)}
 		);
-		auto skin_shader_module_infos = std::to_array(
-			{skin_vert_shader.stage_info(vk::ShaderStageFlagBits::eVertex), frag_shader.stage_info(vk::ShaderStageFlagBits::eFragment)}
+		auto indirect_shader_module_infos = std::to_array(
+			{indirect_vert_shader.stage_info(vk::ShaderStageFlagBits::eVertex), frag_shader.stage_info(vk::ShaderStageFlagBits::eFragment)}
 		);
 		create_info.setStages(shader_module_infos);
 
@@ -513,17 +486,21 @@ void Gbuffer_pipeline::create(const Environment& env)
 		{
 			VkBool32 alpha_cutoff = false;
 			VkBool32 alpha_blend  = false;
+			VkBool32 compact      = false;
 		} spec_map;
 
+		const VkBool32 compact = env.features.compact_gbuffer_enabled;
+
 		const auto constant_entries = std::to_array({
 			vk::SpecializationMapEntry{0, offsetof(Spec_map, alpha_cutoff), sizeof(Spec_map::alpha_cutoff)},
 			vk::SpecializationMapEntry{1, offsetof(Spec_map, alpha_blend),  sizeof(Spec_map::alpha_blend) },
+			vk::SpecializationMapEntry{2, offsetof(Spec_map, compact),      sizeof(Spec_map::compact)     },
 		});
 		const auto specialization_info
 			= vk::SpecializationInfo().setDataSize(sizeof(spec_map)).setPData(&spec_map).setMapEntries(constant_entries);
 
 		shader_module_infos[1].setPSpecializationInfo(&specialization_info);
-		skin_shader_module_infos[1].setPSpecializationInfo(&specialization_info);
+		indirect_shader_module_infos[1].setPSpecializationInfo(&specialization_info);
 
 		// Vertex Input State
 
@@ -535,16 +512,6 @@ void Gbuffer_pipeline::create(const Environment& env)
 			attributes[3].setBinding(3).setFormat(vk::Format::eR32G32B32Sfloat).setLocation(3).setOffset(0);
 		}
 
-		std::array<vk::VertexInputAttributeDescription, 6> skin_attributes;
-		{
-			skin_attributes[0].setBinding(0).setFormat(vk::Format::eR32G32B32Sfloat).setLocation(0).setOffset(0);
-			skin_attributes[1].setBinding(1).setFormat(vk::Format::eR32G32B32Sfloat).setLocation(1).setOffset(0);
-			skin_attributes[2].setBinding(2).setFormat(vk::Format::eR32G32Sfloat).setLocation(2).setOffset(0);
-			skin_attributes[3].setBinding(3).setFormat(vk::Format::eR32G32B32Sfloat).setLocation(3).setOffset(0);
-			skin_attributes[4].setBinding(4).setFormat(vk::Format::eR16G16B16A16Uint).setLocation(4).setOffset(0);
-			skin_attributes[5].setBinding(5).setFormat(vk::Format::eR32G32B32A32Sfloat).setLocation(5).setOffset(0);
-		}
-
 		std::array<vk::VertexInputBindingDescription, 4> bindings;
 		{
 			bindings[0].setBinding(0).setInputRate(vk::VertexInputRate::eVertex).setStride(sizeof(glm::vec3));
@@ -553,22 +520,9 @@ void Gbuffer_pipeline::create(const Environment& env)
 			bindings[3].setBinding(3).setInputRate(vk::VertexInputRate::eVertex).setStride(sizeof(glm::vec3));
 		}
 
-		std::array<vk::VertexInputBindingDescription, 6> skin_bindings;
-		{
-			skin_bindings[0].setBinding(0).setInputRate(vk::VertexInputRate::eVertex).setStride(sizeof(glm::vec3));
-			skin_bindings[1].setBinding(1).setInputRate(vk::VertexInputRate::eVertex).setStride(sizeof(glm::vec3));
-			skin_bindings[2].setBinding(2).setInputRate(vk::VertexInputRate::eVertex).setStride(sizeof(glm::vec2));
-			skin_bindings[3].setBinding(3).setInputRate(vk::VertexInputRate::eVertex).setStride(sizeof(glm::vec3));
-			skin_bindings[4].setBinding(4).setInputRate(vk::VertexInputRate::eVertex).setStride(sizeof(glm::u16vec4));
-			skin_bindings[5].setBinding(5).setInputRate(vk::VertexInputRate::eVertex).setStride(sizeof(glm::vec4));
-		}
-
 		auto vertex_input_state = vk::PipelineVertexInputStateCreateInfo()
 									  .setVertexAttributeDescriptions(attributes)
 									  .setVertexBindingDescriptions(bindings);
-		auto skin_vertex_input_state = vk::PipelineVertexInputStateCreateInfo()
-										   .setVertexAttributeDescriptions(skin_attributes)
-										   .setVertexBindingDescriptions(skin_bindings);
 		create_info.setPVertexInputState(&vertex_input_state);
 
 		// Input Assembly State
@@ -625,62 +579,133 @@ void Gbuffer_pipeline::create(const Environment& env)
 		// Layout & Renderpass
 		create_info.setRenderPass(render_pass).setLayout(pipeline_layout).setSubpass(0);
 
-		auto skin_create_info = create_info;
-		skin_create_info.setStages(skin_shader_module_infos)
-			.setPVertexInputState(&skin_vertex_input_state)
-			.setLayout(pipeline_layout_skin);
+		auto indirect_create_info = create_info;
+		indirect_create_info.setStages(indirect_shader_module_infos).setLayout(pipeline_layout_indirect);
 
 		//* Single Sided
-		spec_map           = {false, false};
+		spec_map           = {false, false, compact};
 		single_side.opaque = Graphics_pipeline(env.device, create_info);
 		env.debug_marker.set_object_name(single_side.opaque, "Gbuffer Pipeline (Single Sided Opaque)");
 
-		spec_map         = {true, false};
+		spec_map         = {true, false, compact};
 		single_side.mask = Graphics_pipeline(env.device, create_info);
 		env.debug_marker.set_object_name(single_side.mask, "Gbuffer Pipeline (Single Sided Alpha)");
 
-		spec_map          = {false, true};
+		spec_map          = {false, true, compact};
 		single_side.blend = Graphics_pipeline(env.device, create_info);
 		env.debug_marker.set_object_name(single_side.blend, "Gbuffer Pipeline (Single Sided Blend)");
 
-		spec_map                = {false, false};
-		single_side_skin.opaque = Graphics_pipeline(env.device, skin_create_info);
-		env.debug_marker.set_object_name(single_side_skin.opaque, "Gbuffer Pipeline (Single Sided Opaque Skin)");
+		spec_map                    = {false, false, compact};
+		single_side_indirect.opaque = Graphics_pipeline(env.device, indirect_create_info);
+		env.debug_marker.set_object_name(single_side_indirect.opaque, "Gbuffer Pipeline (Single Sided Opaque Indirect)");
 
-		spec_map              = {true, false};
-		single_side_skin.mask = Graphics_pipeline(env.device, skin_create_info);
-		env.debug_marker.set_object_name(single_side_skin.mask, "Gbuffer Pipeline (Single Sided Alpha Skin)");
+		spec_map                  = {true, false, compact};
+		single_side_indirect.mask = Graphics_pipeline(env.device, indirect_create_info);
+		env.debug_marker.set_object_name(single_side_indirect.mask, "Gbuffer Pipeline (Single Sided Alpha Indirect)");
 
-		spec_map               = {false, true};
-		single_side_skin.blend = Graphics_pipeline(env.device, skin_create_info);
-		env.debug_marker.set_object_name(single_side_skin.blend, "Gbuffer Pipeline (Single Sided Blend Skin)");
+		spec_map                   = {false, true, compact};
+		single_side_indirect.blend = Graphics_pipeline(env.device, indirect_create_info);
+		env.debug_marker.set_object_name(single_side_indirect.blend, "Gbuffer Pipeline (Single Sided Blend Indirect)");
 
 		//* Double Sided
 		rasterization_state.setCullMode(vk::CullModeFlagBits::eNone);
 
-		spec_map           = {false, false};
+		spec_map           = {false, false, compact};
 		double_side.opaque = Graphics_pipeline(env.device, create_info);
 		env.debug_marker.set_object_name(double_side.opaque, "Gbuffer Pipeline (Double Sided Opaque)");
 
-		spec_map         = {true, false};
+		spec_map         = {true, false, compact};
 		double_side.mask = Graphics_pipeline(env.device, create_info);
 		env.debug_marker.set_object_name(double_side.mask, "Gbuffer Pipeline (Double Sided ALpha)");
 
-		spec_map          = {false, true};
+		spec_map          = {false, true, compact};
 		double_side.blend = Graphics_pipeline(env.device, create_info);
 		env.debug_marker.set_object_name(double_side.blend, "Gbuffer Pipeline (Double Sided Blend)");
 
-		spec_map                = {false, false};
-		double_side_skin.opaque = Graphics_pipeline(env.device, skin_create_info);
-		env.debug_marker.set_object_name(double_side_skin.opaque, "Gbuffer Pipeline (Double Sided Opaque Skin)");
+		spec_map                    = {false, false, compact};
+		double_side_indirect.opaque = Graphics_pipeline(env.device, indirect_create_info);
+		env.debug_marker.set_object_name(double_side_indirect.opaque, "Gbuffer Pipeline (Double Sided Opaque Indirect)");
+
+		spec_map                  = {true, false, compact};
+		double_side_indirect.mask = Graphics_pipeline(env.device, indirect_create_info);
+		env.debug_marker.set_object_name(double_side_indirect.mask, "Gbuffer Pipeline (Double Sided Alpha Indirect)");
+
+		spec_map                   = {false, true, compact};
+		double_side_indirect.blend = Graphics_pipeline(env.device, indirect_create_info);
+		env.debug_marker.set_object_name(double_side_indirect.blend, "Gbuffer Pipeline (Double Sided Blend Indirect)");
+	}
+}
+
+#pragma endregion
+
+#pragma region "Culling Pipeline"
+
+void Culling_pipeline::create(const Environment& env)
+{
+	// Descriptor Set Layout
+	{
+		const std::array<vk::DescriptorSetLayoutBinding, 3> layout_bindings{
+			{{0, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute},
+			 {1, vk::DescriptorType::eUniformBuffer, 1, vk::ShaderStageFlagBits::eCompute},
+			 {2, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute}}
+		};
+
+		descriptor_set_layout = Descriptor_set_layout(env.device, layout_bindings);
+		env.debug_marker.set_object_name(descriptor_set_layout, "Culling Descriptor Set Layout");
+	}
+
+	// Pipeline Layout
+	{
+		const vk::PushConstantRange push_constant_range(vk::ShaderStageFlagBits::eCompute, 0, sizeof(Params));
+
+		pipeline_layout = Pipeline_layout(env.device, {descriptor_set_layout}, {push_constant_range});
+		env.debug_marker.set_object_name(pipeline_layout, "Culling Pipeline Layout");
+	}
+
+	// Pipeline
+	{
+		const auto cull_shader = GET_SHADER_MODULE(cull_comp);
+
+		pipeline = Compute_pipeline(env.device, pipeline_layout, cull_shader.stage_info(vk::ShaderStageFlagBits::eCompute));
+		env.debug_marker.set_object_name(pipeline, "Culling Pipeline");
+	}
+}
+
+#pragma endregion
+
+#pragma region "Skinning Pipeline"
+
+void Skinning_pipeline::create(const Environment& env)
+{
+	// Descriptor Set Layout
+	{
+		// Position, normal, tangent, joints, weights, joint matrices and output
+		std::array<vk::DescriptorSetLayoutBinding, 7> layout_bindings;
+		for (auto i : Iota(7))
+			layout_bindings[i]
+				.setBinding(i)
+				.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+				.setDescriptorCount(1)
+				.setStageFlags(vk::ShaderStageFlagBits::eCompute);
+
+		descriptor_set_layout = Descriptor_set_layout(env.device, layout_bindings);
+		env.debug_marker.set_object_name(descriptor_set_layout, "Skinning Descriptor Set Layout");
+	}
+
+	// Pipeline Layout
+	{
+		const vk::PushConstantRange push_constant_range(vk::ShaderStageFlagBits::eCompute, 0, sizeof(Params));
 
-		spec_map              = {true, false};
-		double_side_skin.mask = Graphics_pipeline(env.device, skin_create_info);
-		env.debug_marker.set_object_name(double_side_skin.mask, "Gbuffer Pipeline (Double Sided ALpha Skin)");
+		pipeline_layout = Pipeline_layout(env.device, {descriptor_set_layout}, {push_constant_range});
+		env.debug_marker.set_object_name(pipeline_layout, "Skinning Pipeline Layout");
+	}
+
+	// Pipeline
+	{
+		const auto skin_shader = GET_SHADER_MODULE(skin_comp);
 
-		spec_map               = {false, true};
-		double_side_skin.blend = Graphics_pipeline(env.device, skin_create_info);
-		env.debug_marker.set_object_name(double_side_skin.blend, "Gbuffer Pipeline (Double Sided Blend Skin)");
+		pipeline = Compute_pipeline(env.device, pipeline_layout, skin_shader.stage_info(vk::ShaderStageFlagBits::eCompute));
+		env.debug_marker.set_object_name(pipeline, "Skinning Pipeline");
 	}
 }
 
@@ -812,6 +837,19 @@ void Lighting_pipeline::create(const Environment& env)
 			= std::to_array({vert_shader.stage_info(vk::ShaderStageFlagBits::eVertex), frag_shader.stage_info(vk::ShaderStageFlagBits::eFragment)});
 		create_info.setStages(shader_module_infos);
 
+		// Shader specialization, gbuffer layout
+		const struct
+		{
+			VkBool32 compact_gbuffer;
+		} spec{env.features.compact_gbuffer_enabled};
+
+		const auto constant_entries = std::to_array({
+			vk::SpecializationMapEntry{0, offsetof(decltype(spec), compact_gbuffer), sizeof(spec.compact_gbuffer)},
+		});
+		const auto specialization_info
+			= vk::SpecializationInfo().setDataSize(sizeof(spec)).setPData(&spec).setMapEntries(constant_entries);
+		shader_module_infos[1].setPSpecializationInfo(&specialization_info);
+
 		// Vertex Input State
 		auto vertex_input_state = vk::PipelineVertexInputStateCreateInfo();
 		create_info.setPVertexInputState(&vertex_input_state);
@@ -1341,6 +1379,8 @@ void Pipeline_set::create(const Environment& env)
 {
 	shadow_pipeline.create(env);
 	gbuffer_pipeline.create(env);
+	culling_pipeline.create(env);
+	skinning_pipeline.create(env);
 	lighting_pipeline.create(env);
 	auto_exposure_pipeline.create(env);
 	bloom_pipeline.create(env);
@@ -0,0 +1,148 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+Gpu_profiler::Gpu_profiler(const Environment& env)
+{
+	const auto  properties        = env.physical_device.getProperties();
+	const auto  family_properties = env.physical_device.getQueueFamilyProperties();
+	const auto& limits            = properties.limits;
+
+	// Stages are recorded on both the graphics and the compute queue
+	const uint32_t valid_bits = std::min(
+		family_properties[env.g_family_idx].timestampValidBits,
+		family_properties[env.c_family_idx].timestampValidBits
+	);
+
+	if (!limits.timestampComputeAndGraphics || valid_bits == 0)
+	{
+		env.log_msg("GPU timestamps not supported, GPU profiler disabled");
+		return;
+	}
+
+	query_pool       = Query_pool(env.device, vk::QueryType::eTimestamp, queries_per_frame * frames_in_flight);
+	timestamp_period = limits.timestampPeriod;
+	timestamp_mask   = valid_bits >= 64 ? ~0ull : (1ull << valid_bits) - 1;
+}
+
+std::string Gpu_profiler::stage_name(Stage stage)
+{
+	const auto idx = (uint32_t)stage;
+	if (idx >= (uint32_t)Stage::Shadow && idx < (uint32_t)Stage::Lighting)
+		return std::format("Shadow {}", idx - (uint32_t)Stage::Shadow);
+
+	switch (stage)
+	{
+	case Stage::Gbuffer:
+		return "Gbuffer";
+	case Stage::Lighting:
+		return "Lighting";
+	case Stage::Auto_exposure:
+		return "Auto Exposure";
+	case Stage::Bloom:
+		return "Bloom";
+	case Stage::Composite:
+		return "Composite";
+	case Stage::Fxaa:
+		return "FXAA";
+	case Stage::Ui:
+		return "UI";
+	default:
+		return "Unknown";
+	}
+}
+
+void Gpu_profiler::collect(uint32_t frame_idx)
+{
+	if (!supported() || !pending[frame_idx]) return;
+	pending[frame_idx] = false;
+
+	std::array<uint64_t, queries_per_frame> timestamps;
+
+	// Not ready only when a stage wasn't recorded in the frame, the frame is skipped then
+	if (query_pool.get_results(frame_idx * queries_per_frame, timestamps) != vk::Result::eSuccess) return;
+
+	for (auto stage : Iota(stage_count))
+	{
+		const auto ticks = (timestamps[stage * 2 + 1] - timestamps[stage * 2]) & timestamp_mask;
+		history[stage][history_cursor] = (float)(ticks * timestamp_period / 1e6);
+	}
+
+	history_cursor = (history_cursor + 1) % history_size;
+	history_count  = std::min(history_count + 1, history_size);
+}
+
+void Gpu_profiler::reset(const Command_buffer& command_buffer, uint32_t frame_idx)
+{
+	if (!supported()) return;
+
+	command_buffer.reset_query_pool(query_pool, frame_idx * queries_per_frame, queries_per_frame);
+	pending[frame_idx] = true;
+}
+
+void Gpu_profiler::begin(const Command_buffer& command_buffer, uint32_t frame_idx, Stage stage) const
+{
+	if (!supported()) return;
+
+	command_buffer.write_timestamp(
+		vk::PipelineStageFlagBits::eTopOfPipe,
+		query_pool,
+		frame_idx * queries_per_frame + (uint32_t)stage * 2
+	);
+}
+
+void Gpu_profiler::end(const Command_buffer& command_buffer, uint32_t frame_idx, Stage stage) const
+{
+	if (!supported()) return;
+
+	command_buffer.write_timestamp(
+		vk::PipelineStageFlagBits::eBottomOfPipe,
+		query_pool,
+		frame_idx * queries_per_frame + (uint32_t)stage * 2 + 1
+	);
+}
+
+Gpu_profiler::Statistics Gpu_profiler::statistics(Stage stage) const
+{
+	if (history_count == 0) return {};
+
+	std::vector<float> samples(history[(uint32_t)stage].begin(), history[(uint32_t)stage].begin() + history_count);
+	std::ranges::sort(samples);
+
+	const auto percentile = [&samples](float p)
+	{
+		return samples[std::min<size_t>(samples.size() * p, samples.size() - 1)];
+	};
+
+	Statistics result;
+	result.average = std::accumulate(samples.begin(), samples.end(), 0.0f) / samples.size();
+	result.p95     = percentile(0.95f);
+	result.p99     = percentile(0.99f);
+	result.max     = samples.back();
+
+	return result;
+}
+
+void Gpu_profiler::export_csv(const std::filesystem::path& path) const
+{
+	std::string content = "stage,average_ms,p95_ms,p99_ms,max_ms,samples\n";
+
+	for (auto idx : Iota(stage_count))
+	{
+		const auto stage = Stage(idx);
+		const auto stats = statistics(stage);
+
+		content += std::format(
+			"{},{:.4f},{:.4f},{:.4f},{:.4f},{}\n",
+			stage_name(stage),
+			stats.average,
+			stats.p95,
+			stats.p99,
+			stats.max,
+			history_count
+		);
+	}
+
+	io::write(path.string(), std::span((const uint8_t*)content.data(), content.size()));
+}
@@ -71,7 +71,9 @@ void Render_source::generate_material_data(const Environment& env, const Pipelin
 		cmd.copy_buffer(material_uniform_buffer, staging_buffer, 0, 0, element_size * materials.size());
 		cmd.end();
 
-		const auto submit_buffers = Command_buffer::to_array({cmd});
+		// Runs on the model loader thread
+		const auto            submit_buffers = Command_buffer::to_array({cmd});
+		const std::lock_guard lock(env.worker_queue_mutex);
 		env.t_queue.submit(vk::SubmitInfo().setCommandBuffers(submit_buffers));
 		env.t_queue.waitIdle();
 	}
@@ -169,16 +171,19 @@ void Render_source::generate_material_data(const Environment& env, const Pipelin
 
 void Render_source::generate_skin_data(const Environment& env, const Pipeline_set& pipeline)
 {
+	skinned_primitives.clear();
+	skinned_primitive_lut.clear();
+	skinned_vertex_count = 0;
+
 	if (model->skins.empty()) return;  // Skip if no skin present
 
 	/* Preparation */
 
-	skin_descriptors.clear();
-	skin_descriptors.reserve(model->skins.size());
-
 	skin_matrix_cpu.clear();
 	skin_matrix_cpu.reserve(model->skins.size());
 
+	for (const auto& skin : model->skins) skin_matrix_cpu.emplace_back(skin.joints.size());
+
 	// Total count of matrices
 	const uint32_t total_count = std::accumulate(
 		model->skins.begin(),
@@ -191,79 +196,124 @@ void Render_source::generate_skin_data(const Environment& env, const Pipeline_se
 	);
 	skin_matrix_count = total_count;
 
-	/* Create Descriptor Pool */
+	skin_matrix_offsets.clear();
+	for (uint32_t offset = 0; const auto& skin : model->skins)
+	{
+		skin_matrix_offsets.push_back(offset);
+		offset += skin.joints.size();
+	}
 
-	const vk::DescriptorPoolSize pool_size = {vk::DescriptorType::eStorageBuffer, total_count * 2};  // 2 Storage Buffers for each skin
-	skin_descriptor_pool                   = Descriptor_pool(env.device, {pool_size}, total_count * 2);  // Maximum = 2 * Skin Count
+	/* Collect skinned primitives */
 
-	/* Create Descriptors */
+	for (auto [node_idx, node] : Walk(model->nodes))
+	{
+		if (!node.mesh_idx.has_value() || !node.skin_idx.has_value()) continue;
 
-	const auto gbuffer_layouts
-		= std::vector<vk::DescriptorSetLayout>(model->skins.size(), pipeline.gbuffer_pipeline.descriptor_set_layout_skin),
-		shadow_layouts
-		= std::vector<vk::DescriptorSetLayout>(model->skins.size(), pipeline.shadow_pipeline.descriptor_set_layout_skin);
+		for (const auto& primitive : model->meshes[node.mesh_idx.value()].primitives)
+		{
+			if (!primitive.skin) continue;
 
-	const auto gbuffer_descriptors = Descriptor_set::create_multiple(env.device, skin_descriptor_pool, gbuffer_layouts),
-			   shadow_descriptors  = Descriptor_set::create_multiple(env.device, skin_descriptor_pool, shadow_layouts);
+			const auto key = std::tuple<uint32_t, uint32_t, uint32_t>(node_idx, primitive.position_buffer, primitive.position_offset);
+			if (skinned_primitive_lut.contains(key)) continue;
 
-	for (auto i : Iota(model->skins.size())) skin_descriptors.emplace_back(gbuffer_descriptors[i], shadow_descriptors[i]);
+			skinned_primitive_lut.emplace(key, skinned_primitives.size());
+			skinned_primitives.emplace_back(node_idx, &primitive, skinned_vertex_count);
+			skinned_vertex_count += primitive.vertex_count;
+		}
+	}
 
-	/* Create full storage buffer */
+	/* Create Descriptor Pool */
 
-	skin_matrix_data_gpu = Buffer(
-		env.allocator,
-		total_count * sizeof(glm::mat4),
-		vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eStorageBuffer,
-		vk::SharingMode::eExclusive,
-		VMA_MEMORY_USAGE_GPU_ONLY
-	);
-	env.debug_marker.set_object_name(skin_matrix_data_gpu, "Skin Matrices Buffer");
+	const uint32_t set_count = skinned_primitives.size() * frames_in_flight;
 
-	skin_matrix_data_staging = Buffer(
-		env.allocator,
-		total_count * sizeof(glm::mat4),
-		vk::BufferUsageFlagBits::eTransferSrc,
-		vk::SharingMode::eExclusive,
-		VMA_MEMORY_USAGE_CPU_TO_GPU
-	);
-	env.debug_marker.set_object_name(skin_matrix_data_staging, "Skin Matrices Staging Buffer");
+	if (set_count != 0)
+	{
+		auto pool_sizes = Skinning_pipeline::descriptor_pool_size;
+		for (auto& size : pool_sizes) size.descriptorCount *= set_count;
 
-	// Create staging buffers and descriptors
+		skin_descriptor_pool = Descriptor_pool(env.device, pool_sizes, set_count);
+	}
 
-	uint32_t count = 0;
+	const auto layouts
+		= std::vector<vk::DescriptorSetLayout>(skinned_primitives.size(), pipeline.skinning_pipeline.descriptor_set_layout);
 
-	for (auto [i, skin] : Walk(model->skins))
+	for (auto [frame, frame_data] : Walk(skin_frame_data))
 	{
-		// Create CPU array
+		/* Create full storage buffer */
 
-		skin_matrix_cpu.emplace_back(skin.joints.size());
+		frame_data.gpu = Buffer(
+			env.allocator,
+			total_count * sizeof(glm::mat4),
+			vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eStorageBuffer,
+			vk::SharingMode::eExclusive,
+			VMA_MEMORY_USAGE_GPU_ONLY
+		);
+		env.debug_marker.set_object_name(frame_data.gpu, std::format("Skin Matrices Buffer (Frame {})", frame));
 
-		// Create Descriptor
+		frame_data.staging = Buffer(
+			env.allocator,
+			total_count * sizeof(glm::mat4),
+			vk::BufferUsageFlagBits::eTransferSrc,
+			vk::SharingMode::eExclusive,
+			VMA_MEMORY_USAGE_CPU_TO_GPU
+		);
+		env.debug_marker.set_object_name(frame_data.staging, std::format("Skin Matrices Staging Buffer (Frame {})", frame));
 
-		const vk::DescriptorBufferInfo buffer_info
-			= {skin_matrix_data_gpu, count * sizeof(glm::mat4), skin.joints.size() * sizeof(glm::mat4)};
-		count += skin.joints.size();
+		frame_data.skinning_sets.clear();
+		if (skinned_primitives.empty()) continue;
 
-		vk::WriteDescriptorSet write_gbuffer, write_shadow;
+		/* Create skinned vertex buffer */
 
-		write_gbuffer.setDescriptorCount(1)
-			.setDescriptorType(vk::DescriptorType::eStorageBuffer)
-			.setDstBinding(0)
-			.setDstSet(gbuffer_descriptors[i])
-			.setPBufferInfo(&buffer_info);
-		write_shadow.setDescriptorCount(1)
-			.setDescriptorType(vk::DescriptorType::eStorageBuffer)
-			.setDstBinding(0)
-			.setDstSet(shadow_descriptors[i])
-			.setPBufferInfo(&buffer_info);
+		frame_data.skinned_vertices = Buffer(
+			env.allocator,
+			skinned_vertex_count * 3 * sizeof(glm::vec3),
+			vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eVertexBuffer,
+			vk::SharingMode::eExclusive,
+			VMA_MEMORY_USAGE_GPU_ONLY
+		);
+		env.debug_marker.set_object_name(frame_data.skinned_vertices, std::format("Skinned Vertices Buffer (Frame {})", frame));
 
-		env.device->updateDescriptorSets({write_gbuffer, write_shadow}, {});
+		/* Create & write descriptors */
+
+		frame_data.skinning_sets = Descriptor_set::create_multiple(env.device, skin_descriptor_pool, layouts);
+
+		for (auto [i, skinned] : Walk(skinned_primitives))
+		{
+			const auto& primitive = *skinned.primitive;
+
+			const auto buffer_infos = std::to_array<vk::DescriptorBufferInfo>({
+				{model->vec3_buffers[primitive.position_buffer],       0, vk::WholeSize},
+				{model->vec3_buffers[primitive.normal_buffer],         0, vk::WholeSize},
+				{model->vec3_buffers[primitive.tangent_buffer],        0, vk::WholeSize},
+				{model->joint_buffers[primitive.skin->joint_buffer],   0, vk::WholeSize},
+				{model->weight_buffers[primitive.skin->weight_buffer], 0, vk::WholeSize},
+				{frame_data.gpu,                                       0, vk::WholeSize},
+				{frame_data.skinned_vertices,                          0, vk::WholeSize}
+			});
+
+			std::array<vk::WriteDescriptorSet, 7> writes;
+			for (auto binding : Iota(7))
+				writes[binding]
+					.setDstSet(frame_data.skinning_sets[i])
+					.setDstBinding(binding)
+					.setDescriptorCount(1)
+					.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+					.setPBufferInfo(&buffer_infos[binding]);
+
+			env.device->updateDescriptorSets(writes, {});
+		}
 	}
 }
 
-void Render_source::stream_skin_data(const Environment& env [[maybe_unused]], const Command_buffer& command_buffer)
+void Render_source::stream_skin_data(
+	const Environment& env [[maybe_unused]],
+	const Command_buffer& command_buffer,
+	uint32_t              frame_idx
+)
 {
-	auto* mapped_memory = (glm::mat4*)skin_matrix_data_staging.map_memory();
+	const auto& frame_data = skin_frame_data[frame_idx];
+
+	auto* mapped_memory = (glm::mat4*)frame_data.staging.map_memory();
 	{
 		uint32_t offset = 0;
 
@@ -273,13 +323,13 @@ void Render_source::stream_skin_data(const Environment& env [[maybe_unused]], co
 			offset += model->skins[i].joints.size();
 		}
 	}
-	skin_matrix_data_staging.unmap_memory();
+	frame_data.staging.unmap_memory();
 
 	command_buffer.begin();
 
 	// Sync [Transfer Write] after [Shader Read]
 	command_buffer->pipelineBarrier(
-		vk::PipelineStageFlagBits::eFragmentShader,
+		vk::PipelineStageFlagBits::eComputeShader,
 		vk::PipelineStageFlagBits::eTransfer,
 		vk::DependencyFlagBits::eByRegion,
 		{},
@@ -288,19 +338,19 @@ void Render_source::stream_skin_data(const Environment& env [[maybe_unused]], co
 			vk::AccessFlagBits::eTransferWrite,
 			vk::QueueFamilyIgnored,
 			vk::QueueFamilyIgnored,
-			skin_matrix_data_gpu,
+			frame_data.gpu,
 			0,
 			skin_matrix_count * sizeof(glm::mat4)
 		),
 		{}
 	);
 
-	command_buffer.copy_buffer(skin_matrix_data_gpu, skin_matrix_data_staging, 0, 0, skin_matrix_count * sizeof(glm::mat4));
+	command_buffer.copy_buffer(frame_data.gpu, frame_data.staging, 0, 0, skin_matrix_count * sizeof(glm::mat4));
 
 	// Sync [Shader Read] after [Transfer Write]
 	command_buffer->pipelineBarrier(
 		vk::PipelineStageFlagBits::eTransfer,
-		vk::PipelineStageFlagBits::eFragmentShader,
+		vk::PipelineStageFlagBits::eComputeShader,
 		vk::DependencyFlagBits::eByRegion,
 		{},
 		vk::BufferMemoryBarrier(
@@ -308,7 +358,7 @@ void Render_source::stream_skin_data(const Environment& env [[maybe_unused]], co
 			vk::AccessFlagBits::eShaderRead,
 			vk::QueueFamilyIgnored,
 			vk::QueueFamilyIgnored,
-			skin_matrix_data_gpu,
+			frame_data.gpu,
 			0,
 			skin_matrix_count * sizeof(glm::mat4)
 		),
@@ -318,6 +368,95 @@ void Render_source::stream_skin_data(const Environment& env [[maybe_unused]], co
 	command_buffer.end();
 }
 
+void Render_source::record_skinning(const Command_buffer& command_buffer, const Pipeline_set& pipeline, uint32_t frame_idx) const
+{
+	if (skinned_primitives.empty()) return;
+
+	const auto& frame_data = skin_frame_data[frame_idx];
+	const auto& skinning   = pipeline.skinning_pipeline;
+
+	command_buffer.bind_pipeline(vk::PipelineBindPoint::eCompute, skinning.pipeline);
+
+	for (auto [i, skinned] : Walk(skinned_primitives))
+	{
+		const auto& primitive = *skinned.primitive;
+		const auto& node      = model->nodes[skinned.node_idx];
+
+		const Skinning_pipeline::Params params{
+			primitive.vertex_count,
+			primitive.position_offset,
+			primitive.normal_offset,
+			primitive.tangent_offset,
+			primitive.skin->joint_offset,
+			primitive.skin->weight_offset,
+			skin_matrix_offsets[node.skin_idx.value()],
+			skinned.output_offset,
+			skinned_vertex_count
+		};
+		const auto group_count = (params.vertex_count + Skinning_pipeline::workgroup_size - 1) / Skinning_pipeline::workgroup_size;
+
+		command_buffer.bind_descriptor_sets(vk::PipelineBindPoint::eCompute, skinning.pipeline_layout, 0, {frame_data.skinning_sets[i]});
+		command_buffer.push_constants(skinning.pipeline_layout, vk::ShaderStageFlagBits::eCompute, params);
+		command_buffer->dispatch(group_count, 1, 1);
+	}
+
+	// Sync [Vertex Attribute Read] after [Shader Write]
+	command_buffer.pipeline_barrier(
+		vk::PipelineStageFlagBits::eComputeShader,
+		vk::PipelineStageFlagBits::eVertexInput,
+		{},
+		{vk::BufferMemoryBarrier(
+			vk::AccessFlagBits::eShaderWrite,
+			vk::AccessFlagBits::eVertexAttributeRead,
+			vk::QueueFamilyIgnored,
+			vk::QueueFamilyIgnored,
+			frame_data.skinned_vertices,
+			0,
+			vk::WholeSize
+		)},
+		{}
+	);
+}
+
+void Render_source::bind_skinned_vertices(
+	const Command_buffer&      command_buffer,
+	uint32_t                   node_idx,
+	const io::gltf::Primitive& primitive,
+	uint32_t                   frame_idx,
+	Skinned_vertex_input       input
+) const
+{
+	const auto& skinned_vertices = skin_frame_data[frame_idx].skinned_vertices;
+	const auto& skinned          = skinned_primitives[skinned_primitive_lut.at({node_idx, primitive.position_buffer, primitive.position_offset})];
+
+	// Offsets of the position, normal and tangent regions
+	const vk::DeviceSize position_offset = skinned.output_offset * sizeof(glm::vec3),
+						 normal_offset   = (skinned_vertex_count + skinned.output_offset) * sizeof(glm::vec3),
+						 tangent_offset  = (skinned_vertex_count * 2 + skinned.output_offset) * sizeof(glm::vec3);
+
+	const auto& uv_buffer = model->vec2_buffers[primitive.uv_buffer];
+	const auto  uv_offset = primitive.uv_offset * sizeof(glm::vec2);
+
+	switch (input)
+	{
+	case Skinned_vertex_input::Gbuffer:
+		command_buffer->bindVertexBuffers(
+			0,
+			{skinned_vertices, skinned_vertices, uv_buffer, skinned_vertices},
+			{position_offset, normal_offset, uv_offset, tangent_offset}
+		);
+		break;
+
+	case Skinned_vertex_input::Shadow:
+		command_buffer->bindVertexBuffers(0, {skinned_vertices, uv_buffer}, {position_offset, uv_offset});
+		break;
+
+	case Skinned_vertex_input::Shadow_opaque:
+		command_buffer->bindVertexBuffers(0, {skinned_vertices}, {position_offset});
+		break;
+	}
+}
+
 static glm::vec3 get_sunlight_direction(float sunlight_yaw, float sunlight_pitch)
 {
 	auto mat = glm::rotate(
@@ -1,9 +1,92 @@
 #include "render-target.hpp"
 
+#pragma region "Render Graph"
+
+// Transient single-layer image of the render graph
+static vk::ImageCreateInfo transient_image_info(vk::Extent2D extent, vk::Format format, vk::ImageUsageFlags usage, uint32_t mipmap_levels = 1)
+{
+	return vk::ImageCreateInfo()
+		.setImageType(vk::ImageType::e2D)
+		.setExtent(vk::Extent3D(extent, 1))
+		.setFormat(format)
+		.setTiling(vk::ImageTiling::eOptimal)
+		.setSharingMode(vk::SharingMode::eExclusive)
+		.setMipLevels(mipmap_levels)
+		.setArrayLayers(1)
+		.setSamples(vk::SampleCountFlagBits::e1)
+		.setUsage(usage)
+		.setInitialLayout(vk::ImageLayout::eUndefined);
+}
+
+// Color attachment cleared by a render pass, which leaves it in `final_layout`
+static Image_usage color_attachment_usage(vk::ImageLayout final_layout)
+{
+	const vk::AccessFlags        access = vk::AccessFlagBits::eColorAttachmentWrite;
+	const vk::PipelineStageFlags stages = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+
+	return {
+		{vk::ImageLayout::eUndefined, access, stages},
+		{final_layout,                access, stages}
+	};
+}
+
+// Depth attachment cleared by a render pass, which leaves it in `final_layout`
+static Image_usage depth_attachment_usage(vk::ImageLayout final_layout)
+{
+	const vk::AccessFlags access
+		= vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite;
+	const vk::PipelineStageFlags stages
+		= vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests;
+
+	return {
+		{vk::ImageLayout::eUndefined, access, stages},
+		{final_layout,                access, stages}
+	};
+}
+
+static const Image_state fragment_sampled{
+	vk::ImageLayout::eShaderReadOnlyOptimal,
+	vk::AccessFlagBits::eShaderRead,
+	vk::PipelineStageFlagBits::eFragmentShader
+};
+
+static const Image_state compute_storage_read{vk::ImageLayout::eGeneral, vk::AccessFlagBits::eShaderRead, vk::PipelineStageFlagBits::eComputeShader};
+
+void Frame_passes::declare(const Environment& env, Render_graph& graph)
+{
+	gbuffer   = graph.add_pass(env.g_family_idx);
+	shadow    = graph.add_pass(env.g_family_idx);
+	lighting  = graph.add_pass(env.g_family_idx);
+	compute   = graph.add_pass(env.c_family_idx);
+	composite = graph.add_pass(env.g_family_idx);
+	fxaa      = graph.add_pass(env.g_family_idx);
+}
+
+#pragma endregion
+
 #pragma region "Shadow RT"
 
+void Shadow_rt::declare(Render_graph& graph, const Frame_passes& passes, const std::array<uint32_t, csm_count>& shadow_map_size)
+{
+	for (auto i : Iota(csm_count))
+	{
+		shadow_image_handles[i] = graph.create_image(
+			transient_image_info(
+				{shadow_map_size[i], shadow_map_size[i]},
+				Shadow_pipeline::shadow_map_format,
+				vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eDepthStencilAttachment
+			),
+			vk::ImageAspectFlagBits::eDepth
+		);
+
+		graph.use(passes.shadow, shadow_image_handles[i], depth_attachment_usage(vk::ImageLayout::eShaderReadOnlyOptimal));
+		graph.use(passes.lighting, shadow_image_handles[i], fragment_sampled);
+	}
+}
+
 void Shadow_rt::create(
 	const Environment&                     env,
+	const Render_graph&                    graph,
 	const Render_pass&                     render_pass,
 	const Descriptor_pool&                 pool,
 	const Descriptor_set_layout&           layout,
@@ -16,16 +99,7 @@ void Shadow_rt::create(
 
 		// Images
 
-		shadow_images[i] = Image(
-			env.allocator,
-			vk::ImageType::e2D,
-			vk::Extent3D(resolution, resolution, 1),
-			Shadow_pipeline::shadow_map_format,
-			vk::ImageTiling::eOptimal,
-			vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eDepthStencilAttachment,
-			VMA_MEMORY_USAGE_GPU_ONLY,
-			vk::SharingMode::eExclusive
-		);
+		shadow_images[i] = graph.image(shadow_image_handles[i]);
 
 		shadow_image_views[i] = Image_view(
 			env.device,
@@ -77,46 +151,71 @@ std::array<Write_descriptor_buffer<>, csm_count> Shadow_rt::update_uniform(
 
 #pragma region "Gbuffer RT"
 
-void Gbuffer_rt::create(const Environment& env, const Render_pass& render_pass, const Descriptor_pool& pool, const Descriptor_set_layout& layout)
+void Gbuffer_rt::declare(const Environment& env, Render_graph& graph, const Frame_passes& passes)
 {
-	const auto extent = vk::Extent3D(env.swapchain.extent, 1);
-
-	/* Images */
-
-	auto create_color_attachment = [=](vk::Format format) -> std::tuple<Image, Image_view>
+	auto declare_color_attachment = [&](vk::Format format) -> Render_graph::Handle
 	{
-		auto img = Image(
-			env.allocator,
-			vk::ImageType::e2D,
-			extent,
-			format,
-			vk::ImageTiling::eOptimal,
-			vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled,
-			VMA_MEMORY_USAGE_GPU_ONLY,
-			vk::SharingMode::eExclusive
+		const auto handle = graph.create_image(
+			transient_image_info(env.swapchain.extent, format, vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled),
+			vk::ImageAspectFlagBits::eColor
 		);
 
-		auto view = Image_view(env.device, img, format, vk::ImageViewType::e2D, {vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1});
+		graph.use(passes.gbuffer, handle, color_attachment_usage(vk::ImageLayout::eShaderReadOnlyOptimal));
+		graph.use(passes.lighting, handle, fragment_sampled);
 
-		return {img, view};
+		return handle;
 	};
 
-	std::tie(normal, normal_view)     = create_color_attachment(Gbuffer_pipeline::normal_format);
-	std::tie(albedo, albedo_view)     = create_color_attachment(Gbuffer_pipeline::color_format);
-	std::tie(pbr, pbr_view)           = create_color_attachment(Gbuffer_pipeline::pbr_format);
-	std::tie(emissive, emissive_view) = create_color_attachment(Gbuffer_pipeline::emissive_format);
+	const auto& formats = Gbuffer_pipeline::formats(env);
 
-	depth = Image(
-		env.allocator,
-		vk::ImageType::e2D,
-		extent,
-		Gbuffer_pipeline::depth_format,
-		vk::ImageTiling::eOptimal,
-		vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eSampled,
-		VMA_MEMORY_USAGE_GPU_ONLY,
-		vk::SharingMode::eExclusive
+	normal_handle   = declare_color_attachment(formats.normal);
+	albedo_handle   = declare_color_attachment(formats.color);
+	pbr_handle      = declare_color_attachment(formats.pbr);
+	emissive_handle = declare_color_attachment(formats.emissive);
+
+	depth_handle = graph.create_image(
+		transient_image_info(
+			env.swapchain.extent,
+			Gbuffer_pipeline::depth_format,
+			vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eSampled
+		),
+		vk::ImageAspectFlagBits::eDepth
 	);
 
+	graph.use(passes.gbuffer, depth_handle, depth_attachment_usage(vk::ImageLayout::eShaderReadOnlyOptimal));
+	graph.use(passes.lighting, depth_handle, fragment_sampled);
+}
+
+void Gbuffer_rt::create(
+	const Environment&           env,
+	const Render_graph&          graph,
+	const Render_pass&           render_pass,
+	const Descriptor_pool&       pool,
+	const Descriptor_set_layout& layout
+)
+{
+	const auto extent = vk::Extent3D(env.swapchain.extent, 1);
+
+	/* Images */
+
+	auto create_color_view = [&](const Image& img, vk::Format format)
+	{
+		return Image_view(env.device, img, format, vk::ImageViewType::e2D, {vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1});
+	};
+
+	normal   = graph.image(normal_handle);
+	albedo   = graph.image(albedo_handle);
+	pbr      = graph.image(pbr_handle);
+	emissive = graph.image(emissive_handle);
+	depth    = graph.image(depth_handle);
+
+	const auto& formats = Gbuffer_pipeline::formats(env);
+
+	normal_view   = create_color_view(normal, formats.normal);
+	albedo_view   = create_color_view(albedo, formats.color);
+	pbr_view      = create_color_view(pbr, formats.pbr);
+	emissive_view = create_color_view(emissive, formats.emissive);
+
 	depth_view = Image_view(
 		env.device,
 		depth,
@@ -165,32 +264,48 @@ Write_descriptor_buffer<> Gbuffer_rt::update_uniform(const Gbuffer_pipeline::Cam
 
 #pragma region "Lighting RT"
 
-void Lighting_rt::create(const Environment& env, const Render_pass& render_pass, const Descriptor_pool& pool, const Descriptor_set_layout& layout)
+void Lighting_rt::declare(const Environment& env, Render_graph& graph, const Frame_passes& passes)
 {
-	const auto extent = vk::Extent3D(env.swapchain.extent, 1);
-
-	luminance = Image(
-		env.allocator,
-		vk::ImageType::e2D,
-		extent,
-		Lighting_pipeline::luminance_format,
-		vk::ImageTiling::eOptimal,
-		vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eStorage,
-		VMA_MEMORY_USAGE_GPU_ONLY,
-		vk::SharingMode::eExclusive
+	luminance_handle = graph.create_image(
+		transient_image_info(
+			env.swapchain.extent,
+			Lighting_pipeline::luminance_format,
+			vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eStorage
+		),
+		vk::ImageAspectFlagBits::eColor
 	);
 
-	brightness = Image(
-		env.allocator,
-		vk::ImageType::e2D,
-		extent,
-		vk::Format::eR16Sfloat,
-		vk::ImageTiling::eOptimal,
-		vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eStorage,
-		VMA_MEMORY_USAGE_GPU_ONLY,
-		vk::SharingMode::eExclusive
+	brightness_handle = graph.create_image(
+		transient_image_info(
+			env.swapchain.extent,
+			vk::Format::eR16Sfloat,
+			vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eStorage
+		),
+		vk::ImageAspectFlagBits::eColor
 	);
 
+	// Read by auto exposure and bloom filter, then by composite
+	graph.use(passes.lighting, luminance_handle, color_attachment_usage(vk::ImageLayout::eGeneral));
+	graph.use(passes.compute, luminance_handle, compute_storage_read);
+	graph.use(passes.composite, luminance_handle, fragment_sampled);
+
+	graph.use(passes.lighting, brightness_handle, color_attachment_usage(vk::ImageLayout::eGeneral));
+	graph.use(passes.compute, brightness_handle, compute_storage_read);
+}
+
+void Lighting_rt::create(
+	const Environment&           env,
+	const Render_graph&          graph,
+	const Render_pass&           render_pass,
+	const Descriptor_pool&       pool,
+	const Descriptor_set_layout& layout
+)
+{
+	const auto extent = vk::Extent3D(env.swapchain.extent, 1);
+
+	luminance  = graph.image(luminance_handle);
+	brightness = graph.image(brightness_handle);
+
 	luminance_view
 		= Image_view(env.device, luminance, Lighting_pipeline::luminance_format, vk::ImageViewType::e2D, {vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1});
 
@@ -397,23 +512,54 @@ std::array<Write_descriptor_buffer<1, vk::DescriptorType::eStorageBuffer>, 2> Au
 
 #pragma region "Bloom RT"
 
-void Bloom_rt::create(const Environment& env, const Descriptor_pool& pool, const Bloom_pipeline& pipeline)
+void Bloom_rt::declare(const Environment& env, Render_graph& graph, const Frame_passes& passes)
 {
-	const auto extent = env.swapchain.extent;
+	extents[0] = env.swapchain.extent;
+	for (auto i : Iota(1u, bloom_downsample_count))
+		extents[i] = vk::Extent2D(extents[i - 1].width == 1 ? 1 : extents[i - 1].width / 2, extents[i - 1].height == 1 ? 1 : extents[i - 1].height / 2);
 
-	bloom_downsample_chain = Image(
-		env.allocator,
-		vk::ImageType::e2D,
-		vk::Extent3D{extent, 1},
-		vk::Format::eR16G16B16A16Sfloat,
-		vk::ImageTiling::eOptimal,
-		vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eTransferSrc,
-		VMA_MEMORY_USAGE_GPU_ONLY,
-		vk::SharingMode::eExclusive,
-		bloom_downsample_count
+	bloom_downsample_chain_handle = graph.create_image(
+		transient_image_info(
+			extents[0],
+			vk::Format::eR16G16B16A16Sfloat,
+			vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eTransferSrc,
+			bloom_downsample_count
+		),
+		vk::ImageAspectFlagBits::eColor
+	);
+
+	bloom_upsample_chain_handle = graph.create_image(
+		transient_image_info(
+			extents[1],
+			vk::Format::eR16G16B16A16Sfloat,
+			vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferSrc,
+			bloom_downsample_count - 2
+		),
+		vk::ImageAspectFlagBits::eColor
+	);
+
+	// Both chains are filtered, blitted and blurred within the compute pass, barriers between mips are recorded there
+	const vk::AccessFlags chain_access = vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite
+									   | vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite;
+	const vk::PipelineStageFlags chain_stages = vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eTransfer;
+
+	graph.use(passes.compute, bloom_downsample_chain_handle, Image_state{vk::ImageLayout::eGeneral, chain_access, chain_stages});
+
+	// Accumulation leaves every mip of the upsample chain ready for composite
+	const Image_usage upsample_chain_usage(
+		{vk::ImageLayout::eGeneral, chain_access, chain_stages},
+		{vk::ImageLayout::eShaderReadOnlyOptimal, vk::AccessFlagBits::eShaderWrite, vk::PipelineStageFlagBits::eComputeShader}
 	);
 
-	extents[0] = extent;
+	graph.use(passes.compute, bloom_upsample_chain_handle, upsample_chain_usage);
+	graph.use(passes.composite, bloom_upsample_chain_handle, fragment_sampled);
+}
+
+void Bloom_rt::create(const Environment& env, const Render_graph& graph, const Descriptor_pool& pool, const Bloom_pipeline& pipeline)
+{
+	bloom_downsample_chain = graph.image(bloom_downsample_chain_handle);
+	bloom_upsample_chain   = graph.image(bloom_upsample_chain_handle);
+
 	for (auto i : Iota(bloom_downsample_count))
 	{
 		downsample_chain_view[i] = Image_view(
@@ -423,23 +569,8 @@ void Bloom_rt::create(const Environment& env, const Descriptor_pool& pool, const
 			vk::ImageViewType::e2D,
 			{vk::ImageAspectFlagBits::eColor, i, 1, 0, 1}
 		);
-
-		if (i != 0)
-			extents[i] = vk::Extent2D(extents[i - 1].width == 1 ? 1 : extents[i - 1].width / 2, extents[i - 1].height == 1 ? 1 : extents[i - 1].height / 2);
 	}
 
-	bloom_upsample_chain = Image(
-		env.allocator,
-		vk::ImageType::e2D,
-		vk::Extent3D{extents[1], 1},
-		vk::Format::eR16G16B16A16Sfloat,
-		vk::ImageTiling::eOptimal,
-		vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferSrc,
-		VMA_MEMORY_USAGE_GPU_ONLY,
-		vk::SharingMode::eExclusive,
-		bloom_downsample_count - 2
-	);
-
 	upsample_chain_sampler = [=]
 	{
 		const auto sampler_create_info = vk::SamplerCreateInfo()
@@ -569,24 +700,30 @@ Bloom_rt::link_bloom_acc()
 
 #pragma region "Composite RT"
 
-void Composite_rt::create(
-	const Environment& env,
+void Composite_rt::declare(const Environment& env, Render_graph& graph, const Frame_passes& passes)
+{
+	composite_output_handle = graph.create_image(
+		transient_image_info(
+			env.swapchain.extent,
+			env.swapchain.surface_format.format,
+			vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled
+		),
+		vk::ImageAspectFlagBits::eColor
+	);
+
+	graph.use(passes.composite, composite_output_handle, color_attachment_usage(vk::ImageLayout::eShaderReadOnlyOptimal));
+	graph.use(passes.fxaa, composite_output_handle, fragment_sampled);
+}
 
+void Composite_rt::create(
+	const Environment&           env,
+	const Render_graph&          graph,
 	const Render_pass&           render_pass,
 	const Descriptor_pool&       pool,
 	const Descriptor_set_layout& layout
 )
 {
-	composite_output = Image(
-		env.allocator,
-		vk::ImageType::e2D,
-		vk::Extent3D{env.swapchain.extent.width, env.swapchain.extent.height, 1},
-		env.swapchain.surface_format.format,
-		vk::ImageTiling::eOptimal,
-		vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled,
-		VMA_MEMORY_USAGE_GPU_ONLY,
-		vk::SharingMode::eExclusive
-	);
+	composite_output = graph.image(composite_output_handle);
 
 	image_view = Image_view(
 		env.device,
@@ -658,18 +795,8 @@ Write_descriptor_buffer<> Composite_rt::update_uniform(const Composite_pipeline:
 
 #pragma region "Fxaa RT"
 
-void Fxaa_rt::create(
-	const Environment&           env,
-	const Render_pass&           render_pass,
-	const Descriptor_pool&       pool,
-	const Descriptor_set_layout& layout,
-	uint32_t                     idx
-)
+void Fxaa_rt::create(const Environment& env, const Descriptor_pool& pool, const Descriptor_set_layout& layout)
 {
-	image_view = env.swapchain.image_views[idx];
-
-	framebuffer = Framebuffer(env.device, render_pass, {image_view}, vk::Extent3D(env.swapchain.extent, 1));
-
 	const auto sampler_create_info = vk::SamplerCreateInfo()
 										 .setAddressModeU(vk::SamplerAddressMode::eClampToEdge)
 										 .setAddressModeV(vk::SamplerAddressMode::eClampToEdge)
@@ -696,7 +823,6 @@ void Fxaa_rt::create(
 
 	env.debug_marker.set_object_name(params_buffer, "Fxaa Params Buffer")
 		.set_object_name(descriptor_set, "Fxaa Input Descriptor Set")
-		.set_object_name(framebuffer, "Fxaa Framebuffer")
 		.set_object_name(input_sampler, "Fxaa Input Sampler");
 }
 
@@ -715,7 +841,19 @@ Write_descriptor_buffer<> Fxaa_rt::update_uniform(const Fxaa_pipeline::Params& p
 
 #pragma endregion
 
-void Render_target_set::create(const Environment& env, const Pipeline_set& pipeline, uint32_t idx)
+#pragma region "Present RT"
+
+void Present_rt::create(const Environment& env, const Render_pass& render_pass, uint32_t idx)
+{
+	image_view  = env.swapchain.image_views[idx];
+	framebuffer = Framebuffer(env.device, render_pass, {image_view}, vk::Extent3D(env.swapchain.extent, 1));
+
+	env.debug_marker.set_object_name(framebuffer, std::format("Present Framebuffer (Index {})", idx));
+}
+
+#pragma endregion
+
+void Render_target_set::create(const Environment& env, const Pipeline_set& pipeline)
 {
 	Pool_size_calculator pool_size_calculator;
 	pool_size_calculator.add(Shadow_pipeline::descriptor_pool_size)
@@ -729,23 +867,48 @@ void Render_target_set::create(const Environment& env, const Pipeline_set& pipel
 
 	shared_pool = Descriptor_pool(env.device, descriptor_pool_sizes, 1024);
 
+	/* Render Graph */
+
+	graph.reset();
+	passes.declare(env, graph);
+
+	shadow_rt.declare(graph, passes, shadow_map_res);
+	gbuffer_rt.declare(env, graph, passes);
+	lighting_rt.declare(env, graph, passes);
+	bloom_rt.declare(env, graph, passes);
+	composite_rt.declare(env, graph, passes);
+
+	graph.compile(env.allocator);
+
+	const auto& statistics = graph.memory_statistics();
+	env.log_msg(
+		"Render graph: {} transient images in {} allocations, {:.1f} MiB aliased into {:.1f} MiB",
+		statistics.image_count,
+		statistics.allocation_count,
+		statistics.requested / 1048576.0,
+		statistics.allocated / 1048576.0
+	);
+
+	/* Render Targets */
+
 	shadow_rt.create(
 		env,
+		graph,
 		pipeline.shadow_pipeline.render_pass,
 		shared_pool,
 		pipeline.shadow_pipeline.descriptor_set_layout_shadow_matrix,
 		shadow_map_res
 	);
 
-	gbuffer_rt.create(env, pipeline.gbuffer_pipeline.render_pass, shared_pool, pipeline.gbuffer_pipeline.descriptor_set_layout_camera);
+	gbuffer_rt.create(env, graph, pipeline.gbuffer_pipeline.render_pass, shared_pool, pipeline.gbuffer_pipeline.descriptor_set_layout_camera);
 
-	lighting_rt.create(env, pipeline.lighting_pipeline.render_pass, shared_pool, pipeline.lighting_pipeline.gbuffer_input_layout);
+	lighting_rt.create(env, graph, pipeline.lighting_pipeline.render_pass, shared_pool, pipeline.lighting_pipeline.gbuffer_input_layout);
 
-	bloom_rt.create(env, shared_pool, pipeline.bloom_pipeline);
+	bloom_rt.create(env, graph, shared_pool, pipeline.bloom_pipeline);
 
-	composite_rt.create(env, pipeline.composite_pipeline.render_pass, shared_pool, pipeline.composite_pipeline.descriptor_set_layout);
+	composite_rt.create(env, graph, pipeline.composite_pipeline.render_pass, shared_pool, pipeline.composite_pipeline.descriptor_set_layout);
 
-	fxaa_rt.create(env, pipeline.fxaa_pipeline.render_pass, shared_pool, pipeline.fxaa_pipeline.descriptor_set_layout, idx);
+	fxaa_rt.create(env, shared_pool, pipeline.fxaa_pipeline.descriptor_set_layout);
 }
 
 void Render_target_set::link(const Environment& env, const Auto_exposure_compute_rt& auto_exposure_rt)
@@ -830,25 +993,27 @@ void Render_targets::create(const Environment& env, const Pipeline_set& pipeline
 
 	Pool_size_calculator pool_calculator;
 	pool_calculator.add(Auto_exposure_compute_pipeline::unvaried_descriptor_pool_size)
-		.add(Auto_exposure_compute_pipeline::descriptor_pool_size, env.swapchain.image_count);
+		.add(Auto_exposure_compute_pipeline::descriptor_pool_size, frames_in_flight);
 
 	const auto pool_sizes = pool_calculator.get();
 
 	shared_pool = Descriptor_pool(env.device, pool_sizes, 16);
 
-	auto_exposure_rt.create(env, shared_pool, pipeline.auto_exposure_pipeline, env.swapchain.image_count);
+	auto_exposure_rt.create(env, shared_pool, pipeline.auto_exposure_pipeline, frames_in_flight);
 
 	/* Render Target Sets */
 
-	render_target_set.clear();
-	render_target_set.resize(env.swapchain.image_count);
-
-	for (auto i : Iota(env.swapchain.image_count))
+	for (auto& set : render_target_set)
 	{
-		render_target_set[i].create(env, pipeline, i);
-		render_target_set[i].link(env, auto_exposure_rt);
+		set.create(env, pipeline);
+		set.link(env, auto_exposure_rt);
 	}
 
+	present_rt.clear();
+	present_rt.resize(env.swapchain.image_count);
+
+	for (auto i : Iota(env.swapchain.image_count)) present_rt[i].create(env, pipeline.fxaa_pipeline.render_pass, i);
+
 	link(env);
 
 	create_sync_objects(env);
@@ -856,9 +1021,36 @@ void Render_targets::create(const Environment& env, const Pipeline_set& pipeline
 
 void Render_targets::create_sync_objects(const Environment& env)
 {
-	acquire_semaphore     = Semaphore(env.device);
-	render_done_semaphore = Semaphore(env.device);
-	next_frame_fence      = Fence(env.device, vk::FenceCreateFlagBits::eSignaled);
+	for (auto& sync : frame_sync)
+	{
+		sync.acquire_semaphore     = Semaphore(env.device);
+		sync.render_done_semaphore = Semaphore(env.device);
+		sync.next_frame_fence      = Fence(env.device, vk::FenceCreateFlagBits::eSignaled);
+	}
+
+	image_fences.assign(env.swapchain.image_count, nullptr);
+	frame_idx = 0;
+}
+
+void Render_targets::wait_frame(const Environment& env) const
+{
+	const auto wait_fence_result = env.device->waitForFences({current_frame().next_frame_fence}, true, 1e10);
+	if (wait_fence_result != vk::Result::eSuccess) throw error::Detailed_error("Fence wait timeout!");
+}
+
+void Render_targets::acquire_image(const Environment& env, uint32_t image_idx)
+{
+	const vk::Fence frame_fence = current_frame().next_frame_fence;
+
+	// Another frame in flight may still be using the render target set of this image
+	if (image_fences[image_idx] && image_fences[image_idx] != frame_fence)
+	{
+		const auto wait_fence_result = env.device->waitForFences({image_fences[image_idx]}, true, 1e10);
+		if (wait_fence_result != vk::Result::eSuccess) throw error::Detailed_error("Fence wait timeout!");
+	}
+
+	image_fences[image_idx] = frame_fence;
+	env.device->resetFences({frame_fence});
 }
 
 void Render_targets::link(const Environment& env)
@@ -0,0 +1,63 @@
+#include "vklib/gltf.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+
+using namespace VKLIB_HPP_NAMESPACE;
+
+// Converts a glTF file into a cooked scene, loadable with `io::gltf::Model::load_cooked`
+int main(int argc, char** argv)
+{
+	const std::vector<std::string_view> args(argv + 1, argv + argc);
+
+	io::gltf::Cook_config    config;
+	std::vector<std::string> paths;
+
+	for (const auto arg : args)
+	{
+		if (arg == "--uncompressed")
+			config.compress_textures = false;
+		else
+			paths.emplace_back(arg);
+	}
+
+	if (paths.empty() || paths.size() > 2)
+	{
+		std::cerr << "Usage: gltf_cooker <input.gltf|input.glb> [output.vkscene] [--uncompressed]\n"
+					 "  --uncompressed  Store textures as 8-bit RGBA, for devices without BC texture compression\n";
+		return EXIT_FAILURE;
+	}
+
+	const auto& input  = paths[0];
+	const auto  output = paths.size() > 1 ? paths[1] : std::filesystem::path(input).replace_extension(".vkscene").string();
+
+	try
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		io::gltf::Model::cook(input, output, config);
+
+		const auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+		std::cout << std::format(
+			"Cooked \"{}\" into \"{}\" ({:.1f} MiB) in {:.2f}s\n",
+			input,
+			output,
+			std::filesystem::file_size(output) / 1048576.0,
+			duration.count()
+		);
+
+		return EXIT_SUCCESS;
+	}
+	catch (const error::Detailed_error& err)
+	{
+		std::cerr << std::format("Error: {}\n", err.msg);
+		if (!err.detail.empty()) std::cerr << std::format("Detail: {}\n", err.detail);
+	}
+	catch (const std::exception& err)
+	{
+		std::cerr << std::format("Unknown Error: {}\n", err.what());
+	}
+
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,11 @@
+target("gltf_cooker")
+
+	-- Basic Properties
+	set_kind("binary")
+	set_languages("c++20")
+
+	-- Dependencies
+	add_deps("vklib_core", "vklib_gltf")
+
+	-- Source Files
+	add_files("src/*.cpp")
@@ -1 +1,2 @@
-includes("deferred-shading-gltf")
\ No newline at end of file
+includes("deferred-shading-gltf")
+includes("gltf-cooker")
\ No newline at end of file
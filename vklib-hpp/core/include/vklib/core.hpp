@@ -9,7 +9,12 @@
 #include <vklib/core/env.hpp>
 #include <vklib/core/io.hpp>
 #include <vklib/core/pipeline.hpp>
+#include <vklib/core/profiler.hpp>
+#include <vklib/core/query.hpp>
+#include <vklib/core/render-graph.hpp>
+#include <vklib/core/staging.hpp>
 #include <vklib/core/storage.hpp>
 #include <vklib/core/swapchain.hpp>
 #include <vklib/core/sync.hpp>
+#include <vklib/core/thread-pool.hpp>
 #include <vklib/core/utility.hpp>
@@ -5,11 +5,36 @@ namespace VKLIB_HPP_NAMESPACE::algorithm
 {
 	namespace conversion
 	{
-		// Convert float32 to float16
+		// Convert float32 to float16, rounded to nearest even. Denormals are kept, NaNs become quiet NaNs
 		uint16_t f32_to_f16(float f32);
 
 		// Convert float32 to float16, output clamped to avoid NaN and Inf
 		uint16_t f32_to_f16_clamped(float f32);
+
+		// Convert `src` to float16 into `dst` in bulk, vectorized where available.
+		// Matches `f32_to_f16` per element, except for NaN payloads
+		void f32_to_f16(std::span<const float> src, std::span<uint16_t> dst);
+
+		// Convert `src` to float16 into `dst` in bulk, vectorized where available. Matches `f32_to_f16_clamped` per element
+		void f32_to_f16_clamped(std::span<const float> src, std::span<uint16_t> dst);
+
+		// Kernels of the bulk conversions
+		enum class F16_path
+		{
+			Scalar,
+			Sse2,  // x86 with SSE2
+			F16c   // x86 with AVX & F16C, detected at runtime. NaN payloads are kept instead of being replaced
+		};
+
+		// Whether `path` is compiled in and supported by the CPU
+		bool f16_path_supported(F16_path path);
+
+		// Fastest supported kernel, used by the bulk conversions above
+		F16_path f16_default_path();
+
+		// Bulk conversions with an explicit kernel, e.g. to test them against each other. Throws if `path` isn't supported
+		void f32_to_f16(std::span<const float> src, std::span<uint16_t> dst, F16_path path);
+		void f32_to_f16_clamped(std::span<const float> src, std::span<uint16_t> dst, F16_path path);
 	}
 
 	namespace geometry
@@ -109,6 +134,23 @@ namespace VKLIB_HPP_NAMESPACE::algorithm
 				bool on_frustum(const Frustum& frustum) const;
 				bool inside(const glm::vec3& point) const;
 			};
+
+			// AABBs stored as structure-of-arrays, tested in batches with SIMD instructions when available
+			struct AABB_batch
+			{
+				std::vector<float> center_x, center_y, center_z, extent_x, extent_y, extent_z;
+
+				size_t size() const { return center_x.size(); }
+
+				void clear();
+				void resize(size_t size);
+				void push_back(const AABB& box);
+				void set(size_t idx, const AABB& box);
+
+				// Tests boxes in [first, first + mask.size()) against `plane` with the same criteria as `AABB::intersect_or_forward`.
+				// Failed boxes are cleared in `mask`
+				void intersect_or_forward(const Plane& plane, std::span<uint8_t> mask, size_t first = 0) const;
+			};
 		};
 	}
 
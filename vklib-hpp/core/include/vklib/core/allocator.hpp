@@ -47,6 +47,15 @@ namespace VKLIB_HPP_NAMESPACE
 
 		void unmap_memory() const { vmaUnmapMemory(this->parent(), this->data->child.alloc_handle); }
 
+		// Persistently mapped memory of allocations created with `VMA_ALLOCATION_CREATE_MAPPED_BIT`, `nullptr` otherwise
+		void* mapped_data() const
+		{
+			VmaAllocationInfo alloc_info;
+			vmaGetAllocationInfo(this->parent(), this->data->child.alloc_handle, &alloc_info);
+
+			return alloc_info.pMappedData;
+		}
+
 		template <std::ranges::contiguous_range Data_T>
 		void operator<<(const Data_T& data_span) const
 		{
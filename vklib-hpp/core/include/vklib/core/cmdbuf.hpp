@@ -2,6 +2,7 @@
 
 #include "vklib/core/base.hpp"
 #include "vklib/core/pipeline.hpp"
+#include "vklib/core/query.hpp"
 #include "vklib/core/storage.hpp"
 
 
@@ -57,6 +58,14 @@ namespace VKLIB_HPP_NAMESPACE
 
 		vk::Result begin(bool one_time_submit = false) const;
 
+		// Begin a secondary command buffer executed inside `subpass` of `render_pass`
+		vk::Result begin_secondary(
+			const Render_pass& render_pass,
+			uint32_t           subpass,
+			const Framebuffer& framebuffer,
+			bool               one_time_submit = true
+		) const;
+
 		inline void end() const { data->child.end(); }
 		inline void reset() const { data->child.reset(); }
 
@@ -75,6 +84,11 @@ namespace VKLIB_HPP_NAMESPACE
 
 		inline void end_render_pass() const { data->child.endRenderPass(); }
 
+		inline void execute_commands(Array_proxy<vk::CommandBuffer> command_buffers) const
+		{
+			data->child.executeCommands(command_buffers);
+		}
+
 		/* Draw */
 
 		inline void draw(uint32_t first_vertex, uint32_t vertex_count, uint32_t first_instance, uint32_t instance_count) const
@@ -82,6 +96,23 @@ namespace VKLIB_HPP_NAMESPACE
 			data->child.draw(vertex_count, instance_count, first_vertex, first_instance);
 		}
 
+		inline void draw_indexed(
+			uint32_t first_index,
+			uint32_t index_count,
+			int32_t  vertex_offset,
+			uint32_t first_instance,
+			uint32_t instance_count
+		) const
+		{
+			data->child.drawIndexed(index_count, instance_count, first_index, vertex_offset, first_instance);
+		}
+
+		// Draws `draw_count` `vk::DrawIndexedIndirectCommand`s stored in `buffer`, starting at `offset`
+		inline void draw_indexed_indirect(const Buffer& buffer, vk::DeviceSize offset, uint32_t draw_count, uint32_t stride) const
+		{
+			data->child.drawIndexedIndirect(buffer, offset, draw_count, stride);
+		}
+
 		inline void set_viewport(const vk::Viewport& viewport) const { data->child.setViewport(0, viewport); }
 		inline void set_scissor(const vk::Rect2D& scissor) const { data->child.setScissor(0, scissor); }
 
@@ -112,6 +143,11 @@ namespace VKLIB_HPP_NAMESPACE
 			data->child.bindVertexBuffers(first_binding, vertex_buffer, offsets);
 		}
 
+		inline void bind_index_buffer(const vk::Buffer& index_buffer, vk::DeviceSize offset, vk::IndexType index_type) const
+		{
+			data->child.bindIndexBuffer(index_buffer, offset, index_type);
+		}
+
 		inline void push_constants(
 			const Pipeline_layout& pipeline_layout,
 			vk::ShaderStageFlags   shader_stage,
@@ -189,5 +225,18 @@ namespace VKLIB_HPP_NAMESPACE
 			uint32_t                  src_queue_family_idx = vk::QueueFamilyIgnored,
 			uint32_t                  dst_queue_family_idx = vk::QueueFamilyIgnored
 		) const;
+
+		/* Query */
+
+		inline void reset_query_pool(const Query_pool& query_pool, uint32_t first, uint32_t count) const
+		{
+			data->child.resetQueryPool(query_pool, first, count);
+		}
+
+		// Writes the timestamp into `query` once all previous commands have completed `stage`
+		inline void write_timestamp(vk::PipelineStageFlagBits stage, const Query_pool& query_pool, uint32_t query) const
+		{
+			data->child.writeTimestamp(stage, query_pool, query);
+		}
 	};
 }
\ No newline at end of file
@@ -106,6 +106,9 @@ namespace VKLIB_HPP_NAMESPACE
 		Command_pool(const Device& device, const vk::CommandPoolCreateInfo& create_info);
 		Command_pool(const Device& device, uint32_t queue_family_idx, vk::CommandPoolCreateFlags flags = {});
 
+		// Resets all command buffers allocated from the pool
+		inline void reset(vk::CommandPoolResetFlags flags = {}) const { parent()->resetCommandPool(data->child, flags); }
+
 		void clean() override;
 		~Command_pool() override { clean(); }
 	};
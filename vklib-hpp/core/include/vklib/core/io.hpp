@@ -5,6 +5,7 @@
 // [Description]
 // - Defines IO_exception class
 // - Provides very basic file reading & writing functions
+// - Provides read-only memory mapped files
 
 #pragma once
 
@@ -26,6 +27,38 @@ namespace VKLIB_HPP_NAMESPACE::io
 	// > Writes binary data to a file
 	void write(const std::string& path, std::span<const uint8_t> data);
 
+	// > Read-only memory mapping of a whole file.
+	// Pages are loaded by the OS on access and can be evicted under memory pressure, so large files are never copied as a whole
+	class Mapped_file
+	{
+	  public:
+
+		Mapped_file() = default;
+
+		// Maps the whole file at `path`, throws `error::IO_error` on failure
+		explicit Mapped_file(const std::string& path);
+
+		Mapped_file(const Mapped_file&)            = delete;
+		Mapped_file& operator=(const Mapped_file&) = delete;
+
+		Mapped_file(Mapped_file&& other) noexcept;
+		Mapped_file& operator=(Mapped_file&& other) noexcept;
+
+		~Mapped_file() { unmap(); }
+
+		std::span<const uint8_t> data() const { return {mapped_data, mapped_size}; }
+		size_t                   size() const { return mapped_size; }
+
+		operator std::span<const uint8_t>() const { return data(); }
+
+	  private:
+
+		const uint8_t* mapped_data = nullptr;
+		size_t         mapped_size = 0;
+
+		void unmap();
+	};
+
 	namespace mesh
 	{
 	};
@@ -0,0 +1,91 @@
+// vklib/core/profiler.hpp
+// ================
+// [Author] Hsin-chieh Liu (Stehsaer)
+// ================
+// [Description]
+// - Provides a scoped-zone CPU profiler, exporting captures as Chrome trace events
+// - Zones are only recorded when `VKLIB_ENABLE_PROFILER` is defined, otherwise the macros expand to nothing
+
+#pragma once
+
+#include "vklib/core/common.hpp"
+
+#define VKLIB_PROFILE_CONCAT_IMPL(a, b) a##b
+#define VKLIB_PROFILE_CONCAT(a, b)      VKLIB_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef VKLIB_ENABLE_PROFILER
+// Records a zone named `name` (a string literal) from here to the end of the enclosing scope
+#define VKLIB_PROFILE_ZONE(name) \
+	const ::VKLIB_HPP_NAMESPACE::utility::Profile_zone VKLIB_PROFILE_CONCAT(vklib_profile_zone_, __LINE__)(name)
+// Names the calling thread in exported traces
+#define VKLIB_PROFILE_THREAD_NAME(name) ::VKLIB_HPP_NAMESPACE::utility::Cpu_profiler::set_thread_name(name)
+#else
+#define VKLIB_PROFILE_ZONE(name)        ((void)0)
+#define VKLIB_PROFILE_THREAD_NAME(name) ((void)0)
+#endif
+
+namespace VKLIB_HPP_NAMESPACE::utility
+{
+	// > Collects zones of all threads during a capture.
+	// Every thread appends to its own fixed-size event buffer, allocated & registered under a lock on its first event in a capture.
+	// Captures are started and stopped by the same controlling thread, which also exports them.
+	class Cpu_profiler
+	{
+	  public:
+
+#ifdef VKLIB_ENABLE_PROFILER
+		static constexpr bool enabled = true;
+#else
+		static constexpr bool enabled = false;
+#endif
+
+		static constexpr size_t thread_capacity = 1 << 16;  // Events per thread in a capture, later ones are dropped
+
+		struct Event
+		{
+			const char* name;
+			uint64_t    begin_ns, end_ns;
+		};
+
+		// Nanoseconds since the profiler epoch
+		static uint64_t now_ns();
+
+		static void set_thread_name(std::string name);
+
+		// Discards events of the previous capture
+		static void begin_capture();
+		static void end_capture();
+		static bool capturing();
+
+		// Events dropped in the current capture because a thread buffer was full
+		static size_t dropped_count();
+
+		static void record(const char* name, uint64_t begin_ns, uint64_t end_ns);
+
+		// > Writes events of the last capture as Chrome `trace_event` JSON, viewable in `chrome://tracing` or Perfetto.
+		// Must be called after `end_capture()`, throws `error::IO_error` on failure
+		static void write_chrome_trace(const std::string& path);
+	};
+
+	// Records a zone from construction to destruction, prefer `VKLIB_PROFILE_ZONE`
+	class Profile_zone
+	{
+	  public:
+
+		explicit Profile_zone(const char* name) :
+			name(name),
+			begin_ns(Cpu_profiler::now_ns())
+		{
+		}
+
+		~Profile_zone() { Cpu_profiler::record(name, begin_ns, Cpu_profiler::now_ns()); }
+
+		Profile_zone(const Profile_zone&)            = delete;
+		Profile_zone& operator=(const Profile_zone&) = delete;
+
+	  private:
+
+		const char* name;
+		uint64_t    begin_ns;
+	};
+}
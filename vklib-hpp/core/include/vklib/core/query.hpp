@@ -0,0 +1,35 @@
+// vklib/core/query.hpp
+// ================
+// [Author] Hsin-chieh Liu (Stehsaer)
+// ================
+// [Description]
+// - Wraps query pools, e.g. for GPU timestamps
+
+#pragma once
+
+#include "vklib/core/env.hpp"
+
+namespace VKLIB_HPP_NAMESPACE
+{
+	class Query_pool : public Child_resource<vk::QueryPool, Device>
+	{
+		using Child_resource<vk::QueryPool, Device>::Child_resource;
+
+		void clean() override;
+
+	  public:
+
+		Query_pool(
+			const Device&                   device,
+			vk::QueryType                   type,
+			uint32_t                        count,
+			vk::QueryPipelineStatisticFlags pipeline_statistics = {}
+		);
+
+		// > Reads 64-bit results of queries in [first, first + results.size()) without waiting.
+		// Returns `vk::Result::eNotReady` if any of the queries isn't available yet
+		vk::Result get_results(uint32_t first, std::span<uint64_t> results, vk::QueryResultFlags flags = {}) const;
+
+		~Query_pool() override { clean(); }
+	};
+}
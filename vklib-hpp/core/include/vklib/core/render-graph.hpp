@@ -0,0 +1,151 @@
+// vklib/core/render-graph.hpp
+// ================
+// [Author] Hsin-chieh Liu (Stehsaer)
+// ================
+// [Description]
+// - Declares the passes of a frame and the images they use
+// - Derives layout transitions, memory dependencies and queue family ownership transfers between passes
+// - Aliases memory of transient images whose lifetimes in the frame don't overlap
+
+#pragma once
+
+#include "vklib/core/cmdbuf.hpp"
+#include "vklib/core/storage.hpp"
+
+namespace VKLIB_HPP_NAMESPACE
+{
+	// Layout, access and pipeline stages of an image at some point of the frame
+	struct Image_state
+	{
+		vk::ImageLayout        layout = vk::ImageLayout::eUndefined;
+		vk::AccessFlags        access = {};
+		vk::PipelineStageFlags stages = vk::PipelineStageFlagBits::eTopOfPipe;
+	};
+
+	// > How a pass uses an image: `begin` is the state the pass expects, `end` the state it leaves the image in.
+	// They differ when the render pass of the pass transitions the image.
+	// A `begin` layout of `eUndefined` discards previous contents, the render pass then performs the transition
+	struct Image_usage
+	{
+		Image_state begin, end;
+
+		Image_usage(const Image_state& state) :
+			begin(state),
+			end(state)
+		{
+		}
+
+		Image_usage(const Image_state& begin, const Image_state& end) :
+			begin(begin),
+			end(end)
+		{
+		}
+	};
+
+	// > Passes run in the order they are added. Passes on different queues must be ordered the same way by semaphores,
+	// whose wait stages cover the stages of the images' first usage after the queue switch.
+	// Handles stay valid until `reset`
+	class Render_graph
+	{
+	  public:
+
+		using Handle = uint32_t;
+
+		struct Memory_statistics
+		{
+			vk::DeviceSize requested = 0;  // sum of the sizes of transient images
+			vk::DeviceSize allocated = 0;  // memory actually allocated after aliasing
+			uint32_t       image_count = 0, allocation_count = 0;
+		};
+
+		// Image outliving the frame, owned by `queue_family_idx` and in `initial` state at the start of every frame
+		Handle import_image(
+			vk::Image                        image,
+			const vk::ImageSubresourceRange& subresource_range,
+			const Image_state&               initial,
+			uint32_t                         queue_family_idx = vk::QueueFamilyIgnored
+		);
+
+		// > Image living within the frame, created by `compile`. Its contents don't survive the frame.
+		// Must be created with optimal tiling, exclusive sharing and an undefined initial layout
+		Handle create_image(const vk::ImageCreateInfo& create_info, vk::ImageAspectFlags aspect);
+
+		Handle add_pass(uint32_t queue_family_idx);
+
+		// Declares that `pass` uses `image`, at most once per pass
+		void use(Handle pass, Handle image, const Image_usage& usage);
+
+		// Creates transient images, sharing memory between images with disjoint lifetimes, then derives barriers of every pass
+		void compile(const Vma_allocator& allocator);
+
+		// Releases transient images and forgets all declarations
+		void reset() { *this = Render_graph(); }
+
+		// Records barriers needed before `pass`: acquires, layout transitions and memory dependencies
+		void begin_pass(const Command_buffer& command_buffer, Handle pass) const;
+
+		// Records ownership releases towards later passes on other queue families
+		void end_pass(const Command_buffer& command_buffer, Handle pass) const;
+
+		// Transient image created by `compile`
+		const Image& image(Handle image) const;
+
+		const Memory_statistics& memory_statistics() const { return statistics; }
+
+	  private:
+
+		struct Image_resource
+		{
+			vk::Image                 handle;
+			vk::ImageSubresourceRange subresource_range;
+			Image_state               initial;
+			uint32_t                  queue_family_idx = vk::QueueFamilyIgnored;
+
+			// Transient only
+			bool                transient = false;
+			vk::ImageCreateInfo create_info;
+			Image               image;
+			uint32_t            block = 0;
+
+			std::vector<std::pair<Handle, Image_usage>> usages;  // (pass, usage), in pass order
+		};
+
+		// Barriers recorded with a single `vkCmdPipelineBarrier`
+		struct Barriers
+		{
+			vk::PipelineStageFlags              src_stages, dst_stages;
+			std::vector<vk::ImageMemoryBarrier> image_barriers;
+			vk::MemoryBarrier                   memory_barrier;
+			bool                                has_memory_barrier = false;
+
+			void add(const vk::ImageMemoryBarrier& barrier, vk::PipelineStageFlags src, vk::PipelineStageFlags dst);
+			void add(const vk::MemoryBarrier& barrier, vk::PipelineStageFlags src, vk::PipelineStageFlags dst);
+			void record(const Command_buffer& command_buffer) const;
+		};
+
+		struct Pass
+		{
+			uint32_t queue_family_idx;
+			Barriers begin, end;
+		};
+
+		// Memory shared by transient images, occupied one after another
+		struct Memory_block
+		{
+			vk::MemoryRequirements requirements;
+			uint32_t               last_pass;
+			std::vector<Handle>    images;  // in lifetime order
+			Vma_memory             memory;
+		};
+
+		// Blocks go first, so images bound to them are destroyed before the memory is freed
+		std::vector<Memory_block>   blocks;
+		std::vector<Image_resource> images;
+		std::vector<Pass>           passes;
+		Memory_statistics           statistics;
+		bool                        compiled = false;
+
+		void allocate_transient_images(const Vma_allocator& allocator);
+		void derive_barriers(Handle image);
+	};
+}
@@ -0,0 +1,124 @@
+// vklib/core/staging.hpp
+// ================
+// [Author] Hsin-chieh Liu (Stehsaer)
+// ================
+// [Description]
+// - Provides a fixed-size staging ring for streaming uploads to device-local resources
+
+#pragma once
+
+#include "vklib/core/cmdbuf.hpp"
+#include "vklib/core/storage.hpp"
+#include "vklib/core/sync.hpp"
+
+#include <functional>
+#include <mutex>
+
+namespace VKLIB_HPP_NAMESPACE
+{
+	// Host-visible staging memory split into `chunk_count` chunks, each recorded into its own command buffer.
+	// A full chunk is submitted right away and reused once its fence signals, so peak staging memory stays at `capacity`.
+	// Not thread-safe, callers uploading from multiple threads must synchronize externally.
+	// If `queue_mutex` is given, it is held while submitting to the queue or waiting for chunks, for queues shared with other threads.
+	class Staging_ring
+	{
+	  public:
+
+		static constexpr uint32_t       chunk_count = 4;
+		static constexpr vk::DeviceSize alignment   = 16;  // satisfies texel size and `optimalBufferCopyOffsetAlignment`
+
+		// Fills the staging memory `dst`
+		using Write_func = std::function<void(std::span<uint8_t> dst)>;
+
+		// Records transfer commands reading from `staging` at `offset`
+		using Record_func = std::function<void(const Command_buffer& command_buffer, const Buffer& staging, vk::DeviceSize offset)>;
+
+		// Fills the staging memory `dst` with `row_count` rows from `first_row` on
+		using Write_rows_func = std::function<void(std::span<uint8_t> dst, uint32_t first_row, uint32_t row_count)>;
+
+		// Records transfer commands reading `row_count` rows from `first_row` on, staged in `staging` at `offset`
+		using Record_rows_func = std::function<void(
+			const Command_buffer& command_buffer,
+			const Buffer&         staging,
+			vk::DeviceSize        offset,
+			uint32_t              first_row,
+			uint32_t              row_count
+		)>;
+
+		// Records commands that don't read staging memory
+		using Command_func = std::function<void(const Command_buffer& command_buffer)>;
+
+		Staging_ring() = default;
+
+		Staging_ring(
+			const Vma_allocator& allocator,
+			const Device&        device,
+			const Command_pool&  command_pool,
+			const Queue&         queue,
+			vk::DeviceSize       capacity,
+			std::mutex*          queue_mutex = nullptr
+		);
+
+		Staging_ring(const Staging_ring&)            = delete;
+		Staging_ring& operator=(const Staging_ring&) = delete;
+		Staging_ring(Staging_ring&&)                 = default;
+		Staging_ring& operator=(Staging_ring&&)      = default;
+
+		// Waits for chunks still in flight, so staging memory isn't released while in use
+		~Staging_ring();
+
+		// > Stages `size` bytes filled by `write`, then records the transfer with `record`.
+		// Uploads larger than a chunk fall back to a dedicated staging buffer. Its chunk is submitted right away and the buffer
+		// released once the chunk is reused, so no more than `chunk_count` of them are alive at once.
+		// Prefer `upload_rows` or `upload_buffer` for data that may exceed a chunk.
+		void upload(vk::DeviceSize size, const Write_func& write, const Record_func& record);
+
+		// > Stages `row_count` rows of `row_size` bytes, e.g. texel or block rows of an image, split into pieces of whole rows
+		// that fit in a chunk. Only rows larger than a chunk fall back to dedicated staging buffers, see `upload`
+		void upload_rows(uint32_t row_count, vk::DeviceSize row_size, const Write_rows_func& write, const Record_rows_func& record);
+
+		// Uploads `data` to `dst_buffer` at `dst_offset`, split into chunk-sized pieces
+		void upload_buffer(const Buffer& dst_buffer, std::span<const uint8_t> data, vk::DeviceSize dst_offset = 0);
+
+		// Records `func` into the chunk being recorded, after all commands recorded so far, e.g. layout transitions around uploads
+		void record(const Command_func& func);
+
+		// Submits the chunk being recorded, without waiting
+		void flush();
+
+		// Submits the chunk being recorded and waits for all chunks to complete
+		void finish();
+
+	  private:
+
+		struct Chunk
+		{
+			Command_buffer      command_buffer;
+			Fence               fence;
+			vk::DeviceSize      used      = 0;
+			bool                recording = false, pending = false;
+			std::vector<Buffer> dedicated_buffers;
+		};
+
+		Vma_allocator allocator;
+		Device        device;
+		Command_pool  command_pool;
+		Queue         queue;
+		std::mutex*   queue_mutex = nullptr;
+
+		Buffer             buffer;
+		uint8_t*           mapped     = nullptr;
+		vk::DeviceSize     chunk_size = 0;
+		std::vector<Chunk> chunks;
+		uint32_t           current = 0;
+
+		// Returns the chunk to record into, moving on to the next chunk when `size` doesn't fit
+		Chunk& acquire(vk::DeviceSize size);
+
+		// Submits the chunk being recorded and moves on to the next one, waiting until it's free
+		void advance();
+
+		void submit(Chunk& chunk);
+		void wait(Chunk& chunk);
+	};
+}
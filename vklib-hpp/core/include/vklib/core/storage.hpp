@@ -5,6 +5,20 @@
 
 namespace VKLIB_HPP_NAMESPACE
 {
+	// Device memory allocated from VMA without a resource bound, for images sharing memory
+	class Vma_memory : public Child_resource<VmaAllocation, Vma_allocator>
+	{
+		using Child_resource<VmaAllocation, Vma_allocator>::Child_resource;
+
+		void clean() override;
+
+	  public:
+
+		Vma_memory(const Vma_allocator& allocator, const vk::MemoryRequirements& requirements, VmaMemoryUsage mem_usage);
+
+		~Vma_memory() override { clean(); }
+	};
+
 	class Image : public Vma_allocation<vk::Image>
 	{
 		using Vma_allocation<vk::Image>::Vma_allocation;
@@ -31,6 +45,10 @@ namespace VKLIB_HPP_NAMESPACE
 			vk::ImageCreateFlags    create_flags   = {}
 		);
 
+		// > Creates an image bound to `memory` at `offset`, without owning the memory.
+		// Images whose lifetimes don't overlap may alias the same memory; `memory` must outlive the image
+		Image(const Vma_allocator& allocator, const Vma_memory& memory, vk::DeviceSize offset, const vk::ImageCreateInfo& create_info);
+
 		~Image() override { clean(); }
 	};
 
@@ -0,0 +1,80 @@
+// vklib/core/thread-pool.hpp
+// ================
+// [Author] Hsin-chieh Liu (Stehsaer)
+// ================
+// [Description]
+// - Provides a fixed-size thread pool for CPU-side parallel work
+
+#pragma once
+
+#include "vklib/core/common.hpp"
+#include "vklib/core/helper.hpp"
+
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+namespace VKLIB_HPP_NAMESPACE::utility
+{
+	// > Fixed-size thread pool, workers consume tasks from a shared FIFO queue
+	// Workers are stopped and joined on destruction, pending tasks are discarded
+	class Thread_pool
+	{
+	  public:
+
+		Thread_pool(size_t thread_count = std::max(std::thread::hardware_concurrency(), 1u));
+		~Thread_pool();
+
+		Thread_pool(const Thread_pool&)            = delete;
+		Thread_pool(Thread_pool&&)                 = delete;
+		Thread_pool& operator=(const Thread_pool&) = delete;
+		Thread_pool& operator=(Thread_pool&&)      = delete;
+
+		// > Submits a task to the pool
+		// Returns `std::future` of the task result, exceptions thrown by the task are forwarded to the future
+		template <typename Func_T>
+		No_discard std::future<std::invoke_result_t<Func_T>> submit(Func_T&& func)
+		{
+			using Result_T = std::invoke_result_t<Func_T>;
+
+			auto task   = std::make_shared<std::packaged_task<Result_T()>>(std::forward<Func_T>(func));
+			auto future = task->get_future();
+
+			{
+				const std::lock_guard lock(mutex);
+				tasks.emplace(
+					[task]
+					{
+						(*task)();
+					}
+				);
+			}
+			condition.notify_one();
+
+			return future;
+		}
+
+		// > Runs `func(idx)` for every `idx` in [0, count), and blocks until all of them are finished
+		// The calling thread takes part in the work. The first exception thrown is rethrown after all workers stopped.
+		// Must NOT be called from a worker thread of the same pool.
+		void parallel_for(size_t count, const std::function<void(size_t)>& func);
+
+		size_t size() const { return workers.size(); }
+
+		// > Index of the calling thread among the workers of this pool, in [0, size())
+		// Returns `size()` if the calling thread is not a worker of this pool (e.g. the thread calling `parallel_for`)
+		size_t worker_index() const;
+
+	  private:
+
+		std::vector<std::jthread>         workers;
+		std::queue<std::function<void()>> tasks;
+
+		std::mutex                  mutex;
+		std::condition_variable_any condition;
+
+		void worker_func(std::stop_token stop_token, size_t index);
+	};
+}
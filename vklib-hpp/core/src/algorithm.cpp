@@ -1,8 +1,31 @@
 #include "vklib/core/algorithm.hpp"
 
+#include <bit>
+#include <cmath>
 #include <memory_resource>
 #include <stack>
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#define VKLIB_AABB_BATCH_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VKLIB_AABB_BATCH_SSE
+#endif
+
+// The F16C kernel is compiled for its own target and only used when the CPU reports F16C at runtime
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#define VKLIB_F16_CONVERSION_SSE
+#define VKLIB_F16_CONVERSION_F16C
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define VKLIB_F16C_TARGET
+#else
+#define VKLIB_F16C_TARGET __attribute__((target("avx,f16c")))
+#endif
+#endif
+
 namespace VKLIB_HPP_NAMESPACE::algorithm
 {
 	glm::vec3 geometry::vertex_tangent(
@@ -118,115 +141,347 @@ namespace VKLIB_HPP_NAMESPACE::algorithm
 		{
 			return abs(point.x - center.x) <= extent.x && abs(point.y - center.y) <= extent.y && abs(point.z - center.z) <= extent.z;
 		}
+
+		void AABB_batch::clear()
+		{
+			center_x.clear();
+			center_y.clear();
+			center_z.clear();
+			extent_x.clear();
+			extent_y.clear();
+			extent_z.clear();
+		}
+
+		void AABB_batch::resize(size_t size)
+		{
+			center_x.resize(size);
+			center_y.resize(size);
+			center_z.resize(size);
+			extent_x.resize(size);
+			extent_y.resize(size);
+			extent_z.resize(size);
+		}
+
+		void AABB_batch::set(size_t idx, const AABB& box)
+		{
+			center_x[idx] = box.center.x;
+			center_y[idx] = box.center.y;
+			center_z[idx] = box.center.z;
+			extent_x[idx] = box.extent.x;
+			extent_y[idx] = box.extent.y;
+			extent_z[idx] = box.extent.z;
+		}
+
+		void AABB_batch::push_back(const AABB& box)
+		{
+			center_x.push_back(box.center.x);
+			center_y.push_back(box.center.y);
+			center_z.push_back(box.center.z);
+			extent_x.push_back(box.extent.x);
+			extent_y.push_back(box.extent.y);
+			extent_z.push_back(box.extent.z);
+		}
+
+		void AABB_batch::intersect_or_forward(const Plane& plane, std::span<uint8_t> mask, size_t first) const
+		{
+			const auto count = mask.size();
+			size_t     i     = 0;
+
+			const float *cx = center_x.data() + first, *cy = center_y.data() + first, *cz = center_z.data() + first,
+						*ex = extent_x.data() + first, *ey = extent_y.data() + first, *ez = extent_z.data() + first;
+
+			// Operations are kept in the same order as the scalar path, so both paths give identical results
+
+#if defined(VKLIB_AABB_BATCH_AVX)
+			{
+				const __m256 nx = _mm256_set1_ps(plane.normal.x), ny = _mm256_set1_ps(plane.normal.y),
+							 nz = _mm256_set1_ps(plane.normal.z);
+				const __m256 ax = _mm256_set1_ps(std::abs(plane.normal.x)), ay = _mm256_set1_ps(std::abs(plane.normal.y)),
+							 az = _mm256_set1_ps(std::abs(plane.normal.z));
+				const __m256 px = _mm256_set1_ps(plane.position.x), py = _mm256_set1_ps(plane.position.y),
+							 pz = _mm256_set1_ps(plane.position.z);
+				const __m256 zero = _mm256_setzero_ps();
+
+				for (; i + 8 <= count; i += 8)
+				{
+					const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(cx + i), px),
+								 dy = _mm256_sub_ps(_mm256_loadu_ps(cy + i), py),
+								 dz = _mm256_sub_ps(_mm256_loadu_ps(cz + i), pz);
+
+					const __m256 distance = _mm256_add_ps(
+						_mm256_add_ps(_mm256_mul_ps(nx, dx), _mm256_mul_ps(ny, dy)),
+						_mm256_mul_ps(nz, dz)
+					);
+					const __m256 r = _mm256_add_ps(
+						_mm256_add_ps(
+							_mm256_mul_ps(_mm256_loadu_ps(ex + i), ax),
+							_mm256_mul_ps(_mm256_loadu_ps(ey + i), ay)
+						),
+						_mm256_mul_ps(_mm256_loadu_ps(ez + i), az)
+					);
+
+					const int bits = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_add_ps(distance, r), zero, _CMP_GE_OQ));
+					for (auto j : Iota(8)) mask[i + j] &= (bits >> j) & 1;
+				}
+			}
+#elif defined(VKLIB_AABB_BATCH_SSE)
+			{
+				const __m128 nx = _mm_set1_ps(plane.normal.x), ny = _mm_set1_ps(plane.normal.y), nz = _mm_set1_ps(plane.normal.z);
+				const __m128 ax = _mm_set1_ps(std::abs(plane.normal.x)), ay = _mm_set1_ps(std::abs(plane.normal.y)),
+							 az = _mm_set1_ps(std::abs(plane.normal.z));
+				const __m128 px = _mm_set1_ps(plane.position.x), py = _mm_set1_ps(plane.position.y),
+							 pz = _mm_set1_ps(plane.position.z);
+				const __m128 zero = _mm_setzero_ps();
+
+				for (; i + 4 <= count; i += 4)
+				{
+					const __m128 dx = _mm_sub_ps(_mm_loadu_ps(cx + i), px),
+								 dy = _mm_sub_ps(_mm_loadu_ps(cy + i), py),
+								 dz = _mm_sub_ps(_mm_loadu_ps(cz + i), pz);
+
+					const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, dx), _mm_mul_ps(ny, dy)), _mm_mul_ps(nz, dz));
+					const __m128 r        = _mm_add_ps(
+						_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(ex + i), ax), _mm_mul_ps(_mm_loadu_ps(ey + i), ay)),
+						_mm_mul_ps(_mm_loadu_ps(ez + i), az)
+					);
+
+					const int bits = _mm_movemask_ps(_mm_cmpge_ps(_mm_add_ps(distance, r), zero));
+					for (auto j : Iota(4)) mask[i + j] &= (bits >> j) & 1;
+				}
+			}
+#endif
+
+			// Scalar path for remaining boxes
+			for (; i < count; i++)
+			{
+				const AABB box{
+					{cx[i], cy[i], cz[i]},
+					{ex[i], ey[i], ez[i]}
+				};
+
+				mask[i] &= box.intersect_or_forward(plane) ? 1 : 0;
+			}
+		}
 	};
 
 	namespace conversion
 	{
-		// Created with Github Copilot
+		// Round-to-nearest-even conversion, see https://gist.github.com/rygorous/2156668 (float_to_half_fast3_rtne)
 		uint16_t f32_to_f16(float f32)
 		{
-			const uint32_t f32i     = reinterpret_cast<uint32_t&>(f32);
-			const uint32_t sign     = (f32i & 0x80000000u) >> 16;
-			const uint32_t exponent = (f32i & 0x7F800000u) >> 23;
+			constexpr uint32_t f32_infinity   = 255u << 23;
+			constexpr uint32_t f16_overflow   = (127u + 16) << 23;  // Rounds to infinity from here on
+			constexpr uint32_t f16_min_normal = (127u - 14) << 23;
+			constexpr uint32_t denorm_magic   = ((127u - 15) + (23 - 10) + 1) << 23;
 
-			uint32_t fraction = f32i & 0x007FFFFFu;
-			uint16_t f16      = 0;
+			uint32_t       bits = std::bit_cast<uint32_t>(f32);
+			const uint32_t sign = bits & 0x80000000u;
+			bits ^= sign;
 
-			if (exponent == 0)
+			uint32_t f16;
+
+			if (bits >= f16_overflow)
 			{
-				// Zero or denormal (treated as zero)
-				f16 = 0;
+				// Infinity, or quiet NaN
+				f16 = bits > f32_infinity ? 0x7E00 : 0x7C00;
 			}
-			else if (exponent == 0xFF)
+			else if (bits < f16_min_normal)
 			{
-				// Infinity or NaN
-				// Convert NaNs to canonical NaN
-				if (fraction)
-				{
-					f16 = 0x7FFF;
-				}
-				else
-				{
-					f16 = sign | 0x7C00;
-				}
+				// Denormal or zero, float addition aligns & rounds the 10 mantissa bits
+				f16 = std::bit_cast<uint32_t>(std::bit_cast<float>(bits) + std::bit_cast<float>(denorm_magic)) - denorm_magic;
 			}
 			else
 			{
-				// Normal number
-				int32_t new_exp = static_cast<int32_t>(exponent) - 127;
-				if (new_exp < -14)
-				{
-					// Underflow
-					f16 = 0;
-				}
-				else if (new_exp > 15)
-				{
-					// Overflow, set to infinity
-					f16 = sign | 0x7C00;
-				}
-				else
-				{
-					// Representable as a normalized half-precision float
-					new_exp += 15;
-					fraction >>= 13;
-					f16 = sign | (new_exp << 10) | fraction;
-				}
+				// Normal, rebias exponent and round half to even
+				const uint32_t mantissa_odd = (bits >> 13) & 1;
+				f16                         = (bits + ((15u - 127u) << 23) + 0xFFF + mantissa_odd) >> 13;
 			}
 
-			return f16;
+			return f16 | (sign >> 16);
 		}
 
 		uint16_t f32_to_f16_clamped(float f32)
 		{
-			const uint32_t f32i     = reinterpret_cast<uint32_t&>(f32);
-			const uint32_t sign     = (f32i & 0x80000000u) >> 16;
-			const uint32_t exponent = (f32i & 0x7F800000u) >> 23;
+			if (std::isnan(f32)) return 0;
+			return f32_to_f16(std::clamp(f32, -65504.0f, 65504.0f));
+		}
 
-			uint32_t fraction = f32i & 0x007FFFFFu;
-			uint16_t f16      = 0;
+#if defined(VKLIB_F16_CONVERSION_SSE)
+		// SSE2 version of `f32_to_f16`, results are sign-extended to 32 bits
+		static __m128i f32_to_f16_sse(__m128 f32)
+		{
+			const __m128i f16_overflow   = _mm_set1_epi32((127 + 16) << 23);
+			const __m128i f16_min_normal = _mm_set1_epi32((127 - 14) << 23);
+			const __m128i denorm_magic   = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+			const __m128i normal_bias    = _mm_set1_epi32(0xFFF - ((127 - 15) << 23));
 
-			if (exponent == 0)
-			{
-				// Zero or denormal (treated as zero)
-				f16 = 0;
-			}
-			else if (exponent == 0xFF)
+			const __m128  sign     = _mm_and_ps(f32, _mm_castsi128_ps(_mm_set1_epi32(0x80000000u)));
+			const __m128  abs_f32  = _mm_xor_ps(f32, sign);
+			const __m128i abs_bits = _mm_castps_si128(abs_f32);
+
+			const __m128i is_nan     = _mm_castps_si128(_mm_cmpunord_ps(abs_f32, abs_f32));
+			const __m128i is_regular = _mm_cmpgt_epi32(f16_overflow, abs_bits);
+			const __m128i is_denorm  = _mm_cmpgt_epi32(f16_min_normal, abs_bits);
+			const __m128i special    = _mm_or_si128(_mm_and_si128(is_nan, _mm_set1_epi32(0x200)), _mm_set1_epi32(0x7C00));
+
+			const __m128i denorm
+				= _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(abs_f32, _mm_castsi128_ps(denorm_magic))), denorm_magic);
+
+			const __m128i mantissa_odd = _mm_srai_epi32(_mm_slli_epi32(abs_bits, 31 - 13), 31);  // -1 if odd
+			const __m128i normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(abs_bits, normal_bias), mantissa_odd), 13);
+
+			const __m128i finite = _mm_or_si128(_mm_and_si128(is_denorm, denorm), _mm_andnot_si128(is_denorm, normal));
+			const __m128i merged = _mm_or_si128(_mm_and_si128(is_regular, finite), _mm_andnot_si128(is_regular, special));
+
+			return _mm_or_si128(merged, _mm_srai_epi32(_mm_castps_si128(sign), 16));
+		}
+#endif
+
+		// > Vector kernels, `Clamped` replaces NaN with zero and clamps to float16's range before converting.
+		// They convert whole groups of 8 from the start of `src`, and return how many values are converted
+
+#if defined(VKLIB_F16_CONVERSION_F16C)
+		template <bool Clamped>
+		VKLIB_F16C_TARGET static size_t f32_to_f16_f16c(std::span<const float> src, std::span<uint16_t> dst)
+		{
+			size_t i = 0;
+
+			for (; i + 8 <= src.size(); i += 8)
 			{
-				// Infinity or NaN
-				// Convert NaNs to canonical NaN
-				if (fraction)
-				{
-					f16 = 0x7FFF;
-				}
-				else
+				__m256 value = _mm256_loadu_ps(src.data() + i);
+
+				if constexpr (Clamped)
 				{
-					f16 = sign | 0x7C00;
+					value = _mm256_and_ps(value, _mm256_cmp_ps(value, value, _CMP_ORD_Q));
+					value = _mm256_min_ps(_mm256_max_ps(value, _mm256_set1_ps(-65504.0f)), _mm256_set1_ps(65504.0f));
 				}
+
+				const __m128i f16 = _mm256_cvtps_ph(value, _MM_FROUND_TO_NEAREST_INT);
+				_mm_storeu_si128((__m128i*)(dst.data() + i), f16);
 			}
-			else
+
+			return i;
+		}
+
+		static bool cpu_supports_f16c()
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			std::array<int, 4> info;
+			__cpuid(info.data(), 1);
+
+			const bool avx_f16c     = (info[2] & (1 << 28)) && (info[2] & (1 << 29));
+			const bool os_saves_ymm = (info[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6;
+
+			return avx_f16c && os_saves_ymm;
+#else
+			return __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+#endif
+		}
+#endif
+
+#if defined(VKLIB_F16_CONVERSION_SSE)
+		template <bool Clamped>
+		static size_t f32_to_f16_sse2(std::span<const float> src, std::span<uint16_t> dst)
+		{
+			size_t i = 0;
+
+			for (; i + 8 <= src.size(); i += 8)
 			{
-				// Normal number
-				int32_t new_exp = static_cast<int32_t>(exponent) - 127;
-				if (new_exp < -14)
-				{
-					// Underflow
-					f16 = 0;
-				}
-				else if (new_exp > 15)
-				{
-					// Overflow, set to float16's maximum (65504.0)
-					f16 = sign | 0x7BFF;
-				}
-				else
+				__m128 value0 = _mm_loadu_ps(src.data() + i), value1 = _mm_loadu_ps(src.data() + i + 4);
+
+				if constexpr (Clamped)
 				{
-					// Representable as a normalized half-precision float
-					new_exp += 15;
-					fraction >>= 13;
-					f16 = sign | (new_exp << 10) | fraction;
+					const __m128 min = _mm_set1_ps(-65504.0f), max = _mm_set1_ps(65504.0f);
+
+					value0 = _mm_min_ps(_mm_max_ps(_mm_and_ps(value0, _mm_cmpord_ps(value0, value0)), min), max);
+					value1 = _mm_min_ps(_mm_max_ps(_mm_and_ps(value1, _mm_cmpord_ps(value1, value1)), min), max);
 				}
+
+				// Sign-extended results fit in int16, so signed saturation packs them losslessly
+				const __m128i f16 = _mm_packs_epi32(f32_to_f16_sse(value0), f32_to_f16_sse(value1));
+				_mm_storeu_si128((__m128i*)(dst.data() + i), f16);
+			}
+
+			return i;
+		}
+#endif
+
+		bool f16_path_supported(F16_path path)
+		{
+			switch (path)
+			{
+			case F16_path::Scalar:
+				return true;
+#if defined(VKLIB_F16_CONVERSION_SSE)
+			case F16_path::Sse2:
+				return true;
+#endif
+#if defined(VKLIB_F16_CONVERSION_F16C)
+			case F16_path::F16c:
+			{
+				static const bool supported = cpu_supports_f16c();
+				return supported;
 			}
+#endif
+			default:
+				return false;
+			}
+		}
+
+		F16_path f16_default_path()
+		{
+			static const F16_path path = f16_path_supported(F16_path::F16c) ? F16_path::F16c
+									   : f16_path_supported(F16_path::Sse2) ? F16_path::Sse2
+																			: F16_path::Scalar;
+			return path;
+		}
+
+		template <bool Clamped>
+		static void f32_to_f16_bulk(std::span<const float> src, std::span<uint16_t> dst, F16_path path)
+		{
+			QUICK_CHECK_ARGUMENT(dst.size() >= src.size());
+			QUICK_CHECK_ARGUMENT(f16_path_supported(path));
 
-			return f16;
+			size_t i = 0;
+
+			switch (path)
+			{
+#if defined(VKLIB_F16_CONVERSION_F16C)
+			case F16_path::F16c:
+				i = f32_to_f16_f16c<Clamped>(src, dst);
+				break;
+#endif
+#if defined(VKLIB_F16_CONVERSION_SSE)
+			case F16_path::Sse2:
+				i = f32_to_f16_sse2<Clamped>(src, dst);
+				break;
+#endif
+			default:
+				break;
+			}
+
+			// Scalar path for remaining values
+			for (; i < src.size(); i++) dst[i] = Clamped ? f32_to_f16_clamped(src[i]) : f32_to_f16(src[i]);
+		}
+
+		void f32_to_f16(std::span<const float> src, std::span<uint16_t> dst)
+		{
+			f32_to_f16_bulk<false>(src, dst, f16_default_path());
+		}
+
+		void f32_to_f16_clamped(std::span<const float> src, std::span<uint16_t> dst)
+		{
+			f32_to_f16_bulk<true>(src, dst, f16_default_path());
+		}
+
+		void f32_to_f16(std::span<const float> src, std::span<uint16_t> dst, F16_path path)
+		{
+			f32_to_f16_bulk<false>(src, dst, path);
+		}
+
+		void f32_to_f16_clamped(std::span<const float> src, std::span<uint16_t> dst, F16_path path)
+		{
+			f32_to_f16_bulk<true>(src, dst, path);
 		}
 	}
 
@@ -46,6 +46,25 @@ namespace VKLIB_HPP_NAMESPACE
 		return data->child.begin(&begin_info);
 	}
 
+	vk::Result Command_buffer::begin_secondary(
+		const Render_pass& render_pass,
+		uint32_t           subpass,
+		const Framebuffer& framebuffer,
+		bool               one_time_submit
+	) const
+	{
+		const vk::CommandBufferInheritanceInfo inheritance_info(render_pass, subpass, framebuffer);
+
+		const vk::CommandBufferBeginInfo begin_info(
+			vk::CommandBufferUsageFlagBits::eRenderPassContinue
+				| (one_time_submit ? vk::CommandBufferUsageFlagBits::eOneTimeSubmit
+								   : vk::CommandBufferUsageFlagBits::eSimultaneousUse),
+			&inheritance_info
+		);
+
+		return data->child.begin(&begin_info);
+	}
+
 	void Command_buffer::begin_render_pass(
 		const Render_pass&          render_pass,
 		const Framebuffer&          framebuffer,
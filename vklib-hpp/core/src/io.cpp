@@ -2,6 +2,17 @@
 #include <filesystem>
 #include <fstream>
 
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #define IO_READ_FAIL_MSG "Failed to read file"
 #define IO_READ_WRITE_MSG "Failed to write file"
 
@@ -49,4 +60,79 @@ namespace VKLIB_HPP_NAMESPACE::io
 		if (!file.write(reinterpret_cast<const char*>(data.data()), data.size()))
 			throw error::IO_error(FILENAME_TO_STRING(path), "Failed to write file");
 	}
+
+	Mapped_file::Mapped_file(const std::string& path)
+	{
+		if (!std::filesystem::exists(path)) throw error::IO_error(FILENAME_TO_STRING(path), "File doesn't exist");
+
+		const size_t size = std::filesystem::file_size(path);
+		if (size == 0) return;  // Empty files can't be mapped
+
+#ifdef _WIN32
+		const HANDLE file = CreateFileA(
+			path.c_str(),
+			GENERIC_READ,
+			FILE_SHARE_READ,
+			nullptr,
+			OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+			nullptr
+		);
+		if (file == INVALID_HANDLE_VALUE) throw error::IO_error(FILENAME_TO_STRING(path), "Can't open file for reading");
+
+		// The view keeps the mapping alive, both handles can be closed right after mapping
+		const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file);
+		if (mapping == nullptr) throw error::IO_error(FILENAME_TO_STRING(path), "Failed to create file mapping");
+
+		void* const view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+		if (view == nullptr) throw error::IO_error(FILENAME_TO_STRING(path), "Failed to map file");
+#else
+		const int file = open(path.c_str(), O_RDONLY);
+		if (file < 0) throw error::IO_error(FILENAME_TO_STRING(path), "Can't open file for reading");
+
+		// The mapping stays valid after the descriptor is closed
+		void* const view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+		close(file);
+		if (view == MAP_FAILED) throw error::IO_error(FILENAME_TO_STRING(path), "Failed to map file");
+
+		madvise(view, size, MADV_SEQUENTIAL);
+#endif
+
+		mapped_data = static_cast<const uint8_t*>(view);
+		mapped_size = size;
+	}
+
+	Mapped_file::Mapped_file(Mapped_file&& other) noexcept :
+		mapped_data(std::exchange(other.mapped_data, nullptr)),
+		mapped_size(std::exchange(other.mapped_size, 0))
+	{
+	}
+
+	Mapped_file& Mapped_file::operator=(Mapped_file&& other) noexcept
+	{
+		if (this != &other)
+		{
+			unmap();
+			mapped_data = std::exchange(other.mapped_data, nullptr);
+			mapped_size = std::exchange(other.mapped_size, 0);
+		}
+
+		return *this;
+	}
+
+	void Mapped_file::unmap()
+	{
+		if (mapped_data == nullptr) return;
+
+#ifdef _WIN32
+		UnmapViewOfFile(mapped_data);
+#else
+		munmap(const_cast<uint8_t*>(mapped_data), mapped_size);
+#endif
+
+		mapped_data = nullptr;
+		mapped_size = 0;
+	}
 }
\ No newline at end of file
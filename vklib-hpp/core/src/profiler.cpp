@@ -0,0 +1,222 @@
+#include "vklib/core/profiler.hpp"
+#include "vklib/core/error.hpp"
+#include "vklib/core/io.hpp"
+
+#include <mutex>
+
+namespace VKLIB_HPP_NAMESPACE::utility
+{
+	static const auto profiler_epoch = std::chrono::steady_clock::now();
+
+	// Written only by its owning thread, read by the exporting thread after the capture
+	struct Thread_buffer
+	{
+		std::unique_ptr<Cpu_profiler::Event[]> events = std::make_unique<Cpu_profiler::Event[]>(Cpu_profiler::thread_capacity);
+
+		std::atomic<size_t>   count   = 0;
+		std::atomic<size_t>   dropped = 0;
+		std::atomic<uint64_t> session = 0;  // Capture the events belong to, `count` is reset by the owner when outdated
+		std::atomic<bool>     exited  = false;
+
+		uint32_t    thread_id;
+		std::string name;
+	};
+
+	static struct
+	{
+		std::atomic<bool>     capturing = false;
+		std::atomic<uint64_t> session   = 0;
+
+		// > Buffers outlive their threads, so zones of finished loader threads are still exported.
+		// Buffers of exited threads are dropped after exporting and when the next capture begins
+		std::mutex                                  mutex;
+		std::vector<std::shared_ptr<Thread_buffer>> buffers;
+		uint32_t                                    next_thread_id = 1;
+	} profiler_state;
+
+	// The event buffer is only allocated for the first event a thread records during a capture,
+	// so short-lived threads that never record cost nothing but their name
+	static thread_local struct Thread_state
+	{
+		std::string                    name;
+		std::shared_ptr<Thread_buffer> buffer;
+
+		~Thread_state()
+		{
+			if (buffer != nullptr) buffer->exited.store(true, std::memory_order_release);
+		}
+	} thread_state;
+
+	static Thread_buffer& local_buffer()
+	{
+		if (thread_state.buffer != nullptr) [[likely]]
+			return *thread_state.buffer;
+
+		auto new_buffer = std::make_shared<Thread_buffer>();
+
+		{
+			const std::lock_guard lock(profiler_state.mutex);
+
+			new_buffer->thread_id = profiler_state.next_thread_id++;
+			new_buffer->name
+				= thread_state.name.empty() ? std::format("Thread {}", new_buffer->thread_id) : std::move(thread_state.name);
+			profiler_state.buffers.push_back(new_buffer);
+		}
+
+		thread_state.buffer = std::move(new_buffer);
+		return *thread_state.buffer;
+	}
+
+	// Called with `profiler_state.mutex` held
+	static void drop_exited_buffers()
+	{
+		std::erase_if(
+			profiler_state.buffers,
+			[](const std::shared_ptr<Thread_buffer>& buffer)
+			{
+				return buffer->exited.load(std::memory_order_acquire);
+			}
+		);
+	}
+
+	uint64_t Cpu_profiler::now_ns()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - profiler_epoch).count();
+	}
+
+	void Cpu_profiler::set_thread_name(std::string name)
+	{
+		if (thread_state.buffer == nullptr)
+		{
+			thread_state.name = std::move(name);
+			return;
+		}
+
+		const std::lock_guard lock(profiler_state.mutex);
+		thread_state.buffer->name = std::move(name);
+	}
+
+	void Cpu_profiler::begin_capture()
+	{
+		{
+			const std::lock_guard lock(profiler_state.mutex);
+			drop_exited_buffers();
+		}
+
+		profiler_state.session.fetch_add(1, std::memory_order_acq_rel);
+		profiler_state.capturing.store(true, std::memory_order_release);
+	}
+
+	void Cpu_profiler::end_capture()
+	{
+		profiler_state.capturing.store(false, std::memory_order_release);
+	}
+
+	bool Cpu_profiler::capturing()
+	{
+		return profiler_state.capturing.load(std::memory_order_relaxed);
+	}
+
+	size_t Cpu_profiler::dropped_count()
+	{
+		const auto            session = profiler_state.session.load(std::memory_order_acquire);
+		const std::lock_guard lock(profiler_state.mutex);
+
+		size_t dropped = 0;
+		for (const auto& buffer : profiler_state.buffers)
+			if (buffer->session.load(std::memory_order_acquire) == session) dropped += buffer->dropped.load(std::memory_order_relaxed);
+
+		return dropped;
+	}
+
+	void Cpu_profiler::record(const char* name, uint64_t begin_ns, uint64_t end_ns)
+	{
+		if (!profiler_state.capturing.load(std::memory_order_relaxed)) return;
+
+		auto&      buffer  = local_buffer();
+		const auto session = profiler_state.session.load(std::memory_order_acquire);
+
+		// First event of this thread in the capture
+		if (buffer.session.load(std::memory_order_relaxed) != session)
+		{
+			buffer.count.store(0, std::memory_order_relaxed);
+			buffer.dropped.store(0, std::memory_order_relaxed);
+			buffer.session.store(session, std::memory_order_release);
+		}
+
+		const auto idx = buffer.count.load(std::memory_order_relaxed);
+		if (idx >= thread_capacity) [[unlikely]]
+		{
+			buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		buffer.events[idx] = {name, begin_ns, end_ns};
+		buffer.count.store(idx + 1, std::memory_order_release);  // Publishes the event to the exporting thread
+	}
+
+	// Zone names are string literals in code, only quotes and backslashes need escaping
+	static std::string escape_json(std::string_view str)
+	{
+		std::string result;
+		result.reserve(str.size());
+
+		for (const char c : str)
+		{
+			if (c == '"' || c == '\\') result.push_back('\\');
+			result.push_back(c);
+		}
+
+		return result;
+	}
+
+	void Cpu_profiler::write_chrome_trace(const std::string& path)
+	{
+		const auto session = profiler_state.session.load(std::memory_order_acquire);
+
+		std::string content = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+		bool        first   = true;
+
+		const auto append = [&](const std::string& event)
+		{
+			if (!first) content += ",\n";
+			content += event;
+			first = false;
+		};
+
+		{
+			const std::lock_guard lock(profiler_state.mutex);
+
+			for (const auto& buffer : profiler_state.buffers)
+			{
+				if (buffer->session.load(std::memory_order_acquire) != session) continue;
+
+				append(std::format(
+					R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":"{}"}}}})",
+					buffer->thread_id,
+					escape_json(buffer->name)
+				));
+
+				const auto count = buffer->count.load(std::memory_order_acquire);
+
+				// Complete events, timestamps in microseconds
+				for (const auto& event : std::span(buffer->events.get(), count))
+				{
+					append(std::format(
+						R"({{"name":"{}","ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f}}})",
+						escape_json(event.name),
+						buffer->thread_id,
+						event.begin_ns / 1000.0,
+						(event.end_ns - event.begin_ns) / 1000.0
+					));
+				}
+			}
+
+			drop_exited_buffers();
+		}
+
+		content += "]}\n";
+
+		io::write(path, std::span((const uint8_t*)content.data(), content.size()));
+	}
+}
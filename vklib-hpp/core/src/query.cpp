@@ -0,0 +1,35 @@
+#include "vklib/core/query.hpp"
+
+namespace VKLIB_HPP_NAMESPACE
+{
+	Query_pool::Query_pool(
+		const Device&                   device,
+		vk::QueryType                   type,
+		uint32_t                        count,
+		vk::QueryPipelineStatisticFlags pipeline_statistics
+	)
+	{
+		const auto create_info
+			= vk::QueryPoolCreateInfo().setQueryType(type).setQueryCount(count).setPipelineStatistics(pipeline_statistics);
+		const auto handle = device->createQueryPool(create_info);
+		*this             = Query_pool(handle, device);
+	}
+
+	void Query_pool::clean()
+	{
+		if (is_unique()) parent()->destroyQueryPool(*this);
+	}
+
+	vk::Result Query_pool::get_results(uint32_t first, std::span<uint64_t> results, vk::QueryResultFlags flags) const
+	{
+		return parent()->getQueryPoolResults(
+			*this,
+			first,
+			(uint32_t)results.size(),
+			results.size_bytes(),
+			results.data(),
+			sizeof(uint64_t),
+			flags | vk::QueryResultFlagBits::e64
+		);
+	}
+}
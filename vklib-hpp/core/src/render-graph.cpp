@@ -0,0 +1,331 @@
+#include "vklib/core/render-graph.hpp"
+#include <algorithm>
+
+namespace VKLIB_HPP_NAMESPACE
+{
+	static constexpr vk::AccessFlags write_access
+		= vk::AccessFlagBits::eShaderWrite | vk::AccessFlagBits::eColorAttachmentWrite
+		| vk::AccessFlagBits::eDepthStencilAttachmentWrite | vk::AccessFlagBits::eTransferWrite | vk::AccessFlagBits::eHostWrite
+		| vk::AccessFlagBits::eMemoryWrite;
+
+	// Read-after-read in the same layout needs no barrier
+	static bool need_barrier(const Image_state& previous, const Image_state& next)
+	{
+		return previous.layout != next.layout || (previous.access & write_access) || (next.access & write_access);
+	}
+
+#pragma region "Declaration"
+
+	Render_graph::Handle Render_graph::import_image(
+		vk::Image                        image,
+		const vk::ImageSubresourceRange& subresource_range,
+		const Image_state&               initial,
+		uint32_t                         queue_family_idx
+	)
+	{
+		if (compiled) throw error::Invalid_argument("Render graph is already compiled");
+
+		images.push_back({.handle = image, .subresource_range = subresource_range, .initial = initial, .queue_family_idx = queue_family_idx});
+		return images.size() - 1;
+	}
+
+	Render_graph::Handle Render_graph::create_image(const vk::ImageCreateInfo& create_info, vk::ImageAspectFlags aspect)
+	{
+		if (compiled) throw error::Invalid_argument("Render graph is already compiled");
+
+		QUICK_CHECK_ARGUMENT(create_info.tiling == vk::ImageTiling::eOptimal);
+		QUICK_CHECK_ARGUMENT(create_info.sharingMode == vk::SharingMode::eExclusive);
+		QUICK_CHECK_ARGUMENT(create_info.initialLayout == vk::ImageLayout::eUndefined);
+
+		images.push_back({
+			.subresource_range = {aspect, 0, create_info.mipLevels, 0, create_info.arrayLayers},
+			.transient         = true,
+			.create_info       = create_info
+		});
+		return images.size() - 1;
+	}
+
+	Render_graph::Handle Render_graph::add_pass(uint32_t queue_family_idx)
+	{
+		if (compiled) throw error::Invalid_argument("Render graph is already compiled");
+
+		passes.push_back({.queue_family_idx = queue_family_idx});
+		return passes.size() - 1;
+	}
+
+	void Render_graph::use(Handle pass, Handle image, const Image_usage& usage)
+	{
+		if (compiled) throw error::Invalid_argument("Render graph is already compiled");
+
+		QUICK_CHECK_ARGUMENT(pass < passes.size());
+		QUICK_CHECK_ARGUMENT(image < images.size());
+
+		auto& usages = images[image].usages;
+
+		// Keep usages in pass order, so passes may declare their images in any order
+		const auto itr = std::ranges::lower_bound(usages, pass, {}, &std::pair<Handle, Image_usage>::first);
+		if (itr != usages.end() && itr->first == pass)
+			throw error::Invalid_argument(std::format("Image {} is used twice in pass {}", image, pass));
+
+		usages.insert(itr, {pass, usage});
+	}
+
+#pragma endregion
+
+#pragma region "Compilation"
+
+	void Render_graph::compile(const Vma_allocator& allocator)
+	{
+		if (compiled) throw error::Invalid_argument("Render graph is already compiled");
+
+		allocate_transient_images(allocator);
+		for (Handle image = 0; image < images.size(); image++) derive_barriers(image);
+
+		compiled = true;
+	}
+
+	void Render_graph::allocate_transient_images(const Vma_allocator& allocator)
+	{
+		const auto& device = allocator.parent();
+
+		std::vector<Handle> order;
+		for (Handle image = 0; image < images.size(); image++)
+		{
+			auto& resource = images[image];
+			if (!resource.transient) continue;
+
+			// Unused images never alias
+			if (resource.usages.empty())
+			{
+				resource.image  = Image(allocator, VMA_MEMORY_USAGE_GPU_ONLY, resource.create_info);
+				resource.handle = resource.image;
+				continue;
+			}
+
+			order.push_back(image);
+		}
+
+		std::ranges::stable_sort(
+			order,
+			{},
+			[this](Handle image)
+			{
+				return images[image].usages.front().first;
+			}
+		);
+
+		for (const auto image : order)
+		{
+			auto&          resource   = images[image];
+			const uint32_t first_pass = resource.usages.front().first, last_pass = resource.usages.back().first;
+
+			// Querying requirements without an image needs Vulkan 1.3, so a probe image is created instead
+			const auto probe        = device->createImage(resource.create_info);
+			const auto requirements = device->getImageMemoryRequirements(probe);
+			device->destroyImage(probe);
+
+			statistics.requested += requirements.size;
+			statistics.image_count++;
+
+			// Best fit among blocks free before `first_pass`; when none is large enough, grow the largest one
+			std::optional<size_t> best;
+			for (size_t i = 0; i < blocks.size(); i++)
+			{
+				const auto& block = blocks[i];
+				if (block.last_pass >= first_pass) continue;
+				if ((block.requirements.memoryTypeBits & requirements.memoryTypeBits) == 0) continue;
+
+				if (!best.has_value())
+				{
+					best = i;
+					continue;
+				}
+
+				const auto best_size = blocks[*best].requirements.size, size = block.requirements.size;
+				const bool best_fits = best_size >= requirements.size, fits = size >= requirements.size;
+
+				if ((fits && (!best_fits || size < best_size)) || (!fits && !best_fits && size > best_size)) best = i;
+			}
+
+			if (!best.has_value())
+			{
+				blocks.push_back({.requirements = requirements});
+				best = blocks.size() - 1;
+			}
+
+			auto& block = blocks[*best];
+			block.requirements.size           = std::max(block.requirements.size, requirements.size);
+			block.requirements.alignment      = std::max(block.requirements.alignment, requirements.alignment);
+			block.requirements.memoryTypeBits &= requirements.memoryTypeBits;
+			block.last_pass                   = last_pass;
+			block.images.push_back(image);
+
+			resource.block = *best;
+		}
+
+		for (auto& block : blocks)
+		{
+			block.memory = Vma_memory(allocator, block.requirements, VMA_MEMORY_USAGE_GPU_ONLY);
+
+			statistics.allocated += block.requirements.size;
+			statistics.allocation_count++;
+
+			for (const auto image : block.images)
+			{
+				auto& resource  = images[image];
+				resource.image  = Image(allocator, block.memory, 0, resource.create_info);
+				resource.handle = resource.image;
+			}
+		}
+	}
+
+	void Render_graph::derive_barriers(Handle image)
+	{
+		const auto& resource = images[image];
+
+		// State before the first usage of the frame
+		Image_state           previous        = resource.initial;
+		uint32_t              previous_family = resource.queue_family_idx;
+		std::optional<Handle> previous_pass;
+
+		// Transient images start undefined, after the previous occupant of the memory
+		if (resource.transient && !resource.usages.empty())
+		{
+			const auto& occupants = blocks[resource.block].images;
+			const auto  itr       = std::ranges::find(occupants, image);
+
+			if (itr != occupants.begin())
+			{
+				const auto& [pass, usage] = images[*(itr - 1)].usages.back();
+
+				previous        = {vk::ImageLayout::eUndefined, usage.end.access, usage.end.stages};
+				previous_family = passes[pass].queue_family_idx;
+				previous_pass   = pass;
+			}
+		}
+
+		for (const auto& [pass_handle, usage] : resource.usages)
+		{
+			auto&      pass        = passes[pass_handle];
+			const bool same_family = previous_family == vk::QueueFamilyIgnored || previous_family == pass.queue_family_idx;
+
+			if (usage.begin.layout == vk::ImageLayout::eUndefined)
+			{
+				// The render pass transitions the image, only order it after earlier accesses on this queue family
+				if (previous_pass.has_value() && same_family)
+					pass.begin.add(
+						vk::MemoryBarrier(previous.access & write_access, usage.begin.access),
+						previous.stages,
+						usage.begin.stages
+					);
+			}
+			else if (same_family || previous.layout == vk::ImageLayout::eUndefined)
+			{
+				// Contents are discarded when coming from an undefined layout, so no ownership transfer is needed
+				if (need_barrier(previous, usage.begin))
+					pass.begin.add(
+						vk::ImageMemoryBarrier(
+							previous.access & write_access,
+							usage.begin.access,
+							previous.layout,
+							usage.begin.layout,
+							vk::QueueFamilyIgnored,
+							vk::QueueFamilyIgnored,
+							resource.handle,
+							resource.subresource_range
+						),
+						same_family ? previous.stages : vk::PipelineStageFlagBits::eTopOfPipe,
+						usage.begin.stages
+					);
+			}
+			else
+			{
+				if (!previous_pass.has_value())
+					throw error::Invalid_argument(
+						std::format("Image {} must be first used on queue family {} which owns it", image, previous_family)
+					);
+
+				// Ownership transfer: release after the previous pass, acquire before this pass
+				const vk::ImageMemoryBarrier transfer(
+					{},
+					{},
+					previous.layout,
+					usage.begin.layout,
+					previous_family,
+					pass.queue_family_idx,
+					resource.handle,
+					resource.subresource_range
+				);
+
+				passes[*previous_pass].end.add(
+					vk::ImageMemoryBarrier(transfer).setSrcAccessMask(previous.access & write_access),
+					previous.stages,
+					vk::PipelineStageFlagBits::eBottomOfPipe
+				);
+
+				pass.begin.add(
+					vk::ImageMemoryBarrier(transfer).setDstAccessMask(usage.begin.access),
+					vk::PipelineStageFlagBits::eTopOfPipe,
+					usage.begin.stages
+				);
+			}
+
+			previous        = usage.end;
+			previous_family = pass.queue_family_idx;
+			previous_pass   = pass_handle;
+		}
+	}
+
+#pragma endregion
+
+#pragma region "Recording"
+
+	void Render_graph::Barriers::add(const vk::ImageMemoryBarrier& barrier, vk::PipelineStageFlags src, vk::PipelineStageFlags dst)
+	{
+		image_barriers.push_back(barrier);
+		src_stages |= src;
+		dst_stages |= dst;
+	}
+
+	void Render_graph::Barriers::add(const vk::MemoryBarrier& barrier, vk::PipelineStageFlags src, vk::PipelineStageFlags dst)
+	{
+		memory_barrier.srcAccessMask |= barrier.srcAccessMask;
+		memory_barrier.dstAccessMask |= barrier.dstAccessMask;
+		has_memory_barrier = true;
+		src_stages |= src;
+		dst_stages |= dst;
+	}
+
+	void Render_graph::Barriers::record(const Command_buffer& command_buffer) const
+	{
+		if (image_barriers.empty() && !has_memory_barrier) return;
+
+		command_buffer.pipeline_barrier(
+			src_stages,
+			dst_stages,
+			std::span<const vk::MemoryBarrier>(&memory_barrier, has_memory_barrier ? 1 : 0),
+			{},
+			image_barriers
+		);
+	}
+
+	void Render_graph::begin_pass(const Command_buffer& command_buffer, Handle pass) const
+	{
+		QUICK_CHECK_ARGUMENT(compiled && pass < passes.size());
+		passes[pass].begin.record(command_buffer);
+	}
+
+	void Render_graph::end_pass(const Command_buffer& command_buffer, Handle pass) const
+	{
+		QUICK_CHECK_ARGUMENT(compiled && pass < passes.size());
+		passes[pass].end.record(command_buffer);
+	}
+
+	const Image& Render_graph::image(Handle image) const
+	{
+		QUICK_CHECK_ARGUMENT(compiled && image < images.size() && images[image].transient);
+		return images[image].image;
+	}
+
+#pragma endregion
+}
@@ -0,0 +1,217 @@
+#include "vklib/core/staging.hpp"
+
+namespace VKLIB_HPP_NAMESPACE
+{
+	static vk::DeviceSize align_up(vk::DeviceSize size, vk::DeviceSize alignment)
+	{
+		return (size + alignment - 1) / alignment * alignment;
+	}
+
+	Staging_ring::Staging_ring(
+		const Vma_allocator& allocator,
+		const Device&        device,
+		const Command_pool&  command_pool,
+		const Queue&         queue,
+		vk::DeviceSize       capacity,
+		std::mutex*          queue_mutex
+	) :
+		allocator(allocator),
+		device(device),
+		command_pool(command_pool),
+		queue(queue),
+		queue_mutex(queue_mutex),
+		chunk_size(std::max(capacity / chunk_count / alignment * alignment, alignment))
+	{
+		buffer = Buffer(
+			allocator,
+			chunk_size * chunk_count,
+			vk::BufferUsageFlagBits::eTransferSrc,
+			vk::SharingMode::eExclusive,
+			VMA_MEMORY_USAGE_CPU_TO_GPU,
+			VMA_ALLOCATION_CREATE_MAPPED_BIT
+		);
+
+		mapped = (uint8_t*)buffer.mapped_data();
+
+		chunks.resize(chunk_count);
+		for (auto& chunk : chunks) chunk.fence = Fence(device);
+	}
+
+	static std::unique_lock<std::mutex> lock_queue(std::mutex* queue_mutex)
+	{
+		return queue_mutex != nullptr ? std::unique_lock(*queue_mutex) : std::unique_lock<std::mutex>();
+	}
+
+	Staging_ring::~Staging_ring()
+	{
+		const auto lock = lock_queue(queue_mutex);
+
+		for (const auto& chunk : chunks)
+			if (chunk.pending) chunk.fence.wait();
+	}
+
+	void Staging_ring::upload(vk::DeviceSize size, const Write_func& write, const Record_func& record)
+	{
+		const auto aligned_size = align_up(size, alignment);
+
+		if (aligned_size > chunk_size)
+		{
+			auto& chunk = acquire(0);
+
+			const Buffer dedicated_buffer(
+				allocator,
+				size,
+				vk::BufferUsageFlagBits::eTransferSrc,
+				vk::SharingMode::eExclusive,
+				VMA_MEMORY_USAGE_CPU_TO_GPU,
+				VMA_ALLOCATION_CREATE_MAPPED_BIT
+			);
+
+			write(std::span((uint8_t*)dedicated_buffer.mapped_data(), size));
+			record(chunk.command_buffer, dedicated_buffer, 0);
+
+			// Bounds the dedicated buffers alive to one per chunk
+			chunk.dedicated_buffers.push_back(dedicated_buffer);
+			advance();
+			return;
+		}
+
+		auto&      chunk  = acquire(aligned_size);
+		const auto offset = current * chunk_size + chunk.used;
+
+		write(std::span(mapped + offset, size));
+		record(chunk.command_buffer, buffer, offset);
+
+		chunk.used += aligned_size;
+	}
+
+	void Staging_ring::upload_buffer(const Buffer& dst_buffer, std::span<const uint8_t> data, vk::DeviceSize dst_offset)
+	{
+		for (vk::DeviceSize offset = 0; offset < data.size(); offset += chunk_size)
+		{
+			const auto piece = data.subspan(offset, std::min<vk::DeviceSize>(chunk_size, data.size() - offset));
+
+			upload(
+				piece.size(),
+				[piece](std::span<uint8_t> dst)
+				{
+					std::ranges::copy(piece, dst.begin());
+				},
+				[&, offset](const Command_buffer& command_buffer, const Buffer& staging, vk::DeviceSize staging_offset)
+				{
+					command_buffer.copy_buffer(dst_buffer, staging, dst_offset + offset, staging_offset, piece.size());
+				}
+			);
+		}
+	}
+
+	void Staging_ring::upload_rows(
+		uint32_t                row_count,
+		vk::DeviceSize          row_size,
+		const Write_rows_func&  write,
+		const Record_rows_func& record
+	)
+	{
+		if (row_size == 0) return;
+
+		const auto full_chunk_rows = std::max<vk::DeviceSize>(chunk_size / row_size, 1);
+
+		for (uint32_t first_row = 0; first_row < row_count;)
+		{
+			// Fills the rest of the current chunk before moving on to the next one
+			const auto free_rows  = (chunk_size - chunks[current].used) / row_size;
+			const auto piece_rows = (uint32_t)std::min<vk::DeviceSize>(
+				row_count - first_row,
+				free_rows > 0 ? free_rows : full_chunk_rows
+			);
+
+			upload(
+				piece_rows * row_size,
+				[&](std::span<uint8_t> dst)
+				{
+					write(dst, first_row, piece_rows);
+				},
+				[&](const Command_buffer& command_buffer, const Buffer& staging, vk::DeviceSize offset)
+				{
+					record(command_buffer, staging, offset, first_row, piece_rows);
+				}
+			);
+
+			first_row += piece_rows;
+		}
+	}
+
+	void Staging_ring::record(const Command_func& func)
+	{
+		func(acquire(0).command_buffer);
+	}
+
+	void Staging_ring::flush()
+	{
+		if (chunks.empty()) return;
+
+		submit(chunks[current]);
+	}
+
+	void Staging_ring::finish()
+	{
+		flush();
+		for (auto& chunk : chunks) wait(chunk);
+	}
+
+	Staging_ring::Chunk& Staging_ring::acquire(vk::DeviceSize size)
+	{
+		if (chunks[current].used + size > chunk_size) advance();
+
+		auto& chunk = chunks[current];
+
+		if (!chunk.recording)
+		{
+			chunk.command_buffer = Command_buffer(command_pool);
+			chunk.command_buffer.begin(true);
+			chunk.recording = true;
+		}
+
+		return chunk;
+	}
+
+	void Staging_ring::advance()
+	{
+		submit(chunks[current]);
+		current = (current + 1) % chunk_count;
+		wait(chunks[current]);
+	}
+
+	void Staging_ring::submit(Chunk& chunk)
+	{
+		if (!chunk.recording) return;
+
+		chunk.command_buffer.end();
+
+		const auto submit_buffers = chunk.command_buffer.raw();
+		{
+			const auto lock = lock_queue(queue_mutex);
+			queue.submit(vk::SubmitInfo().setCommandBuffers(submit_buffers), chunk.fence);
+		}
+
+		chunk.recording = false;
+		chunk.pending   = true;
+	}
+
+	void Staging_ring::wait(Chunk& chunk)
+	{
+		if (chunk.pending)
+		{
+			{
+				const auto lock = lock_queue(queue_mutex);
+				vk::resultCheck(chunk.fence.wait(), "Wait for staging chunk failed");
+			}
+			device->resetFences(chunk.fence.to<vk::Fence>());
+			chunk.pending = false;
+		}
+
+		chunk.used = 0;
+		chunk.dedicated_buffers.clear();
+		chunk.command_buffer = {};
+	}
+}
@@ -2,6 +2,28 @@
 
 namespace VKLIB_HPP_NAMESPACE
 {
+#pragma region "VMA Memory"
+
+	Vma_memory::Vma_memory(const Vma_allocator& allocator, const vk::MemoryRequirements& requirements, VmaMemoryUsage mem_usage)
+	{
+		const VkMemoryRequirements    c_requirements = requirements;
+		const VmaAllocationCreateInfo alloc_info{.usage = mem_usage};
+
+		VmaAllocation handle;
+
+		auto result = vmaAllocateMemory(allocator, &c_requirements, &alloc_info, &handle, nullptr);
+		vk::resultCheck(vk::Result(result), "Can't allocate memory");
+
+		*this = Vma_memory(handle, allocator);
+	}
+
+	void Vma_memory::clean()
+	{
+		if (is_unique()) vmaFreeMemory(parent(), *this);
+	}
+
+#pragma endregion
+
 #pragma region "Image"
 
 	Image::Image(const Vma_allocator& allocator, VmaMemoryUsage mem_usage, const vk::ImageCreateInfo& create_info)
@@ -51,6 +73,18 @@ namespace VKLIB_HPP_NAMESPACE
 		*this = {allocator, mem_usage, create_info};
 	}
 
+	Image::Image(const Vma_allocator& allocator, const Vma_memory& memory, vk::DeviceSize offset, const vk::ImageCreateInfo& create_info)
+	{
+		const auto handle = allocator.parent()->createImage(create_info);
+
+		auto result = vmaBindImageMemory2(allocator, memory, offset, static_cast<VkImage>(handle), nullptr);
+		if (result != VK_SUCCESS) allocator.parent()->destroyImage(handle);
+		vk::resultCheck(vk::Result(result), "Can't bind image memory");
+
+		// Null allocation: only the image is destroyed, the memory stays with `memory`
+		*this = Image({handle, VK_NULL_HANDLE}, allocator);
+	}
+
 	void Image::clean()
 	{
 		if (is_unique()) vmaDestroyImage(parent(), data->child.data, data->child.alloc_handle);
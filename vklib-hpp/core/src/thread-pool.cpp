@@ -0,0 +1,125 @@
+#include "vklib/core/thread-pool.hpp"
+#include "vklib/core/profiler.hpp"
+
+namespace VKLIB_HPP_NAMESPACE::utility
+{
+	// Pool and index of the current thread, set once a worker starts
+	static thread_local struct
+	{
+		const Thread_pool* pool  = nullptr;
+		size_t             index = 0;
+	} current_worker;
+
+	Thread_pool::Thread_pool(size_t thread_count)
+	{
+		workers.reserve(thread_count);
+
+		for (auto i : Iota(thread_count))
+		{
+			workers.emplace_back(
+				[this, i](std::stop_token stop_token)
+				{
+					worker_func(stop_token, i);
+				}
+			);
+		}
+	}
+
+	Thread_pool::~Thread_pool()
+	{
+		for (auto& worker : workers) worker.request_stop();
+		condition.notify_all();
+
+		workers.clear();
+	}
+
+	size_t Thread_pool::worker_index() const
+	{
+		return current_worker.pool == this ? current_worker.index : size();
+	}
+
+	void Thread_pool::worker_func(std::stop_token stop_token, size_t index)
+	{
+		current_worker = {this, index};
+		VKLIB_PROFILE_THREAD_NAME(std::format("Worker {}", index));
+
+		while (true)
+		{
+			std::function<void()> task;
+
+			{
+				std::unique_lock lock(mutex);
+
+				if (!condition.wait(
+						lock,
+						stop_token,
+						[this]
+						{
+							return !tasks.empty();
+						}
+					))
+					return;
+
+				task = std::move(tasks.front());
+				tasks.pop();
+			}
+
+			task();
+		}
+	}
+
+	void Thread_pool::parallel_for(size_t count, const std::function<void(size_t)>& func)
+	{
+		if (count == 0) return;
+
+		std::atomic<size_t> next_idx = 0;
+
+		auto work = [&]
+		{
+			for (auto idx = next_idx++; idx < count; idx = next_idx++)
+			{
+				try
+				{
+					func(idx);
+				}
+				catch (...)
+				{
+					// skip remaining work
+					next_idx = count;
+					throw;
+				}
+			}
+		};
+
+		const auto                     task_count = std::min(count, workers.size());
+		std::vector<std::future<void>> futures;
+		futures.reserve(task_count);
+
+		for (auto _ : Iota(task_count)) futures.push_back(submit(work));
+
+		std::exception_ptr exception = nullptr;
+
+		try
+		{
+			work();
+		}
+		catch (...)
+		{
+			exception = std::current_exception();
+		}
+
+		for (auto& future : futures)
+		{
+			try
+			{
+				future.get();
+			}
+			catch (...)
+			{
+				if (exception == nullptr) exception = std::current_exception();
+			}
+		}
+
+		if (exception != nullptr) std::rethrow_exception(exception);
+	}
+}
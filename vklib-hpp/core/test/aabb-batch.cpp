@@ -0,0 +1,100 @@
+#include "vklib/core.hpp"
+
+#include <iostream>
+#include <random>
+
+using namespace VKLIB_HPP_NAMESPACE;
+using namespace algorithm::geometry::frustum;
+
+// Compares `AABB_batch::intersect_or_forward` against the scalar `AABB::intersect_or_forward` over random boxes & frusta.
+// Batch sizes and offsets are chosen so that every SIMD lane width leaves a partial batch for the scalar tail
+int main()
+{
+	std::mt19937                          rng(20240613);
+	std::uniform_real_distribution<float> position_dist(-50, 50), extent_dist(0, 10), unit_dist(-1, 1);
+	std::uniform_real_distribution<float> fov_dist(0.2, 2.5), aspect_dist(0.25, 4), near_dist(0.01, 5), far_dist(5, 200);
+	std::bernoulli_distribution           mask_dist(0.8);
+
+	const auto random_direction = [&]
+	{
+		glm::vec3 direction;
+		do direction = {unit_dist(rng), unit_dist(rng), unit_dist(rng)};
+		while (glm::length(direction) < 0.01f);
+
+		return direction;
+	};
+
+	const auto random_frustum = [&](bool ortho)
+	{
+		const glm::vec3 position = {position_dist(rng), position_dist(rng), position_dist(rng)};
+		const glm::vec3 front = random_direction(), up = glm::cross(front, random_direction());
+
+		if (ortho)
+		{
+			const float half_x = extent_dist(rng) + 1, half_y = extent_dist(rng) + 1;
+			return Frustum::from_ortho(position, front, up, -half_x, half_x, -half_y, half_y, -far_dist(rng), far_dist(rng));
+		}
+
+		return Frustum::from_projection(position, front, up, aspect_dist(rng), fov_dist(rng), near_dist(rng), far_dist(rng));
+	};
+
+	const std::array<size_t, 14> counts  = {0, 1, 3, 4, 5, 7, 8, 9, 12, 15, 16, 17, 31, 1003};
+	const std::array<size_t, 4>  offsets = {0, 1, 3, 5};
+
+	size_t test_count = 0, failure_count = 0;
+
+	for (const auto count : counts)
+		for (const auto offset : offsets)
+			for (auto iteration = 0; iteration < 16; iteration++)
+			{
+				AABB_batch        batch;
+				std::vector<AABB> boxes;
+
+				for (size_t i = 0; i < offset + count; i++)
+				{
+					const glm::vec3 center = {position_dist(rng), position_dist(rng), position_dist(rng)};
+					const glm::vec3 extent = {extent_dist(rng), extent_dist(rng), extent_dist(rng)};
+
+					boxes.push_back({center, extent});
+					batch.push_back(boxes.back());
+				}
+
+				const auto frustum = random_frustum(iteration % 4 == 3);
+
+				std::vector<uint8_t> initial_mask(count);
+				for (auto& value : initial_mask) value = mask_dist(rng) ? 1 : 0;
+
+				for (const auto& plane : {frustum.near, frustum.far, frustum.left, frustum.right, frustum.top, frustum.bottom})
+				{
+					auto batch_mask = initial_mask;
+					batch.intersect_or_forward(plane, batch_mask, offset);
+
+					for (size_t i = 0; i < count; i++)
+					{
+						const uint8_t expected = initial_mask[i] & (boxes[offset + i].intersect_or_forward(plane) ? 1 : 0);
+						test_count++;
+
+						if (batch_mask[i] == expected) continue;
+
+						if (failure_count++ < 16)
+							std::cerr << std::format(
+								"Mismatch: count {}, offset {}, box {}: batch {}, scalar {}\n",
+								count,
+								offset,
+								i,
+								batch_mask[i],
+								expected
+							);
+					}
+				}
+			}
+
+	if (failure_count != 0)
+	{
+		std::cerr << std::format("{} of {} box tests mismatched\n", failure_count, test_count);
+		return EXIT_FAILURE;
+	}
+
+	std::cout << std::format("{} box tests passed\n", test_count);
+	return EXIT_SUCCESS;
+}
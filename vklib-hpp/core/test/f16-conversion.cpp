@@ -0,0 +1,142 @@
+#include "vklib/core.hpp"
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace VKLIB_HPP_NAMESPACE;
+using namespace algorithm::conversion;
+
+// Float32 bit patterns that exercise every boundary class of the conversion:
+// - Every exponent (float32 denormals, float16 denormals, the overflow edge, Inf & NaN) with both signs, every
+//   float16 mantissa and the discarded bits at zero, just below, at and just above the rounding tie
+// - Ties at every shift of the float16 denormal range, where more than 13 bits are discarded
+// - A strided sweep and random patterns over the whole input space
+static std::vector<uint32_t> sample_inputs()
+{
+	std::vector<uint32_t> inputs;
+
+	const std::array<uint32_t, 6> low_patterns = {0x0000, 0x0001, 0x0FFF, 0x1000, 0x1001, 0x1FFF};
+
+	for (uint32_t sign = 0; sign < 2; sign++)
+		for (uint32_t exponent = 0; exponent < 256; exponent++)
+			for (uint32_t mantissa = 0; mantissa < 1024; mantissa++)
+				for (const auto low : low_patterns)
+					inputs.push_back(sign << 31 | exponent << 23 | mantissa << 13 | low);
+
+	std::mt19937 rng(20240613);
+
+	for (uint32_t sign = 0; sign < 2; sign++)
+		for (uint32_t exponent = 98; exponent < 113; exponent++)
+			for (uint32_t discarded = 14; discarded < 24; discarded++)
+				for (auto iteration = 0; iteration < 256; iteration++)
+				{
+					const uint32_t half = 1u << (discarded - 1), mask = (1u << discarded) - 1;
+					const uint32_t upper = rng() & 0x007FFFFF & ~mask;
+
+					for (const auto low : {half - 1, half, half + 1})
+						inputs.push_back(sign << 31 | exponent << 23 | upper | (low & 0x007FFFFF));
+				}
+
+	for (uint64_t pattern = 0; pattern < (1ull << 32); pattern += 65521) inputs.push_back(uint32_t(pattern));
+	for (auto i = 0; i < (1 << 20); i++) inputs.push_back(rng());
+
+	return inputs;
+}
+
+// > Compares every vector kernel of the bulk float16 conversions bit-for-bit against the scalar `f32_to_f16` and
+// `f32_to_f16_clamped`. The only accepted difference is the NaN payload of the F16C kernel in the unclamped conversion
+// - Default: boundary classes and a sample of the input space, see `sample_inputs`
+// - `--exhaustive`: all 2^32 float32 bit patterns, takes minutes
+int main(int argc, char** argv)
+{
+	const std::vector<std::string_view> args(argv + 1, argv + argc);
+	const bool                          exhaustive = std::ranges::find(args, "--exhaustive") != args.end();
+
+	static constexpr size_t chunk_size = 1 << 16;
+
+	const auto   samples     = exhaustive ? std::vector<uint32_t>() : sample_inputs();
+	const size_t input_count = exhaustive ? (1ull << 32) : samples.size();
+	const size_t chunk_count = (input_count + chunk_size - 1) / chunk_size;
+
+	const std::array<std::pair<F16_path, const char*>, 2> paths = {
+		std::pair{F16_path::Sse2, "SSE2"},
+		std::pair{F16_path::F16c, "F16C"}
+	};
+
+	utility::Thread_pool pool;
+	bool                 passed = true;
+
+	for (const auto& [path, name] : paths)
+	{
+		if (!f16_path_supported(path))
+		{
+			std::cout << std::format("{}: not supported, skipped\n", name);
+			continue;
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+
+		std::atomic<size_t> failure_count = 0;
+		std::mutex          output_mutex;
+
+		pool.parallel_for(
+			chunk_count,
+			[&](size_t chunk)
+			{
+				const size_t begin = chunk * chunk_size, count = std::min(chunk_size, input_count - begin);
+
+				std::vector<float>    src(count);
+				std::vector<uint16_t> dst(count), dst_clamped(count);
+
+				for (auto i : Iota(count))
+					src[i] = std::bit_cast<float>(exhaustive ? uint32_t(begin + i) : samples[begin + i]);
+
+				f32_to_f16(src, dst, path);
+				f32_to_f16_clamped(src, dst_clamped, path);
+
+				for (auto i : Iota(count))
+				{
+					const uint16_t expected = f32_to_f16(src[i]), expected_clamped = f32_to_f16_clamped(src[i]);
+
+					const auto is_f16_nan = [](uint16_t value)
+					{
+						return (value & 0x7C00) == 0x7C00 && (value & 0x03FF) != 0;
+					};
+					const bool nan_payload_differs = path == F16_path::F16c && is_f16_nan(expected) && is_f16_nan(dst[i])
+												  && (expected & 0x8000) == (dst[i] & 0x8000);
+
+					if ((dst[i] == expected || nan_payload_differs) && dst_clamped[i] == expected_clamped) continue;
+
+					if (failure_count++ < 16)
+					{
+						const std::lock_guard lock(output_mutex);
+						std::cerr << std::format(
+							"{}: mismatch at 0x{:08X}: 0x{:04X} (expected 0x{:04X}), clamped 0x{:04X} (expected 0x{:04X})\n",
+							name,
+							std::bit_cast<uint32_t>(src[i]),
+							dst[i],
+							expected,
+							dst_clamped[i],
+							expected_clamped
+						);
+					}
+				}
+			}
+		);
+
+		const auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+		if (failure_count != 0)
+		{
+			std::cerr << std::format("{}: {} inputs mismatched\n", name, failure_count.load());
+			passed = false;
+		}
+		else
+			std::cout << std::format("{}: {} inputs match the scalar conversions ({:.1f}s)\n", name, input_count, duration.count());
+	}
+
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
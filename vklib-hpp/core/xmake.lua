@@ -1,7 +1,46 @@
 add_requires("vulkansdk", "vulkan-hpp", "vulkan-memory-allocator", "tinyobjloader", "glm")
 
+option("vklib_profiler")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Record CPU profiler zones, see vklib/core/profiler.hpp")
+option_end()
+
+option("vklib_exhaustive_tests")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Also register the exhaustive CPU tests with `xmake test`, these take minutes")
+option_end()
+
 target("vklib_core")
     set_kind("static")
     add_files("src/*.cpp")
     add_includedirs("include", {public = true})
-    add_packages("vulkansdk", "vulkan-hpp", "vulkan-memory-allocator", "tinyobjloader", "glm", {public = true})
\ No newline at end of file
+    add_packages("vulkansdk", "vulkan-hpp", "vulkan-memory-allocator", "tinyobjloader", "glm", {public = true})
+
+    if has_config("vklib_profiler") then
+        add_defines("VKLIB_ENABLE_PROFILER", {public = true})
+    end
+
+-- CPU tests, run with `xmake test`
+
+target("vklib_core_test_aabb_batch")
+    set_kind("binary")
+    set_default(false)
+    set_group("test")
+    add_files("test/aabb-batch.cpp")
+    add_deps("vklib_core")
+    add_tests("default")
+
+target("vklib_core_test_f16_conversion")
+    set_kind("binary")
+    set_default(false)
+    set_group("test")
+    add_files("test/f16-conversion.cpp")
+    add_deps("vklib_core")
+    add_tests("default")
+
+    -- All 2^32 inputs, run with `xmake f --vklib_exhaustive_tests=y && xmake test vklib_core_test_f16_conversion/exhaustive`
+    if has_config("vklib_exhaustive_tests") then
+        add_tests("exhaustive", {runargs = "--exhaustive"})
+    end
@@ -8,9 +8,10 @@
 #include "vklib/core/env.hpp"
 #include "vklib/core/io.hpp"
 #include "vklib/core/pipeline.hpp"
+#include "vklib/core/staging.hpp"
 #include "vklib/core/storage.hpp"
 #include "vklib/core/sync.hpp"
-
+#include "vklib/core/thread-pool.hpp"
 
 #include <set>
 #include <unordered_set>
@@ -59,6 +60,11 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 	{
 		bool  enable_anistropy = false;
 		float max_anistropy    = 1.0;
+
+		vk::DeviceSize staging_capacity = 64 * 1024 * 1024;  // Size of the staging ring used for uploads
+
+		// `textureCompressionBC` is enabled on the device, so BC-compressed KTX2 images can be used
+		bool enable_texture_compression_bc = false;
 	};
 
 	enum class Load_stage
@@ -74,6 +80,7 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 	struct Loader_context
 	{
 		Queue           transfer_queue;
+		std::mutex*     queue_mutex = nullptr;  // Held while using `transfer_queue` if given, for queues shared with other threads
 		Command_pool    command_pool;
 		Vma_allocator   allocator;
 		Device          device;
@@ -82,11 +89,28 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 
 		Loader_config config;
 
-		std::vector<Buffer>         staging_buffers;
-		std::vector<Command_buffer> command_buffers;
+		Staging_ring staging_ring;
+
+		// Guards `command_pool` and `staging_ring` when loading with multiple threads
+		std::mutex mutex;
+
+		Load_stage*         load_stage   = nullptr;
+		std::atomic<float>* sub_progress = nullptr;
+
+		// Non-fatal issues found while loading, e.g. `KHR_texture_basisu` images replaced by their fallback source
+		std::vector<std::string> warnings;
+	};
 
-		Load_stage* load_stage   = nullptr;
-		float*      sub_progress = nullptr;
+	// Material slot sampling an image
+	enum class Texture_usage
+	{
+		Unused = 0,
+		Color,
+		Normal,
+		Metal_roughness,
+		Occlusion,
+		Emissive,
+		Shared  // Sampled by more than one slot
 	};
 
 	struct Texture
@@ -98,13 +122,34 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 		uint32_t   component_count;
 		vk::Format format;
 
+		// Applied by views of the texture, maps two-channel metal-roughness images (roughness, metalness) to (-, g, b)
+		vk::ComponentMapping components;
+
 		Image image;
 
-		void parse(const tinygltf::Image& tex, Loader_context& loader_context);
+		// > Decodes and uploads `tex`, generating mipmaps.
+		// KTX2 images are uploaded as stored, together with their mip levels, see `is_ktx2_supported`
+		void parse(const tinygltf::Image& tex, Texture_usage usage, Loader_context& loader_context);
 
 		void generate(uint8_t value0, uint8_t value1, uint8_t value2, uint8_t value3, Loader_context& loader_context);
+
+		// > Uploads stored mip levels, level 0 being the largest, each tightly packed in `format`.
+		// `width`, `height` and `format` must be set beforehand
+		void upload(std::span<const std::span<const uint8_t>> levels, Loader_context& loader_context);
+
+		// > Whether `tex` is a KTX2 image `parse` can upload to the device of `loader_context`:
+		// 2D, without supercompression, in a supported BC or 8-bit format.
+		// Only pre-transcoded KTX2 is supported, BasisLZ & UASTC payloads would need the Basis Universal transcoder
+		static bool is_ktx2_supported(const tinygltf::Image& tex, const Loader_context& loader_context);
+
+		// Why `tex` isn't a KTX2 image `parse` can upload, empty if it is, see `is_ktx2_supported`
+		static std::string ktx2_unsupported_reason(const tinygltf::Image& tex, const Loader_context& loader_context);
 	};
 
+	// > Image sampled by `texture`. The KTX2 image of `KHR_texture_basisu` is preferred when supported,
+	// `source` is the fallback
+	uint32_t texture_source(const Loader_context& context, const tinygltf::Model& model, const tinygltf::Texture& texture);
+
 	struct Texture_view
 	{
 		Image_view    view;
@@ -121,12 +166,12 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 
 		Texture_view(const Loader_context& context, const Texture& texture, const vk::ComponentMapping& components = {});
 
+		// Views the image of `texture` (see `texture_source`), with components mapped by `Texture::components`
 		Texture_view(
 			const Loader_context&       context,
 			const std::vector<Texture>& texture_list,
 			const tinygltf::Model&      model,
-			const tinygltf::Texture&    texture,
-			const vk::ComponentMapping& components = {}
+			const tinygltf::Texture&    texture
 		);
 
 		vk::DescriptorImageInfo descriptor_info(vk::ImageLayout layout = vk::ImageLayout::eShaderReadOnlyOptimal) const
@@ -147,7 +192,7 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 		std::string name;
 
 		uint32_t albedo_idx, metal_roughness_idx, normal_idx, emissive_idx, occlusion_idx;
-		bool     double_sided;
+		bool     double_sided = false;
 
 		Alpha_mode alpha_mode = Alpha_mode::Opaque;
 
@@ -205,13 +250,17 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 
 		std::optional<uint32_t> material_idx;
 
-		uint32_t vertex_count;
+		uint32_t vertex_count, index_count;
 
 		uint32_t position_buffer, position_offset;
 		uint32_t normal_buffer, normal_offset;
 		uint32_t tangent_buffer, tangent_offset;
 		uint32_t uv_buffer, uv_offset;
 
+		// Triangle list indices, `index_buffer` refers to `index16_buffers` or `index32_buffers` depending on `index_type`
+		vk::IndexType index_type = vk::IndexType::eUint32;
+		uint32_t      index_buffer, index_offset;
+
 		std::optional<Primitive_skin> skin = std::nullopt;
 
 		glm::vec3 min, max;
@@ -272,65 +321,40 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 	{
 	  public:
 
-		// 3 parameters for Cubic
-		struct Cubic_params
-		{
-			T v, a, b;
-		};
+		// Keyframe timestamps, sorted
+		std::vector<float> timestamps;
 
-		struct Keyframe
-		{
-			float time = 0.0;
-
-			union
-			{
-				// Linear
-				T linear;
-
-				// Cubic
-				Cubic_params cubic;
-			};
-
-			bool operator<(const Keyframe& other) const { return time < other.time; }
-
-			Keyframe() = default;
-			Keyframe(float time, const T& linear) :
-				time(time),
-				linear(linear)
-			{
-			}
-
-			Keyframe(float time, const T& v, const T& a, const T& b) :
-				time(time),
-				cubic(v, a, b)
-			{
-			}
-		};
+		// Keyframe values. One value per keyframe, or 3 values (in-tangent, value, out-tangent) per keyframe if cubic
+		std::vector<T> values;
 
-		std::set<Keyframe> keyframes;
 		Interpolation_mode mode = Interpolation_mode::Linear;
 
 		void load(const tinygltf::Model& model, const tinygltf::AnimationSampler& sampler);
 
-		float start_time() const { return keyframes.begin()->time; }
-		float end_time() const { return keyframes.rbegin()->time; }
+		float start_time() const { return timestamps.front(); }
+		float end_time() const { return timestamps.back(); }
 
 		// Get the interpolated value at given time
-		T operator[](float time) const;
+		T operator[](float time) const
+		{
+			uint32_t cursor = 0;
+			return sample(time, cursor);
+		}
+
+		// Get the interpolated value at given time.
+		// `cursor` is the keyframe index found in the last sampling, used as a hint and updated.
+		// Amortized O(1) when sampling with monotonic time, O(log n) otherwise.
+		T sample(float time, uint32_t& cursor) const;
 
 	  private:
 
-		T linear_interpolate(
-			const typename std::set<Keyframe>::const_iterator& first,
-			const typename std::set<Keyframe>::const_iterator& second,
-			float                                              time
-		) const;
+		// Find keyframe index `idx` where timestamps[idx] <= time < timestamps[idx + 1]
+		uint32_t find_keyframe(float time, uint32_t hint) const;
 
-		T cubic_interpolate(
-			const typename std::set<Keyframe>::const_iterator& first,
-			const typename std::set<Keyframe>::const_iterator& second,
-			float                                              time
-		) const;
+		T keyframe_value(uint32_t idx) const { return mode == Interpolation_mode::Cubic_spline ? values[idx * 3 + 1] : values[idx]; }
+
+		T linear_interpolate(uint32_t first, float time) const;
+		T cubic_interpolate(uint32_t first, float time) const;
 	};
 
 	std::variant<Animation_sampler<glm::vec3>, Animation_sampler<glm::quat>> load_sampler(
@@ -368,7 +392,13 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 
 		void load(const tinygltf::Model& model, const tinygltf::Animation& animation);
 
-		void set_transformation(float time, const std::function<Node_transformation&(uint32_t)>& func) const;
+		// Set node transformations at given time.
+		// `cursors` optionally holds keyframe hints of every sampler between calls, see `Animation_sampler::sample`
+		void set_transformation(
+			float                                                time,
+			const std::function<Node_transformation&(uint32_t)>& func,
+			std::vector<uint32_t>*                               cursors = nullptr
+		) const;
 	};
 
 	struct Camera
@@ -397,9 +427,16 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 
 		std::optional<uint32_t> node_idx;
 
+		Camera() = default;
 		Camera(const tinygltf::Camera& camera);
 	};
 
+	struct Cook_config
+	{
+		// Block-compresses decoded images by the material slot sampling them, otherwise they are stored as 8-bit RGBA
+		bool compress_textures = true;
+	};
+
 	class Model
 	{
 	  public:
@@ -410,6 +447,7 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 		std::vector<Material>     materials;
 		std::vector<Mesh>         meshes;
 		std::vector<Buffer>       vec3_buffers, vec2_buffers, joint_buffers, weight_buffers;
+		std::vector<Buffer>       index16_buffers, index32_buffers;
 		std::vector<Scene>        scenes;
 		std::vector<Animation>    animations;
 		std::vector<Skin>         skins;
@@ -421,10 +459,24 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 
 		void load_gltf_bin(Loader_context& loader_context, const std::string& path);
 
-		void load_gltf_memory(Loader_context& loader_context, std::span<uint8_t> data);
+		void load_gltf_memory(Loader_context& loader_context, std::span<const uint8_t> data);
+
+		// > Loads a scene written by `cook`. Buffers and mip levels are uploaded straight from the mapped file,
+		// block-compressed scenes need `Loader_config::enable_texture_compression_bc`
+		void load_cooked(Loader_context& loader_context, const std::string& path);
+
+		// > Converts the glTF file at `input` into a cooked scene at `output`, no device is needed.
+		// Vertex & index buffers are stored in their final layout, images with their full mip chain
+		static void cook(const std::string& input, const std::string& output, const Cook_config& config = {});
 
 	  private:
 
+		// Byte views of the blocks of every buffer list
+		struct Buffer_blocks
+		{
+			std::vector<std::span<const uint8_t>> vec3, vec2, joint, weight, index16, index32;
+		};
+
 		struct Mesh_data_context
 		{
 			inline static constexpr size_t max_single_size = 64 * 1048576;  // MAX. 64M per block
@@ -433,22 +485,63 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 			std::vector<std::vector<glm::vec2>>    vec2_data;
 			std::vector<std::vector<glm::u16vec4>> joint_data;
 			std::vector<std::vector<glm::vec4>>    weight_data;
+			std::vector<std::vector<uint16_t>>     index16_data;
+			std::vector<std::vector<uint32_t>>     index32_data;
+
+			Buffer_blocks blocks() const;
+		};
+
+		// Parsed primitive with its own vertex & index data, merged into `Mesh_data_context` afterwards
+		struct Primitive_data
+		{
+			Primitive primitive;
+
+			std::vector<glm::vec3>    position, normal, tangent;
+			std::vector<glm::vec2>    uv;
+			std::vector<glm::u16vec4> joint;
+			std::vector<glm::vec4>    weight;
+			std::vector<uint32_t>     indices;
 		};
 
 		void load(Loader_context& loader_context, const tinygltf::Model& gltf_model);
 
 		void load_all_materials(Loader_context& loader_context, const tinygltf::Model& gltf_model);
-		void load_all_images(Loader_context& loader_context, const tinygltf::Model& gltf_model);
+		void load_all_images(Loader_context& loader_context, const tinygltf::Model& gltf_model, utility::Thread_pool& thread_pool);
 		void load_all_textures(Loader_context& loader_context, const tinygltf::Model& gltf_model);
 		void load_all_scenes(const tinygltf::Model& gltf_model);
 		void load_all_nodes(const tinygltf::Model& model);
-		void load_all_meshes(Loader_context& loader_context, const tinygltf::Model& gltf_model);
+		void load_all_meshes(Loader_context& loader_context, const tinygltf::Model& gltf_model, utility::Thread_pool& thread_pool);
 		void load_all_animations(const tinygltf::Model& model);
 		void load_all_skins(const tinygltf::Model& model);
 		void load_all_cameras(const tinygltf::Model& model);
 
-		void generate_buffers(Loader_context& loader_context, const Mesh_data_context& mesh_context);
+		void generate_buffers(Loader_context& loader_context, const Buffer_blocks& blocks);
+
+		// Uploads are streamed through the staging ring of `loader_context` while loading
+		static void create_staging_ring(Loader_context& loader_context);
+
+		// Materials of `gltf_model` and the default material. Missing textures are replaced by `add_placeholder(color)`,
+		// which returns the index of a texture view sampling `color`
+		static std::vector<Material> parse_materials(
+			const tinygltf::Model&                      gltf_model,
+			const std::function<uint32_t(glm::u8vec4)>& add_placeholder
+		);
+
+		// Parses all primitives in parallel, their data is merged into `mesh_context` in order
+		static std::vector<Mesh> parse_meshes(
+			const tinygltf::Model& gltf_model,
+			utility::Thread_pool&  thread_pool,
+			Mesh_data_context&     mesh_context,
+			std::atomic<float>*    sub_progress
+		);
+
+		// Thread-safe, only reads from `model`
+		static Primitive_data parse_primitive(const tinygltf::Model& model, const tinygltf::Primitive& primitive);
+
+		// > Merges vertices of `data` whose attributes are all bitwise equal and drops vertices no index refers to.
+		// Vertices are renumbered in order of first use
+		static void weld_vertices(Primitive_data& data);
 
-		Primitive parse_primitive(const tinygltf::Model& model, const tinygltf::Primitive& primitive, Mesh_data_context& mesh_context);
+		static Primitive merge_primitive(const Primitive_data& data, Mesh_data_context& mesh_context);
 	};
 }
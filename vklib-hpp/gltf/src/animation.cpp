@@ -4,37 +4,39 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 {
 
 	template <Vec3_or_quat T>
-	T Animation_sampler<T>::operator[](float time) const
+	uint32_t Animation_sampler<T>::find_keyframe(float time, uint32_t hint) const
 	{
-		const auto upper = std::upper_bound(
-			keyframes.begin(),
-			keyframes.end(),
-			time,
-			[](float time, auto val)
-			{
-				return time < val.time;
-			}
-		);
+		// try the hinted keyframe and the one after it
+		for (auto idx : Iota(hint, hint + 2))
+			if (idx + 1 < timestamps.size() && timestamps[idx] <= time && time < timestamps[idx + 1]) return idx;
 
-		// time larger than upper bound
-		if (upper == keyframes.end()) return keyframes.rbegin()->linear;
+		// binary search
+		const auto upper = std::upper_bound(timestamps.begin(), timestamps.end(), time);
+
+		return upper - timestamps.begin() - 1;
+	}
 
+	template <Vec3_or_quat T>
+	T Animation_sampler<T>::sample(float time, uint32_t& cursor) const
+	{
 		// time smaller than lower bound
-		if (upper == keyframes.begin()) return keyframes.begin()->linear;
+		if (time < timestamps.front()) return keyframe_value(0);
+
+		// time larger than upper bound
+		if (time >= timestamps.back()) return keyframe_value(timestamps.size() - 1);
 
-		auto lower = upper;
-		lower--;
+		cursor = find_keyframe(time, cursor);
 
 		switch (mode)
 		{
 		case Interpolation_mode::Step:
-			return lower->linear;
+			return keyframe_value(cursor);
 
 		case Interpolation_mode::Linear:
-			return linear_interpolate(lower, upper, time);
+			return linear_interpolate(cursor, time);
 
 		case Interpolation_mode::Cubic_spline:
-			return cubic_interpolate(lower, upper, time);
+			return cubic_interpolate(cursor, time);
 
 		default:
 			throw Animation_runtime_error(
@@ -45,69 +47,58 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 	}
 
 	template <>
-	glm::vec3 Animation_sampler<glm::vec3>::linear_interpolate(
-		const std::set<Animation_sampler<glm::vec3>::Keyframe>::const_iterator& first,
-		const std::set<Animation_sampler<glm::vec3>::Keyframe>::const_iterator& second,
-		float                                                                   time
-	) const
+	glm::vec3 Animation_sampler<glm::vec3>::linear_interpolate(uint32_t first, float time) const
 	{
-		const auto& frame1 = *first;
-		const auto& frame2 = *second;
+		const auto time1 = timestamps[first], time2 = timestamps[first + 1];
 
-		return glm::mix(frame1.linear, frame2.linear, (time - frame1.time) / (frame2.time - frame1.time));
+		return glm::mix(values[first], values[first + 1], (time - time1) / (time2 - time1));
 	}
 
 	template <>
-	glm::quat Animation_sampler<glm::quat>::linear_interpolate(
-		const std::set<Animation_sampler<glm::quat>::Keyframe>::const_iterator& first,
-		const std::set<Animation_sampler<glm::quat>::Keyframe>::const_iterator& second,
-		float                                                                   time
-	) const
+	glm::quat Animation_sampler<glm::quat>::linear_interpolate(uint32_t first, float time) const
 	{
-		const auto& frame1 = *first;
-		const auto& frame2 = *second;
+		const auto time1 = timestamps[first], time2 = timestamps[first + 1];
 
-		return glm::slerp(frame1.linear, frame2.linear, (time - frame1.time) / (frame2.time - frame1.time));
+		return glm::slerp(values[first], values[first + 1], (time - time1) / (time2 - time1));
 	}
 
 	template <>
-	glm::vec3 Animation_sampler<glm::vec3>::cubic_interpolate(
-		const std::set<Animation_sampler<glm::vec3>::Keyframe>::const_iterator& first,
-		const std::set<Animation_sampler<glm::vec3>::Keyframe>::const_iterator& second,
-		float                                                                   time
-	) const
+	glm::vec3 Animation_sampler<glm::vec3>::cubic_interpolate(uint32_t first, float time) const
 	{
-		const auto& frame1 = *first;
-		const auto& frame2 = *second;
+		const auto time1 = timestamps[first], time2 = timestamps[first + 1];
 
-		const float tc = time, td = frame2.time - frame1.time, t = (tc - frame1.time) / td;
+		// (in-tangent, value, out-tangent) of both keyframes
+		const auto *frame1 = &values[first * 3], *frame2 = &values[(first + 1) * 3];
+
+		const float tc = time, td = time2 - time1, t = (tc - time1) / td;
 		const float t_2 = t * t, t_3 = t_2 * t;
 
-		const glm::vec3 item1 = (2 * t_3 - 3 * t_2 + 1) * frame1.cubic.v, item2 = td * (t_3 - 2 * t_2 + t) * frame1.cubic.b,
-						item3 = (-2 * t_3 + 3 * t_2) * frame2.cubic.v, item4 = td * (t_3 - t_2) * frame2.cubic.a;
+		const glm::vec3 item1 = (2 * t_3 - 3 * t_2 + 1) * frame1[1], item2 = td * (t_3 - 2 * t_2 + t) * frame1[2],
+						item3 = (-2 * t_3 + 3 * t_2) * frame2[1], item4 = td * (t_3 - t_2) * frame2[0];
 
 		return item1 + item2 + item3 + item4;
 	}
 
 	template <>
-	glm::quat Animation_sampler<glm::quat>::cubic_interpolate(
-		const std::set<Animation_sampler<glm::quat>::Keyframe>::const_iterator& first,
-		const std::set<Animation_sampler<glm::quat>::Keyframe>::const_iterator& second,
-		float                                                                   time
-	) const
+	glm::quat Animation_sampler<glm::quat>::cubic_interpolate(uint32_t first, float time) const
 	{
-		const auto& frame1 = *first;
-		const auto& frame2 = *second;
+		const auto time1 = timestamps[first], time2 = timestamps[first + 1];
 
-		const float tc = time, td = frame2.time - frame1.time, t = (tc - frame1.time) / td;
+		// (in-tangent, value, out-tangent) of both keyframes
+		const auto *frame1 = &values[first * 3], *frame2 = &values[(first + 1) * 3];
+
+		const float tc = time, td = time2 - time1, t = (tc - time1) / td;
 		const float t_2 = t * t, t_3 = t_2 * t;
 
-		const glm::quat item1 = (2 * t_3 - 3 * t_2 + 1) * frame1.cubic.v, item2 = td * (t_3 - 2 * t_2 + t) * frame1.cubic.b,
-						item3 = (-2 * t_3 + 3 * t_2) * frame2.cubic.v, item4 = td * (t_3 - t_2) * frame2.cubic.a;
+		const glm::quat item1 = (2 * t_3 - 3 * t_2 + 1) * frame1[1], item2 = td * (t_3 - 2 * t_2 + t) * frame1[2],
+						item3 = (-2 * t_3 + 3 * t_2) * frame2[1], item4 = td * (t_3 - t_2) * frame2[0];
 
 		return glm::normalize(item1 + item2 + item3 + item4);
 	}
 
+	template glm::vec3 Animation_sampler<glm::vec3>::sample(float time, uint32_t& cursor) const;
+	template glm::quat Animation_sampler<glm::quat>::sample(float time, uint32_t& cursor) const;
+
 	template <>
 	void Animation_sampler<glm::vec3>::load(const tinygltf::Model& model, const tinygltf::AnimationSampler& sampler)
 	{
@@ -135,8 +126,8 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 			accessor.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT || accessor.type != TINYGLTF_TYPE_VEC3)
 			throw Animation_parse_error("Invalid animation sampler output type");
 
-		const auto timestamp_list = data_parser::acquire_accessor<float>(model, sampler.input);
-		const auto value_list     = data_parser::acquire_accessor<glm::vec3>(model, sampler.output);
+		auto timestamp_list = data_parser::acquire_accessor<float>(model, sampler.input);
+		auto value_list     = data_parser::acquire_accessor<glm::vec3>(model, sampler.output);
 
 		// check value size
 		if (auto target = (mode == Interpolation_mode::Cubic_spline) ? timestamp_list.size() * 3 : timestamp_list.size();
@@ -145,20 +136,15 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 				std::format("Invalid animation sampler data size: {} VEC3, target is {}", value_list.size(), target)
 			);
 
+		// check timestamps
+		if (timestamp_list.empty()) throw Animation_parse_error("Empty animation sampler");
+
+		if (!std::is_sorted(timestamp_list.begin(), timestamp_list.end()))
+			throw Animation_parse_error("Animation sampler timestamps not in ascending order");
+
 		// store values
-		if (mode == Interpolation_mode::Cubic_spline)
-			// Cubic spline, 3 values per timestamp
-			for (auto i : Iota(timestamp_list.size()))
-			{
-				keyframes
-					.emplace_hint(keyframes.end(), timestamp_list[i], value_list[i * 3 + 1], value_list[i * 3], value_list[i * 3 + 2]);
-			}
-		else
-			// Not cubic spline, 1 value per timestamp
-			for (auto i : Iota(timestamp_list.size()))
-			{
-				keyframes.emplace_hint(keyframes.end(), timestamp_list[i], value_list[i]);
-			}
+		timestamps = std::move(timestamp_list);
+		values     = std::move(value_list);
 	}
 
 	template <>
@@ -188,8 +174,8 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 			accessor.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT || accessor.type != TINYGLTF_TYPE_VEC4)
 			throw Animation_parse_error("Invalid animation sampler output type");
 
-		const auto timestamp_list = data_parser::acquire_accessor<float>(model, sampler.input);
-		const auto value_list     = data_parser::acquire_normalized_accessor<glm::quat>(model, sampler.output);
+		auto timestamp_list = data_parser::acquire_accessor<float>(model, sampler.input);
+		auto value_list     = data_parser::acquire_normalized_accessor<glm::quat>(model, sampler.output);
 
 		// check value size
 		if (auto target = (mode == Interpolation_mode::Cubic_spline) ? timestamp_list.size() * 3 : timestamp_list.size();
@@ -198,20 +184,15 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 				std::format("Invalid animation sampler data size: {} VEC3, target is {}", value_list.size(), target)
 			);
 
+		// check timestamps
+		if (timestamp_list.empty()) throw Animation_parse_error("Empty animation sampler");
+
+		if (!std::is_sorted(timestamp_list.begin(), timestamp_list.end()))
+			throw Animation_parse_error("Animation sampler timestamps not in ascending order");
+
 		// store values
-		if (mode == Interpolation_mode::Cubic_spline)
-			// Cubic spline, 3 values per timestamp
-			for (auto i : Iota(timestamp_list.size()))
-			{
-				keyframes
-					.emplace_hint(keyframes.end(), timestamp_list[i], value_list[i * 3 + 1], value_list[i * 3], value_list[i * 3 + 2]);
-			}
-		else
-			// Not cubic spline, 1 value per timestamp
-			for (auto i : Iota(timestamp_list.size()))
-			{
-				keyframes.emplace_hint(keyframes.end(), timestamp_list[i], value_list[i]);
-			}
+		timestamps = std::move(timestamp_list);
+		values     = std::move(value_list);
 	}
 
 	std::variant<Animation_sampler<glm::vec3>, Animation_sampler<glm::quat>> load_sampler(
@@ -302,11 +283,21 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 		}
 	}
 
-	void Animation::set_transformation(float time, const std::function<Node_transformation&(uint32_t)>& func) const
+	void Animation::set_transformation(
+		float                                                time,
+		const std::function<Node_transformation&(uint32_t)>& func,
+		std::vector<uint32_t>*                               cursors
+	) const
 	{
+		// sampler cursors, local ones are used if not provided
+		std::vector<uint32_t> local_cursors;
+		if (cursors == nullptr) cursors = &local_cursors;
+		cursors->resize(samplers.size(), 0);
+
 		for (const auto& channel : channels)
 		{
 			const auto& sampler_variant = samplers[channel.sampler.value()];
+			auto&       cursor          = (*cursors)[channel.sampler.value()];
 
 			// check type
 			if ((sampler_variant.index() != 1 && channel.target == Animation_target::Rotation)
@@ -322,19 +313,19 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 			case Animation_target::Translation:
 			{
 				const auto& sampler = std::get<0>(sampler_variant);
-				find.translation    = sampler[time];
+				find.translation    = sampler.sample(time, cursor);
 				break;
 			}
 			case Animation_target::Rotation:
 			{
 				const auto& sampler = std::get<1>(sampler_variant);
-				find.rotation       = sampler[time];
+				find.rotation       = sampler.sample(time, cursor);
 				break;
 			}
 			case Animation_target::Scale:
 			{
 				const auto& sampler = std::get<0>(sampler_variant);
-				find.scale          = sampler[time];
+				find.scale          = sampler.sample(time, cursor);
 				break;
 			}
 			default:
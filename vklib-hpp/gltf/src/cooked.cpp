@@ -0,0 +1,1103 @@
+#include "texture-codec.hpp"
+
+#include <bit>
+#include <cstring>
+#include <filesystem>
+
+namespace VKLIB_HPP_NAMESPACE::io::gltf
+{
+	// > Cooked scene layout: [Header] [Structure] [Blobs].
+	// The structure describes the scene record by record, see the `transfer` functions for the order of the fields.
+	// Blobs hold vertex & index buffer blocks and mip levels, aligned to 16 bytes so they can be uploaded from the mapped file.
+	// Values are stored in little-endian byte order. Bump `cooked_version` whenever the layout changes
+	static constexpr std::array<char, 8> cooked_magic   = {'V', 'K', 'S', 'C', 'E', 'N', 'E', '\0'};
+	static constexpr uint32_t            cooked_version = 1;
+	static constexpr uint64_t            blob_alignment = 16;
+
+	static_assert(std::endian::native == std::endian::little, "Cooked scenes are read & written in native byte order");
+
+	struct Cooked_header
+	{
+		std::array<char, 8> magic;
+		uint32_t            version, reserved;
+		uint64_t            structure_offset, structure_size;
+		uint64_t            blob_offset, blob_size;
+	};
+
+	static_assert(sizeof(Cooked_header) == 48);
+
+	struct Cooked_scene_error : public error::Detailed_error
+	{
+		Cooked_scene_error(const std::string& detail, const std::source_location& loc = std::source_location::current()) :
+			Detailed_error(std::format("Invalid cooked scene: {}", detail), detail, loc)
+		{
+		}
+	};
+
+	static uint64_t align_blob(uint64_t offset)
+	{
+		return (offset + blob_alignment - 1) / blob_alignment * blob_alignment;
+	}
+
+#pragma region "Records"
+
+	// Location of a blob, relative to the start of the blob section
+	struct Blob_ref
+	{
+		uint64_t offset, size;
+	};
+
+	struct Cooked_image
+	{
+		std::string           name;
+		vk::Format            format;  // always an upload format of `codec::block_formats`
+		uint32_t              width, height, component_count;
+		vk::ComponentMapping  components;
+		std::vector<Blob_ref> levels;
+	};
+
+	// Filters & wrap modes as defined by glTF
+	struct Cooked_sampler
+	{
+		int32_t min_filter, mag_filter, wrap_s, wrap_t;
+	};
+
+	struct Cooked_texture_view
+	{
+		uint32_t                      image;
+		std::optional<Cooked_sampler> sampler;  // default sampler if absent
+	};
+
+	// Blocks of the buffer lists of `Model`
+	struct Cooked_buffers
+	{
+		std::vector<Blob_ref> vec3, vec2, joint, weight, index16, index32;
+	};
+
+	struct Cooked_scene
+	{
+		std::vector<Cooked_image>        images;
+		std::vector<Cooked_texture_view> texture_views;
+		std::vector<Material>            materials;
+		Cooked_buffers                   buffers;
+		std::vector<Mesh>                meshes;
+		std::vector<Scene>               scenes;
+		std::vector<Node>                nodes;
+		std::vector<Skin>                skins;
+		std::vector<Camera>              cameras;
+		std::vector<Animation>           animations;
+	};
+
+	/* Fields of every record in file order, `Archive` being `Cooked_writer` or `Cooked_reader` */
+
+	template <typename Archive>
+	static void transfer(Archive& archive, Cooked_image& image)
+	{
+		archive(image.name, image.format, image.width, image.height, image.component_count, image.components, image.levels);
+	}
+
+	template <typename Archive>
+	static void transfer(Archive& archive, vk::ComponentMapping& components)
+	{
+		archive(components.r, components.g, components.b, components.a);
+	}
+
+	template <typename Archive>
+	static void transfer(Archive& archive, Cooked_texture_view& view)
+	{
+		archive(view.image, view.sampler);
+	}
+
+	template <typename Archive>
+	static void transfer(Archive& archive, Cooked_buffers& buffers)
+	{
+		archive(buffers.vec3, buffers.vec2, buffers.joint, buffers.weight, buffers.index16, buffers.index32);
+	}
+
+	template <typename Archive>
+	static void transfer(Archive& archive, Material& material)
+	{
+		auto& params = material.params;
+
+		archive(material.name, material.double_sided, material.alpha_mode);
+		archive(material.albedo_idx, material.metal_roughness_idx, material.normal_idx, material.emissive_idx, material.occlusion_idx);
+		archive(params.emissive_multiplier, params.metalness_roughness_multiplier, params.base_color_multiplier);
+		archive(params.alpha_cutoff, params.normal_scale, params.occlusion_strength, params.emissive_strength);
+	}
+
+	template <typename Archive>
+	static void transfer(Archive& archive, Primitive& primitive)
+	{
+		archive(primitive.enabled, primitive.material_idx, primitive.vertex_count, primitive.index_count);
+		archive(primitive.position_buffer, primitive.position_offset, primitive.normal_buffer, primitive.normal_offset);
+		archive(primitive.tangent_buffer, primitive.tangent_offset, primitive.uv_buffer, primitive.uv_offset);
+		archive(primitive.index_type, primitive.index_buffer, primitive.index_offset);
+		archive(primitive.skin, primitive.min, primitive.max);
+	}
+
+	template <typename Archive>
+	static void transfer(Archive& archive, Mesh& mesh)
+	{
+		archive(mesh.name, mesh.primitives);
+	}
+
+	template <typename Archive>
+	static void transfer(Archive& archive, Scene& scene)
+	{
+		archive(scene.name, scene.nodes);
+	}
+
+	template <typename Archive>
+	static void transfer(Archive& archive, Node& node)
+	{
+		auto& transformation = node.transformation;
+
+		archive(node.name, node.mesh_idx, node.children, node.skin_idx);
+		archive(transformation.rotation, transformation.translation, transformation.scale);
+	}
+
+	template <typename Archive>
+	static void transfer(Archive& archive, Skin& skin)
+	{
+		archive(skin.joints, skin.inverse_bind_matrices);
+	}
+
+	template <typename Archive>
+	static void transfer(Archive& archive, Camera& camera)
+	{
+		archive(camera.name, camera.znear, camera.zfar, camera.is_ortho, camera.node_idx);
+
+		if (camera.is_ortho)
+			archive(camera.ortho.xmag, camera.ortho.ymag);
+		else
+			archive(camera.perspective.yfov, camera.perspective.aspect_ratio);
+	}
+
+	template <typename Archive>
+	static void transfer(Archive& archive, Animation_channel& channel)
+	{
+		archive(channel.node, channel.target, channel.sampler);
+	}
+
+	template <typename Archive>
+	static void transfer(Archive& archive, std::variant<Animation_sampler<glm::vec3>, Animation_sampler<glm::quat>>& sampler)
+	{
+		uint32_t type = sampler.index();
+		archive(type);
+
+		if constexpr (Archive::reading)
+		{
+			if (type == 0)
+				sampler.template emplace<0>();
+			else if (type == 1)
+				sampler.template emplace<1>();
+			else
+				throw Cooked_scene_error(std::format("Unknown animation sampler type {}", type));
+		}
+
+		std::visit(
+			[&archive](auto& alternative)
+			{
+				archive(alternative.timestamps, alternative.values, alternative.mode);
+			},
+			sampler
+		);
+	}
+
+	template <typename Archive>
+	static void transfer(Archive& archive, Animation& animation)
+	{
+		archive(animation.name, animation.start_time, animation.end_time, animation.channels, animation.samplers);
+	}
+
+	template <typename Archive>
+	static void transfer(Archive& archive, Cooked_scene& scene)
+	{
+		archive(scene.images, scene.texture_views, scene.materials, scene.buffers, scene.meshes);
+		archive(scene.scenes, scene.nodes, scene.skins, scene.cameras, scene.animations);
+	}
+
+#pragma endregion
+
+#pragma region "Archives"
+
+	template <typename T>
+	struct Is_optional : std::false_type
+	{
+	};
+
+	template <typename T>
+	struct Is_optional<std::optional<T>> : std::true_type
+	{
+	};
+
+	template <typename T>
+	struct Is_vector : std::false_type
+	{
+	};
+
+	template <typename T>
+	struct Is_vector<std::vector<T>> : std::true_type
+	{
+	};
+
+	class Cooked_writer;
+
+	// Records are stored field by field, even when trivially copyable, so padding never reaches the file
+	template <typename T>
+	concept Cooked_record = requires(Cooked_writer& archive, T& value) { transfer(archive, value); };
+
+	// Stored as their bytes like plain values, but range-checked when read
+	template <typename T>
+	concept Checked_value = std::is_same_v<T, bool> || std::is_enum_v<T>;
+
+	// Stored as their bytes, none of these types have padding
+	template <typename T>
+	concept Plain_value = std::is_trivially_copyable_v<T> && !Cooked_record<T> && !Is_optional<T>::value && !Checked_value<T>;
+
+	static_assert(sizeof(bool) == 1);
+
+	/* Valid values of enums in cooked scenes */
+
+	static bool valid_enum(vk::Format)
+	{
+		return true;  // checked against `codec::block_formats` when loading images
+	}
+
+	static bool valid_enum(vk::ComponentSwizzle swizzle)
+	{
+		return swizzle >= vk::ComponentSwizzle::eIdentity && swizzle <= vk::ComponentSwizzle::eA;
+	}
+
+	static bool valid_enum(vk::IndexType type)
+	{
+		return type == vk::IndexType::eUint16 || type == vk::IndexType::eUint32;
+	}
+
+	static bool valid_enum(Alpha_mode mode)
+	{
+		return mode == Alpha_mode::Opaque || mode == Alpha_mode::Mask || mode == Alpha_mode::Blend;
+	}
+
+	static bool valid_enum(Interpolation_mode mode)
+	{
+		return mode == Interpolation_mode::Linear || mode == Interpolation_mode::Cubic_spline || mode == Interpolation_mode::Step;
+	}
+
+	static bool valid_enum(Animation_target target)
+	{
+		return target >= Animation_target::Translation && target <= Animation_target::Weights;
+	}
+
+	// > Fields are stored as:
+	// - plain values, bools & enums: their bytes;
+	// - strings & vectors: a `uint64_t` element count followed by the elements;
+	// - optionals: a `bool` followed by the value if present;
+	// - records: their fields, see `transfer`
+	class Cooked_writer
+	{
+	  public:
+
+		static constexpr bool reading = false;
+
+		template <typename... Ts>
+		void operator()(Ts&... values)
+		{
+			(field(values), ...);
+		}
+
+		// Appends `data` to the blob section
+		Blob_ref blob(std::span<const uint8_t> data)
+		{
+			const Blob_ref ref{blobs.size(), data.size()};
+
+			blobs.insert(blobs.end(), data.begin(), data.end());
+			blobs.resize(align_blob(blobs.size()));
+
+			return ref;
+		}
+
+		// Whole file, with header
+		std::vector<uint8_t> finish() const
+		{
+			const Cooked_header header{
+				.magic            = cooked_magic,
+				.version          = cooked_version,
+				.reserved         = 0,
+				.structure_offset = sizeof(Cooked_header),
+				.structure_size   = structure.size(),
+				.blob_offset      = align_blob(sizeof(Cooked_header) + structure.size()),
+				.blob_size        = blobs.size()
+			};
+
+			std::vector<uint8_t> output(header.blob_offset + header.blob_size);
+
+			std::memcpy(output.data(), &header, sizeof(header));
+			std::ranges::copy(structure, output.begin() + header.structure_offset);
+			std::ranges::copy(blobs, output.begin() + header.blob_offset);
+
+			return output;
+		}
+
+	  private:
+
+		std::vector<uint8_t> structure, blobs;
+
+		void write_bytes(const void* data, size_t size)
+		{
+			const auto* const bytes = (const uint8_t*)data;
+			structure.insert(structure.end(), bytes, bytes + size);
+		}
+
+		template <typename T>
+		void field(T& value)
+		{
+			if constexpr (Is_optional<T>::value)
+			{
+				bool has_value = value.has_value();
+				field(has_value);
+
+				if (has_value) field(*value);
+			}
+			else if constexpr (Is_vector<T>::value || std::is_same_v<T, std::string>)
+			{
+				uint64_t count = value.size();
+				field(count);
+
+				using Element_T = typename T::value_type;
+
+				if constexpr (Plain_value<Element_T>)
+					write_bytes(value.data(), value.size() * sizeof(Element_T));
+				else
+					for (auto& element : value) field(element);
+			}
+			else if constexpr (Plain_value<T> || Checked_value<T>)
+				write_bytes(&value, sizeof(T));
+			else
+				transfer(*this, value);
+		}
+	};
+
+	class Cooked_reader
+	{
+	  public:
+
+		static constexpr bool reading = true;
+
+		Cooked_reader(std::span<const uint8_t> structure) :
+			structure(structure)
+		{
+		}
+
+		template <typename... Ts>
+		void operator()(Ts&... values)
+		{
+			(field(values), ...);
+		}
+
+		bool finished() const { return cursor == structure.size(); }
+
+	  private:
+
+		std::span<const uint8_t> structure;
+		size_t                   cursor = 0;
+
+		void read_bytes(void* dst, size_t size)
+		{
+			if (size > structure.size() - cursor) throw Cooked_scene_error("Structure ends unexpectedly");
+
+			std::memcpy(dst, structure.data() + cursor, size);
+			cursor += size;
+		}
+
+		template <typename T>
+		void field(T& value)
+		{
+			if constexpr (Is_optional<T>::value)
+			{
+				bool has_value;
+				field(has_value);
+
+				if (has_value)
+					field(value.emplace());
+				else
+					value.reset();
+			}
+			else if constexpr (Is_vector<T>::value || std::is_same_v<T, std::string>)
+			{
+				uint64_t count;
+				field(count);
+
+				using Element_T = typename T::value_type;
+
+				// Every element takes at least one byte, which bounds the allocation by the size of the file
+				const auto remaining = structure.size() - cursor;
+				if (count > remaining / (Plain_value<Element_T> ? sizeof(Element_T) : 1))
+					throw Cooked_scene_error(std::format("Element count {} exceeds the structure", count));
+
+				value.resize(count);
+
+				if constexpr (Plain_value<Element_T>)
+					read_bytes(value.data(), count * sizeof(Element_T));
+				else
+					for (auto& element : value) field(element);
+			}
+			else if constexpr (std::is_same_v<T, bool>)
+			{
+				uint8_t byte;
+				read_bytes(&byte, sizeof(byte));
+
+				if (byte > 1) throw Cooked_scene_error(std::format("Invalid boolean value {}", byte));
+				value = byte != 0;
+			}
+			else if constexpr (std::is_enum_v<T>)
+			{
+				read_bytes(&value, sizeof(T));
+
+				if (!valid_enum(value))
+					throw Cooked_scene_error(std::format("Invalid enum value {}", (int64_t)value));
+			}
+			else if constexpr (Plain_value<T>)
+				read_bytes(&value, sizeof(T));
+			else
+				transfer(*this, value);
+		}
+	};
+
+#pragma endregion
+
+#pragma region "Cook"
+
+	// KTX2 images are kept as stored when the cooked scene can hold them
+	static bool is_cookable_ktx2(const tinygltf::Image& image, const Cook_config& config)
+	{
+		// Images decoded by tinygltf are never KTX2
+		if (image.width >= 0) return false;
+
+		try
+		{
+			const auto ktx2 = codec::read_ktx2(image.image);
+			if (!ktx2.has_value() || !codec::ktx2_container_reason(*ktx2).empty()) return false;
+
+			return config.compress_textures || codec::block_formats.at((vk::Format)ktx2->header.vk_format).block_extent == 1;
+		}
+		catch (const Gltf_parse_error&)
+		{
+			return false;
+		}
+	}
+
+	// Image with its encoded mip levels, which are written as blobs afterwards
+	struct Cooked_image_data
+	{
+		Cooked_image                      image;
+		std::vector<std::vector<uint8_t>> levels;
+	};
+
+	// > Encodes `gltf_image` by the slot sampling it:
+	// color & emissive to BC1 (BC3 if not opaque), normal (x, y) to BC5, metal-roughness (g, b) to BC5, occlusion (r) to BC4
+	static Cooked_image_data cook_image(const tinygltf::Image& gltf_image, Texture_usage usage, const Cook_config& config)
+	{
+		Cooked_image_data output;
+		auto&             image = output.image;
+
+		image.name = gltf_image.name;
+
+		// Two-channel metal-roughness images hold (roughness, metalness), mapped to (-, g, b)
+		const vk::ComponentMapping metal_roughness_components
+			= {vk::ComponentSwizzle::eOne, vk::ComponentSwizzle::eR, vk::ComponentSwizzle::eG, vk::ComponentSwizzle::eOne};
+
+		if (is_cookable_ktx2(gltf_image, config))
+		{
+			const auto  ktx2   = *codec::read_ktx2(gltf_image.image);
+			const auto& format = codec::block_formats.at((vk::Format)ktx2.header.vk_format);
+
+			image.format = format.upload_format;
+			image.width = ktx2.header.pixel_width, image.height = ktx2.header.pixel_height;
+			image.component_count = format.component_count;
+
+			if (image.component_count == 2 && usage == Texture_usage::Metal_roughness) image.components = metal_roughness_components;
+
+			for (const auto level : codec::ktx2_levels(ktx2, gltf_image.image)) output.levels.emplace_back(level.begin(), level.end());
+
+			return output;
+		}
+
+		// Full mip chain down to 1x1
+		std::vector<codec::Rgba8_image> mipmaps{codec::to_rgba8(codec::decode_image(gltf_image))};
+		while (mipmaps.back().width > 1 || mipmaps.back().height > 1) mipmaps.push_back(codec::downsample(mipmaps.back()));
+
+		image.width = mipmaps.front().width, image.height = mipmaps.front().height;
+
+		auto encode = [&](vk::Format format, const std::function<std::vector<uint8_t>(const codec::Rgba8_image&)>& encode_level)
+		{
+			image.format          = format;
+			image.component_count = codec::block_formats.at(format).component_count;
+
+			for (const auto& mipmap : mipmaps) output.levels.push_back(encode_level(mipmap));
+		};
+
+		if (!config.compress_textures)
+		{
+			encode(
+				vk::Format::eR8G8B8A8Unorm,
+				[](const codec::Rgba8_image& mipmap)
+				{
+					const auto* const bytes = (const uint8_t*)mipmap.pixels.data();
+					return std::vector<uint8_t>(bytes, bytes + mipmap.pixels.size() * sizeof(glm::u8vec4));
+				}
+			);
+
+			return output;
+		}
+
+		switch (usage)
+		{
+		case Texture_usage::Normal:
+			encode(
+				vk::Format::eBc5UnormBlock,
+				[](const codec::Rgba8_image& mipmap)
+				{
+					return codec::encode_bc5(mipmap, 0, 1);
+				}
+			);
+			break;
+
+		case Texture_usage::Metal_roughness:
+			encode(
+				vk::Format::eBc5UnormBlock,
+				[](const codec::Rgba8_image& mipmap)
+				{
+					return codec::encode_bc5(mipmap, 1, 2);
+				}
+			);
+			image.components = metal_roughness_components;
+			break;
+
+		case Texture_usage::Occlusion:
+			encode(
+				vk::Format::eBc4UnormBlock,
+				[](const codec::Rgba8_image& mipmap)
+				{
+					return codec::encode_bc4(mipmap, 0);
+				}
+			);
+			break;
+
+		default:
+		{
+			const bool opaque = std::ranges::all_of(
+				mipmaps.front().pixels,
+				[](const glm::u8vec4& pixel)
+				{
+					return pixel.a == 255;
+				}
+			);
+
+			if (opaque)
+				encode(vk::Format::eBc1RgbUnormBlock, codec::encode_bc1);
+			else
+				encode(vk::Format::eBc3UnormBlock, codec::encode_bc3);
+		}
+		}
+
+		return output;
+	}
+
+	void Model::cook(const std::string& input, const std::string& output, const Cook_config& config)
+	{
+		tinygltf::TinyGLTF parser;
+		tinygltf::Model    gltf_model;
+		parser.SetImageLoader(codec::deferred_image_loader, nullptr);
+
+		std::string warn, err;
+
+		const Mapped_file file(input);
+		const auto        base_dir  = std::filesystem::path(input).parent_path().string();
+		const auto        is_binary = std::filesystem::path(input).extension() == ".glb";
+
+		const auto result
+			= is_binary ? parser.LoadBinaryFromMemory(&gltf_model, &err, &warn, file.data().data(), file.size(), base_dir)
+						: parser.LoadASCIIFromString(&gltf_model, &err, &warn, (const char*)file.data().data(), file.size(), base_dir);
+
+		if (!result) throw error::Detailed_error(std::format("Load GLTF \"{}\" Failed: {}", input, err));
+
+		utility::Thread_pool thread_pool;
+		Cooked_writer        writer;
+		Cooked_scene         scene;
+
+		/* Images */
+
+		const auto ktx2_filter = [&config](const tinygltf::Image& image)
+		{
+			return is_cookable_ktx2(image, config);
+		};
+
+		const auto usages = codec::image_usages(gltf_model, ktx2_filter);
+
+		// Encode in parallel
+		std::vector<Cooked_image_data> image_data(gltf_model.images.size());
+		thread_pool.parallel_for(
+			image_data.size(),
+			[&](size_t idx)
+			{
+				if (usages[idx] != Texture_usage::Unused) image_data[idx] = cook_image(gltf_model.images[idx], usages[idx], config);
+			}
+		);
+
+		// Unused images are dropped, `image_remap` maps glTF images to cooked ones
+		std::vector<uint32_t> image_remap(image_data.size());
+
+		for (auto [idx, data] : Walk(image_data))
+		{
+			if (usages[idx] == Texture_usage::Unused) continue;
+
+			for (const auto& level : data.levels) data.image.levels.push_back(writer.blob(level));
+
+			image_remap[idx] = scene.images.size();
+			scene.images.push_back(std::move(data.image));
+			data = {};  // release memory
+		}
+
+		/* Texture Views */
+
+		for (const auto& texture : gltf_model.textures)
+		{
+			Cooked_texture_view view{image_remap[codec::texture_source(gltf_model, texture, ktx2_filter)], std::nullopt};
+
+			if (texture.sampler >= 0)
+			{
+				const auto& sampler = gltf_model.samplers[texture.sampler];
+				view.sampler        = Cooked_sampler{sampler.minFilter, sampler.magFilter, sampler.wrapS, sampler.wrapT};
+			}
+
+			scene.texture_views.push_back(view);
+		}
+
+		/* Materials */
+
+		// Missing textures sample single-color images, stored like the other images
+		scene.materials = parse_materials(
+			gltf_model,
+			[&scene, &writer](glm::u8vec4 color) -> uint32_t
+			{
+				scene.images.push_back({
+					.name            = std::format("Generated Image ({}, {}, {}, {})", color.r, color.g, color.b, color.a),
+					.format          = vk::Format::eR8G8B8A8Unorm,
+					.width           = 1,
+					.height          = 1,
+					.component_count = 4,
+					.components      = {},
+					.levels          = {writer.blob(std::span((const uint8_t*)&color, sizeof(color)))}
+				});
+				scene.texture_views.push_back({(uint32_t)scene.images.size() - 1, std::nullopt});
+
+				return scene.texture_views.size() - 1;
+			}
+		);
+
+		/* Meshes */
+
+		Mesh_data_context mesh_context;
+		scene.meshes = parse_meshes(gltf_model, thread_pool, mesh_context, nullptr);
+
+		const auto blocks       = mesh_context.blocks();
+		auto       write_blocks = [&writer](const std::vector<std::span<const uint8_t>>& src, std::vector<Blob_ref>& dst)
+		{
+			for (const auto& block : src) dst.push_back(writer.blob(block));
+		};
+
+		write_blocks(blocks.vec3, scene.buffers.vec3);
+		write_blocks(blocks.vec2, scene.buffers.vec2);
+		write_blocks(blocks.joint, scene.buffers.joint);
+		write_blocks(blocks.weight, scene.buffers.weight);
+		write_blocks(blocks.index16, scene.buffers.index16);
+		write_blocks(blocks.index32, scene.buffers.index32);
+
+		/* Scenes & Nodes */
+
+		Model model;
+		model.load_all_cameras(gltf_model);
+		model.load_all_scenes(gltf_model);
+		model.load_all_nodes(gltf_model);
+		model.load_all_animations(gltf_model);
+		model.load_all_skins(gltf_model);
+
+		scene.scenes     = std::move(model.scenes);
+		scene.nodes      = std::move(model.nodes);
+		scene.skins      = std::move(model.skins);
+		scene.cameras    = std::move(model.cameras);
+		scene.animations = std::move(model.animations);
+
+		writer(scene);
+		io::write(output, writer.finish());
+	}
+
+#pragma endregion
+
+#pragma region "Load"
+
+	static std::span<const uint8_t> get_blob(std::span<const uint8_t> blobs, const Blob_ref& ref)
+	{
+		if (ref.offset > blobs.size() || ref.size > blobs.size() - ref.offset)
+			throw Cooked_scene_error("Blob lies outside of the blob section");
+
+		if (ref.offset % blob_alignment != 0) throw Cooked_scene_error("Blob is not aligned");
+
+		return blobs.subspan(ref.offset, ref.size);
+	}
+
+	// Whether `count` elements of `element_size` bytes from element `offset` lie inside block `block` of `blocks`
+	static bool block_range_valid(
+		const std::vector<Blob_ref>& blocks,
+		uint32_t                     block,
+		uint32_t                     offset,
+		uint32_t                     count,
+		size_t                       element_size
+	)
+	{
+		return block < blocks.size() && ((uint64_t)offset + count) * element_size <= blocks[block].size;
+	}
+
+	// Whether all indices in `count` elements from element `offset` of `block` refer to one of `vertex_count` vertices
+	template <typename T>
+	static bool indices_valid(std::span<const uint8_t> block, uint32_t offset, uint32_t count, uint32_t vertex_count)
+	{
+		// Blobs are aligned to 16 bytes in the mapped file, see `blob_alignment`
+		const std::span indices((const T*)block.data() + offset, count);
+
+		return std::ranges::all_of(
+			indices,
+			[vertex_count](T idx)
+			{
+				return idx < vertex_count;
+			}
+		);
+	}
+
+	// > Checks every index in `scene` against the array it refers to, and every vertex & index range against its block,
+	// as none of them are checked again when drawing or animating. Images are checked when uploading them
+	static void validate_scene(const Cooked_scene& scene, std::span<const uint8_t> blobs)
+	{
+		const auto& buffers = scene.buffers;
+
+		for (const auto* blocks : {&buffers.vec3, &buffers.vec2, &buffers.joint, &buffers.weight, &buffers.index16, &buffers.index32})
+			for (const auto& ref : *blocks) get_blob(blobs, ref);
+
+		/* Texture Views & Materials */
+
+		for (const auto& view : scene.texture_views)
+			if (view.image >= scene.images.size()) throw Cooked_scene_error("Texture view refers to a missing image");
+
+		for (const auto& material : scene.materials)
+		{
+			const auto indices = std::to_array(
+				{material.albedo_idx, material.metal_roughness_idx, material.normal_idx, material.emissive_idx, material.occlusion_idx}
+			);
+
+			for (const auto idx : indices)
+				if (idx >= scene.texture_views.size())
+					throw Cooked_scene_error(std::format("Material \"{}\" refers to a missing texture view", material.name));
+		}
+
+		/* Meshes */
+
+		for (const auto& mesh : scene.meshes)
+			for (const auto& primitive : mesh.primitives)
+			{
+				auto fail = [&mesh](std::string_view reason)
+				{
+					throw Cooked_scene_error(std::format("Primitive of mesh \"{}\" {}", mesh.name, reason));
+				};
+
+				if (primitive.material_idx.has_value() && *primitive.material_idx >= scene.materials.size())
+					fail("refers to a missing material");
+
+				// Buffer fields of primitives without geometry are never used
+				if (!primitive.enabled)
+				{
+					if (primitive.skin.has_value()) fail("is disabled but skinned");
+					continue;
+				}
+
+				const auto vertex_count = primitive.vertex_count;
+
+				auto vertices_valid = [vertex_count](const std::vector<Blob_ref>& blocks, uint32_t block, uint32_t offset, size_t size)
+				{
+					return block_range_valid(blocks, block, offset, vertex_count, size);
+				};
+
+				if (!vertices_valid(buffers.vec3, primitive.position_buffer, primitive.position_offset, sizeof(glm::vec3))
+					|| !vertices_valid(buffers.vec3, primitive.normal_buffer, primitive.normal_offset, sizeof(glm::vec3))
+					|| !vertices_valid(buffers.vec3, primitive.tangent_buffer, primitive.tangent_offset, sizeof(glm::vec3))
+					|| !vertices_valid(buffers.vec2, primitive.uv_buffer, primitive.uv_offset, sizeof(glm::vec2)))
+					fail("has vertices outside of their buffers");
+
+				if (primitive.skin.has_value())
+				{
+					const auto& skin = *primitive.skin;
+
+					if (!vertices_valid(buffers.joint, skin.joint_buffer, skin.joint_offset, sizeof(glm::u16vec4))
+						|| !vertices_valid(buffers.weight, skin.weight_buffer, skin.weight_offset, sizeof(glm::vec4)))
+						fail("has skin data outside of its buffers");
+				}
+
+				const bool index16     = primitive.index_type == vk::IndexType::eUint16;
+				const auto& index_list = index16 ? buffers.index16 : buffers.index32;
+				const auto  index_size = index16 ? sizeof(uint16_t) : sizeof(uint32_t);
+
+				if (!block_range_valid(index_list, primitive.index_buffer, primitive.index_offset, primitive.index_count, index_size))
+					fail("has indices outside of their buffer");
+
+				const auto index_block = get_blob(blobs, index_list[primitive.index_buffer]);
+				const auto index_valid
+					= index16 ? indices_valid<uint16_t>(index_block, primitive.index_offset, primitive.index_count, vertex_count)
+							  : indices_valid<uint32_t>(index_block, primitive.index_offset, primitive.index_count, vertex_count);
+
+				if (!index_valid) fail("has indices exceeding its vertex count");
+			}
+
+		/* Nodes & Scenes */
+
+		const auto node_count = scene.nodes.size();
+
+		// Nodes form trees below the scene roots, so traversals always terminate
+		std::vector<bool> has_parent(node_count, false);
+
+		for (const auto& node : scene.nodes)
+		{
+			if (node.mesh_idx.has_value() && *node.mesh_idx >= scene.meshes.size())
+				throw Cooked_scene_error(std::format("Node \"{}\" refers to a missing mesh", node.name));
+
+			if (node.skin_idx.has_value() && *node.skin_idx >= scene.skins.size())
+				throw Cooked_scene_error(std::format("Node \"{}\" refers to a missing skin", node.name));
+
+			for (const auto child : node.children)
+			{
+				if (child >= node_count)
+					throw Cooked_scene_error(std::format("Node \"{}\" refers to a missing child", node.name));
+
+				if (has_parent[child]) throw Cooked_scene_error(std::format("Node {} has more than one parent", child));
+				has_parent[child] = true;
+			}
+		}
+
+		for (const auto& cooked_scene : scene.scenes)
+			for (const auto root : cooked_scene.nodes)
+				if (root >= node_count || has_parent[root])
+					throw Cooked_scene_error(std::format("Scene \"{}\" has an invalid root node {}", cooked_scene.name, root));
+
+		/* Skins & Cameras */
+
+		for (const auto& skin : scene.skins)
+		{
+			if (skin.inverse_bind_matrices.size() != skin.joints.size())
+				throw Cooked_scene_error("Skin has a different count of joints and inverse bind matrices");
+
+			for (const auto joint : skin.joints)
+				if (joint >= node_count) throw Cooked_scene_error(std::format("Skin refers to a missing joint node {}", joint));
+		}
+
+		for (const auto& camera : scene.cameras)
+			if (camera.node_idx.has_value() && *camera.node_idx >= node_count)
+				throw Cooked_scene_error(std::format("Camera \"{}\" refers to a missing node", camera.name));
+
+		/* Animations */
+
+		for (const auto& animation : scene.animations)
+		{
+			auto fail = [&animation](std::string_view reason)
+			{
+				throw Cooked_scene_error(std::format("Animation \"{}\" {}", animation.name, reason));
+			};
+
+			for (const auto& sampler_variant : animation.samplers)
+				std::visit(
+					[&fail](const auto& sampler)
+					{
+						const auto value_count = sampler.mode == Interpolation_mode::Cubic_spline ? sampler.timestamps.size() * 3
+																								   : sampler.timestamps.size();
+
+						if (sampler.timestamps.empty() || sampler.values.size() != value_count)
+							fail("has a sampler with mismatching keyframes");
+
+						if (!std::ranges::is_sorted(sampler.timestamps)) fail("has a sampler with unsorted timestamps");
+					},
+					sampler_variant
+				);
+
+			for (const auto& channel : animation.channels)
+			{
+				if (!channel.node.has_value() || *channel.node >= node_count) fail("has a channel targeting a missing node");
+				if (!channel.sampler.has_value() || *channel.sampler >= animation.samplers.size())
+					fail("has a channel using a missing sampler");
+
+				// Rotations are sampled as quaternions, other targets as vectors
+				const auto expected_sampler = channel.target == Animation_target::Rotation ? 1u : 0u;
+				if (animation.samplers[*channel.sampler].index() != expected_sampler)
+					fail("has a channel whose sampler doesn't match its target");
+			}
+		}
+	}
+
+	void Model::load_cooked(Loader_context& loader_context, const std::string& path)
+	{
+		loader_context.fence = Fence(loader_context.device);
+
+		const Mapped_file file(path);
+		const auto        data = file.data();
+
+		/* Header */
+
+		Cooked_header header;
+		if (data.size() < sizeof(header)) throw Cooked_scene_error("File is shorter than the header");
+		std::memcpy(&header, data.data(), sizeof(header));
+
+		if (header.magic != cooked_magic) throw Cooked_scene_error(std::format("\"{}\" is not a cooked scene", path));
+		if (header.version != cooked_version)
+			throw Cooked_scene_error(
+				std::format("Version {} is not supported (expected {}), cook the scene again", header.version, cooked_version)
+			);
+
+		auto section = [data](uint64_t offset, uint64_t size)
+		{
+			if (offset > data.size() || size > data.size() - offset) throw Cooked_scene_error("Section lies outside of the file");
+			return data.subspan(offset, size);
+		};
+
+		if (header.blob_offset % blob_alignment != 0) throw Cooked_scene_error("Blob section is not aligned");
+
+		const auto blobs = section(header.blob_offset, header.blob_size);
+
+		auto blob = [blobs](const Blob_ref& ref)
+		{
+			return get_blob(blobs, ref);
+		};
+
+		/* Structure */
+
+		Cooked_scene  scene;
+		Cooked_reader reader(section(header.structure_offset, header.structure_size));
+
+		reader(scene);
+		if (!reader.finished()) throw Cooked_scene_error("Trailing data after the structure");
+
+		validate_scene(scene, blobs);
+
+		create_staging_ring(loader_context);
+
+		/* Images */
+
+		if (loader_context.load_stage) *loader_context.load_stage = Load_stage::Load_material;
+
+		for (const auto [idx, cooked] : Walk(scene.images))
+		{
+			const auto format_itr = codec::block_formats.find(cooked.format);
+			if (format_itr == codec::block_formats.end() || format_itr->second.upload_format != cooked.format)
+				throw Cooked_scene_error(
+					std::format("Image \"{}\" has unsupported VkFormat {}", cooked.name, (uint32_t)cooked.format)
+				);
+
+			const auto& format = format_itr->second;
+
+			if (const auto reason = codec::format_unsupported_reason(format, loader_context); !reason.empty())
+				throw error::Detailed_error(std::format(
+					"Can't load image \"{}\" of cooked scene: {}{}",
+					cooked.name,
+					reason,
+					format.block_extent != 1 ? ", cook the scene without texture compression" : ""
+				));
+
+			if (cooked.width == 0 || cooked.height == 0 || cooked.levels.empty()
+				|| cooked.levels.size() > (size_t)std::bit_width(std::max(cooked.width, cooked.height)))
+				throw Cooked_scene_error(std::format("Image \"{}\" has an invalid extent or mip level count", cooked.name));
+
+			std::vector<std::span<const uint8_t>> levels;
+			for (const auto [level, ref] : Walk(cooked.levels))
+			{
+				const auto level_data = blob(ref);
+
+				if (level_data.size() < format.level_size(std::max(cooked.width >> level, 1u), std::max(cooked.height >> level, 1u)))
+					throw Cooked_scene_error(
+						std::format("Mip level {} of image \"{}\" is smaller than its extent", level, cooked.name)
+					);
+
+				levels.push_back(level_data);
+			}
+
+			Texture texture;
+			texture.name  = cooked.name;
+			texture.width = cooked.width, texture.height = cooked.height;
+			texture.component_count = cooked.component_count;
+			texture.format          = cooked.format;
+			texture.components      = cooked.components;
+
+			texture.upload(levels, loader_context);
+			textures.push_back(std::move(texture));
+
+			if (loader_context.sub_progress) *loader_context.sub_progress = (float)(idx + 1) / scene.images.size();
+		}
+
+		/* Texture Views */
+
+		for (const auto& view : scene.texture_views)
+		{
+			const auto& texture = textures[view.image];
+
+			if (!view.sampler.has_value())
+			{
+				texture_views.emplace_back(loader_context, texture, texture.components);
+				continue;
+			}
+
+			tinygltf::Sampler sampler;
+			sampler.minFilter = view.sampler->min_filter;
+			sampler.magFilter = view.sampler->mag_filter;
+			sampler.wrapS     = view.sampler->wrap_s;
+			sampler.wrapT     = view.sampler->wrap_t;
+
+			texture_views.emplace_back(loader_context, texture, sampler, texture.components);
+		}
+
+		materials = std::move(scene.materials);
+
+		/* Meshes */
+
+		if (loader_context.load_stage) *loader_context.load_stage = Load_stage::Load_mesh;
+
+		auto blob_list = [&blob](const std::vector<Blob_ref>& refs)
+		{
+			std::vector<std::span<const uint8_t>> output;
+			for (const auto& ref : refs) output.push_back(blob(ref));
+
+			return output;
+		};
+
+		generate_buffers(
+			loader_context,
+			{blob_list(scene.buffers.vec3),
+			 blob_list(scene.buffers.vec2),
+			 blob_list(scene.buffers.joint),
+			 blob_list(scene.buffers.weight),
+			 blob_list(scene.buffers.index16),
+			 blob_list(scene.buffers.index32)}
+		);
+
+		meshes = std::move(scene.meshes);
+
+		loader_context.staging_ring.flush();
+
+		/* Scenes & Nodes */
+
+		cameras    = std::move(scene.cameras);
+		scenes     = std::move(scene.scenes);
+		nodes      = std::move(scene.nodes);
+		animations = std::move(scene.animations);
+		skins      = std::move(scene.skins);
+
+		loader_context.staging_ring.finish();
+		if (loader_context.load_stage) *loader_context.load_stage = Load_stage::Finished;
+	}
+
+#pragma endregion
+}
@@ -1,24 +1,62 @@
 #include "data-accessor.hpp"
+#include "texture-codec.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <numeric>
+#include <unordered_map>
 
 namespace VKLIB_HPP_NAMESPACE::io::gltf
 {
-	static const void* get_buffer_data(const tinygltf::Model& model, uint32_t accessor_idx)
+	// Finds a block in `list` that can hold `count` more elements, creates a new block if necessary
+	template <typename T, size_t Max_size>
+	static size_t find_buffer(std::vector<std::vector<T>>& list, size_t count)
 	{
-		const auto& accessor    = model.accessors[accessor_idx];
-		const auto& buffer_view = model.bufferViews[accessor.bufferView];
-		const auto& buffer      = model.buffers[buffer_view.buffer];
-		const auto* buffer_data = buffer.data.data() + buffer_view.byteOffset + accessor.byteOffset;
+		if (list.empty())
+		{
+			list.emplace_back();
+			list.back().reserve(Max_size / sizeof(T));
+		}
+
+		// Data exceeds single block size
+		if (count * sizeof(T) > Max_size)
+		{
+			// Last block not empty, create a new one
+			if (list.back().size() != 0)
+			{
+				list.emplace_back();
+			}
+
+			list.back().reserve(count);
 
-		return buffer_data;
+			return list.size() - 1;
+		}
+
+		const auto find = std::find_if(
+			list.begin(),
+			list.end(),
+			[=](const auto& list) -> bool
+			{
+				return (list.size() + count) * sizeof(T) <= Max_size;
+			}
+		);
+
+		if (find != list.end()) return find - list.begin();
+
+		if ((list.back().size() + count) * sizeof(T) > Max_size)
+		{
+			list.emplace_back();
+			list.back().reserve(Max_size / sizeof(T));
+		}
+
+		return list.size() - 1;
 	}
 
-	Primitive Model::parse_primitive(
-		const tinygltf::Model&     model,
-		const tinygltf::Primitive& primitive,
-		Mesh_data_context&         mesh_context
-	)
+	Model::Primitive_data Model::parse_primitive(const tinygltf::Model& model, const tinygltf::Primitive& primitive)
 	{
-		Primitive output_primitive;
+		Primitive_data output;
+
+		auto& output_primitive        = output.primitive;
 		output_primitive.material_idx = to_optional(primitive.material);
 
 		// Vertex Attributes
@@ -31,7 +69,7 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 		if (auto end = primitive.attributes.end(); find_position == end)
 		{
 			output_primitive.enabled = false;
-			return output_primitive;
+			return output;
 		}
 
 		//[ERR] GLTF Spec: A vertex must contains or NOT contains `WEIGHTS_0` and `JOINTS_0` simutaneously
@@ -43,536 +81,377 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 				"3.7.3.3. Skinned Mesh Attributes"
 			);
 
+		if (primitive.mode != TINYGLTF_MODE_TRIANGLES && primitive.mode != TINYGLTF_MODE_TRIANGLE_STRIP)
+			throw Gltf_parse_error(
+				"Unsupported TinyGLTF Vertex Mode",
+				"The parser only supports Triangle Strip and Triange List by now."
+			);
+
 		const bool has_indices = primitive.indices >= 0, has_texcoord = find_uv != primitive.attributes.end(),
 				   has_normal = find_normal != primitive.attributes.end(), has_tangent = find_tangent != primitive.attributes.end();
 
 		const bool has_skin = find_weight != primitive.attributes.end() && find_joints != primitive.attributes.end();
 
-		// Get indices
-		std::vector<uint32_t> indices;
-		if (has_indices) indices = data_parser::acquire_accessor<uint32_t>(model, primitive.indices);
-
-		uint32_t vertex_count = has_indices ? indices.size() : model.accessors[find_position->second].count;
+		const uint32_t accessor_vertex_count = model.accessors[find_position->second].count;
 
-		/* Data Parsing Function */
-
-		auto parse_data_no_index = [&]<typename T>(std::vector<T>& list, uint32_t accessor_idx, const T* optional_data = nullptr)
+		// Get indices, converted to triangle list
+		std::vector<uint32_t> indices = [&]
 		{
-			const auto* dat         = optional_data == nullptr ? (const T*)get_buffer_data(model, accessor_idx) : optional_data;
-			const auto& accessor    = model.accessors[accessor_idx];
-			const auto& buffer_view = model.bufferViews[accessor.bufferView];
-
-			if (optional_data || buffer_view.byteStride == 0)
-			{
-				if (primitive.mode == TINYGLTF_MODE_TRIANGLES)
-				{
-					list.resize(list.size() + vertex_count);
-					std::copy(dat, dat + vertex_count, list.begin() + list.size() - vertex_count);
-
-					return;
-				}
-				else if (primitive.mode == TINYGLTF_MODE_TRIANGLE_STRIP)
-				{
-					list.reserve(list.size() + vertex_count);
+			std::vector<uint32_t> source;
 
-					for (auto item : Iota(vertex_count - 2))
-					{
-						list.emplace_back(dat[item]);
-						list.emplace_back(dat[item + 1]);
-						list.emplace_back(dat[item + 2]);
-					}
-
-					return;
-				}
-			}
+			if (has_indices)
+				source = data_parser::acquire_accessor<uint32_t>(model, primitive.indices);
 			else
 			{
-				list.reserve(list.size() + vertex_count);
+				source.resize(accessor_vertex_count);
+				std::iota(source.begin(), source.end(), 0u);
+			}
 
-				if (primitive.mode == TINYGLTF_MODE_TRIANGLES)
-				{
-					for (auto idx : Iota(vertex_count))
-					{
-						const auto* src_ptr = (const uint8_t*)dat + buffer_view.byteStride * idx;
-						list.emplace_back(*((const T*)src_ptr));
-					}
+			if (primitive.mode == TINYGLTF_MODE_TRIANGLES)
+			{
+				source.resize(source.size() / 3 * 3);
+				return source;
+			}
 
-					return;
-				}
-				else if (primitive.mode == TINYGLTF_MODE_TRIANGLE_STRIP)
-				{
-					for (auto idx : Iota(vertex_count - 2))
-					{
-						const auto* src_ptr = (const uint8_t*)dat + buffer_view.byteStride * idx;
-						list.emplace_back(*((const T*)src_ptr));
+			// Triangle Strip, keep the winding order of odd triangles (see glTF Spec 3.7.2.1)
+			std::vector<uint32_t> list;
+			if (source.size() < 3) return list;
 
-						src_ptr += buffer_view.byteStride;
-						list.emplace_back(*((const T*)src_ptr));
+			list.reserve((source.size() - 2) * 3);
+			for (auto i : Iota(source.size() - 2))
+			{
+				list.push_back(source[i]);
+				list.push_back(source[i + 1 + i % 2]);
+				list.push_back(source[i + 2 - i % 2]);
+			}
 
-						src_ptr += buffer_view.byteStride;
-						list.emplace_back(*((const T*)src_ptr));
-					}
+			return list;
+		}();
 
-					return;
-				}
+		//[ERR] GLTF Spec: Indices must not exceed the vertex count
+		const auto index_out_of_range = std::any_of(
+			indices.begin(),
+			indices.end(),
+			[=](uint32_t idx)
+			{
+				return idx >= accessor_vertex_count;
 			}
+		);
 
-			throw Gltf_parse_error(
-				"Unsupported TinyGLTF Vertex Mode",
-				"The parser only supports Triangle Strip and Triange List by now."
+		if (index_out_of_range)
+			throw Gltf_spec_violation(
+				"Index Out of Range",
+				"Index references a vertex outside of the attribute accessors",
+				"3.7.2.1. Overview"
 			);
-		};
 
-		auto parse_data_with_index = [&]<typename T>(std::vector<T>& list, uint32_t accessor_idx, const T* optional_data = nullptr)
+		// No triangle to draw
+		if (indices.empty())
 		{
-			const auto* dat         = optional_data == nullptr ? (const T*)get_buffer_data(model, accessor_idx) : optional_data;
-			const auto& accessor    = model.accessors[accessor_idx];
-			const auto& buffer_view = model.bufferViews[accessor.bufferView];
-			list.reserve(list.size() + vertex_count);
+			output_primitive.enabled = false;
+			return output;
+		}
 
-			if (optional_data || buffer_view.byteStride == 0)
-			{
-				if (primitive.mode == TINYGLTF_MODE_TRIANGLES)
-				{
-					for (auto i : Iota(vertex_count))
-					{
-						list.emplace_back(dat[indices[i]]);
-					}
+		// Flat normals must be generated when normals are absent, which can't be done with shared vertices.
+		// In that case the primitive is unwelded: each index gets its own vertex, referenced by `remap`.
+		// Vertices ending up identical, e.g. of coplanar triangles, are merged again by `weld_vertices`.
+		const bool            unweld = !has_normal;
+		std::vector<uint32_t> remap;
 
-					return;
-				}
-				else if (primitive.mode == TINYGLTF_MODE_TRIANGLE_STRIP)
-				{
-					for (auto item : Iota(vertex_count - 2))
-					{
-						list.emplace_back(dat[indices[item]]);
-						list.emplace_back(dat[indices[item + 1]]);
-						list.emplace_back(dat[indices[item + 2]]);
-					}
-
-					return;
-				}
-			}
-			else
-			{
-				if (primitive.mode == TINYGLTF_MODE_TRIANGLES)
-				{
-					for (auto idx : Iota(vertex_count))
-					{
-						const auto* src_ptr = (const uint8_t*)dat + buffer_view.byteStride * indices[idx];
-						list.emplace_back(*((const T*)src_ptr));
-					}
+		if (unweld)
+		{
+			remap   = std::move(indices);
+			indices = std::vector<uint32_t>(remap.size());
+			std::iota(indices.begin(), indices.end(), 0u);
+		}
 
-					return;
-				}
-				else if (primitive.mode == TINYGLTF_MODE_TRIANGLE_STRIP)
-				{
-					for (auto idx : Iota(vertex_count - 2))
-					{
-						const auto* src_ptr = (const uint8_t*)dat + buffer_view.byteStride * indices[idx];
-						list.emplace_back(*((const T*)src_ptr));
+		const uint32_t vertex_count = unweld ? remap.size() : accessor_vertex_count;
 
-						src_ptr = (const uint8_t*)dat + buffer_view.byteStride * indices[idx + 1];
-						list.emplace_back(*((const T*)src_ptr));
+		/* Data Parsing Function */
 
-						src_ptr = (const uint8_t*)dat + buffer_view.byteStride * indices[idx + 2];
-						list.emplace_back(*((const T*)src_ptr));
-					}
+		// Expand accessor data to the output vertex stream
+		auto expand = [&]<typename T>(std::vector<T> data) -> std::vector<T>
+		{
+			if (!unweld) return data;
 
-					return;
-				}
-			}
+			std::vector<T> output;
+			output.reserve(remap.size());
+			for (const auto idx : remap) output.push_back(data[idx]);
 
-			throw Gltf_parse_error(
-				"Unsupported TinyGLTF Vertex Mode",
-				"The parser only supports Triangle Strip and Triange List by now."
-			);
+			return output;
 		};
 
-		auto parse_tangent_data_no_index = [&](std::vector<glm::vec3>& list, uint32_t accessor_idx)
+		// Position Data
+		output.position      = expand(data_parser::acquire_accessor<glm::vec3>(model, find_position->second));
+		const auto& position = output.position;
 		{
-			using T = glm::vec4;
-
-			const auto* dat         = (const T*)get_buffer_data(model, accessor_idx);
-			const auto& accessor    = model.accessors[accessor_idx];
-			const auto& buffer_view = model.bufferViews[accessor.bufferView];
-			list.reserve(list.size() + vertex_count);
-
-			if (buffer_view.byteStride == 0)
-			{
-				if (primitive.mode == TINYGLTF_MODE_TRIANGLES)
-				{
-					for (auto i : Iota(vertex_count))
-					{
-						list.emplace_back(dat[i] * dat[i].w);
-					}
-
-					return;
-				}
-				else if (primitive.mode == TINYGLTF_MODE_TRIANGLE_STRIP)
-				{
-					for (auto item : Iota(vertex_count - 2))
-					{
-						list.emplace_back(dat[item] * dat[item].w);
-						list.emplace_back(dat[item + 1] * dat[item].w);
-						list.emplace_back(dat[item + 2] * dat[item].w);
-					}
-
-					return;
-				}
-			}
-			else
-			{
-				if (primitive.mode == TINYGLTF_MODE_TRIANGLES)
-				{
-					for (auto idx : Iota(vertex_count))
-					{
-						const auto* src_ptr = (const uint8_t*)dat + buffer_view.byteStride * idx;
-
-						const auto item = *((const T*)src_ptr);
-						list.emplace_back(item * item.w);
-					}
+			const auto& accessor = model.accessors[find_position->second];
 
-					return;
-				}
-				else if (primitive.mode == TINYGLTF_MODE_TRIANGLE_STRIP)
-				{
-					for (auto idx : Iota(vertex_count - 2))
-					{
-						const auto* src_ptr = (const uint8_t*)dat + buffer_view.byteStride * idx;
+			output_primitive.min = glm::make_vec3(accessor.minValues.data());
+			output_primitive.max = glm::make_vec3(accessor.maxValues.data());
+		}
 
-						auto item = *((const T*)src_ptr);
-						list.emplace_back(item * item.w);
+		// Normal Data
+		output.normal = [&]
+		{
+			// has normal, directly parse the data
+			if (has_normal) return expand(data_parser::acquire_accessor<glm::vec3>(model, find_normal->second));
 
-						src_ptr += buffer_view.byteStride;
-						item = *((const T*)src_ptr);
-						list.emplace_back(item * item.w);
+			// manual generate flat normal, every vertex belongs to exactly one triangle here
+			std::vector<glm::vec3> output(vertex_count);
 
-						src_ptr += buffer_view.byteStride;
-						item = *((const T*)src_ptr);
-						list.emplace_back(item * item.w);
-					}
+			for (auto idx = 0u; idx < indices.size(); idx += 3)
+			{
+				const auto [i0, i1, i2]       = std::tuple{indices[idx], indices[idx + 1], indices[idx + 2]};
+				const auto [pos0, pos1, pos2] = std::tuple{position[i0], position[i1], position[i2]};
+				const auto normal_vector      = glm::normalize(glm::cross(pos1 - pos0, pos2 - pos0));
 
-					return;
-				}
+				output[i0] = output[i1] = output[i2] = normal_vector;
 			}
 
-			throw Gltf_parse_error(
-				"Unsupported TinyGLTF Vertex Mode",
-				"The parser only supports Triangle Strip and Triange List by now."
-			);
-		};
+			return output;
+		}();
 
-		auto parse_tangent_data_with_index = [&](std::vector<glm::vec3>& list, uint32_t accessor_idx)
-		{
-			using T = glm::vec4;
+		const auto& normal = output.normal;
 
-			const auto* dat         = (const T*)get_buffer_data(model, accessor_idx);
-			const auto& accessor    = model.accessors[accessor_idx];
-			const auto& buffer_view = model.bufferViews[accessor.bufferView];
-			list.reserve(list.size() + vertex_count);
+		// UV Data
+		output.uv = [&]
+		{
+			// has texcoord, directly parse the data
+			if (has_texcoord) return expand(data_parser::acquire_normalized_accessor<glm::vec2>(model, find_uv->second));
 
-			if (buffer_view.byteStride == 0)
-			{
-				if (primitive.mode == TINYGLTF_MODE_TRIANGLES)
-				{
-					for (auto i : Iota(vertex_count))
-					{
-						list.emplace_back(dat[indices[i]] * dat[indices[i]].w);
-					}
+			// manual generate data
+			std::vector<glm::vec2> output(vertex_count, glm::vec2(0.0));
 
-					return;
-				}
-				else if (primitive.mode == TINYGLTF_MODE_TRIANGLE_STRIP)
+			if (unweld)
+				for (auto idx = 0u; idx < indices.size(); idx += 3)
 				{
-					for (auto item : Iota(vertex_count - 2))
-					{
-						list.emplace_back(dat[indices[item]] * dat[indices[item]].w);
-						list.emplace_back(dat[indices[item + 1]] * dat[indices[item]].w);
-						list.emplace_back(dat[indices[item + 2]] * dat[indices[item]].w);
-					}
-
-					return;
+					output[indices[idx]]     = {0.0, 0.0};
+					output[indices[idx + 1]] = {0.0, 1.0};
+					output[indices[idx + 2]] = {1.0, 0.0};
 				}
-			}
-			else
-			{
-				if (primitive.mode == TINYGLTF_MODE_TRIANGLES)
-				{
-					for (auto idx : Iota(vertex_count))
-					{
-						const auto* src_ptr = (const uint8_t*)dat + buffer_view.byteStride * indices[idx];
 
-						const auto item = *((const T*)src_ptr);
-						list.emplace_back(item * item.w);
-					}
+			return output;
+		}();
 
-					return;
-				}
-				else if (primitive.mode == TINYGLTF_MODE_TRIANGLE_STRIP)
-				{
-					for (auto idx : Iota(vertex_count - 2))
-					{
-						const auto* src_ptr = (const uint8_t*)dat + buffer_view.byteStride * indices[idx];
+		const auto& uv = output.uv;
 
-						auto item = *((const T*)src_ptr);
-						list.emplace_back(item * item.w);
+		// Tangent Data
+		output.tangent = [&]
+		{
+			std::vector<glm::vec3> output;
 
-						src_ptr = (const uint8_t*)dat + buffer_view.byteStride * indices[idx + 1];
-						item    = *((const T*)src_ptr);
-						list.emplace_back(item * item.w);
+			// both tangent and normal present (see glTF Specification), directly parse the data
+			if (has_tangent && has_normal)
+			{
+				const auto tangent_data = data_parser::acquire_accessor<glm::vec4>(model, find_tangent->second);
 
-						src_ptr = (const uint8_t*)dat + buffer_view.byteStride * indices[idx + 2];
-						item    = *((const T*)src_ptr);
-						list.emplace_back(item * item.w);
-					}
+				output.reserve(tangent_data.size());
+				for (const auto& item : tangent_data) output.emplace_back(glm::vec3(item) * item.w);
 
-					return;
-				}
+				return expand(std::move(output));
 			}
 
-			throw Gltf_parse_error(
-				"Unsupported TinyGLTF Vertex Mode",
-				"The parser only supports Triangle Strip and Triange List by now."
-			);
-		};
-
-		auto parse_data = [&]<typename T>(std::vector<T>& list, uint32_t accessor_idx, const T* optional_data = nullptr)
-		{
-			if (has_indices)
-				parse_data_with_index(list, accessor_idx, optional_data);
-			else
-				parse_data_no_index(list, accessor_idx, optional_data);
-		};
+			// manual generate tangent, accumulated over the triangles sharing the vertex
+			output.resize(vertex_count, glm::vec3(0.0));
 
-		auto find_buffer = [&]<typename T>(std::vector<std::vector<T>>& list) -> size_t
-		{
-			if (list.empty())
+			for (auto idx = 0u; idx < indices.size(); idx += 3)
 			{
-				list.emplace_back();
-				list.back().reserve(Mesh_data_context::max_single_size / sizeof(T));
+				const auto [i0, i1, i2] = std::tuple{indices[idx], indices[idx + 1], indices[idx + 2]};
+
+				const auto [pos0, pos1, pos2] = std::tuple{position[i0], position[i1], position[i2]};
+				const auto [uv0, uv1, uv2]    = std::tuple{uv[i0], uv[i1], uv[i2]};
+
+				const auto [tangent0, tangent1, tangent2] = std::tuple{
+					algorithm::geometry::vertex_tangent(pos0, pos1, pos2, uv0, uv1, uv2),
+					algorithm::geometry::vertex_tangent(pos1, pos0, pos2, uv1, uv0, uv2),
+					algorithm::geometry::vertex_tangent(pos2, pos1, pos0, uv2, uv1, uv0)
+				};
+
+				// detect NaNs in tangent
+				const auto nan_judgement0 = glm::isnan(tangent0) || glm::isinf(tangent0);
+				const auto nan_judgement1 = glm::isnan(tangent1) || glm::isinf(tangent1);
+				const auto nan_judgement2 = glm::isnan(tangent2) || glm::isinf(tangent2);
+				const auto nan_judgement  = nan_judgement0 || nan_judgement1 || nan_judgement2;
+				const bool should_discard = nan_judgement.x || nan_judgement.y || nan_judgement.z;
+
+				if (should_discard) [[unlikely]]
+					continue;
+
+				output[i0] += tangent0;
+				output[i1] += tangent1;
+				output[i2] += tangent2;
 			}
 
-			// Data exceeds single block size
-			if (vertex_count * 3 * sizeof(T) > Mesh_data_context::max_single_size)
+			for (auto i : Iota(vertex_count))
 			{
-				// Last block not empty, create a new one
-				if (list.back().size() != 0)
-				{
-					list.emplace_back();
-				}
-
-				list.back().reserve(vertex_count * 3);
-
-				return list.size() - 1;
-			}
+				const auto length = glm::length(output[i]);
 
-			const auto find = std::find_if(
-				list.begin(),
-				list.end(),
-				[=](const auto& list) -> bool
+				if (length > 1e-6) [[likely]]
+					output[i] /= length;
+				else
 				{
-					return (list.size() + vertex_count * 3) * sizeof(T) <= Mesh_data_context::max_single_size;
+					// swizzle normal vector as the tangent vector
+					output[i] = glm::vec3{normal[i].y, normal[i].z, normal[i].x};
 				}
-			);
-
-			if (find != list.end()) return find - list.begin();
-
-			if ((list.back().size() + vertex_count * 3) * sizeof(T) > Mesh_data_context::max_single_size)
-			{
-				list.emplace_back();
-				list.back().reserve(Mesh_data_context::max_single_size / sizeof(T));
 			}
 
-			return list.size() - 1;
-		};
+			return output;
+		}();
 
-		// Position Data, returns (Buffer Index, Buffer Offset) to prevent reallocation of `std::vector`
-		const auto [position_buffer, position_offset] = [&]
+		// Skin Data
+		if (has_skin)
 		{
-			const auto buffer_idx = find_buffer(mesh_context.vec3_data);
-			auto&      position   = mesh_context.vec3_data[buffer_idx];
-			const auto size       = position.size();
+			output.joint  = expand(data_parser::acquire_accessor<glm::u16vec4>(model, find_joints->second));
+			output.weight = expand(data_parser::acquire_normalized_accessor<glm::vec4>(model, find_weight->second));
+		}
 
-			output_primitive.position_buffer = buffer_idx;
-			output_primitive.position_offset = size;
+		output.indices = std::move(indices);
+		weld_vertices(output);
 
-			const auto& accessor = model.accessors[find_position->second];
+		output_primitive.vertex_count = output.position.size();
+		output_primitive.index_count  = output.indices.size();
 
-			output_primitive.min = glm::make_vec3(accessor.minValues.data());
-			output_primitive.max = glm::make_vec3(accessor.maxValues.data());
-
-			parse_data(position, find_position->second);
+		return output;
+	}
 
-			return std::tuple{position, size};
-		}();
+	void Model::weld_vertices(Primitive_data& data)
+	{
+		const bool has_skin = !data.joint.empty();
 
-		// Normal Data
-		const auto [normal_buffer, normal_offset] = [&]
+		// Visits every attribute of `vertex`
+		const auto for_each_attribute = [&](uint32_t vertex, const auto& func)
 		{
-			const auto buffer_idx = find_buffer(mesh_context.vec3_data);
-			auto&      normal     = mesh_context.vec3_data[buffer_idx];
-			const auto size       = normal.size();
+			func(data.position[vertex]);
+			func(data.normal[vertex]);
+			func(data.uv[vertex]);
+			func(data.tangent[vertex]);
 
-			output_primitive.normal_buffer = buffer_idx;
-			output_primitive.normal_offset = normal.size();
-
-			// has normal, directly parse the data
-			if (has_normal)
+			if (has_skin)
 			{
-				parse_data(normal, find_normal->second);
+				func(data.joint[vertex]);
+				func(data.weight[vertex]);
 			}
-			else
-			{
-				// manual generate data
-				for (auto idx = 0u; idx < vertex_count; idx += 3)
+		};
+
+		// FNV-1a over the attribute bytes
+		const auto vertex_hash = [&](uint32_t vertex)
+		{
+			uint64_t hash = 0xCBF29CE484222325;
+
+			for_each_attribute(
+				vertex,
+				[&hash](const auto& value)
 				{
-					const auto [pos0, pos1, pos2] = std::tuple{
-						position_buffer[position_offset + idx],
-						position_buffer[position_offset + idx + 1],
-						position_buffer[position_offset + idx + 2]
-					};
-					const auto normal_vector = glm::normalize(glm::cross(pos1 - pos0, pos2 - pos0));
-
-					normal.push_back(normal_vector);
-					normal.push_back(normal_vector);
-					normal.push_back(normal_vector);
+					const auto* const bytes = (const uint8_t*)&value;
+					for (auto i : Iota(sizeof(value))) hash = (hash ^ bytes[i]) * 0x100000001B3;
 				}
-			}
+			);
 
-			return std::tuple{normal, size};
-		}();
+			return (size_t)hash;
+		};
 
-		// UV Data
-		const auto [uv_buffer, uv_offset] = [&]
+		// Bitwise, so that e.g. +0 and -0 normals stay apart
+		const auto vertex_equal = [&](uint32_t vertex0, uint32_t vertex1)
 		{
-			const auto buffer_idx = find_buffer(mesh_context.vec2_data);
-			auto&      uv         = mesh_context.vec2_data[buffer_idx];
-			const auto size       = uv.size();
+			return std::memcmp(&data.position[vertex0], &data.position[vertex1], sizeof(glm::vec3)) == 0
+				&& std::memcmp(&data.normal[vertex0], &data.normal[vertex1], sizeof(glm::vec3)) == 0
+				&& std::memcmp(&data.uv[vertex0], &data.uv[vertex1], sizeof(glm::vec2)) == 0
+				&& std::memcmp(&data.tangent[vertex0], &data.tangent[vertex1], sizeof(glm::vec3)) == 0
+				&& (!has_skin
+					|| (std::memcmp(&data.joint[vertex0], &data.joint[vertex1], sizeof(glm::u16vec4)) == 0
+						&& std::memcmp(&data.weight[vertex0], &data.weight[vertex1], sizeof(glm::vec4)) == 0));
+		};
 
-			output_primitive.uv_buffer = buffer_idx;
-			output_primitive.uv_offset = size;
+		// Source vertex of every output vertex, keyed by its attributes
+		std::unordered_map<uint32_t, uint32_t, decltype(vertex_hash), decltype(vertex_equal)>
+			welded(data.indices.size(), vertex_hash, vertex_equal);
 
-			// has normal, directly parse the data
-			if (has_texcoord)
-			{
-				parse_data(uv, find_uv->second);
-			}
-			else
+		constexpr auto        unmapped = std::numeric_limits<uint32_t>::max();
+		std::vector<uint32_t> remap(data.position.size(), unmapped);
+		std::vector<uint32_t> sources;
+
+		for (auto& index : data.indices)
+		{
+			if (remap[index] == unmapped)
 			{
-				// manual generate data
-				for (auto _ : Iota(vertex_count / 3))
-				{
-					uv.emplace_back(0.0, 0.0);
-					uv.emplace_back(0.0, 1.0);
-					uv.emplace_back(1.0, 0.0);
-				}
+				const auto [itr, inserted] = welded.try_emplace(index, (uint32_t)sources.size());
+				if (inserted) sources.push_back(index);
+
+				remap[index] = itr->second;
 			}
 
-			return std::tuple{uv, size};
-		}();
+			index = remap[index];
+		}
 
-		// Tangent Data
+		const auto gather = [&sources]<typename T>(std::vector<T>& attribute)
 		{
-			const auto buffer_idx = find_buffer(mesh_context.vec3_data);
-			auto&      tangent    = mesh_context.vec3_data[buffer_idx];
+			std::vector<T> output;
+			output.reserve(sources.size());
+			for (const auto source : sources) output.push_back(attribute[source]);
 
-			output_primitive.tangent_buffer = buffer_idx;
-			output_primitive.tangent_offset = tangent.size();
+			attribute = std::move(output);
+		};
 
-			// both tangent and normal present (see glTF Specification), directly parse the data
-			if (has_tangent && has_normal)
-			{
-				if (has_indices)
-					parse_tangent_data_with_index(tangent, find_tangent->second);
-				else
-					parse_tangent_data_no_index(tangent, find_tangent->second);
-			}
-			else
-			{
-				// manual generate tangent
-				for (auto idx = 0u; idx < vertex_count; idx += 3)
-				{
-					const auto [pos0, pos1, pos2] = std::tuple{
-						position_buffer[position_offset + idx],
-						position_buffer[position_offset + idx + 1],
-						position_buffer[position_offset + idx + 2]
-					};
-
-					const auto [uv0, uv1, uv2]
-						= std::tuple{uv_buffer[uv_offset + idx], uv_buffer[uv_offset + idx + 1], uv_buffer[uv_offset + idx + 2]};
-
-					const auto [tangent0, tangent1, tangent2] = std::tuple{
-						algorithm::geometry::vertex_tangent(pos0, pos1, pos2, uv0, uv1, uv2),
-						algorithm::geometry::vertex_tangent(pos1, pos0, pos2, uv1, uv0, uv2),
-						algorithm::geometry::vertex_tangent(pos2, pos1, pos0, uv2, uv1, uv0)
-					};
-
-					// detect NaNs in tangent
-					const auto nan_judgement0 = glm::isnan(tangent0) || glm::isinf(tangent0);
-					const auto nan_judgement1 = glm::isnan(tangent1) || glm::isinf(tangent1);
-					const auto nan_judgement2 = glm::isnan(tangent2) || glm::isinf(tangent2);
-					const auto nan_judgement  = nan_judgement0 || nan_judgement1 || nan_judgement2;
-					const bool should_discard = nan_judgement.x || nan_judgement.y || nan_judgement.z;
-
-					if (should_discard) [[unlikely]]
-					{
-						for (auto i : Iota(3))
-						{
-							// if present, swizzle normal vector as the tangent vector
-							const auto normal  = normal_buffer[normal_offset + i];
-							const auto swizzle = glm::vec3{normal.y, normal.z, normal.x};
-
-							tangent.push_back(swizzle);
-						}
-					}
-					else
-					{
-						tangent.push_back(tangent0);
-						tangent.push_back(tangent1);
-						tangent.push_back(tangent2);
-					}
-				}
-			}
-		}
+		gather(data.position);
+		gather(data.normal);
+		gather(data.uv);
+		gather(data.tangent);
 
-		// Skin Data
 		if (has_skin)
 		{
-			Primitive_skin skin_info;
+			gather(data.joint);
+			gather(data.weight);
+		}
+	}
 
-			// Parse Joint Data
-			{
-				const auto buffer_idx   = find_buffer(mesh_context.joint_data);
-				auto&      joint_buffer = mesh_context.joint_data[buffer_idx];
-				const auto size         = joint_buffer.size();
+	Primitive Model::merge_primitive(const Primitive_data& data, Mesh_data_context& mesh_context)
+	{
+		Primitive output_primitive = data.primitive;
 
-				skin_info.joint_buffer = buffer_idx;
-				skin_info.joint_offset = size;
+		if (!output_primitive.enabled) return output_primitive;
 
-				const auto joint_data = data_parser::acquire_accessor<glm::u16vec4>(model, find_joints->second);
+		// Store data into mesh context, returns (Buffer Index, Buffer Offset)
+		auto store = []<typename T>(std::vector<std::vector<T>>& list, const std::vector<T>& data) -> std::tuple<uint32_t, uint32_t>
+		{
+			const auto buffer_idx = find_buffer<T, Mesh_data_context::max_single_size>(list, data.size());
+			auto&      buffer     = list[buffer_idx];
+			const auto offset     = buffer.size();
 
-				parse_data(joint_buffer, 0, joint_data.data());
-			}
+			buffer.insert(buffer.end(), data.begin(), data.end());
 
-			// Parse Weight Data
-			{
-				const auto buffer_idx    = find_buffer(mesh_context.weight_data);
-				auto&      weight_buffer = mesh_context.weight_data[buffer_idx];
-				const auto size          = weight_buffer.size();
+			return {(uint32_t)buffer_idx, (uint32_t)offset};
+		};
 
-				skin_info.weight_buffer = buffer_idx;
-				skin_info.weight_offset = size;
+		std::tie(output_primitive.position_buffer, output_primitive.position_offset) = store(mesh_context.vec3_data, data.position);
+		std::tie(output_primitive.normal_buffer, output_primitive.normal_offset)     = store(mesh_context.vec3_data, data.normal);
+		std::tie(output_primitive.uv_buffer, output_primitive.uv_offset)             = store(mesh_context.vec2_data, data.uv);
+		std::tie(output_primitive.tangent_buffer, output_primitive.tangent_offset)   = store(mesh_context.vec3_data, data.tangent);
 
-				const auto weight_data = data_parser::acquire_normalized_accessor<glm::vec4>(model, find_weight->second);
+		// Skin Data
+		if (!data.joint.empty())
+		{
+			Primitive_skin skin_info;
 
-				parse_data(weight_buffer, 0, weight_data.data());
-			}
+			std::tie(skin_info.joint_buffer, skin_info.joint_offset)   = store(mesh_context.joint_data, data.joint);
+			std::tie(skin_info.weight_buffer, skin_info.weight_offset) = store(mesh_context.weight_data, data.weight);
 
 			output_primitive.skin = skin_info;
 		}
 
-		output_primitive.vertex_count = vertex_count;
+		// Index Data, use 16-bit indices whenever possible
+		if (output_primitive.vertex_count <= std::numeric_limits<uint16_t>::max())
+		{
+			const std::vector<uint16_t> index16_data(data.indices.begin(), data.indices.end());
+
+			output_primitive.index_type = vk::IndexType::eUint16;
+			std::tie(output_primitive.index_buffer, output_primitive.index_offset) = store(mesh_context.index16_data, index16_data);
+		}
+		else
+		{
+			output_primitive.index_type = vk::IndexType::eUint32;
+			std::tie(output_primitive.index_buffer, output_primitive.index_offset) = store(mesh_context.index32_data, data.indices);
+		}
 
 		return output_primitive;
 	}
@@ -595,17 +474,45 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 		}
 	}
 
-	void Model::load_all_images(Loader_context& loader_context, const tinygltf::Model& gltf_model)
+	void Model::load_all_images(Loader_context& loader_context, const tinygltf::Model& gltf_model, utility::Thread_pool& thread_pool)
 	{
-		for (auto i : Iota(gltf_model.images.size()))
+		const auto          image_count = gltf_model.images.size();
+		std::atomic<size_t> finished    = 0;
+
+		textures.resize(image_count);
+
+		// Only pre-transcoded KTX2 is uploaded, textures with other KTX2 images (e.g. BasisLZ or UASTC) use their fallback
+		for (const auto& texture : gltf_model.textures)
 		{
-			const auto& image = gltf_model.images[i];
-			if (loader_context.sub_progress) *loader_context.sub_progress = (float)i / gltf_model.images.size();
+			const auto source = codec::basisu_source(gltf_model, texture);
+			if (!source.has_value()) continue;
 
-			Texture tex;
-			tex.parse(image, loader_context);
-			textures.push_back(tex);
+			const auto reason = Texture::ktx2_unsupported_reason(gltf_model.images[*source], loader_context);
+			if (!reason.empty())
+				loader_context.warnings.push_back(
+					std::format("KTX2 image of texture \"{}\" not used, falling back to its source: {}", texture.name, reason)
+				);
 		}
+
+		const auto usages = codec::image_usages(
+			gltf_model,
+			[&loader_context](const tinygltf::Image& image)
+			{
+				return Texture::is_ktx2_supported(image, loader_context);
+			}
+		);
+
+		// decode & upload images in parallel
+		thread_pool.parallel_for(
+			image_count,
+			[&](size_t idx)
+			{
+				if (usages[idx] != Texture_usage::Unused) textures[idx].parse(gltf_model.images[idx], usages[idx], loader_context);
+
+				const auto finished_count = ++finished;
+				if (loader_context.sub_progress) *loader_context.sub_progress = (float)finished_count / image_count;
+			}
+		);
 	}
 
 	void Model::load_all_textures(Loader_context& loader_context, const tinygltf::Model& gltf_model)
@@ -619,27 +526,34 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 
 	void Model::load_all_materials(Loader_context& context, const tinygltf::Model& gltf_model)
 	{
-		auto add_material = [&context, gltf_model, this](
-								uint32_t&                   self_index,
-								const auto&                 tex_info,
-								const glm::vec<4, uint8_t>  col,
-								const vk::ComponentMapping& mapping = {}
-							)
-		{
-			if (tex_info.index < 0 || tex_info.index > (int)gltf_model.textures.size())
+		materials = parse_materials(
+			gltf_model,
+			[&context, this](glm::u8vec4 color) -> uint32_t
 			{
-				self_index = texture_views.size();
-
 				Texture tex;
-				tex.generate(col.r, col.g, col.b, col.a, context);
+				tex.generate(color.r, color.g, color.b, color.a, context);
 
 				textures.push_back(tex);
-				texture_views.emplace_back(context, tex, mapping);
+				texture_views.emplace_back(context, tex);
+
+				return texture_views.size() - 1;
 			}
+		);
+	}
+
+	std::vector<Material> Model::parse_materials(
+		const tinygltf::Model&                      gltf_model,
+		const std::function<uint32_t(glm::u8vec4)>& add_placeholder
+	)
+	{
+		std::vector<Material> output;
+
+		auto add_material = [&](uint32_t& self_index, const auto& tex_info, const glm::u8vec4 col)
+		{
+			if (tex_info.index < 0 || tex_info.index >= (int)gltf_model.textures.size())
+				self_index = add_placeholder(col);
 			else
-			{
 				self_index = tex_info.index;
-			}
 		};
 
 		for (const auto& material : gltf_model.materials)
@@ -694,7 +608,7 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 			// Emissive
 			add_material(output_material.emissive_idx, material.emissiveTexture, {255, 255, 255, 255});
 
-			materials.push_back(std::move(output_material));
+			output.push_back(std::move(output_material));
 		}
 
 		//* Generate Default Material
@@ -721,8 +635,10 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 			// Emissive
 			add_material(output_material.emissive_idx, placeholder, {255, 255, 255, 255});
 
-			materials.push_back(std::move(output_material));
+			output.push_back(std::move(output_material));
 		}
+
+		return output;
 	}
 
 	void Model::load_all_scenes(const tinygltf::Model& gltf_model)
@@ -740,28 +656,63 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 		}
 	}
 
-	void Model::load_all_meshes(Loader_context& loader_context, const tinygltf::Model& gltf_model)
+	std::vector<Mesh> Model::parse_meshes(
+		const tinygltf::Model& gltf_model,
+		utility::Thread_pool&  thread_pool,
+		Mesh_data_context&     mesh_context,
+		std::atomic<float>*    sub_progress
+	)
 	{
-		Mesh_data_context mesh_context;
+		// (Mesh Index, Primitive Index) of all primitives
+		std::vector<std::tuple<uint32_t, uint32_t>> primitive_list;
 
-		for (auto idx : Iota(gltf_model.meshes.size()))
-		{
-			const auto& mesh = gltf_model.meshes[idx];
-			if (loader_context.sub_progress) *loader_context.sub_progress = (float)idx / gltf_model.meshes.size();
+		for (auto [mesh_idx, mesh] : Walk(gltf_model.meshes))
+			for (auto primitive_idx : Iota(mesh.primitives.size())) primitive_list.emplace_back(mesh_idx, primitive_idx);
+
+		// parse all primitives in parallel
+		std::vector<Primitive_data> primitive_data(primitive_list.size());
+		std::atomic<size_t>         finished = 0;
+
+		thread_pool.parallel_for(
+			primitive_list.size(),
+			[&](size_t idx)
+			{
+				const auto [mesh_idx, primitive_idx] = primitive_list[idx];
+
+				primitive_data[idx] = parse_primitive(gltf_model, gltf_model.meshes[mesh_idx].primitives[primitive_idx]);
+
+				const auto finished_count = ++finished;
+				if (sub_progress) *sub_progress = (float)finished_count / primitive_list.size();
+			}
+		);
+
+		// merge into mesh context, in order
+		std::vector<Mesh> output;
+		auto              primitive_data_iter = primitive_data.begin();
 
+		for (const auto& mesh : gltf_model.meshes)
+		{
 			Mesh output_mesh;
 			output_mesh.name = mesh.name;
 
-			// Parse all primitives
-			for (const auto& primitive : mesh.primitives)
+			for (auto _ : Iota(mesh.primitives.size()))
 			{
-				output_mesh.primitives.push_back(parse_primitive(gltf_model, primitive, mesh_context));
+				output_mesh.primitives.push_back(merge_primitive(*primitive_data_iter, mesh_context));
+				*primitive_data_iter++ = {};  // release memory
 			}
 
-			meshes.push_back(std::move(output_mesh));
+			output.push_back(std::move(output_mesh));
 		}
 
-		generate_buffers(loader_context, mesh_context);
+		return output;
+	}
+
+	void Model::load_all_meshes(Loader_context& loader_context, const tinygltf::Model& gltf_model, utility::Thread_pool& thread_pool)
+	{
+		Mesh_data_context mesh_context;
+
+		meshes = parse_meshes(gltf_model, thread_pool, mesh_context, loader_context.sub_progress);
+		generate_buffers(loader_context, mesh_context.blocks());
 	}
 
 	void Model::load_all_animations(const tinygltf::Model& model)
@@ -803,67 +754,89 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 		}
 	}
 
-	void Model::generate_buffers(Loader_context& loader_context, const Mesh_data_context& mesh_context)
+	Model::Buffer_blocks Model::Mesh_data_context::blocks() const
 	{
-		const Command_buffer command(loader_context.command_pool);
-
-		command.begin(true);
-
-		auto generate_buffer = [&]<typename T>(const std::vector<std::vector<T>>& buffer, std::vector<Buffer>& dst) -> void
+		auto as_bytes = []<typename T>(const std::vector<std::vector<T>>& list)
 		{
-			for (const auto& buf : buffer)
-			{
-				const auto size = buf.size() * sizeof(T);
+			std::vector<std::span<const uint8_t>> output;
+			for (const auto& block : list) output.emplace_back((const uint8_t*)block.data(), block.size() * sizeof(T));
 
-				const Buffer staging_buffer(
-					loader_context.allocator,
-					size,
-					vk::BufferUsageFlagBits::eTransferSrc,
-					vk::SharingMode::eExclusive,
-					VMA_MEMORY_USAGE_CPU_TO_GPU
-				);
+			return output;
+		};
 
-				staging_buffer << buf;
+		return {
+			as_bytes(vec3_data),
+			as_bytes(vec2_data),
+			as_bytes(joint_data),
+			as_bytes(weight_data),
+			as_bytes(index16_data),
+			as_bytes(index32_data)
+		};
+	}
 
+	void Model::generate_buffers(Loader_context& loader_context, const Buffer_blocks& blocks)
+	{
+		auto generate_buffer = [&](
+								   const std::vector<std::span<const uint8_t>>& src,
+								   std::vector<Buffer>&                         dst,
+								   vk::BufferUsageFlags                         usage = vk::BufferUsageFlagBits::eVertexBuffer
+							   ) -> void
+		{
+			for (const auto& block : src)
+			{
 				const Buffer vertex_buffer(
 					loader_context.allocator,
-					size,
-					vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
+					block.size(),
+					vk::BufferUsageFlagBits::eTransferDst | usage,
 					vk::SharingMode::eExclusive,
 					VMA_MEMORY_USAGE_GPU_ONLY
 				);
 
-				command.copy_buffer(vertex_buffer, staging_buffer, 0, 0, size);
-
-				loader_context.staging_buffers.push_back(staging_buffer);
+				loader_context.staging_ring.upload_buffer(vertex_buffer, block);
 				dst.push_back(vertex_buffer);
 			}
 		};
 
-		generate_buffer(mesh_context.vec3_data, vec3_buffers);
-		generate_buffer(mesh_context.vec2_data, vec2_buffers);
-		generate_buffer(mesh_context.joint_data, joint_buffers);
-		generate_buffer(mesh_context.weight_data, weight_buffers);
+		// Skinning attributes are also readable as storage buffers, for skinning in compute shaders
+		constexpr auto skinnable_usage = vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eStorageBuffer;
 
-		command.end();
+		generate_buffer(blocks.vec3, vec3_buffers, skinnable_usage);
+		generate_buffer(blocks.vec2, vec2_buffers);
+		generate_buffer(blocks.joint, joint_buffers, skinnable_usage);
+		generate_buffer(blocks.weight, weight_buffers, skinnable_usage);
+		generate_buffer(blocks.index16, index16_buffers, vk::BufferUsageFlagBits::eIndexBuffer);
+		generate_buffer(blocks.index32, index32_buffers, vk::BufferUsageFlagBits::eIndexBuffer);
+	}
 
-		loader_context.command_buffers.push_back(command);
+	void Model::create_staging_ring(Loader_context& loader_context)
+	{
+		loader_context.staging_ring = Staging_ring(
+			loader_context.allocator,
+			loader_context.device,
+			loader_context.command_pool,
+			loader_context.transfer_queue,
+			loader_context.config.staging_capacity,
+			loader_context.queue_mutex
+		);
 	}
 
 	void Model::load(Loader_context& loader_context, const tinygltf::Model& gltf_model)
 	{
+		create_staging_ring(loader_context);
+
 		// parse Materials
+		utility::Thread_pool thread_pool;
+
 		if (loader_context.load_stage) *loader_context.load_stage = Load_stage::Load_material;
-		load_all_images(loader_context, gltf_model);
+		load_all_images(loader_context, gltf_model, thread_pool);
 		load_all_textures(loader_context, gltf_model);
 		load_all_materials(loader_context, gltf_model);
 
 		// parse Meshes
 		if (loader_context.load_stage) *loader_context.load_stage = Load_stage::Load_mesh;
-		load_all_meshes(loader_context, gltf_model);
+		load_all_meshes(loader_context, gltf_model, thread_pool);
 
-		const auto submit_buffer = Command_buffer::to_vector(loader_context.command_buffers);
-		loader_context.transfer_queue.submit(vk::SubmitInfo().setCommandBuffers(submit_buffer));
+		loader_context.staging_ring.flush();
 
 		// parse scenes & nodes
 		load_all_cameras(gltf_model);
@@ -872,9 +845,7 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 		load_all_animations(gltf_model);
 		load_all_skins(gltf_model);
 
-		loader_context.transfer_queue.waitIdle();
-		loader_context.command_buffers.clear();
-		loader_context.staging_buffers.clear();
+		loader_context.staging_ring.finish();
 	}
 
 	void Model::load_gltf_bin(Loader_context& loader_context, const std::string& path)
@@ -883,11 +854,16 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 
 		tinygltf::TinyGLTF parser;
 		tinygltf::Model    gltf_model;
+		parser.SetImageLoader(codec::deferred_image_loader, nullptr);
 
 		std::string warn, err;
 
 		if (loader_context.load_stage) *loader_context.load_stage = Load_stage::Tinygltf_loading;
-		auto result = parser.LoadBinaryFromFile(&gltf_model, &err, &warn, path);
+
+		// Parse directly from the mapped file, external resources are resolved relative to the file
+		const Mapped_file file(path);
+		const auto        base_dir = std::filesystem::path(path).parent_path().string();
+		auto result = parser.LoadBinaryFromMemory(&gltf_model, &err, &warn, file.data().data(), file.size(), base_dir);
 
 		if (!result)
 		{
@@ -905,11 +881,16 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 
 		tinygltf::TinyGLTF parser;
 		tinygltf::Model    gltf_model;
+		parser.SetImageLoader(codec::deferred_image_loader, nullptr);
 
 		std::string warn, err;
 
 		if (loader_context.load_stage) *loader_context.load_stage = Load_stage::Tinygltf_loading;
-		auto result = parser.LoadASCIIFromFile(&gltf_model, &err, &warn, path);
+
+		const Mapped_file file(path);
+		const auto        base_dir  = std::filesystem::path(path).parent_path().string();
+		const auto        file_text = reinterpret_cast<const char*>(file.data().data());
+		auto result = parser.LoadASCIIFromString(&gltf_model, &err, &warn, file_text, file.size(), base_dir);
 
 		if (!result)
 		{
@@ -921,12 +902,13 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 		if (loader_context.load_stage) *loader_context.load_stage = Load_stage::Finished;
 	}
 
-	void Model::load_gltf_memory(Loader_context& loader_context, std::span<uint8_t> data)
+	void Model::load_gltf_memory(Loader_context& loader_context, std::span<const uint8_t> data)
 	{
 		loader_context.fence = Fence(loader_context.device);
 
 		tinygltf::TinyGLTF parser;
 		tinygltf::Model    gltf_model;
+		parser.SetImageLoader(codec::deferred_image_loader, nullptr);
 
 		std::string warn, err;
 
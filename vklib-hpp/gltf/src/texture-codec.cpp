@@ -0,0 +1,453 @@
+#include "texture-codec.hpp"
+
+#include <bit>
+#include <cstring>
+#include <stb_image.h>
+
+namespace VKLIB_HPP_NAMESPACE::io::gltf::codec
+{
+#pragma region "Decoding"
+
+	bool deferred_image_loader(
+		tinygltf::Image* image,
+		const int,
+		std::string*,
+		std::string*,
+		int,
+		int,
+		const unsigned char* bytes,
+		int                  size,
+		void*
+	)
+	{
+		image->width = image->height = -1;
+		image->image.assign(bytes, bytes + size);
+
+		return true;
+	}
+
+	Decoded_image decode_image(const tinygltf::Image& tex)
+	{
+		// Already decoded by tinygltf
+		if (tex.width >= 0) return {tex.width, tex.height, tex.component, tex.pixel_type, tex.image};
+
+		const auto* const bytes = tex.image.data();
+		const int         size  = tex.image.size();
+
+		Decoded_image output;
+		void*         pixels;
+		size_t        component_size;
+
+		if (stbi_is_16_bit_from_memory(bytes, size))
+		{
+			pixels            = stbi_load_16_from_memory(bytes, size, &output.width, &output.height, &output.component, 0);
+			output.pixel_type = TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT;
+			component_size    = sizeof(uint16_t);
+		}
+		else
+		{
+			pixels            = stbi_load_from_memory(bytes, size, &output.width, &output.height, &output.component, 0);
+			output.pixel_type = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+			component_size    = sizeof(uint8_t);
+		}
+
+		if (pixels == nullptr)
+			throw Gltf_parse_error(std::format("Failed to decode image \"{}\"", tex.name), stbi_failure_reason());
+
+		const std::unique_ptr<void, decltype(&stbi_image_free)> pixels_guard(pixels, stbi_image_free);
+
+		const auto* const pixel_bytes = (const uint8_t*)pixels;
+		output.image.assign(pixel_bytes, pixel_bytes + (size_t)output.width * output.height * output.component * component_size);
+
+		return output;
+	}
+
+#pragma endregion
+
+#pragma region "KTX2"
+
+	static constexpr std::array<uint8_t, 12> ktx2_identifier
+		= {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+	const std::map<vk::Format, Block_format> block_formats{
+		{vk::Format::eR8Unorm,           {vk::Format::eR8Unorm, 1, 1, 1}          },
+		{vk::Format::eR8G8Unorm,         {vk::Format::eR8G8Unorm, 1, 2, 2}        },
+		{vk::Format::eR8G8B8A8Unorm,     {vk::Format::eR8G8B8A8Unorm, 1, 4, 4}    },
+		{vk::Format::eR8G8B8A8Srgb,      {vk::Format::eR8G8B8A8Unorm, 1, 4, 4}    },
+		{vk::Format::eBc1RgbUnormBlock,  {vk::Format::eBc1RgbUnormBlock, 4, 8, 4} },
+		{vk::Format::eBc1RgbSrgbBlock,   {vk::Format::eBc1RgbUnormBlock, 4, 8, 4} },
+		{vk::Format::eBc1RgbaUnormBlock, {vk::Format::eBc1RgbaUnormBlock, 4, 8, 4}},
+		{vk::Format::eBc1RgbaSrgbBlock,  {vk::Format::eBc1RgbaUnormBlock, 4, 8, 4}},
+		{vk::Format::eBc3UnormBlock,     {vk::Format::eBc3UnormBlock, 4, 16, 4}   },
+		{vk::Format::eBc3SrgbBlock,      {vk::Format::eBc3UnormBlock, 4, 16, 4}   },
+		{vk::Format::eBc4UnormBlock,     {vk::Format::eBc4UnormBlock, 4, 8, 1}    },
+		{vk::Format::eBc5UnormBlock,     {vk::Format::eBc5UnormBlock, 4, 16, 2}   },
+		{vk::Format::eBc7UnormBlock,     {vk::Format::eBc7UnormBlock, 4, 16, 4}   },
+		{vk::Format::eBc7SrgbBlock,      {vk::Format::eBc7UnormBlock, 4, 16, 4}   },
+	};
+
+	std::string format_unsupported_reason(const Block_format& format, const Loader_context& context)
+	{
+		if (format.block_extent != 1 && !context.config.enable_texture_compression_bc)
+			return "BC texture compression is not enabled on the device";
+
+		const auto required_features = vk::FormatFeatureFlagBits::eSampledImage | vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+		const auto format_features   = context.physical_device.getFormatProperties(format.upload_format).optimalTilingFeatures;
+		if ((format_features & required_features) != required_features)
+			return std::format("VkFormat {} can't be sampled on the device", (uint32_t)format.upload_format);
+
+		return {};
+	}
+
+	std::optional<Ktx2_image> read_ktx2(std::span<const uint8_t> data)
+	{
+		if (data.size() < ktx2_identifier.size() || !std::ranges::equal(data.first(ktx2_identifier.size()), ktx2_identifier))
+			return std::nullopt;
+
+		if (data.size() < sizeof(Ktx2_header)) throw Gltf_parse_error("Invalid KTX2 image", "File is shorter than the header");
+
+		Ktx2_image output;
+		std::memcpy(&output.header, data.data(), sizeof(Ktx2_header));
+
+		const auto& header      = output.header;
+		const auto  level_count = std::max(header.level_count, 1u);
+
+		if (data.size() < sizeof(Ktx2_header) + level_count * sizeof(Ktx2_level))
+			throw Gltf_parse_error("Invalid KTX2 image", "File is shorter than the level index");
+
+		output.levels.resize(level_count);
+		std::memcpy(output.levels.data(), data.data() + sizeof(Ktx2_header), level_count * sizeof(Ktx2_level));
+
+		for (const auto& level : output.levels)
+			if (level.byte_offset > data.size() || level.byte_length > data.size() - level.byte_offset)
+				throw Gltf_parse_error("Invalid KTX2 image", "Mip level lies outside of the file");
+
+		return output;
+	}
+
+	std::string ktx2_container_reason(const Ktx2_image& image)
+	{
+		const auto& header = image.header;
+
+		// Only pre-transcoded payloads are loaded, there is no Basis Universal transcoder
+		if (header.supercompression_scheme != 0)
+			return std::format(
+				"Supercompression scheme {} (BasisLZ/Zstd) is not supported, only pre-transcoded BCn KTX2 is",
+				header.supercompression_scheme
+			);
+		if (header.vk_format == (uint32_t)vk::Format::eUndefined)
+			return "UASTC payloads are not transcoded, only pre-transcoded BCn KTX2 is supported";
+
+		if (header.pixel_width == 0 || header.pixel_height == 0 || header.pixel_depth != 0) return "Only 2D images are supported";
+		if (header.layer_count != 0 || header.face_count != 1) return "Array and cubemap images are not supported";
+
+		const auto format_itr = block_formats.find((vk::Format)header.vk_format);
+		if (format_itr == block_formats.end()) return std::format("VkFormat {} is not supported", header.vk_format);
+
+		const auto& format = format_itr->second;
+
+		if (image.levels.size() > (size_t)std::bit_width(std::max(header.pixel_width, header.pixel_height)))
+			return "Too many mip levels";
+
+		for (const auto [level, info] : Walk(image.levels))
+		{
+			const auto level_width  = std::max(header.pixel_width >> level, 1u);
+			const auto level_height = std::max(header.pixel_height >> level, 1u);
+
+			if (info.byte_length < format.level_size(level_width, level_height))
+				return std::format("Mip level {} is smaller than its extent", level);
+		}
+
+		return {};
+	}
+
+	std::vector<std::span<const uint8_t>> ktx2_levels(const Ktx2_image& image, std::span<const uint8_t> data)
+	{
+		std::vector<std::span<const uint8_t>> output;
+
+		for (const auto& level : image.levels) output.push_back(data.subspan(level.byte_offset, level.byte_length));
+
+		return output;
+	}
+
+#pragma endregion
+
+#pragma region "Texture Sources"
+
+	std::optional<uint32_t> basisu_source(const tinygltf::Model& model, const tinygltf::Texture& texture)
+	{
+		const auto basisu = texture.extensions.find("KHR_texture_basisu");
+		if (basisu == texture.extensions.end() || !basisu->second.Has("source")) return std::nullopt;
+
+		const auto source = basisu->second.Get("source").GetNumberAsInt();
+		if (source < 0 || source >= (int)model.images.size()) return std::nullopt;
+
+		return source;
+	}
+
+	uint32_t texture_source(const tinygltf::Model& model, const tinygltf::Texture& texture, const Ktx2_filter& filter)
+	{
+		const auto basisu = basisu_source(model, texture);
+		if (basisu.has_value() && filter(model.images[*basisu])) return *basisu;
+
+		if (texture.source < 0 || texture.source >= (int)model.images.size())
+			throw Gltf_parse_error(
+				"No usable texture source",
+				std::format("Texture \"{}\" has neither a valid source nor a supported KTX2 image", texture.name)
+			);
+
+		return texture.source;
+	}
+
+	std::vector<Texture_usage> image_usages(const tinygltf::Model& model, const Ktx2_filter& filter)
+	{
+		const auto image_count = model.images.size();
+
+		std::vector<Texture_usage> usages(image_count, Texture_usage::Unused);
+		std::vector<bool>          referenced(image_count, false);
+
+		for (const auto& texture : model.textures) referenced[texture_source(model, texture, filter)] = true;
+
+		auto mark = [&](int texture_idx, Texture_usage usage)
+		{
+			if (texture_idx < 0 || texture_idx >= (int)model.textures.size()) return;
+
+			auto& dst = usages[texture_source(model, model.textures[texture_idx], filter)];
+			dst       = (dst == Texture_usage::Unused || dst == usage) ? usage : Texture_usage::Shared;
+		};
+
+		for (const auto& material : model.materials)
+		{
+			mark(material.pbrMetallicRoughness.baseColorTexture.index, Texture_usage::Color);
+			mark(material.pbrMetallicRoughness.metallicRoughnessTexture.index, Texture_usage::Metal_roughness);
+			mark(material.normalTexture.index, Texture_usage::Normal);
+			mark(material.occlusionTexture.index, Texture_usage::Occlusion);
+			mark(material.emissiveTexture.index, Texture_usage::Emissive);
+		}
+
+		// Referenced by textures outside of materials
+		for (auto i : Iota(image_count))
+			if (referenced[i] && usages[i] == Texture_usage::Unused) usages[i] = Texture_usage::Shared;
+
+		return usages;
+	}
+
+#pragma endregion
+
+#pragma region "Encoding"
+
+	Rgba8_image to_rgba8(const Decoded_image& decoded)
+	{
+		const bool   is_16bit    = decoded.pixel_type == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT;
+		const size_t pixel_count = (size_t)decoded.width * decoded.height;
+
+		// 16-bit values are rounded to 8 bits
+		auto component = [&](size_t idx) -> uint8_t
+		{
+			if (!is_16bit) return decoded.image[idx];
+
+			uint16_t value;
+			std::memcpy(&value, decoded.image.data() + idx * sizeof(uint16_t), sizeof(uint16_t));
+			return ((uint32_t)value * 255 + 32767) / 65535;
+		};
+
+		Rgba8_image output{(uint32_t)decoded.width, (uint32_t)decoded.height, std::vector<glm::u8vec4>(pixel_count, {0, 0, 0, 255})};
+
+		for (auto i : Iota(pixel_count))
+			for (auto c : Iota(decoded.component)) output.pixels[i][c] = component(i * decoded.component + c);
+
+		return output;
+	}
+
+	Rgba8_image downsample(const Rgba8_image& image)
+	{
+		Rgba8_image output{std::max(image.width / 2, 1u), std::max(image.height / 2, 1u), {}};
+		output.pixels.resize((size_t)output.width * output.height);
+
+		// Coordinates past the edge of odd-sized images are clamped
+		auto texel = [&image](uint32_t x, uint32_t y)
+		{
+			return glm::u32vec4(image.pixels[(size_t)std::min(y, image.height - 1) * image.width + std::min(x, image.width - 1)]);
+		};
+
+		for (auto y : Iota(output.height))
+			for (auto x : Iota(output.width))
+			{
+				const auto sum = texel(x * 2, y * 2) + texel(x * 2 + 1, y * 2) + texel(x * 2, y * 2 + 1) + texel(x * 2 + 1, y * 2 + 1);
+				output.pixels[(size_t)y * output.width + x] = glm::u8vec4((sum + 2u) / 4u);
+			}
+
+		return output;
+	}
+
+	using Block_pixels = std::array<glm::u8vec4, 16>;
+
+	// Runs `encode(pixels, dst)` for every 4x4 block of `image`, row by row
+	template <size_t Block_size>
+	static std::vector<uint8_t> encode_blocks(
+		const Rgba8_image&                                        image,
+		const std::function<void(const Block_pixels&, uint8_t*)>& encode
+	)
+	{
+		const auto blocks_x = (image.width + 3) / 4, blocks_y = (image.height + 3) / 4;
+
+		std::vector<uint8_t> output((size_t)blocks_x * blocks_y * Block_size);
+		Block_pixels         pixels;
+
+		for (auto by : Iota(blocks_y))
+			for (auto bx : Iota(blocks_x))
+			{
+				for (auto i : Iota(16u))
+				{
+					const auto x = std::min(bx * 4 + i % 4, image.width - 1), y = std::min(by * 4 + i / 4, image.height - 1);
+					pixels[i]    = image.pixels[(size_t)y * image.width + x];
+				}
+
+				encode(pixels, output.data() + ((size_t)by * blocks_x + bx) * Block_size);
+			}
+
+		return output;
+	}
+
+	// 8-value BC4 block with the block maximum as the first endpoint
+	static void encode_bc4_block(const Block_pixels& pixels, uint32_t channel, uint8_t* dst)
+	{
+		uint8_t min = 255, max = 0;
+		for (const auto& pixel : pixels)
+		{
+			min = std::min(min, pixel[channel]);
+			max = std::max(max, pixel[channel]);
+		}
+
+		dst[0] = max;
+		dst[1] = min;
+
+		uint64_t indices = 0;
+
+		if (max != min)
+			for (auto i : Iota(16u))
+			{
+				// Position on the ramp from `min` (0) to `max` (7), palette indices are 1, 7, 6, ..., 2, 0 along it
+				const uint32_t step  = ((pixels[i][channel] - min) * 7 + (max - min) / 2) / (max - min);
+				const uint64_t index = step == 7 ? 0 : step == 0 ? 1 : 8 - step;
+
+				indices |= index << (i * 3);
+			}
+
+		for (auto i : Iota(6u)) dst[2 + i] = (indices >> (i * 8)) & 0xFF;
+	}
+
+	static uint16_t pack_565(const glm::ivec3& color)
+	{
+		return ((color.r * 31 + 127) / 255) << 11 | ((color.g * 63 + 127) / 255) << 5 | ((color.b * 31 + 127) / 255);
+	}
+
+	static glm::ivec3 unpack_565(uint16_t color)
+	{
+		const int r = color >> 11 & 31, g = color >> 5 & 63, b = color & 31;
+		return {r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2};
+	}
+
+	// > 4-color BC1 block, endpoints are the inset bounding box of the block.
+	// The diagonal of the box follows the sign of the covariance of green and blue against red
+	static void encode_bc1_block(const Block_pixels& pixels, uint8_t* dst)
+	{
+		glm::ivec3 min(255), max(0), sum(0);
+		for (const auto& pixel : pixels)
+		{
+			min = glm::min(min, glm::ivec3(pixel));
+			max = glm::max(max, glm::ivec3(pixel));
+			sum += glm::ivec3(pixel);
+		}
+
+		int covariance_g = 0, covariance_b = 0;
+		for (const auto& pixel : pixels)
+		{
+			const auto delta = glm::ivec3(pixel) * 16 - sum;
+			covariance_g += delta.r * delta.g;
+			covariance_b += delta.r * delta.b;
+		}
+
+		if (covariance_g < 0) std::swap(min.g, max.g);
+		if (covariance_b < 0) std::swap(min.b, max.b);
+
+		const auto inset = (max - min) / 16;
+		max -= inset;
+		min += inset;
+
+		uint16_t color0 = pack_565(max), color1 = pack_565(min);
+		if (color0 < color1) std::swap(color0, color1);
+
+		const auto endpoint0 = unpack_565(color0), endpoint1 = unpack_565(color1);
+		const auto palette   = std::to_array({endpoint0, endpoint1, (endpoint0 * 2 + endpoint1) / 3, (endpoint0 + endpoint1 * 2) / 3});
+
+		uint32_t indices = 0;
+
+		if (color0 != color1)
+			for (auto i : Iota(16u))
+			{
+				uint32_t best          = 0;
+				int      best_distance = std::numeric_limits<int>::max();
+
+				for (auto [index, color] : Walk(palette))
+				{
+					const auto delta    = color - glm::ivec3(pixels[i]);
+					const auto distance = delta.r * delta.r + delta.g * delta.g + delta.b * delta.b;
+
+					if (distance < best_distance)
+					{
+						best          = index;
+						best_distance = distance;
+					}
+				}
+
+				indices |= best << (i * 2);
+			}
+
+		std::memcpy(dst, &color0, 2);
+		std::memcpy(dst + 2, &color1, 2);
+		std::memcpy(dst + 4, &indices, 4);
+	}
+
+	std::vector<uint8_t> encode_bc1(const Rgba8_image& image)
+	{
+		return encode_blocks<8>(image, encode_bc1_block);
+	}
+
+	std::vector<uint8_t> encode_bc3(const Rgba8_image& image)
+	{
+		return encode_blocks<16>(
+			image,
+			[](const Block_pixels& pixels, uint8_t* dst)
+			{
+				encode_bc4_block(pixels, 3, dst);
+				encode_bc1_block(pixels, dst + 8);
+			}
+		);
+	}
+
+	std::vector<uint8_t> encode_bc4(const Rgba8_image& image, uint32_t channel)
+	{
+		return encode_blocks<8>(
+			image,
+			[channel](const Block_pixels& pixels, uint8_t* dst)
+			{
+				encode_bc4_block(pixels, channel, dst);
+			}
+		);
+	}
+
+	std::vector<uint8_t> encode_bc5(const Rgba8_image& image, uint32_t channel0, uint32_t channel1)
+	{
+		return encode_blocks<16>(
+			image,
+			[channel0, channel1](const Block_pixels& pixels, uint8_t* dst)
+			{
+				encode_bc4_block(pixels, channel0, dst);
+				encode_bc4_block(pixels, channel1, dst + 8);
+			}
+		);
+	}
+
+#pragma endregion
+}
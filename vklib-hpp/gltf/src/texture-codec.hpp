@@ -0,0 +1,123 @@
+#pragma once
+#include "vklib/gltf.hpp"
+
+// Image decoding, KTX2 containers and CPU block compression, shared by the loader and the cooker
+namespace VKLIB_HPP_NAMESPACE::io::gltf::codec
+{
+	/* Decoding */
+
+	// > Image loader for tinygltf, which keeps the encoded data and leaves the decoding to `decode_image`.
+	// Deferred images are marked with negative width & height.
+	bool deferred_image_loader(
+		tinygltf::Image* image,
+		const int,
+		std::string*,
+		std::string*,
+		int,
+		int,
+		const unsigned char* bytes,
+		int                  size,
+		void*
+	);
+
+	struct Decoded_image
+	{
+		int width, height, component, pixel_type;
+
+		std::vector<uint8_t> image;
+	};
+
+	// Decodes images whose decoding is deferred by `deferred_image_loader`, thread-safe
+	Decoded_image decode_image(const tinygltf::Image& tex);
+
+	/* KTX2 */
+
+	// File layout: https://registry.khronos.org/KTX/specs/2.0/ktxspec.v2.html
+	struct Ktx2_header
+	{
+		std::array<uint8_t, 12> identifier;
+		uint32_t                vk_format, type_size;
+		uint32_t                pixel_width, pixel_height, pixel_depth;
+		uint32_t                layer_count, face_count, level_count;
+		uint32_t                supercompression_scheme;
+		uint32_t                dfd_byte_offset, dfd_byte_length, kvd_byte_offset, kvd_byte_length;
+		uint64_t                sgd_byte_offset, sgd_byte_length;
+	};
+
+	struct Ktx2_level
+	{
+		uint64_t byte_offset, byte_length, uncompressed_byte_length;
+	};
+
+	static_assert(sizeof(Ktx2_header) == 80 && sizeof(Ktx2_level) == 24);
+
+	struct Block_format
+	{
+		vk::Format upload_format;    // sRGB formats are uploaded as UNORM, as shaders decode gamma themselves
+		uint32_t   block_extent;     // 4 for BC formats, 1 otherwise
+		uint32_t   block_size;       // bytes per block
+		uint32_t   component_count;
+
+		// Bytes of a tightly packed mip level
+		size_t level_size(uint32_t width, uint32_t height) const
+		{
+			return (size_t)((width + block_extent - 1) / block_extent) * ((height + block_extent - 1) / block_extent) * block_size;
+		}
+	};
+
+	// Formats of KTX2 and cooked images
+	extern const std::map<vk::Format, Block_format> block_formats;
+
+	// Why images in `format` can't be sampled on the device of `context`, empty if they can
+	std::string format_unsupported_reason(const Block_format& format, const Loader_context& context);
+
+	struct Ktx2_image
+	{
+		Ktx2_header             header;
+		std::vector<Ktx2_level> levels;  // level 0 is the largest
+	};
+
+	// Reads the header and level index of `data`, returns `std::nullopt` if `data` isn't a KTX2 file
+	std::optional<Ktx2_image> read_ktx2(std::span<const uint8_t> data);
+
+	// Why `image` can't be uploaded on any device, empty if it can. Its format is then in `block_formats`
+	std::string ktx2_container_reason(const Ktx2_image& image);
+
+	// Mip levels of `image`, stored in `data`
+	std::vector<std::span<const uint8_t>> ktx2_levels(const Ktx2_image& image, std::span<const uint8_t> data);
+
+	/* Texture Sources */
+
+	// Whether a KTX2 image can be used in place of the fallback source
+	using Ktx2_filter = std::function<bool(const tinygltf::Image&)>;
+
+	// Image of the `KHR_texture_basisu` extension of `texture`, if present and in range
+	std::optional<uint32_t> basisu_source(const tinygltf::Model& model, const tinygltf::Texture& texture);
+
+	// Image sampled by `texture`, see `gltf::texture_source`
+	uint32_t texture_source(const tinygltf::Model& model, const tinygltf::Texture& texture, const Ktx2_filter& filter);
+
+	// Slots sampling each image. Images no texture refers to, such as fallbacks of usable KTX2 images, are `Unused`
+	std::vector<Texture_usage> image_usages(const tinygltf::Model& model, const Ktx2_filter& filter);
+
+	/* Encoding */
+
+	struct Rgba8_image
+	{
+		uint32_t                 width, height;
+		std::vector<glm::u8vec4> pixels;
+	};
+
+	// Converts to 8-bit RGBA, missing channels are filled as sampling an image of `decoded` would return them
+	Rgba8_image to_rgba8(const Decoded_image& decoded);
+
+	// Box-filtered half-size image, clamped at 1 pixel
+	Rgba8_image downsample(const Rgba8_image& image);
+
+	// > 4x4 block encoders, using the bounding box of each block as endpoints.
+	// Blocks crossing the border repeat the edge pixels
+	std::vector<uint8_t> encode_bc1(const Rgba8_image& image);
+	std::vector<uint8_t> encode_bc3(const Rgba8_image& image);
+	std::vector<uint8_t> encode_bc4(const Rgba8_image& image, uint32_t channel);
+	std::vector<uint8_t> encode_bc5(const Rgba8_image& image, uint32_t channel0, uint32_t channel1);
+}
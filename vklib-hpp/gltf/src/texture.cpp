@@ -1,9 +1,133 @@
-#include "data-accessor.hpp"
+#include "texture-codec.hpp"
 
 namespace VKLIB_HPP_NAMESPACE::io::gltf
 {
-	void Texture::parse(const tinygltf::Image& tex, Loader_context& loader_context)
+	// Expands 3-component pixels in `src` to 4 components in `dst`, with alpha set to opaque
+	template <typename T>
+	static void expand_rgb_to_rgba(const uint8_t* src, uint8_t* dst, size_t pixel_count)
 	{
+		const auto* const src_pixels = (const T*)src;
+		auto* const       dst_pixels = (T*)dst;
+
+		for (const auto i : Iota(pixel_count))
+		{
+			dst_pixels[i * 4 + 0] = src_pixels[i * 3 + 0];
+			dst_pixels[i * 4 + 1] = src_pixels[i * 3 + 1];
+			dst_pixels[i * 4 + 2] = src_pixels[i * 3 + 2];
+			dst_pixels[i * 4 + 3] = std::numeric_limits<T>::max();
+		}
+	}
+
+	// > Copies a tightly packed mip level of `image` from staging memory, in pieces of whole texel or block rows no larger
+	// than a staging chunk. `write` fills the given rows, `image` must be in transfer destination layout
+	static void upload_level(
+		Staging_ring&                        staging_ring,
+		const Image&                         image,
+		uint32_t                             level,
+		uint32_t                             width,
+		uint32_t                             height,
+		const codec::Block_format&           format,
+		const Staging_ring::Write_rows_func& write
+	)
+	{
+		const auto block_rows = (height + format.block_extent - 1) / format.block_extent;
+		const auto row_size   = (vk::DeviceSize)((width + format.block_extent - 1) / format.block_extent) * format.block_size;
+
+		const auto record_rows = [&](const Command_buffer& command_buffer,
+									 const Buffer&         staging,
+									 vk::DeviceSize        offset,
+									 uint32_t              first_row,
+									 uint32_t              row_count)
+		{
+			// Extents of block compressed images may end at the image border instead of a block border
+			const auto y = first_row * format.block_extent;
+
+			const vk::BufferImageCopy copy_info(
+				offset,
+				0,
+				0,
+				{vk::ImageAspectFlagBits::eColor, level, 0, 1},
+				{0, (int32_t)y, 0},
+				vk::Extent3D(width, std::min(row_count * format.block_extent, height - y), 1)
+			);
+			command_buffer.copy_buffer_to_image(image, staging, vk::ImageLayout::eTransferDstOptimal, {copy_info});
+		};
+
+		staging_ring.upload_rows(block_rows, row_size, write, record_rows);
+	}
+
+	// Why `image` can't be uploaded by `Texture::parse`, empty if it can
+	static std::string ktx2_image_unsupported_reason(const codec::Ktx2_image& image, const Loader_context& context)
+	{
+		const auto container_reason = codec::ktx2_container_reason(image);
+		if (!container_reason.empty()) return container_reason;
+
+		return codec::format_unsupported_reason(codec::block_formats.at((vk::Format)image.header.vk_format), context);
+	}
+
+	std::string Texture::ktx2_unsupported_reason(const tinygltf::Image& tex, const Loader_context& loader_context)
+	{
+		// Images decoded by tinygltf are never KTX2
+		if (tex.width >= 0) return "Not a KTX2 image";
+
+		try
+		{
+			const auto image = codec::read_ktx2(tex.image);
+			if (!image.has_value()) return "Not a KTX2 image";
+
+			return ktx2_image_unsupported_reason(*image, loader_context);
+		}
+		catch (const Gltf_parse_error& e)
+		{
+			return e.detail;
+		}
+	}
+
+	bool Texture::is_ktx2_supported(const tinygltf::Image& tex, const Loader_context& loader_context)
+	{
+		return ktx2_unsupported_reason(tex, loader_context).empty();
+	}
+
+	uint32_t texture_source(const Loader_context& context, const tinygltf::Model& model, const tinygltf::Texture& texture)
+	{
+		return codec::texture_source(
+			model,
+			texture,
+			[&context](const tinygltf::Image& image)
+			{
+				return Texture::is_ktx2_supported(image, context);
+			}
+		);
+	}
+
+	void Texture::parse(const tinygltf::Image& gltf_image, Texture_usage usage, Loader_context& loader_context)
+	{
+		// Images decoded by tinygltf are never KTX2
+		const auto ktx2 = gltf_image.width < 0 ? codec::read_ktx2(gltf_image.image) : std::nullopt;
+
+		if (ktx2.has_value())
+		{
+			const auto reason = ktx2_image_unsupported_reason(*ktx2, loader_context);
+			if (!reason.empty())
+				throw Gltf_parse_error(std::format("Unsupported KTX2 image \"{}\"", gltf_image.name), reason);
+
+			const auto& header      = ktx2->header;
+			const auto& ktx2_format = codec::block_formats.at((vk::Format)header.vk_format);
+
+			width = header.pixel_width, height = header.pixel_height;
+			component_count = ktx2_format.component_count;
+			format          = ktx2_format.upload_format;
+			name            = gltf_image.name;
+
+			if (component_count == 2 && usage == Texture_usage::Metal_roughness)
+				components = {vk::ComponentSwizzle::eOne, vk::ComponentSwizzle::eR, vk::ComponentSwizzle::eG, vk::ComponentSwizzle::eOne};
+
+			upload(codec::ktx2_levels(*ktx2, gltf_image.image), loader_context);
+			return;
+		}
+
+		const auto tex = codec::decode_image(gltf_image);
+
 		format = [](uint32_t pixel_type, uint32_t component_count)
 		{
 			switch (pixel_type)
@@ -39,15 +163,12 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 			);
 		}(tex.pixel_type, tex.component);
 
-		Buffer         staging_buffer;
-		vk::DeviceSize copy_size [[maybe_unused]];
-
 		/* Create Image */
 
 		width = tex.width, height = tex.height;
 		component_count = tex.component == 3 ? 4 : tex.component;
 		mipmap_levels   = algorithm::texture::log2_mipmap_level(width, height, 128);
-		name            = tex.name;
+		name            = gltf_image.name;
 
 		image = Image(
 			loader_context.allocator,
@@ -63,115 +184,143 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 
 		/* Transfer Data */
 
-		if (tex.component == 3)
+		const size_t component_size = tex.pixel_type == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint8_t);
+
+		const codec::Block_format pixel_format{format, 1, component_count * (uint32_t)component_size, component_count};
+		const size_t              src_row_size = (size_t)width * tex.component * component_size;
+
+		// Writes pixel rows straight into staging memory, 3-component images are expanded to 4 components
+		const auto write_rows = [&](std::span<uint8_t> dst, uint32_t first_row, uint32_t row_count)
 		{
-			// 3 Component, converts to 4 Component
+			const auto src = std::span(tex.image).subspan(first_row * src_row_size, row_count * src_row_size);
 
-			// Unsigned Byte
-			if (tex.pixel_type == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE)
+			if (tex.component != 3)
 			{
-				std::vector<uint8_t> data(tex.width * tex.height * 4, 255);
+				std::ranges::copy(src, dst.begin());
+				return;
+			}
 
-				const uint8_t* const raw = tex.image.data();
+			if (tex.pixel_type == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE)
+				expand_rgb_to_rgba<uint8_t>(src.data(), dst.data(), (size_t)width * row_count);
+			else
+				expand_rgb_to_rgba<uint16_t>(src.data(), dst.data(), (size_t)width * row_count);
+		};
 
-				for (const auto i : Iota(tex.width * tex.height))
-				{
-					data[i * 4 + 0] = raw[i * 3 + 0];
-					data[i * 4 + 1] = raw[i * 3 + 1];
-					data[i * 4 + 2] = raw[i * 3 + 2];
-				}
+		/* Submit */
 
-				staging_buffer = Buffer(
-					loader_context.allocator,
-					data.size(),
-					vk::BufferUsageFlagBits::eTransferSrc,
-					vk::SharingMode::eExclusive,
-					VMA_MEMORY_USAGE_CPU_TO_GPU
+		// Staging ring and command pool can't be used by multiple threads simultaneously
+		const std::lock_guard lock(loader_context.mutex);
+
+		// Level 0 may span several chunks, the transitions & mipmap generation are recorded around all of its pieces
+		loader_context.staging_ring.record(
+			[this](const Command_buffer& command_buffer)
+			{
+				command_buffer.layout_transit(
+					image,
+					vk::ImageLayout::eUndefined,
+					vk::ImageLayout::eTransferDstOptimal,
+					{},
+					vk::AccessFlagBits::eTransferWrite,
+					vk::PipelineStageFlagBits::eTopOfPipe,
+					vk::PipelineStageFlagBits::eTransfer,
+					{vk::ImageAspectFlagBits::eColor, 0, mipmap_levels, 0, 1}
 				);
+			}
+		);
 
-				copy_size = data.size();
+		upload_level(loader_context.staging_ring, image, 0, width, height, pixel_format, write_rows);
 
-				staging_buffer << data;
-			}
-			else if (tex.pixel_type == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT)  // Unsigned Short
+		loader_context.staging_ring.record(
+			[this](const Command_buffer& command_buffer)
 			{
-				std::vector<uint16_t> data(tex.width * tex.height * 4, std::numeric_limits<uint16_t>::max());
+				algorithm::texture::generate_mipmap(
+					command_buffer,
+					image,
+					width,
+					height,
+					mipmap_levels,
+					0,
+					1,
+					vk::ImageLayout::eTransferDstOptimal,
+					vk::ImageLayout::eShaderReadOnlyOptimal
+				);
+			}
+		);
+	}
 
-				const auto* const raw = (const uint16_t*)tex.image.data();
+	void Texture::upload(std::span<const std::span<const uint8_t>> levels, Loader_context& loader_context)
+	{
+		mipmap_levels = levels.size();
 
-				for (const auto i : Iota(tex.width * tex.height))
-				{
-					data[i * 4 + 0] = raw[i * 3 + 0];
-					data[i * 4 + 1] = raw[i * 3 + 1];
-					data[i * 4 + 2] = raw[i * 3 + 2];
-				}
+		image = Image(
+			loader_context.allocator,
+			vk::ImageType::e2D,
+			vk::Extent3D(width, height, 1),
+			format,
+			vk::ImageTiling::eOptimal,
+			vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled,
+			VMA_MEMORY_USAGE_GPU_ONLY,
+			vk::SharingMode::eExclusive,
+			mipmap_levels
+		);
 
-				staging_buffer = Buffer(
-					loader_context.allocator,
-					data.size() * sizeof(uint16_t),
-					vk::BufferUsageFlagBits::eTransferSrc,
-					vk::SharingMode::eExclusive,
-					VMA_MEMORY_USAGE_CPU_TO_GPU
-				);
+		const auto& block_format = codec::block_formats.at(format);
 
-				copy_size = data.size() * sizeof(uint16_t);
+		// Staging ring and command pool can't be used by multiple threads simultaneously
+		const std::lock_guard lock(loader_context.mutex);
 
-				staging_buffer << data;
+		loader_context.staging_ring.record(
+			[this](const Command_buffer& command_buffer)
+			{
+				command_buffer.layout_transit(
+					image,
+					vk::ImageLayout::eUndefined,
+					vk::ImageLayout::eTransferDstOptimal,
+					{},
+					vk::AccessFlagBits::eTransferWrite,
+					vk::PipelineStageFlagBits::eTopOfPipe,
+					vk::PipelineStageFlagBits::eTransfer,
+					{vk::ImageAspectFlagBits::eColor, 0, mipmap_levels, 0, 1}
+				);
 			}
-		}
-		else
-		{
-			// non-3 components
-
-			staging_buffer = Buffer(
-				loader_context.allocator,
-				tex.image.size(),
-				vk::BufferUsageFlagBits::eTransferSrc,
-				vk::SharingMode::eExclusive,
-				VMA_MEMORY_USAGE_CPU_TO_GPU
-			);
+		);
 
-			copy_size = tex.image.size();
+		// Each level is uploaded in pieces of whole block rows
+		for (const auto [level, data] : Walk(levels))
+		{
+			const auto level_width = std::max(width >> level, 1u), level_height = std::max(height >> level, 1u);
+			const auto row_size    = (size_t)((level_width + block_format.block_extent - 1) / block_format.block_extent)
+								* block_format.block_size;
 
-			staging_buffer << tex.image;
+			upload_level(
+				loader_context.staging_ring,
+				image,
+				level,
+				level_width,
+				level_height,
+				block_format,
+				[&](std::span<uint8_t> dst, uint32_t first_row, uint32_t row_count)
+				{
+					std::ranges::copy(data.subspan(first_row * row_size, row_count * row_size), dst.begin());
+				}
+			);
 		}
 
-		/* Submit */
-		auto command_buffer = Command_buffer(loader_context.command_pool);
-
-		command_buffer.begin();
-
-		command_buffer.layout_transit(
-			image,
-			vk::ImageLayout::eUndefined,
-			vk::ImageLayout::eTransferDstOptimal,
-			{},
-			vk::AccessFlagBits::eTransferWrite,
-			vk::PipelineStageFlagBits::eTopOfPipe,
-			vk::PipelineStageFlagBits::eTransfer,
-			{vk::ImageAspectFlagBits::eColor, 0, mipmap_levels, 0, 1}
-		);
-
-		const vk::BufferImageCopy
-			copy_info(0, 0, 0, {vk::ImageAspectFlagBits::eColor, 0, 0, 1}, {0, 0, 0}, vk::Extent3D(width, height, 1));
-		command_buffer.copy_buffer_to_image(image, staging_buffer, vk::ImageLayout::eTransferDstOptimal, {copy_info});
-
-		algorithm::texture::generate_mipmap(
-			command_buffer,
-			image,
-			width,
-			height,
-			mipmap_levels,
-			0,
-			1,
-			vk::ImageLayout::eTransferDstOptimal,
-			vk::ImageLayout::eShaderReadOnlyOptimal
+		loader_context.staging_ring.record(
+			[this](const Command_buffer& command_buffer)
+			{
+				command_buffer.layout_transit(
+					image,
+					vk::ImageLayout::eTransferDstOptimal,
+					vk::ImageLayout::eShaderReadOnlyOptimal,
+					vk::AccessFlagBits::eTransferWrite,
+					vk::AccessFlagBits::eShaderRead,
+					vk::PipelineStageFlagBits::eTransfer,
+					vk::PipelineStageFlagBits::eAllGraphics,
+					{vk::ImageAspectFlagBits::eColor, 0, mipmap_levels, 0, 1}
+				);
+			}
 		);
-
-		command_buffer.end();
-
-		loader_context.command_buffers.push_back(command_buffer);
-		loader_context.staging_buffers.push_back(staging_buffer);
 	}
 
 	void Texture::generate(uint8_t value0, uint8_t value1, uint8_t value2, uint8_t value3, Loader_context& loader_context)
@@ -195,20 +344,12 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 		format          = vk::Format::eR8G8B8A8Unorm;
 		name            = std::format("Generated Image ({}, {}, {}, {})", value0, value1, value2, value3);
 
-		const Buffer staging_buffer(
-			loader_context.allocator,
-			4,
-			vk::BufferUsageFlagBits::eTransferSrc,
-			vk::SharingMode::eExclusive,
-			VMA_MEMORY_USAGE_CPU_TO_GPU
-		);
-
-		staging_buffer << pixel_data;
-
-		auto command_buffer = Command_buffer(loader_context.command_pool);
+		const auto write_pixels = [&pixel_data](std::span<uint8_t> dst)
+		{
+			std::ranges::copy(pixel_data, dst.begin());
+		};
 
-		// Record command buffer
-		command_buffer.begin();
+		const auto record_upload = [this](const Command_buffer& command_buffer, const Buffer& staging, vk::DeviceSize offset)
 		{
 			command_buffer.layout_transit(
 				image,
@@ -222,8 +363,8 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 			);
 
 			const vk::BufferImageCopy
-				copy_info(0, 0, 0, {vk::ImageAspectFlagBits::eColor, 0, 0, 1}, {0, 0, 0}, vk::Extent3D(width, height, 1));
-			command_buffer.copy_buffer_to_image(image, staging_buffer, vk::ImageLayout::eTransferDstOptimal, {copy_info});
+				copy_info(offset, 0, 0, {vk::ImageAspectFlagBits::eColor, 0, 0, 1}, {0, 0, 0}, vk::Extent3D(width, height, 1));
+			command_buffer.copy_buffer_to_image(image, staging, vk::ImageLayout::eTransferDstOptimal, {copy_info});
 
 			command_buffer.layout_transit(
 				image,
@@ -235,11 +376,10 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 				vk::PipelineStageFlagBits::eAllGraphics,
 				{vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1}
 			);
-		}
-		command_buffer.end();
+		};
 
-		loader_context.command_buffers.push_back(command_buffer);
-		loader_context.staging_buffers.push_back(staging_buffer);
+		const std::lock_guard lock(loader_context.mutex);
+		loader_context.staging_ring.upload(pixel_data.size(), write_pixels, record_upload);
 	}
 
 #pragma endregion
@@ -359,13 +499,12 @@ namespace VKLIB_HPP_NAMESPACE::io::gltf
 		const Loader_context&       context,
 		const std::vector<Texture>& texture_list,
 		const tinygltf::Model&      model,
-		const tinygltf::Texture&    texture,
-		const vk::ComponentMapping& components
-	) :
-		Texture_view(
-			texture.sampler >= 0 ? Texture_view(context, texture_list[texture.source], model.samplers[texture.sampler], components)
-								 : Texture_view(context, texture_list[texture.source], components)
-		)
+		const tinygltf::Texture&    texture
+	)
 	{
+		const auto& source = texture_list[texture_source(context, model, texture)];
+
+		*this = texture.sampler >= 0 ? Texture_view(context, source, model.samplers[texture.sampler], source.components)
+									 : Texture_view(context, source, source.components);
 	}
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 // ================
 // [Description]
 // - Provides wrapped interface to stb_image for reading image files
+// - Provides wrapped interface to stb_image_write for writing PNG files
 // - Provides pre-built functions to convert image data to vulkan images
 
 #pragma once
@@ -25,9 +26,10 @@ namespace VKLIB_HPP_NAMESPACE::io::stbi
 	template <typename Data_T>
 	struct Stbi_raw_data
 	{
-		std::vector<Data_T> raw_data;
-		int                 width, height;
-		int                 original_channels, channels;
+		std::shared_ptr<Data_T[]> pixels;    // Pixel memory allocated by stbi, moved out without copying
+		std::span<Data_T>         raw_data;  // View of `pixels`
+		int                       width, height;
+		int                       original_channels, channels;
 
 		// > Convert raw data to vulkan image.
 		// When converting a hdr image, `generate_mipmap` will be ignored.
@@ -64,7 +66,7 @@ namespace VKLIB_HPP_NAMESPACE::io::stbi
 		}
 	};
 
-	// > Load 8bit image from file.
+	// > Load 8bit image from file, the file is memory mapped instead of read.
 	// `path`: Image file path
 	// `request_channel`: Requested channel count; normally and default to 4 channels (RGBA); choose 1 for grayscale
 	No_discard Stbi_raw_data<uint8_t> load_8bit(const std::string& path, int request_channel = 4);
@@ -74,7 +76,7 @@ namespace VKLIB_HPP_NAMESPACE::io::stbi
 	// `request_channel`: Requested channel count; normally and default to 4 channels (RGBA); choose 1 for grayscale
 	No_discard Stbi_raw_data<uint8_t> load_8bit(std::span<const uint8_t> file_data, int request_channel = 4);
 
-	// > Load 16bit image from file.
+	// > Load 16bit image from file, the file is memory mapped instead of read.
 	// `path`: Image file path
 	// `request_channel`: Requested channel count; normally and default to 4 channels (RGBA); choose 1 for grayscale
 	No_discard Stbi_raw_data<uint16_t> load_16bit(const std::string& path, int request_channel = 4);
@@ -84,11 +86,15 @@ namespace VKLIB_HPP_NAMESPACE::io::stbi
 	// `request_channel`: Requested channel count; normally and default to 4 channels (RGBA); choose 1 for grayscale
 	No_discard Stbi_raw_data<uint16_t> load_16bit(std::span<const uint8_t> file_data, int request_channel = 4);
 
-	// > Load hdr image from file.
+	// > Load hdr image from file, the file is memory mapped instead of read.
 	// `path`: Image file path
 	No_discard Stbi_raw_data<float> load_hdri(const std::string& path);
 
 	// > Load hdr image from image file data.
 	// `file_data`: Image file data
 	No_discard Stbi_raw_data<float> load_hdri(std::span<const uint8_t> file_data);
+
+	// > Write 8bit image to a PNG file, throws `error::IO_error` on failure.
+	// `data`: Tightly packed pixels, `width * height * channels` bytes
+	void write_png(const std::string& path, int width, int height, int channels, std::span<const uint8_t> data);
 }
\ No newline at end of file
@@ -1,24 +1,39 @@
 #include "stb_image.h"
+#include "stb_image_write.h"
 #include "vklib/stbi.hpp"
 #include <vklib/core/algorithm.hpp>
 
 
 namespace VKLIB_HPP_NAMESPACE::io::stbi
 {
+	// Takes ownership of pixel memory returned by stbi, instead of copying it into a new container
+	template <typename Data_T>
+	static Stbi_raw_data<Data_T> take_pixels(Data_T* pixels, int width, int height, int original_channels, int channels)
+	{
+		const auto pixel_count = (size_t)width * height * channels;
+
+		return {
+			std::shared_ptr<Data_T[]>(pixels, stbi_image_free),
+			std::span<Data_T>(pixels, pixel_count),
+			width,
+			height,
+			original_channels,
+			channels
+		};
+	}
+
 	Stbi_raw_data<uint8_t> load_8bit(const std::string& path, int request_channel)
 	{
-		auto img_data = read(path);
-		return load_8bit(img_data, request_channel);
+		const Mapped_file file(path);
+		return load_8bit(file.data(), request_channel);
 	}
 
 	Stbi_raw_data<uint8_t> load_8bit(std::span<const uint8_t> file_data, int request_channel)
 	{
 		int width, height, channels;
 
-		const std::unique_ptr<uint8_t, decltype(&stbi_image_free)> img_data(
-			stbi_load_from_memory(file_data.data(), file_data.size(), &width, &height, &channels, request_channel),
-			stbi_image_free
-		);
+		auto* const img_data
+			= stbi_load_from_memory(file_data.data(), file_data.size(), &width, &height, &channels, request_channel);
 
 		if (img_data == nullptr)
 		{
@@ -26,30 +41,21 @@ namespace VKLIB_HPP_NAMESPACE::io::stbi
 			throw Stbi_conversion_error(std::format("8-Bit Image, request_channel={}", request_channel), reason);
 		}
 
-		Stbi_raw_data<uint8_t> ret
-			= {std::vector<uint8_t>(img_data.get(), img_data.get() + width * height * sizeof(uint8_t) * request_channel),
-			   width,
-			   height,
-			   channels,
-			   request_channel};
-
-		return ret;
+		return take_pixels(img_data, width, height, channels, request_channel);
 	}
 
 	Stbi_raw_data<uint16_t> load_16bit(const std::string& path, int request_channel)
 	{
-		auto img_data = read(path);
-		return load_16bit(img_data, request_channel);
+		const Mapped_file file(path);
+		return load_16bit(file.data(), request_channel);
 	}
 
 	Stbi_raw_data<uint16_t> load_16bit(std::span<const uint8_t> file_data, int request_channel)
 	{
 		int width, height, channels;
 
-		const std::unique_ptr<uint16_t, decltype(&stbi_image_free)> img_data(
-			stbi_load_16_from_memory(file_data.data(), file_data.size(), &width, &height, &channels, request_channel),
-			stbi_image_free
-		);
+		auto* const img_data
+			= stbi_load_16_from_memory(file_data.data(), file_data.size(), &width, &height, &channels, request_channel);
 
 		if (img_data == nullptr)
 		{
@@ -57,30 +63,20 @@ namespace VKLIB_HPP_NAMESPACE::io::stbi
 			throw Stbi_conversion_error(std::format("16-Bit Image, request_channel={}", request_channel), reason);
 		}
 
-		Stbi_raw_data<uint16_t> ret
-			= {std::vector<uint16_t>(img_data.get(), img_data.get() + width * height * sizeof(uint16_t) * request_channel),
-			   width,
-			   height,
-			   channels,
-			   request_channel};
-
-		return ret;
+		return take_pixels(img_data, width, height, channels, request_channel);
 	}
 
 	Stbi_raw_data<float> load_hdri(const std::string& path)
 	{
-		auto img_data = read(path);
-		return load_hdri(img_data);
+		const Mapped_file file(path);
+		return load_hdri(file.data());
 	}
 
 	Stbi_raw_data<float> load_hdri(std::span<const uint8_t> file_data)
 	{
 		int width, height, channels;
 
-		const std::unique_ptr<float, decltype(&stbi_image_free)> img_data(
-			stbi_loadf_from_memory(file_data.data(), file_data.size(), &width, &height, &channels, 4),
-			stbi_image_free
-		);
+		auto* const img_data = stbi_loadf_from_memory(file_data.data(), file_data.size(), &width, &height, &channels, 4);
 
 		if (img_data == nullptr)
 		{
@@ -88,10 +84,7 @@ namespace VKLIB_HPP_NAMESPACE::io::stbi
 			throw Stbi_conversion_error("32-bit Float Image (HDRI)", reason);
 		}
 
-		Stbi_raw_data<float> ret
-			= {std::vector<float>(img_data.get(), img_data.get() + width * height * 4), width, height, channels, 4};
-
-		return ret;
+		return take_pixels(img_data, width, height, channels, 4);
 	}
 
 	template <>
@@ -106,10 +99,6 @@ namespace VKLIB_HPP_NAMESPACE::io::stbi
 		const vk::Format image_format = vk::Format::eR16G16B16A16Sfloat;
 		const auto       image_extent = vk::Extent3D(width, height, 1);
 
-		// Transform 32bit float to 16bit float
-		std::vector<uint16_t> image_converted(image_extent.width * image_extent.height * 4);
-		for (auto i : Iota(raw_data.size())) image_converted[i] = algorithm::conversion::f32_to_f16_clamped(raw_data[i]);
-
 		// Create Objects
 
 		result.image = Image(
@@ -125,17 +114,21 @@ namespace VKLIB_HPP_NAMESPACE::io::stbi
 
 		result.staging_buffer = Buffer(
 			allocator,
-			image_converted.size() * sizeof(uint16_t),
+			raw_data.size() * sizeof(uint16_t),
 			vk::BufferUsageFlagBits::eTransferSrc,
 			vk::SharingMode::eExclusive,
-			VMA_MEMORY_USAGE_CPU_TO_GPU
+			VMA_MEMORY_USAGE_CPU_TO_GPU,
+			VMA_ALLOCATION_CREATE_MAPPED_BIT
 		);
 
 		result.mipmap_levels = 1;
 
-		// Upload and copy
+		// Transform 32bit float to 16bit float, directly into the staging buffer
+
+		const auto staging_data = std::span((uint16_t*)result.staging_buffer.mapped_data(), raw_data.size());
+		algorithm::conversion::f32_to_f16_clamped(raw_data, staging_data);
 
-		result.staging_buffer << image_converted;
+		// Copy
 
 		command_buffer.layout_transit(
 			result.image,
@@ -329,4 +322,12 @@ namespace VKLIB_HPP_NAMESPACE::io::stbi
 
 		return result;
 	}
+
+	void write_png(const std::string& path, int width, int height, int channels, std::span<const uint8_t> data)
+	{
+		if (data.size() < (size_t)width * height * channels) throw error::IO_error(path, "Pixel data smaller than image size");
+
+		if (stbi_write_png(path.c_str(), width, height, channels, data.data(), width * channels) == 0)
+			throw error::IO_error(path, "Write PNG failed");
+	}
 }
\ No newline at end of file